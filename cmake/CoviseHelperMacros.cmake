@@ -454,6 +454,23 @@ MACRO(ADD_COVISE_MODULE category targetname)
   SET_TARGET_PROPERTIES(${targetname} PROPERTIES LABELS "${category}")
   
   # SET_TARGET_PROPERTIES(${targetname} PROPERTIES DEBUG_OUTPUT_NAME "${targetname}${CMAKE_DEBUG_POSTFIX}")
+
+  IF(COVISE_BUILD_MODULE_LIBRARIES AND UNIX AND NOT APPLE)
+    # the same module as shared object <targetname>.so next to the executable,
+    # loaded by the pre-forked module launcher of the crb
+    ADD_LIBRARY(${targetname}_launch MODULE ${ARGN} ${SOURCES} ${HEADERS})
+    SET_TARGET_PROPERTIES(${targetname}_launch PROPERTIES OUTPUT_NAME "${targetname}" PREFIX "" SUFFIX ".so")
+    set_target_properties(${targetname}_launch PROPERTIES FOLDER ${category}_Modules)
+    COVISE_ADJUST_OUTPUT_DIR(${targetname}_launch ${category} bin)
+    SET_TARGET_PROPERTIES(${targetname}_launch PROPERTIES COMPILE_FLAGS "${COVISE_COMPILE_FLAGS}")
+    SET_TARGET_PROPERTIES(${targetname}_launch PROPERTIES LINK_FLAGS "${COVISE_LINK_FLAGS}")
+    # link whatever the executable is linked with later on and use its definitions
+    # and include directories, per target flags are applied to both by ADD_COVISE_COMPILE_FLAGS & co.
+    TARGET_LINK_LIBRARIES(${targetname}_launch $<TARGET_PROPERTY:${targetname},LINK_LIBRARIES>)
+    SET_PROPERTY(TARGET ${targetname}_launch APPEND PROPERTY COMPILE_DEFINITIONS $<TARGET_PROPERTY:${targetname},COMPILE_DEFINITIONS>)
+    SET_PROPERTY(TARGET ${targetname}_launch APPEND PROPERTY INCLUDE_DIRECTORIES $<TARGET_PROPERTY:${targetname},INCLUDE_DIRECTORIES>)
+  ENDIF()
+
   UNSET(SOURCES)
   UNSET(HEADERS)
 ENDMACRO(ADD_COVISE_MODULE)
@@ -684,6 +701,10 @@ FUNCTION(ADD_COVISE_COMPILE_FLAGS targetname flags)
     #ENDIF(NOT flag_matched)
   ENDFOREACH(cflag)
   SET_TARGET_PROPERTIES(${targetname} PROPERTIES COMPILE_FLAGS "${MY_CFLAGS}")
+  # the module library built next to a module executable has to be compiled alike
+  IF(TARGET ${targetname}_launch)
+    ADD_COVISE_COMPILE_FLAGS(${targetname}_launch "${flags}")
+  ENDIF()
   # MESSAGE("added compile flags ${MY_CFLAGS} to target ${targetname}")
 ENDFUNCTION(ADD_COVISE_COMPILE_FLAGS)
 
@@ -696,6 +717,9 @@ FUNCTION(REMOVE_COVISE_COMPILE_FLAGS targetname flags)
     STRING(REGEX REPLACE "${cflag}[ ]+|${cflag}$" "" MY_CFLAGS "${MY_CFLAGS}")
   ENDFOREACH(cflag)
   SET_TARGET_PROPERTIES(${targetname} PROPERTIES COMPILE_FLAGS "${MY_CFLAGS}")
+  IF(TARGET ${targetname}_launch)
+    REMOVE_COVISE_COMPILE_FLAGS(${targetname}_launch "${flags}")
+  ENDIF()
 ENDFUNCTION(REMOVE_COVISE_COMPILE_FLAGS)
 
 FUNCTION(ADD_COVISE_LINK_FLAGS targetname flags)
@@ -710,6 +734,10 @@ FUNCTION(ADD_COVISE_LINK_FLAGS targetname flags)
     #ENDIF(NOT flag_matched)
   ENDFOREACH(lflag)
   SET_TARGET_PROPERTIES(${targetname} PROPERTIES LINK_FLAGS "${MY_LFLAGS}")
+  # the module library built next to a module executable has to be linked alike
+  IF(TARGET ${targetname}_launch)
+    ADD_COVISE_LINK_FLAGS(${targetname}_launch "${flags}")
+  ENDIF()
   #MESSAGE("added link flags ${MY_LFLAGS} to target ${targetname}")
 ENDFUNCTION(ADD_COVISE_LINK_FLAGS)
 
@@ -722,6 +750,9 @@ FUNCTION(REMOVE_COVISE_LINK_FLAGS targetname flags)
     STRING(REGEX REPLACE "${lflag}[ ]+|${lflag}$" "" MY_LFLAGS "${MY_LFLAGS}")
   ENDFOREACH(lflag)
   SET_TARGET_PROPERTIES(${targetname} PROPERTIES LINK_FLAGS "${MY_LFLAGS}")
+  IF(TARGET ${targetname}_launch)
+    REMOVE_COVISE_LINK_FLAGS(${targetname}_launch "${flags}")
+  ENDIF()
 ENDFUNCTION(REMOVE_COVISE_LINK_FLAGS)
 
 # small debug helper
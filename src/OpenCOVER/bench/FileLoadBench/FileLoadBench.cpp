@@ -0,0 +1,174 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Loading many small files with the loader threads of OpenCOVER
+ *
+ * n small ASCII STL files, as referenced by the parts of a PLMXML
+ * assembly, are written to a directory. They are read once on the main
+ * thread, as coVRFileManager::loadFile does, and then with coVRAsyncLoader
+ * and 1 to j threads. In the asynchronous case, the main thread simulates
+ * frames of f ms and attaches the finished nodes at the frame boundaries.
+ *
+ * Reported are the time until all files are attached and the longest time
+ * the main thread spent attaching in one frame. Reading on the main thread
+ * blocks rendering for the whole time.
+ */
+
+#include "BenchUtil.h"
+
+#include <cover/coVRAsyncLoader.h>
+
+#include <osg/Group>
+#include <osgDB/ReadFile>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+using namespace opencover;
+
+// a ring of triangles, different for every file
+static bool writeSTL(const std::string &filename, int index, int numTriangles)
+{
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp)
+        return false;
+    fprintf(fp, "solid part%d\n", index);
+    float z = (float)index;
+    for (int t = 0; t < numTriangles; ++t)
+    {
+        float a0 = 2.f * (float)M_PI * t / numTriangles;
+        float a1 = 2.f * (float)M_PI * (t + 1) / numTriangles;
+        fprintf(fp, "facet normal 0 0 1\n outer loop\n");
+        fprintf(fp, "  vertex 0 0 %f\n", z);
+        fprintf(fp, "  vertex %f %f %f\n", cosf(a0), sinf(a0), z);
+        fprintf(fp, "  vertex %f %f %f\n", cosf(a1), sinf(a1), z);
+        fprintf(fp, " endloop\nendfacet\n");
+    }
+    fprintf(fp, "endsolid part%d\n", index);
+    fclose(fp);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int numFiles = 2000;
+    int numTriangles = 200;
+    int maxThreads = 8;
+    int frameMs = 10;
+    std::string dir = "/tmp/FileLoadBench";
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numFiles = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            numTriangles = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+            maxThreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            frameMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            dir = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [-n files] [-t triangles] [-j threads] [-f frame ms] [-d directory]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numFiles < 1 || numTriangles < 1 || maxThreads < 1 || frameMs < 0)
+        return 1;
+
+    mkdir(dir.c_str(), 0755);
+    std::vector<std::string> files;
+    for (int i = 0; i < numFiles; ++i)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "/part%05d.stl", i);
+        files.push_back(dir + name);
+        if (!writeSTL(files.back(), i, numTriangles))
+        {
+            fprintf(stderr, "cannot write %s\n", files.back().c_str());
+            return 1;
+        }
+    }
+    printf("%d files with %d triangles in %s\n", numFiles, numTriangles, dir.c_str());
+
+    bool ok = true;
+    osg::ref_ptr<osgDB::ReaderWriter::Options> options = new osgDB::ReaderWriter::Options("noRotation");
+    osg::ref_ptr<osg::Group> root = new osg::Group;
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < numFiles; ++i)
+    {
+        osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(files[i], options.get());
+        if (node.valid())
+            root->addChild(node.get());
+    }
+    double serial = timer.elapsed();
+    if ((int)root->getNumChildren() != numFiles)
+    {
+        fprintf(stderr, "main thread: %d of %d files read\n", root->getNumChildren(), numFiles);
+        ok = false;
+    }
+    printf("main thread: %8.3f s, rendering blocked for all of it\n", serial);
+    printf("threads  total s  speedup  frames  max attach ms\n");
+
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        root = new osg::Group;
+        int frames = 0;
+        double maxAttach = 0.;
+        timer.start();
+        {
+            coVRAsyncLoader loader(numThreads, "noRotation");
+            for (int i = 0; i < numFiles; ++i)
+                loader.add(i, files[i]);
+
+            int done = 0;
+            while (done < numFiles)
+            {
+                usleep(frameMs * 1000);
+                ++frames;
+
+                BenchTimer attachTimer;
+                attachTimer.start();
+                std::vector<coVRAsyncLoader::Request> finished;
+                loader.takeFinished(finished);
+                for (size_t r = 0; r < finished.size(); ++r)
+                {
+                    if (finished[r].node.valid())
+                        root->addChild(finished[r].node.get());
+                }
+                done += (int)finished.size();
+                double attach = attachTimer.elapsed();
+                if (attach > maxAttach)
+                    maxAttach = attach;
+            }
+        }
+        double total = timer.elapsed();
+        if ((int)root->getNumChildren() != numFiles)
+        {
+            fprintf(stderr, "%d threads: %d of %d files read\n", numThreads, root->getNumChildren(), numFiles);
+            ok = false;
+        }
+        printf("%7d %8.3f %8.2f %7d %14.3f\n", numThreads, total, serial / total, frames, maxAttach * 1e3);
+    }
+
+    for (int i = 0; i < numFiles; ++i)
+        unlink(files[i].c_str());
+    rmdir(dir.c_str());
+
+    printf("%s\n", ok ? "all files loaded" : "files MISSING");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,272 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Vector field glyphs: expanded lines against instanced arrows
+ *
+ * n vectors of a swirling field on a cubic grid are turned into arrows
+ * with s sectors in the arrow head. Reported are the sizes of the COVISE
+ * objects VectorField creates with output=lines (Lines and Float per
+ * line point) and output=glyphs (Points, Vec3 and Float per vector), and
+ * the sizes of the arrays COVER uploads for them.
+ *
+ * Unless -t is given, both variants are rendered in a window for f frames
+ * with an orbiting camera: the lines as GeometryManager::addLine builds
+ * them (a line strip and a color per point), the glyphs with ArrowGlyphs.
+ * The frame rate needs a display and a GPU with enough memory for the
+ * expanded lines.
+ */
+
+#include "BenchUtil.h"
+
+#include <VRCoviseArrowGlyphs.h>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/DisplaySettings>
+#include <osgViewer/Viewer>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace opencover;
+
+// points of the line strip coVectField creates for one vector
+static int linePoints(int numSectors)
+{
+    int line2 = numSectors >= 2 ? 3 * (numSectors / 2) + 2 * (numSectors % 2) : numSectors;
+    int line3 = numSectors > 2 ? numSectors - numSectors % 2 : 0;
+    return 2 + line2 + line3;
+}
+
+// the line strip of coVectField::create_stings for one vector
+static void expandArrow(const osg::Vec3 &p, const osg::Vec3 &d, int numSectors, float arrowFactor, float angle,
+                        osg::Vec3Array *vertices)
+{
+    float len = d.length();
+    osg::Vec3 w = len > 0.f ? d / len : osg::Vec3(0.f, 0.f, 1.f);
+    osg::Vec3 u = (fabs(w.x()) < 0.9f ? osg::Vec3(1.f, 0.f, 0.f) : osg::Vec3(0.f, 1.f, 0.f)) ^ w;
+    u.normalize();
+    osg::Vec3 v = w ^ u;
+
+    float a = (float)(angle * M_PI / 180.0);
+    osg::Vec3 tip = p + d;
+    osg::Vec3 center = tip - d * (arrowFactor * cosf(a));
+    std::vector<osg::Vec3> sting(numSectors);
+    for (int k = 0; k < numSectors; ++k)
+    {
+        float phi = (float)(2.0 * M_PI * k / numSectors);
+        sting[k] = center + (u * cosf(phi) + v * sinf(phi)) * (arrowFactor * len * sinf(a));
+    }
+
+    vertices->push_back(p);
+    vertices->push_back(tip);
+    if (numSectors == 1)
+    {
+        vertices->push_back(sting[0]);
+    }
+    else if (numSectors >= 2)
+    {
+        for (int j = 0; j < numSectors / 2; ++j)
+        {
+            vertices->push_back(sting[2 * j]);
+            vertices->push_back(sting[2 * j + 1]);
+            vertices->push_back(tip);
+        }
+        if (numSectors % 2)
+        {
+            vertices->push_back(sting[numSectors - 1]);
+            vertices->push_back(sting[0]);
+        }
+    }
+    if (numSectors > 2)
+    {
+        for (int k = 1; k < numSectors; ++k)
+            vertices->push_back(sting[k]);
+        if (numSectors % 2 == 0)
+            vertices->push_back(sting[0]);
+    }
+}
+
+static osg::Vec4 colorMap(float value)
+{
+    return osg::Vec4(value, 0.3f, 1.f - value, 1.f);
+}
+
+static osg::Geode *createLines(const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &z,
+                               const std::vector<float> &u, const std::vector<float> &v, const std::vector<float> &w,
+                               const std::vector<float> &mag, float maxMag, int numSectors, float arrowFactor, float angle)
+{
+    int n = (int)x.size();
+    int numPoints = linePoints(numSectors);
+    osg::Vec3Array *vertices = new osg::Vec3Array;
+    osg::Vec4Array *colors = new osg::Vec4Array;
+    vertices->reserve((size_t)n * numPoints);
+    colors->reserve((size_t)n * numPoints);
+    osg::DrawArrayLengths *primitives = new osg::DrawArrayLengths(osg::PrimitiveSet::LINE_STRIP);
+    for (int i = 0; i < n; ++i)
+    {
+        expandArrow(osg::Vec3(x[i], y[i], z[i]), osg::Vec3(u[i], v[i], w[i]), numSectors, arrowFactor, angle, vertices);
+        for (int k = 0; k < numPoints; ++k)
+            colors->push_back(colorMap(mag[i] / maxMag));
+        primitives->push_back(numPoints);
+    }
+
+    osg::Geometry *geom = new osg::Geometry;
+    geom->setUseDisplayList(false);
+    geom->setUseVertexBufferObjects(true);
+    geom->setVertexArray(vertices);
+    geom->setColorArray(colors, osg::Array::BIND_PER_VERTEX);
+    geom->addPrimitiveSet(primitives);
+    geom->getOrCreateStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+
+    osg::Geode *geode = new osg::Geode;
+    geode->addDrawable(geom);
+    return geode;
+}
+
+static osg::Geode *createGlyphs(const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &z,
+                                const std::vector<float> &u, const std::vector<float> &v, const std::vector<float> &w,
+                                const std::vector<float> &mag, float maxMag, int numSectors, float arrowFactor, float angle)
+{
+    int n = (int)x.size();
+    osg::Vec4ubArray *colors = new osg::Vec4ubArray(n);
+    for (int i = 0; i < n; ++i)
+    {
+        osg::Vec4 c = colorMap(mag[i] / maxMag);
+        (*colors)[i].set((unsigned char)(c[0] * 255.f), (unsigned char)(c[1] * 255.f), (unsigned char)(c[2] * 255.f), 255);
+    }
+
+    osg::Geometry *geom = ArrowGlyphs::create(n, &x[0], &y[0], &z[0], &u[0], &v[0], &w[0], colors,
+                                              numSectors, arrowFactor, angle);
+    geom->getOrCreateStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+
+    osg::Geode *geode = new osg::Geode;
+    geode->addDrawable(geom);
+    return geode;
+}
+
+// frames per second with the camera orbiting around the scene
+static double render(osgViewer::Viewer &viewer, osg::Node *scene, int numFrames)
+{
+    viewer.setSceneData(scene);
+    const osg::BoundingSphere &bs = scene->getBound();
+    BenchTimer timer;
+    const int warmup = 5;
+    for (int f = 0; f < warmup + numFrames; ++f)
+    {
+        if (f == warmup)
+            timer.start();
+        double phi = 2. * M_PI * f / (warmup + numFrames);
+        osg::Vec3 eye = bs.center() + osg::Vec3(cos(phi), sin(phi), 0.5) * (2.5 * bs.radius());
+        viewer.getCamera()->setViewMatrixAsLookAt(eye, bs.center(), osg::Vec3(0., 0., 1.));
+        viewer.frame();
+    }
+    return numFrames / timer.elapsed();
+}
+
+int main(int argc, char **argv)
+{
+    int n = 10000000;
+    int numSectors = 8;
+    int numFrames = 50;
+    bool renderFrames = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            numSectors = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            numFrames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-t"))
+            renderFrames = false;
+        else
+        {
+            fprintf(stderr, "usage: %s [-n vectors] [-s sectors] [-f frames] [-t (sizes only)]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1 || numSectors < 0 || numFrames < 1)
+        return 1;
+    const float arrowFactor = 0.2f, angle = 9.5f;
+
+    // swirl around the z axis on a cubic grid
+    int dim = (int)ceil(pow((double)n, 1. / 3.));
+    float spacing = 1.f / dim, scale = 0.8f * spacing;
+    std::vector<float> x(n), y(n), z(n), u(n), v(n), w(n), mag(n);
+    float maxMag = 0.f;
+    for (int i = 0; i < n; ++i)
+    {
+        x[i] = (i % dim) * spacing - 0.5f;
+        y[i] = ((i / dim) % dim) * spacing - 0.5f;
+        z[i] = (i / (dim * dim)) * spacing - 0.5f;
+        float du = -y[i], dv = x[i], dw = 0.2f * sinf(6.f * z[i]);
+        mag[i] = sqrtf(du * du + dv * dv + dw * dw);
+        maxMag = std::max(maxMag, mag[i]);
+        u[i] = du * scale / 0.7f;
+        v[i] = dv * scale / 0.7f;
+        w[i] = dw * scale / 0.7f;
+    }
+    if (maxMag == 0.f)
+        maxMag = 1.f;
+
+    // sizes as allocated by coVectField::compute_vectorfields and compute_vectorglyphs
+    int numc_line = linePoints(numSectors);
+    double linesObj = (double)n * ((2 + numSectors) * 3 * sizeof(float) + numc_line * sizeof(int) + sizeof(int));
+    double linesData = (double)n * (2 + numSectors) * sizeof(float);
+    double glyphsObj = (double)n * (3 * sizeof(float) + 3 * sizeof(float));
+    double glyphsData = (double)n * sizeof(float);
+    // arrays COVER creates: addLine expands the vertex list and adds a color per vertex
+    double linesGPU = (double)n * numc_line * (3 * sizeof(float) + 4 * sizeof(float));
+    double glyphsGPU = (double)n * (6 * sizeof(float) + 4);
+
+    printf("%d vectors, %d sectors per arrow head\n", n, numSectors);
+    printf("output  geometry MB  data MB  total MB  COVER arrays MB\n");
+    printf("lines   %11.1f  %7.1f  %8.1f  %15.1f\n", linesObj / 1e6, linesData / 1e6, (linesObj + linesData) / 1e6, linesGPU / 1e6);
+    printf("glyphs  %11.1f  %7.1f  %8.1f  %15.1f\n", glyphsObj / 1e6, glyphsData / 1e6, (glyphsObj + glyphsData) / 1e6, glyphsGPU / 1e6);
+    printf("reduction %.1fx (objects), %.1fx (COVER arrays)\n",
+           (linesObj + linesData) / (glyphsObj + glyphsData), linesGPU / glyphsGPU);
+
+    if (!renderFrames)
+        return 0;
+
+    osg::DisplaySettings::instance()->setSyncToVBlank(false);
+    osgViewer::Viewer viewer;
+    viewer.setThreadingModel(osgViewer::Viewer::SingleThreaded);
+    viewer.setUpViewInWindow(0, 0, 1280, 1024);
+    viewer.realize();
+    if (!viewer.isRealized())
+    {
+        fprintf(stderr, "no graphics context, frame rate not measured\n");
+        return 1;
+    }
+
+    BenchTimer timer;
+    timer.start();
+    osg::ref_ptr<osg::Node> glyphs = createGlyphs(x, y, z, u, v, w, mag, maxMag, numSectors, arrowFactor, angle);
+    double glyphsBuild = timer.elapsed();
+    double glyphsFps = render(viewer, glyphs.get(), numFrames);
+    viewer.setSceneData(NULL);
+    glyphs = NULL;
+
+    timer.start();
+    osg::ref_ptr<osg::Node> lines = createLines(x, y, z, u, v, w, mag, maxMag, numSectors, arrowFactor, angle);
+    double linesBuild = timer.elapsed();
+    double linesFps = render(viewer, lines.get(), numFrames);
+    viewer.setSceneData(NULL);
+
+    printf("output  build s  frames/s\n");
+    printf("lines   %7.2f  %8.1f\n", linesBuild, linesFps);
+    printf("glyphs  %7.2f  %8.1f\n", glyphsBuild, glyphsFps);
+    return 0;
+}
@@ -27,6 +27,7 @@
 #include "coTUIFileBrowser/IRemoteData.h"
 #include "coTUIFileBrowser/NetHelp.h"
 #include "OpenCOVER.h"
+#include "VRViewer.h"
 #ifdef FB_USE_AG
 #include "coTUIFileBrowser/AGData.h"
 #endif
@@ -5105,12 +5106,18 @@ coTabletUI::coTabletUI()
     elements.setNoDelete();
     ID = 3;
     timeout = 0.0;
+    batchUpdates = coCoviseConfig::isOn("COVER.TabletPC.BatchUpdates", false);
+    numMessages = numBytes = 0;
+    messagesPerFrame = bytesPerFrame = 0;
     tUI = this;
     tryConnect();
 }
 
 void coTabletUI::close()
 {
+    pending.clear();
+    pendingIndex.clear();
+
     delete conn;
     conn = NULL;
 
@@ -5187,9 +5194,120 @@ void coTabletUI::send(TokenBuffer &tb)
 {
     if (conn == NULL)
         return;
+    if (batchUpdates)
+        queue(tb);
+    else
+        sendMessage(tb);
+}
+
+void coTabletUI::sendMessage(TokenBuffer &tb)
+{
     Message m(tb);
     m.type = COVISE_MESSAGE_TABLET_UI;
     conn->send_msg(&m);
+    ++numMessages;
+    numBytes += tb.get_length();
+}
+
+// values which replace the previous one, all other messages are sent in order
+static bool isStateField(int field)
+{
+    switch (field)
+    {
+    case TABLET_BOOL:
+    case TABLET_INT:
+    case TABLET_FLOAT:
+    case TABLET_STRING:
+    case TABLET_MIN:
+    case TABLET_MAX:
+    case TABLET_STEP:
+    case TABLET_NUM_TICKS:
+    case TABLET_POS:
+    case TABLET_SELECT_ENTRY:
+    case TABLET_LABEL:
+    case TABLET_SIZE:
+    case TABLET_RGBA:
+    case TABLET_RED:
+    case TABLET_GREEN:
+    case TABLET_BLUE:
+    case TABLET_ORIENTATION:
+    case TABLET_COLOR:
+    case TABLET_SET_HIDDEN:
+        return true;
+    }
+    return false;
+}
+
+void coTabletUI::queue(TokenBuffer &tb)
+{
+    PendingMessage p;
+    p.ID = -1;
+    p.field = -1;
+    p.valid = true;
+
+    TokenBuffer header(tb.get_data(), tb.get_length());
+    int type;
+    header >> type;
+    if (type == TABLET_SET_VALUE && tb.get_length() >= 3 * (int)sizeof(int))
+    {
+        header >> p.field;
+        header >> p.ID;
+    }
+    else if (type == TABLET_REMOVE && tb.get_length() >= 2 * (int)sizeof(int))
+    {
+        header >> p.ID;
+        std::map<std::pair<int, int>, size_t>::iterator it = pendingIndex.lower_bound(std::make_pair(p.ID, INT_MIN));
+        while (it != pendingIndex.end() && it->first.first == p.ID)
+            pendingIndex.erase(it++);
+    }
+
+    if (p.field >= 0 && isStateField(p.field))
+    {
+        // last value wins
+        std::pair<int, int> key(p.ID, p.field);
+        std::map<std::pair<int, int>, size_t>::iterator it = pendingIndex.find(key);
+        if (it != pendingIndex.end())
+            pending[it->second].valid = false;
+        pendingIndex[key] = pending.size();
+    }
+
+    pending.push_back(p);
+    pending.back().data.assign(tb.get_data(), tb.get_data() + tb.get_length());
+}
+
+void coTabletUI::flush()
+{
+    if (pending.empty())
+        return;
+
+    if (conn)
+    {
+        int count = 0;
+        int size = 2 * sizeof(int);
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            if (pending[i].valid)
+            {
+                ++count;
+                size += sizeof(int) + pending[i].data.size();
+            }
+        }
+
+        TokenBuffer tb(size + 1);
+        tb << TABLET_BATCH;
+        tb << count;
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            if (!pending[i].valid)
+                continue;
+            tb << (int)pending[i].data.size();
+            tb.addBinary(&pending[i].data[0], pending[i].data.size());
+        }
+        sendMessage(tb);
+    }
+
+    pending.clear();
+    pendingIndex.clear();
 }
 
 void coTabletUI::update()
@@ -5467,6 +5585,18 @@ void coTabletUI::update()
             }
         }
     } while (gotMessage);
+
+    flush();
+
+    messagesPerFrame = numMessages;
+    bytesPerFrame = numBytes;
+    numMessages = numBytes = 0;
+    if (VRViewer::instance()->getStats() && VRViewer::instance()->getStats()->collectStats("opencover"))
+    {
+        int fn = VRViewer::instance()->getFrameStamp()->getFrameNumber();
+        VRViewer::instance()->getStats()->setAttribute(fn, "TabletUI messages", messagesPerFrame);
+        VRViewer::instance()->getStats()->setAttribute(fn, "TabletUI bytes", bytesPerFrame);
+    }
 }
 
 void coTabletUI::addElement(coTUIElement *e)
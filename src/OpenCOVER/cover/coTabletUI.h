@@ -27,6 +27,7 @@
 #include <OpenThreads/Mutex>
 #include <queue>
 #include <map>
+#include <vector>
 //#ifndef WIN32
 //#include <stdint.h>
 //#define FILESYS_SEP "\\"
@@ -115,10 +116,23 @@ public:
     void addElement(coTUIElement *);
     void removeElement(coTUIElement *e);
     covise::Connection *conn;
+    // with COVER.TabletPC.BatchUpdates on, tb is queued and sent by flush()
     void send(covise::TokenBuffer &tb);
+    // send all queued messages as one batch, called once per frame by update()
+    void flush();
     void tryConnect();
     void close();
 
+    // messages and bytes written to the tablet UI connection in the last frame
+    int getMessagesPerFrame() const
+    {
+        return messagesPerFrame;
+    }
+    int getBytesPerFrame() const
+    {
+        return bytesPerFrame;
+    }
+
     void lock()
     {
         connectionMutex.lock();
@@ -145,6 +159,25 @@ protected:
     int port;
     int ID;
     float timeout;
+
+private:
+    struct PendingMessage
+    {
+        int ID;
+        int field; // value field of TABLET_SET_VALUE or -1
+        std::vector<char> data;
+        bool valid;
+    };
+
+    void sendMessage(covise::TokenBuffer &tb);
+    void queue(covise::TokenBuffer &tb);
+
+    bool batchUpdates;
+    std::vector<PendingMessage> pending;
+    // position of the last queued update for an element and value field
+    std::map<std::pair<int, int>, size_t> pendingIndex;
+    int numMessages, numBytes;
+    int messagesPerFrame, bytesPerFrame;
 };
 
 /**
@@ -0,0 +1,143 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coVRAsyncLoader.h"
+
+#include <osgDB/ReadFile>
+#include <OpenThreads/Thread>
+#include <OpenThreads/ScopedLock>
+
+using namespace opencover;
+
+class coVRAsyncLoader::LoaderThread : public OpenThreads::Thread
+{
+public:
+    LoaderThread(coVRAsyncLoader *loader)
+        : loader(loader)
+    {
+    }
+
+    virtual void run()
+    {
+        loader->work();
+    }
+
+private:
+    coVRAsyncLoader *loader;
+};
+
+coVRAsyncLoader::coVRAsyncLoader(int numThreads, const std::string &options)
+    : options(options)
+    , quit(false)
+{
+    if (numThreads < 1)
+        numThreads = 1;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        LoaderThread *thread = new LoaderThread(this);
+        thread->start();
+        threads.push_back(thread);
+    }
+}
+
+coVRAsyncLoader::~coVRAsyncLoader()
+{
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+        quit = true;
+        queued.clear();
+        condition.broadcast();
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+}
+
+void coVRAsyncLoader::add(int id, const std::string &filename)
+{
+    Request request;
+    request.id = id;
+    request.filename = filename;
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+    queued.push_back(request);
+    condition.signal();
+}
+
+void coVRAsyncLoader::cancel(const std::vector<int> &ids)
+{
+    std::set<int> drop(ids.begin(), ids.end());
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+    for (std::deque<Request>::iterator it = queued.begin(); it != queued.end();)
+    {
+        if (drop.count(it->id))
+            it = queued.erase(it);
+        else
+            ++it;
+    }
+    for (std::vector<Request>::iterator it = finished.begin(); it != finished.end();)
+    {
+        if (drop.count(it->id))
+            it = finished.erase(it);
+        else
+            ++it;
+    }
+    for (std::set<int>::iterator it = drop.begin(); it != drop.end(); ++it)
+    {
+        if (reading.count(*it))
+            cancelled.insert(*it);
+    }
+}
+
+void coVRAsyncLoader::takeFinished(std::vector<Request> &done)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+    done.insert(done.end(), finished.begin(), finished.end());
+    finished.clear();
+}
+
+int coVRAsyncLoader::getNumPending()
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+    return (int)(queued.size() + finished.size() + reading.size());
+}
+
+int coVRAsyncLoader::getNumThreads() const
+{
+    return (int)threads.size();
+}
+
+void coVRAsyncLoader::work()
+{
+    osg::ref_ptr<osgDB::ReaderWriter::Options> readerOptions = new osgDB::ReaderWriter::Options();
+    readerOptions->setOptionString(options);
+
+    for (;;)
+    {
+        Request request;
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+            while (!quit && queued.empty())
+                condition.wait(&mutex);
+            if (quit)
+                return;
+            request = queued.front();
+            queued.pop_front();
+            reading.insert(request.id);
+        }
+
+        request.node = osgDB::readNodeFile(request.filename, readerOptions.get());
+
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+        reading.erase(request.id);
+        if (cancelled.erase(request.id) == 0)
+            finished.push_back(request);
+    }
+}
@@ -0,0 +1,93 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef COVR_ASYNC_LOADER_H
+#define COVR_ASYNC_LOADER_H
+
+/*! \file
+ \brief  read files with osgDB in a pool of threads
+
+ \author (C)
+         Computer Centre University of Stuttgart,
+         Allmandring 30,
+         D-70550 Stuttgart,
+         Germany
+
+ \date
+ */
+
+#include <util/coExport.h>
+#include <osg/Node>
+#include <osg/ref_ptr>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/Condition>
+
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace opencover
+{
+
+// Pool of threads reading files with osgDB::readNodeFile.
+// The loader does not touch the scene graph: the thread owning the scene
+// graph collects the finished requests with takeFinished() and attaches
+// the nodes at a frame boundary.
+class COVEREXPORT coVRAsyncLoader
+{
+public:
+    struct Request
+    {
+        Request()
+            : id(-1)
+        {
+        }
+        int id;
+        std::string filename;
+        osg::ref_ptr<osg::Node> node; // NULL if the file could not be read
+    };
+
+    // options are passed to osgDB as option string
+    coVRAsyncLoader(int numThreads, const std::string &options = "");
+    // waits for the files being read, requests not started are dropped
+    ~coVRAsyncLoader();
+
+    // queue a file, requests are started in the order they were added
+    void add(int id, const std::string &filename);
+
+    // drop the requests with these ids: queued and finished requests are
+    // removed, requests being read are dropped when reading has finished
+    void cancel(const std::vector<int> &ids);
+
+    // append the requests finished since the last call to finished
+    void takeFinished(std::vector<Request> &finished);
+
+    // number of requests added but not yet taken
+    int getNumPending();
+
+    int getNumThreads() const;
+
+private:
+    class LoaderThread;
+    friend class LoaderThread;
+
+    void work();
+
+    std::string options;
+    std::vector<LoaderThread *> threads;
+
+    OpenThreads::Mutex mutex;
+    OpenThreads::Condition condition;
+    std::deque<Request> queued;
+    std::vector<Request> finished;
+    std::set<int> reading; // ids of the requests being read
+    std::set<int> cancelled; // ids of requests being read that are dropped
+    bool quit;
+};
+}
+#endif
@@ -10,8 +10,11 @@
 #include "coHud.h"
 #include <assert.h>
 #include <string.h>
+#include <sstream>
+#include <algorithm>
 
 #include <osg/Texture2D>
+#include <osg/Timer>
 #include <osgDB/ReadFile>
 #include <osgText/Font>
 #include <util/unixcompat.h>
@@ -25,6 +28,7 @@
 #include "coVRCommunication.h"
 #include "coTabletUI.h"
 #include "coVRIOReader.h"
+#include "coVRAsyncLoader.h"
 #include "coTUIFileBrowser/NetHelp.h"
 #include "VRRegisterSceneGraph.h"
 
@@ -245,7 +249,8 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
     }
     OpenCOVER::instance()->hud->setText2("loading");
     OpenCOVER::instance()->hud->setText3(fileName);
-    OpenCOVER::instance()->hud->redraw();
+    if (showLoadProgress)
+        OpenCOVER::instance()->hud->redraw();
     /// read the 1st line of file and try to guess the type
     char fileTypeBuf[10] = "";
     const char *fileTypeString = findFileExt(adjustedFileName);
@@ -310,7 +315,8 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
         strcpy(lastCovise_key, covise_key);
         coVRCommunication::instance()->setCurrentFile(adjustedFileName);
         OpenCOVER::instance()->hud->setText2("done loading");
-        OpenCOVER::instance()->hud->redraw();
+        if (showLoadProgress)
+            OpenCOVER::instance()->hud->redraw();
     }
     else if (reader)
     {
@@ -348,7 +354,8 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
         strcpy(lastCovise_key, covise_key);
         coVRCommunication::instance()->setCurrentFile(adjustedFileName);
         OpenCOVER::instance()->hud->setText2("done loading");
-        OpenCOVER::instance()->hud->redraw();
+        if (showLoadProgress)
+            OpenCOVER::instance()->hud->redraw();
     }
     else
     {
@@ -367,16 +374,8 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
         if (node)
         {
             //OpenCOVER::instance()->databasePager->registerPagedLODs(node);
-            if (node->getName() == "")
-            {
-                node->setName(fileName);
-            }
-            parent->addChild(node);
+            addNode(node, parent, fileName);
             coVRCommunication::instance()->setCurrentFile(adjustedFileName);
-            VRRegisterSceneGraph::instance()->registerNode(node, parent->getName());
-            node->setNodeMask(node->getNodeMask() & (~Isect::Intersection));
-            if (cover->debugLevel(3))
-                fprintf(stderr, "coVRFileManager::loadFile setting nodeMask of %s to %x\n", node->getName().c_str(), node->getNodeMask());
         }
         else
         {
@@ -395,7 +394,8 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
         {
             OpenCOVER::instance()->hud->setText2("failed to load");
         }
-        OpenCOVER::instance()->hud->redraw();
+        if (showLoadProgress)
+            OpenCOVER::instance()->hud->redraw();
         lastNode = node;
         this->fileFBMap.erase(key);
         return node;
@@ -409,6 +409,203 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
     return NULL;
 }
 
+void coVRFileManager::addNode(osg::Node *node, osg::Group *parent, const char *name)
+{
+    if (node->getName() == "")
+    {
+        node->setName(name);
+    }
+    parent->addChild(node);
+    VRRegisterSceneGraph::instance()->registerNode(node, parent->getName());
+    node->setNodeMask(node->getNodeMask() & (~Isect::Intersection));
+    if (cover->debugLevel(3))
+        fprintf(stderr, "coVRFileManager::loadFile setting nodeMask of %s to %x\n", node->getName().c_str(), node->getNodeMask());
+}
+
+void coVRFileManager::loadFileAsync(const char *fileName, osg::Group *parent, LoadCallback *callback)
+{
+    START("coVRFileManager::loadFileAsync");
+
+    if (!parent)
+        parent = cover->getObjectsRoot();
+    else
+        parent->setNodeMask(parent->getNodeMask() & (~Isect::Intersection));
+
+    int id = nextAsyncLoad++;
+    AsyncLoad &load = asyncLoads[id];
+    load.filename = fileName;
+    load.parent = parent;
+    load.callback = callback;
+    ++asyncTotal;
+    if (callback)
+        ++callbackProgress[callback].second;
+
+    // plugin loaders modify the scene graph and are not thread safe,
+    // URLs need the adjustments done in loadFile
+    const char *fileTypeString = findFileExt(fileName);
+    if (strstr(fileName, "://") || findFileHandler(fileTypeString) || findIOHandler(fileTypeString))
+    {
+        handlerLoads.push_back(id);
+        return;
+    }
+
+    if (!asyncLoader)
+    {
+        int numThreads = coCoviseConfig::getInt("COVER.FileManager.LoaderThreads", 4);
+        //obj-Objects must not be rotated
+        asyncLoader = new coVRAsyncLoader(numThreads, "noRotation");
+    }
+    asyncLoader->add(id, fileName);
+}
+
+void coVRFileManager::cancelAsyncLoads(LoadCallback *callback)
+{
+    if (!callback)
+        return;
+
+    std::vector<int> ids;
+    for (std::map<int, AsyncLoad>::iterator it = asyncLoads.begin(); it != asyncLoads.end();)
+    {
+        if (it->second.callback == callback)
+        {
+            ids.push_back(it->first);
+            asyncLoads.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    if (ids.empty())
+        return;
+
+    for (std::deque<int>::iterator it = handlerLoads.begin(); it != handlerLoads.end();)
+    {
+        if (std::find(ids.begin(), ids.end(), *it) != ids.end())
+            it = handlerLoads.erase(it);
+        else
+            ++it;
+    }
+    if (asyncLoader)
+        asyncLoader->cancel(ids);
+
+    asyncTotal -= (int)ids.size();
+    callbackProgress.erase(callback);
+    if (asyncLoads.empty())
+    {
+        OpenCOVER::instance()->hud->setText2("done loading");
+        asyncFinished = asyncTotal = 0;
+    }
+}
+
+int coVRFileManager::getNumAsyncLoads() const
+{
+    return (int)asyncLoads.size();
+}
+
+bool coVRFileManager::isReadingParts() const
+{
+    for (ReadOperations::const_iterator op = readOperations.begin(); op != readOperations.end(); ++op)
+    {
+        if (!op->second.empty())
+            return true;
+    }
+    return false;
+}
+
+void coVRFileManager::finishAsyncLoad(int id, osg::Node *node, bool attach)
+{
+    std::map<int, AsyncLoad>::iterator it = asyncLoads.find(id);
+    if (it == asyncLoads.end())
+        return;
+    AsyncLoad &load = it->second;
+
+    if (node && attach)
+    {
+        addNode(node, load.parent.get(), load.filename.c_str());
+        // disable culling for one frame to load data to all GPUs
+        VRViewer::instance()->culling(false, osg::CullSettings::ENABLE_ALL_CULLING, true);
+    }
+
+    ++asyncFinished;
+    if (load.callback)
+    {
+        ++callbackProgress[load.callback].first;
+        load.callback->loaded(load.filename, load.parent.get(), node);
+    }
+    asyncLoads.erase(it);
+}
+
+void coVRFileManager::updateAsyncLoads()
+{
+    if (asyncLoads.empty() || inAsyncUpdate)
+        return;
+    inAsyncUpdate = true;
+
+    if (asyncLoader)
+    {
+        std::vector<coVRAsyncLoader::Request> finished;
+        asyncLoader->takeFinished(finished);
+        for (size_t i = 0; i < finished.size(); ++i)
+        {
+            if (!finished[i].node.valid())
+                cerr << "WARNING: Could not load file " << finished[i].filename << endl;
+            finishAsyncLoad(finished[i].id, finished[i].node.get(), true);
+        }
+    }
+
+    // load files for plugins until the time of this frame is used up
+    if (!handlerLoads.empty())
+    {
+        showLoadProgress = false;
+        osg::Timer_t start = osg::Timer::instance()->tick();
+        do
+        {
+            int id = handlerLoads.front();
+            handlerLoads.pop_front();
+            std::map<int, AsyncLoad>::iterator load = asyncLoads.find(id);
+            if (load == asyncLoads.end())
+                continue;
+            std::string filename = load->second.filename;
+            osg::ref_ptr<osg::Group> parent = load->second.parent;
+            // loadFile has already attached the node to parent
+            osg::Node *node = loadFile(filename.c_str(), NULL, parent.get());
+            finishAsyncLoad(id, node, false);
+        } while (!handlerLoads.empty()
+                 && osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick()) < asyncLoadTime);
+        showLoadProgress = true;
+    }
+
+    // a callback may cancel its own or other files from progress()
+    CallbackProgress reported = callbackProgress;
+    for (CallbackProgress::iterator it = reported.begin(); it != reported.end(); ++it)
+    {
+        CallbackProgress::iterator current = callbackProgress.find(it->first);
+        if (current == callbackProgress.end())
+            continue;
+        current->first->progress(current->second.first, current->second.second);
+        current = callbackProgress.find(it->first);
+        if (current != callbackProgress.end() && current->second.first == current->second.second)
+            callbackProgress.erase(current);
+    }
+
+    std::stringstream progress;
+    progress << asyncFinished << " of " << asyncTotal << " files";
+    OpenCOVER::instance()->hud->setText3(progress.str());
+    if (asyncLoads.empty())
+    {
+        if (cover->debugLevel(2))
+            fprintf(stderr, "coVRFileManager: loaded %d files asynchronously\n", asyncTotal);
+        OpenCOVER::instance()->hud->setText2("done loading");
+        asyncFinished = asyncTotal = 0;
+    }
+    else
+    {
+        OpenCOVER::instance()->hud->setText2("loading");
+    }
+    inAsyncUpdate = false;
+}
+
 osg::Node *coVRFileManager::replaceFile(const char *fileName, coTUIFileBrowserButton *fb, osg::Group *parent, const char *covise_key)
 {
     START("coVRFileManager::replaceFile");
@@ -732,6 +929,12 @@ coVRFileManager::coVRFileManager()
 
     lastFileName = NULL;
     lastCovise_key = NULL;
+    nextAsyncLoad = 0;
+    asyncFinished = asyncTotal = 0;
+    asyncLoader = NULL;
+    asyncLoadTime = coCoviseConfig::getFloat("COVER.FileManager.AsyncLoadTime", 0.03f);
+    showLoadProgress = true;
+    inAsyncUpdate = false;
     if (cover != NULL)
         cover->getUpdateManager()->add(this);
 }
@@ -741,6 +944,7 @@ coVRFileManager::~coVRFileManager()
     START("coVRFileManager::~coVRFileManager");
     if (cover->debugLevel(2))
         fprintf(stderr, "delete coVRFileManager\n");
+    delete asyncLoader;
     cover->getUpdateManager()->remove(this);
 }
 
@@ -1087,5 +1291,7 @@ bool coVRFileManager::update()
                 std::cerr << "coVRFileManager::update info: loading " << readOperation.filename << " (" << readOperation.reader->getIOProgress() << ")" << std::endl;
         }
     }
+
+    updateAsyncLoads();
     return true;
 }
@@ -22,6 +22,7 @@
 
 #include <util/coExport.h>
 #include <list>
+#include <deque>
 #include <limits.h>
 #include <util/coStringMultiHash.h>
 #include <map>
@@ -47,6 +48,7 @@ namespace opencover
 
 class coTUIFileBrowserButton;
 class coVRIOReader;
+class coVRAsyncLoader;
 
 typedef struct
 {
@@ -60,6 +62,29 @@ typedef struct
 class COVEREXPORT coVRFileManager : public vrui::coUpdateable
 {
 public:
+    // notification about files queued with loadFileAsync
+    class LoadCallback
+    {
+    public:
+        virtual ~LoadCallback()
+        {
+        }
+        // file was attached to parent at a frame boundary,
+        // node is NULL if loading failed or a plugin attached the file itself
+        virtual void loaded(const std::string &file, osg::Group *parent, osg::Node *node)
+        {
+            (void)file;
+            (void)parent;
+            (void)node;
+        }
+        // called once per frame while files of this callback are loaded
+        virtual void progress(int finished, int total)
+        {
+            (void)finished;
+            (void)total;
+        }
+    };
+
     static coVRFileManager *instance();
 
     const char *findFileExt(const char *filename);
@@ -70,6 +95,23 @@ public:
     // load a OSG or VRML97 or other (via plugin) file
     osg::Node *loadFile(const char *file, coTUIFileBrowserButton *fb = NULL, osg::Group *parent = NULL, const char *covise_key = "");
 
+    // queue a file for loading without blocking the render thread:
+    // files read by OSG are read by a pool of loader threads, files handled by
+    // plugins are loaded in update() within a time budget per frame.
+    // The callback has to stay valid until all its files are loaded
+    // or cancelAsyncLoads has been called for it.
+    void loadFileAsync(const char *file, osg::Group *parent = NULL, LoadCallback *callback = NULL);
+
+    // drop the files queued with callback that are not yet attached,
+    // callback is not called any more
+    void cancelAsyncLoads(LoadCallback *callback);
+
+    // number of files queued with loadFileAsync and not yet attached
+    int getNumAsyncLoads() const;
+
+    // files of readers that load in parts are still being read in update()
+    bool isReadingParts() const;
+
     // replace the last loaded Performer or VRML97 file
     osg::Node *replaceFile(const char *file, coTUIFileBrowserButton *fb = NULL, osg::Group *parent = NULL, const char *covise_key = "");
 
@@ -131,6 +173,13 @@ private:
     // Get the configured font style.
     int coLoadFontDefaultStyle();
 
+    // attach a node read by OSG to parent
+    void addNode(osg::Node *node, osg::Group *parent, const char *name);
+
+    // report a file queued with loadFileAsync, attach node to its parent unless already done
+    void finishAsyncLoad(int id, osg::Node *node, bool attach);
+    void updateAsyncLoads();
+
     char *lastFileName;
     char *lastCovise_key;
     osg::Node *lastNode;
@@ -161,6 +210,23 @@ private:
     typedef std::map<std::string, std::list<IOReadOperation> > ReadOperations;
     ReadOperations readOperations;
 
+    struct AsyncLoad
+    {
+        std::string filename;
+        osg::ref_ptr<osg::Group> parent;
+        LoadCallback *callback;
+    };
+    std::map<int, AsyncLoad> asyncLoads; // queued files by id
+    std::deque<int> handlerLoads; // files loaded by plugins on the render thread
+    int nextAsyncLoad;
+    int asyncFinished, asyncTotal; // files since the queue was last empty
+    typedef std::map<LoadCallback *, std::pair<int, int> > CallbackProgress;
+    CallbackProgress callbackProgress; // finished and total files per callback
+    coVRAsyncLoader *asyncLoader; // loader threads, created on first use
+    double asyncLoadTime; // seconds per frame for files loaded by plugins
+    bool showLoadProgress; // redraw the HUD while loading a file
+    bool inAsyncUpdate;
+
     coVRFileManager();
     ~coVRFileManager();
 };
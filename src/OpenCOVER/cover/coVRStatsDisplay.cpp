@@ -295,6 +295,27 @@ struct AveragedValueTextDrawCallback : public virtual osg::Drawable::DrawCallbac
     mutable osg::Timer_t _tickLastUpdated;
 };
 
+// draws a label only while a plugin reports the attribute it belongs to
+struct AttributeLabelDrawCallback : public virtual osg::Drawable::DrawCallback
+{
+    AttributeLabelDrawCallback(osg::Stats *stats, const std::string &name)
+        : _stats(stats)
+        , _attributeName(name)
+    {
+    }
+
+    /** do customized draw code.*/
+    virtual void drawImplementation(osg::RenderInfo &renderInfo, const osg::Drawable *drawable) const
+    {
+        double value;
+        if (_stats->getAveragedAttribute(_attributeName, value))
+            drawable->drawImplementation(renderInfo);
+    }
+
+    osg::ref_ptr<osg::Stats> _stats;
+    std::string _attributeName;
+};
+
 struct CameraSceneStatsTextDrawCallback : public virtual osg::Drawable::DrawCallback
 {
     CameraSceneStatsTextDrawCallback(osg::Camera *camera, int cameraNumber)
@@ -1030,6 +1051,33 @@ void coVRStatsDisplay::setUpScene(osgViewer::ViewerBase *viewer)
 
         frameRateValue->setDrawCallback(new AveragedValueTextDrawCallback(viewer->getViewerStats(), "Frame rate", -1, true, 1.0));
 
+        // share of triangles in chunked geometry left after culling and level of detail,
+        // reported by the COVISE plugin, stays empty if nothing is chunked
+        pos.x() = leftPos + 20.0f * characterSize;
+
+        osg::ref_ptr<osgText::Text> chunkLabel = new osgText::Text;
+        geode->addDrawable(chunkLabel.get());
+
+        chunkLabel->setColor(colorFR);
+        chunkLabel->setFont(font);
+        chunkLabel->setCharacterSize(characterSize);
+        chunkLabel->setPosition(pos);
+        chunkLabel->setText("Chunk triangles drawn %: ", osgText::String::ENCODING_UTF8);
+        chunkLabel->setDrawCallback(new AttributeLabelDrawCallback(viewer->getViewerStats(), "Chunk triangles drawn fraction"));
+
+        pos.x() = chunkLabel->getBound().xMax();
+
+        osg::ref_ptr<osgText::Text> chunkValue = new osgText::Text;
+        geode->addDrawable(chunkValue.get());
+
+        chunkValue->setColor(colorFR);
+        chunkValue->setFont(font);
+        chunkValue->setCharacterSize(characterSize);
+        chunkValue->setPosition(pos);
+        chunkValue->setText("", osgText::String::ENCODING_UTF8);
+
+        chunkValue->setDrawCallback(new AveragedValueTextDrawCallback(viewer->getViewerStats(), "Chunk triangles drawn fraction", -1, false, 100.0));
+
         pos.y() -= characterSize * 1.5f;
     }
 
@@ -308,22 +308,22 @@ void coVrbRegistryAccess::update(TokenBuffer &tb, int reason)
         tb >> clID;
         tb >> name;
         tb >> val;
+        entryChanged(cl, clID, name, val);
 
-        // call all class specific observers
-        _entryList->reset();
+        break;
 
-        while (_entryList->current())
+    case COVISE_MESSAGE_VRB_REGISTRY_ENTRIES_CHANGED:
+
+        // several changes, terminated by an empty class name
+        for (;;)
         {
-            if (!strcmp(_entryList->current()->getClass(), cl))
-            {
-                _entryList->current()->setVar((const char *)name);
-                _entryList->current()->setVal((const char *)val);
-                _entryList->current()->setID(clID);
-                // call observers
-                _entryList->current()->setChanged();
-                _entryList->current()->changedByMe(false);
-            }
-            _entryList->next();
+            tb >> cl;
+            if (!cl[0])
+                break;
+            tb >> clID;
+            tb >> name;
+            tb >> val;
+            entryChanged(cl, clID, name, val);
         }
 
         break;
@@ -360,6 +360,26 @@ void coVrbRegistryAccess::update(TokenBuffer &tb, int reason)
     } // switch
 }
 
+void coVrbRegistryAccess::entryChanged(const char *cl, int clID, const char *name, const char *val)
+{
+    // call all class specific observers
+    _entryList->reset();
+
+    while (_entryList->current())
+    {
+        if (!strcmp(_entryList->current()->getClass(), cl))
+        {
+            _entryList->current()->setVar(name);
+            _entryList->current()->setVal(val);
+            _entryList->current()->setID(clID);
+            // call observers
+            _entryList->current()->setChanged();
+            _entryList->current()->changedByMe(false);
+        }
+        _entryList->next();
+    }
+}
+
 void coVrbRegEntry::setValue(const char *val)
 {
     if ((_cl.c_str() == NULL) || (_var.c_str() == NULL))
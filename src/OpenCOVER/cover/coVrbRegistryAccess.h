@@ -230,6 +230,8 @@ protected:
 private:
     void addEntry(coVrbRegEntry *e);
     void removeEntry(coVrbRegEntry *e);
+    // inform the observers of cl about a new value
+    void entryChanged(const char *cl, int clID, const char *name, const char *val);
 
     int _ID;
     std::string _name;
@@ -0,0 +1,127 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "gtest/gtest.h"
+
+#include <cover/coVRAsyncLoader.h>
+
+#include <OpenThreads/Thread>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+using namespace opencover;
+
+namespace
+{
+
+const char *scene = "Group {\n}\n";
+
+class AsyncLoaderTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        char tmpl[] = "/tmp/AsyncLoaderTestXXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+        dir = tmpl;
+    }
+
+    virtual void TearDown()
+    {
+        for (size_t i = 0; i < files.size(); ++i)
+            unlink(files[i].c_str());
+        rmdir(dir.c_str());
+    }
+
+    std::string writeFile(const std::string &name)
+    {
+        std::string path = dir + "/" + name;
+        FILE *fp = fopen(path.c_str(), "w");
+        if (fp)
+        {
+            fputs(scene, fp);
+            fclose(fp);
+        }
+        files.push_back(path);
+        return path;
+    }
+
+    // a file whose reader blocks until the test writes the contents
+    std::string makePipe(const std::string &name)
+    {
+        std::string path = dir + "/" + name;
+        mkfifo(path.c_str(), 0600);
+        files.push_back(path);
+        return path;
+    }
+
+    // opens the write end as soon as a loader thread has opened the pipe for reading
+    static int waitForReader(const std::string &path)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            int fd = open(path.c_str(), O_WRONLY | O_NONBLOCK);
+            if (fd >= 0 || errno != ENXIO)
+                return fd;
+            OpenThreads::Thread::microSleep(10000);
+        }
+        return -1;
+    }
+
+    static bool waitIdle(coVRAsyncLoader &loader, int pending)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (loader.getNumPending() == pending)
+                return true;
+            OpenThreads::Thread::microSleep(10000);
+        }
+        return false;
+    }
+
+    std::string dir;
+    std::vector<std::string> files;
+};
+
+TEST_F(AsyncLoaderTest, CancelledFilesAreNotReported)
+{
+    coVRAsyncLoader loader(1);
+    std::string reading = makePipe("reading.osg");
+    loader.add(0, reading);
+    loader.add(1, writeFile("kept.osg"));
+    loader.add(2, writeFile("queued.osg"));
+
+    // the only loader thread is now reading file 0, file 2 is still queued
+    int fd = waitForReader(reading);
+    ASSERT_GE(fd, 0);
+    std::vector<int> ids;
+    ids.push_back(0);
+    ids.push_back(2);
+    loader.cancel(ids);
+
+    ASSERT_EQ(write(fd, scene, strlen(scene)), (ssize_t)strlen(scene));
+    close(fd);
+
+    // only file 1 remains and is reported once it is read
+    ASSERT_TRUE(waitIdle(loader, 1));
+    std::vector<coVRAsyncLoader::Request> finished;
+    loader.takeFinished(finished);
+    ASSERT_EQ(finished.size(), 1u);
+    EXPECT_EQ(finished[0].id, 1);
+    EXPECT_TRUE(finished[0].node.valid());
+    EXPECT_EQ(loader.getNumPending(), 0);
+}
+}
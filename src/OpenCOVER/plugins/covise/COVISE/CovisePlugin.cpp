@@ -8,6 +8,7 @@
 #include <cover/coInteractor.h>
 #include "VRCoviseObjectManager.h"
 #include "VRCoviseConnection.h"
+#include "VRCoviseGeometryChunker.h"
 #include "coVRMenuList.h"
 #include "CovisePlugin.h"
 #include <net/message.h>
@@ -148,6 +149,7 @@ void CovisePlugin::preFrame()
 {
     VRCoviseConnection::covconn->update();
     updateScenegraph();
+    GeometryChunker::instance()->update();
 }
 
 void CovisePlugin::requestQuit(bool killSession)
@@ -0,0 +1,181 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "VRCoviseArrowGlyphs.h"
+
+#include <osg/BoundingBox>
+#include <osg/PrimitiveSet>
+#include <osg/Shader>
+#include <osg/StateSet>
+#include <osg/VertexAttribDivisor>
+
+#include <math.h>
+#include <vector>
+
+using namespace opencover;
+
+namespace
+{
+
+// gl_Vertex is a point of the arrow along z with length 1
+const char *arrowGlyphVertSource = {
+    "// arrow glyphs\n"
+    "attribute vec4 glyphColor;\n"
+    "attribute vec3 glyphPosition;\n"
+    "attribute vec3 glyphVector;\n"
+    "void main()\n"
+    "{\n"
+    "    float len = length(glyphVector);\n"
+    "    vec3 w = len > 0.0 ? glyphVector / len : vec3(0.0, 0.0, 1.0);\n"
+    "    vec3 u = normalize(cross(abs(w.x) < 0.9 ? vec3(1.0, 0.0, 0.0) : vec3(0.0, 1.0, 0.0), w));\n"
+    "    vec3 v = cross(w, u);\n"
+    "    vec4 p = vec4(glyphPosition + len * (gl_Vertex.x * u + gl_Vertex.y * v + gl_Vertex.z * w), 1.0);\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * p;\n"
+    "    gl_ClipVertex = gl_ModelViewMatrix * p;\n"
+    "    gl_FrontColor = glyphColor;\n"
+    "    gl_BackColor = glyphColor;\n"
+    "}\n"
+};
+
+// the instance attributes advance once per arrow,
+// the divisors are reset after drawing as other geometry uses the same attributes
+class DivisorCallback : public osg::Drawable::DrawCallback
+{
+public:
+    DivisorCallback(bool colorPerGlyph)
+    {
+        int numAttribs = colorPerGlyph ? 3 : 2;
+        const unsigned int attribs[] = { ArrowGlyphs::PositionAttrib, ArrowGlyphs::VectorAttrib, ArrowGlyphs::ColorAttrib };
+        for (int i = 0; i < numAttribs; ++i)
+        {
+            on.push_back(new osg::VertexAttribDivisor(attribs[i], 1));
+            off.push_back(new osg::VertexAttribDivisor(attribs[i], 0));
+        }
+    }
+
+    virtual void drawImplementation(osg::RenderInfo &renderInfo, const osg::Drawable *drawable) const
+    {
+        osg::State &state = *renderInfo.getState();
+        for (size_t i = 0; i < on.size(); ++i)
+            on[i]->apply(state);
+        drawable->drawImplementation(renderInfo);
+        for (size_t i = 0; i < off.size(); ++i)
+            off[i]->apply(state);
+    }
+
+private:
+    std::vector<osg::ref_ptr<osg::VertexAttribDivisor> > on;
+    std::vector<osg::ref_ptr<osg::VertexAttribDivisor> > off;
+};
+
+// the vertex array only holds the arrow, the bounds are those of the instances
+class BoundCallback : public osg::Drawable::ComputeBoundingBoxCallback
+{
+public:
+    BoundCallback(const osg::BoundingBox &bb)
+        : bb(bb)
+    {
+    }
+
+    virtual osg::BoundingBox computeBound(const osg::Drawable &) const
+    {
+        return bb;
+    }
+
+private:
+    osg::BoundingBox bb;
+};
+}
+
+osg::Vec3Array *ArrowGlyphs::createArrow(int numSectors, float arrowFactor, float angle)
+{
+    osg::Vec3Array *arrow = new osg::Vec3Array;
+    osg::Vec3 tip(0.f, 0.f, 1.f);
+    arrow->push_back(osg::Vec3(0.f, 0.f, 0.f));
+    arrow->push_back(tip);
+
+    // as coVectField::fillTheStingPoints: lines from the tip to a circle
+    // around the shaft, connected to a pyramid for more than 2 sectors
+    float a = (float)(angle * M_PI / 180.0);
+    float radius = arrowFactor * sinf(a);
+    float z = 1.f - arrowFactor * cosf(a);
+    for (int k = 0; k < numSectors; ++k)
+    {
+        float phi = (float)(2.0 * M_PI * k / numSectors);
+        osg::Vec3 p(radius * cosf(phi), radius * sinf(phi), z);
+        arrow->push_back(tip);
+        arrow->push_back(p);
+        if (numSectors > 2)
+        {
+            float next = (float)(2.0 * M_PI * (k + 1) / numSectors);
+            arrow->push_back(p);
+            arrow->push_back(osg::Vec3(radius * cosf(next), radius * sinf(next), z));
+        }
+    }
+    return arrow;
+}
+
+osg::Program *ArrowGlyphs::getProgram()
+{
+    static osg::ref_ptr<osg::Program> program;
+    if (!program.valid())
+    {
+        program = new osg::Program;
+        program->setName("ArrowGlyphs");
+        program->addShader(new osg::Shader(osg::Shader::VERTEX, arrowGlyphVertSource));
+        program->addBindAttribLocation("glyphColor", ColorAttrib);
+        program->addBindAttribLocation("glyphPosition", PositionAttrib);
+        program->addBindAttribLocation("glyphVector", VectorAttrib);
+    }
+    return program.get();
+}
+
+osg::Geometry *ArrowGlyphs::create(int numGlyphs,
+                                   const float *x, const float *y, const float *z,
+                                   const float *u, const float *v, const float *w,
+                                   osg::Array *colors,
+                                   int numSectors, float arrowFactor, float angle)
+{
+    osg::Geometry *geom = new osg::Geometry();
+    // instanced drawing requires vertex buffer objects
+    geom->setUseDisplayList(false);
+    geom->setUseVertexBufferObjects(true);
+
+    osg::Vec3Array *arrow = createArrow(numSectors, arrowFactor, angle);
+    geom->setVertexArray(arrow);
+    geom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINES, 0, arrow->size(), numGlyphs));
+
+    osg::Vec3Array *positions = new osg::Vec3Array(numGlyphs);
+    osg::Vec3Array *vectors = new osg::Vec3Array(numGlyphs);
+    osg::BoundingBox bb;
+    for (int i = 0; i < numGlyphs; ++i)
+    {
+        (*positions)[i].set(x[i], y[i], z[i]);
+        (*vectors)[i].set(u[i], v[i], w[i]);
+        bb.expandBy((*positions)[i]);
+        bb.expandBy((*positions)[i] + (*vectors)[i]);
+    }
+    geom->setVertexAttribArray(PositionAttrib, positions, osg::Array::BIND_PER_VERTEX);
+    geom->setVertexAttribArray(VectorAttrib, vectors, osg::Array::BIND_PER_VERTEX);
+    geom->setComputeBoundingBoxCallback(new BoundCallback(bb));
+
+    if (!colors)
+    {
+        osg::Vec4Array *white = new osg::Vec4Array;
+        white->push_back(osg::Vec4(1.f, 1.f, 1.f, 1.f));
+        colors = white;
+    }
+    bool colorPerGlyph = (numGlyphs > 1 && colors->getNumElements() == (unsigned int)numGlyphs);
+    if (colors->getDataType() != GL_FLOAT)
+        colors->setNormalize(true);
+    geom->setVertexAttribArray(ColorAttrib, colors, colorPerGlyph ? osg::Array::BIND_PER_VERTEX : osg::Array::BIND_OVERALL);
+
+    geom->setDrawCallback(new DivisorCallback(colorPerGlyph));
+    geom->getOrCreateStateSet()->setAttributeAndModes(getProgram(), osg::StateAttribute::ON);
+
+    return geom;
+}
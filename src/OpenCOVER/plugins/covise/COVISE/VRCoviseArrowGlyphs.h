@@ -0,0 +1,55 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/*! \file
+ \brief draw vector fields as instances of a single arrow
+
+ The VectorField module with output=glyphs creates one point per vector,
+ the scaled vectors arrive as normals and the VECTOR_GLYPHS attribute
+ holds the arrow head ("num_sectors arrow_factor angle"). Instead of
+ expanding every vector to lines, one arrow of length 1 along z is drawn
+ once per point and placed, rotated and scaled in a vertex shader.
+ */
+
+#ifndef ARROW_GLYPHS
+#define ARROW_GLYPHS
+
+#include <util/coExport.h>
+
+#include <osg/Array>
+#include <osg/Geometry>
+#include <osg/Program>
+
+namespace opencover
+{
+
+class COVISEPLUGINEXPORT ArrowGlyphs
+{
+public:
+    /// vertex attributes holding the arrow position, vector and color
+    enum Attribute
+    {
+        ColorAttrib = 5,
+        PositionAttrib = 6,
+        VectorAttrib = 7
+    };
+
+    /// geometry with an arrow per point, colors may be NULL, one color or one color per point
+    static osg::Geometry *create(int numGlyphs,
+                                 const float *x, const float *y, const float *z,
+                                 const float *u, const float *v, const float *w,
+                                 osg::Array *colors,
+                                 int numSectors, float arrowFactor, float angle);
+
+    /// line segments of an arrow from 0 to 1 along z, head as built by coVectField
+    static osg::Vec3Array *createArrow(int numSectors, float arrowFactor, float angle);
+
+    /// shader program shared by all arrow geometries
+    static osg::Program *getProgram();
+};
+}
+#endif
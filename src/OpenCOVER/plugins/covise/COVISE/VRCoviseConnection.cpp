@@ -441,6 +441,14 @@ VRCoviseConnection::receiveRenderMessage()
             ak->message(strcmp(key, "FINISHED"), 0, NULL);
         }
     }
+    else if (strcmp(key, "STREAM_STEP") == 0)
+    {
+        // set name, element name, timestep and number of timesteps
+        char setName[1024], element[1024];
+        int step = 0, numSteps = 0;
+        if (sscanf(tmp, "%1023s\n%1023s\n%d\n%d", setName, element, &step, &numSteps) == 4)
+            ObjectManager::instance()->addStreamedStep(setName, element, step, numSteps);
+    }
     else if (strncmp(key, "GRMSG", 5) == 0)
     {
         coVRPluginList::instance()->guiToRenderMsg(tmp);
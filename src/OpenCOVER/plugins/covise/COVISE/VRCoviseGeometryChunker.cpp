@@ -0,0 +1,499 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "VRCoviseGeometryChunker.h"
+
+#include <config/CoviseConfig.h>
+#include <cover/VRViewer.h>
+
+#include <osg/Geometry>
+#include <osg/Group>
+#include <osg/NodeCallback>
+#include <osg/TriangleIndexFunctor>
+#include <osg/BoundingBox>
+#include <osg/Stats>
+
+#include <OpenThreads/ScopedLock>
+
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <cfloat>
+
+using namespace opencover;
+using covise::coCoviseConfig;
+
+namespace
+{
+
+struct TriangleCollector
+{
+    std::vector<unsigned int> *indices;
+    void operator()(unsigned int a, unsigned int b, unsigned int c)
+    {
+        if (a == b || b == c || a == c)
+            return;
+        indices->push_back(a);
+        indices->push_back(b);
+        indices->push_back(c);
+    }
+};
+
+struct CenterLess
+{
+    const std::vector<osg::Vec3> *centers;
+    int axis;
+    bool operator()(unsigned int a, unsigned int b) const
+    {
+        return (*centers)[a][axis] < (*centers)[b][axis];
+    }
+};
+
+// counts the triangles of the chunks which survive view frustum culling
+class ChunkCullCallback : public osg::NodeCallback
+{
+public:
+    ChunkCullCallback(unsigned int numTriangles)
+        : numTriangles(numTriangles)
+    {
+    }
+    virtual void operator()(osg::Node *node, osg::NodeVisitor *nv)
+    {
+        GeometryChunker::instance()->addDrawnTriangles(numTriangles);
+        traverse(node, nv);
+    }
+
+private:
+    unsigned int numTriangles;
+};
+
+template <class A>
+A *gather(const A *src, const std::vector<unsigned int> &vertices)
+{
+    A *dst = new A;
+    dst->reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+        dst->push_back((*src)[vertices[i]]);
+    return dst;
+}
+
+// per vertex arrays are reduced to the listed vertices, other arrays are shared
+bool gatherArray(const osg::Array *src, unsigned int numVertices, osg::Geometry::AttributeBinding binding,
+                 const std::vector<unsigned int> &vertices, osg::ref_ptr<osg::Array> &dst)
+{
+    dst = NULL;
+    if (!src || binding == osg::Geometry::BIND_OFF)
+        return true;
+    if (binding == osg::Geometry::BIND_OVERALL)
+    {
+        dst = const_cast<osg::Array *>(src);
+        return true;
+    }
+    if (binding != osg::Geometry::BIND_PER_VERTEX || src->getNumElements() != numVertices)
+        return false;
+    if (const osg::Vec2Array *a = dynamic_cast<const osg::Vec2Array *>(src))
+        dst = gather(a, vertices);
+    else if (const osg::Vec3Array *a = dynamic_cast<const osg::Vec3Array *>(src))
+        dst = gather(a, vertices);
+    else if (const osg::Vec4Array *a = dynamic_cast<const osg::Vec4Array *>(src))
+        dst = gather(a, vertices);
+    else if (const osg::FloatArray *a = dynamic_cast<const osg::FloatArray *>(src))
+        dst = gather(a, vertices);
+    return dst.valid();
+}
+
+// copy vertices, normals, colors, texture coordinates and vertex attributes,
+// returns false if an array can't be split
+bool copyAttributes(const osg::Geometry *src, osg::Geometry *dst, const std::vector<unsigned int> &vertices)
+{
+    const unsigned int numVertices = src->getVertexArray()->getNumElements();
+    osg::ref_ptr<osg::Array> array;
+
+    if (!gatherArray(src->getVertexArray(), numVertices, osg::Geometry::BIND_PER_VERTEX, vertices, array))
+        return false;
+    dst->setVertexArray(array.get());
+
+    if (!gatherArray(src->getNormalArray(), numVertices, src->getNormalBinding(), vertices, array))
+        return false;
+    if (array.valid())
+    {
+        dst->setNormalArray(array.get());
+        dst->setNormalBinding(src->getNormalBinding());
+    }
+
+    if (!gatherArray(src->getColorArray(), numVertices, src->getColorBinding(), vertices, array))
+        return false;
+    if (array.valid())
+    {
+        dst->setColorArray(array.get());
+        dst->setColorBinding(src->getColorBinding());
+    }
+
+    for (unsigned int unit = 0; unit < src->getNumTexCoordArrays(); ++unit)
+    {
+        if (!gatherArray(src->getTexCoordArray(unit), numVertices, osg::Geometry::BIND_PER_VERTEX, vertices, array))
+            return false;
+        if (array.valid())
+            dst->setTexCoordArray(unit, array.get());
+    }
+
+    for (unsigned int index = 0; index < src->getNumVertexAttribArrays(); ++index)
+    {
+        // older osg leaves the binding of vertex attributes off even if they are used per vertex
+        const osg::Array *attrib = src->getVertexAttribArray(index);
+        osg::Geometry::AttributeBinding binding = src->getVertexAttribBinding(index);
+        if (attrib && attrib->getNumElements() == numVertices)
+            binding = osg::Geometry::BIND_PER_VERTEX;
+        if (!gatherArray(attrib, numVertices, binding, vertices, array))
+            return false;
+        if (array.valid())
+        {
+            dst->setVertexAttribArray(index, array.get());
+            dst->setVertexAttribBinding(index, src->getVertexAttribBinding(index));
+        }
+    }
+
+    dst->setUseDisplayList(src->getUseDisplayList());
+    dst->setUseVertexBufferObjects(src->getUseVertexBufferObjects());
+    dst->setStateSet(const_cast<osg::StateSet *>(src->getStateSet()));
+    return true;
+}
+
+// vertex clustering on a grid with cells sized for the requested number of triangles
+osg::Geometry *simplifyChunk(const osg::Geometry *detail, float ratio)
+{
+    const osg::Vec3Array *vert = static_cast<const osg::Vec3Array *>(detail->getVertexArray());
+    const osg::DrawElementsUInt *prim = static_cast<const osg::DrawElementsUInt *>(detail->getPrimitiveSet(0));
+    const size_t numTriangles = prim->size() / 3;
+
+    double area = 0.0;
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        const osg::Vec3 &a = (*vert)[(*prim)[3 * t]];
+        const osg::Vec3 &b = (*vert)[(*prim)[3 * t + 1]];
+        const osg::Vec3 &c = (*vert)[(*prim)[3 * t + 2]];
+        area += 0.5 * ((b - a) ^ (c - a)).length();
+    }
+    osg::BoundingBox bbox;
+    for (size_t v = 0; v < vert->size(); ++v)
+        bbox.expandBy((*vert)[v]);
+
+    const size_t target = std::max((size_t)(numTriangles * ratio), (size_t)8);
+    if (area <= 0.0 || !bbox.valid())
+        return NULL;
+    // a surface covers about two triangles per occupied cell
+    float cell = (float)sqrt(area / (0.5 * target));
+    const float extent = std::max(bbox.xMax() - bbox.xMin(), std::max(bbox.yMax() - bbox.yMin(), bbox.zMax() - bbox.zMin()));
+    cell = std::max(cell, extent / 1000000.0f);
+    if (cell <= 0.0f)
+        return NULL;
+
+    const osg::Vec3Array *normals = NULL;
+    if (detail->getNormalBinding() == osg::Geometry::BIND_PER_VERTEX)
+        normals = dynamic_cast<const osg::Vec3Array *>(detail->getNormalArray());
+
+    std::map<unsigned long long, unsigned int> clusters;
+    std::vector<unsigned int> cluster(vert->size());
+    std::vector<unsigned int> representative;
+    std::vector<osg::Vec3> position, normal;
+    std::vector<unsigned int> count;
+    for (size_t v = 0; v < vert->size(); ++v)
+    {
+        const osg::Vec3 p = ((*vert)[v] - bbox._min) / cell;
+        unsigned long long key = (unsigned long long)p[0]
+                                 | ((unsigned long long)p[1] << 21)
+                                 | ((unsigned long long)p[2] << 42);
+        std::map<unsigned long long, unsigned int>::iterator it = clusters.find(key);
+        if (it == clusters.end())
+        {
+            it = clusters.insert(std::make_pair(key, (unsigned int)representative.size())).first;
+            representative.push_back(v);
+            position.push_back(osg::Vec3(0., 0., 0.));
+            normal.push_back(osg::Vec3(0., 0., 0.));
+            count.push_back(0);
+        }
+        const unsigned int c = it->second;
+        cluster[v] = c;
+        position[c] += (*vert)[v];
+        if (normals)
+            normal[c] += (*normals)[v];
+        ++count[c];
+    }
+
+    osg::ref_ptr<osg::DrawElementsUInt> coarsePrim = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES);
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        const unsigned int a = cluster[(*prim)[3 * t]];
+        const unsigned int b = cluster[(*prim)[3 * t + 1]];
+        const unsigned int c = cluster[(*prim)[3 * t + 2]];
+        if (a == b || b == c || a == c)
+            continue;
+        coarsePrim->push_back(a);
+        coarsePrim->push_back(b);
+        coarsePrim->push_back(c);
+    }
+    if (coarsePrim->empty())
+        return NULL;
+
+    osg::Geometry *coarse = new osg::Geometry;
+    copyAttributes(detail, coarse, representative);
+    osg::Vec3Array *coarseVert = static_cast<osg::Vec3Array *>(coarse->getVertexArray());
+    for (size_t c = 0; c < representative.size(); ++c)
+        (*coarseVert)[c] = position[c] / count[c];
+    if (normals)
+    {
+        osg::Vec3Array *coarseNormals = static_cast<osg::Vec3Array *>(coarse->getNormalArray());
+        for (size_t c = 0; c < representative.size(); ++c)
+        {
+            osg::Vec3 n = normal[c];
+            if (n.normalize() > 0.0f)
+                (*coarseNormals)[c] = n;
+        }
+    }
+    coarse->addPrimitiveSet(coarsePrim.get());
+    return coarse;
+}
+}
+
+GeometryChunker *GeometryChunker::instance()
+{
+    static GeometryChunker *singleton = NULL;
+    if (!singleton)
+        singleton = new GeometryChunker();
+    return singleton;
+}
+
+GeometryChunker::GeometryChunker()
+    : running(true)
+    , drawnTriangles(0.0)
+{
+    enabled = coCoviseConfig::isOn("COVER.Plugin.COVISE.Chunking", false);
+    threshold = coCoviseConfig::getInt("COVER.Plugin.COVISE.ChunkThreshold", 1000000);
+    chunkSize = coCoviseConfig::getInt("COVER.Plugin.COVISE.ChunkSize", 65536);
+    lodPixels = coCoviseConfig::getFloat("COVER.Plugin.COVISE.ChunkLodPixels", 250.0f);
+    lodRatio = coCoviseConfig::getFloat("COVER.Plugin.COVISE.ChunkLodRatio", 0.1f);
+    if (chunkSize < 1024)
+        chunkSize = 1024;
+    if (threshold < chunkSize)
+        threshold = chunkSize;
+}
+
+GeometryChunker::~GeometryChunker()
+{
+    if (isRunning())
+    {
+        mutex.lock();
+        running = false;
+        pending.clear();
+        condition.signal();
+        mutex.unlock();
+        join();
+    }
+}
+
+osg::Node *GeometryChunker::process(osg::Node *node)
+{
+    if (!enabled)
+        return node;
+    osg::Geode *geode = dynamic_cast<osg::Geode *>(node);
+    if (!geode || geode->getNumDrawables() != 1)
+        return node;
+    osg::Geometry *geom = geode->getDrawable(0)->asGeometry();
+    if (!geom || !dynamic_cast<const osg::Vec3Array *>(geom->getVertexArray()))
+        return node;
+
+    // polygons, strips and fans all end up as triangles
+    osg::TriangleIndexFunctor<TriangleCollector> collector;
+    std::vector<unsigned int> indices;
+    collector.indices = &indices;
+    geom->accept(collector);
+    const size_t numTriangles = indices.size() / 3;
+    if (numTriangles < threshold)
+        return node;
+
+    const osg::Vec3Array *vert = static_cast<const osg::Vec3Array *>(geom->getVertexArray());
+    std::vector<osg::Vec3> centers(numTriangles);
+    std::vector<unsigned int> triangles(numTriangles);
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        centers[t] = ((*vert)[indices[3 * t]] + (*vert)[indices[3 * t + 1]] + (*vert)[indices[3 * t + 2]]) / 3.0f;
+        triangles[t] = t;
+    }
+
+    osg::ref_ptr<osg::Group> group = new osg::Group;
+    group->setName(geode->getName());
+    group->setStateSet(geode->getStateSet());
+    group->setNodeMask(geode->getNodeMask());
+    vertexMap.assign(vert->size(), -1);
+    split(geom, indices, centers, triangles, 0, numTriangles, group.get());
+    vertexMap.clear();
+    if (group->getNumChildren() == 0)
+        return node;
+
+    chunked.push_back(std::make_pair(osg::observer_ptr<osg::Node>(group.get()), (unsigned int)numTriangles));
+    if (!isRunning())
+        start();
+    return group.release();
+}
+
+void GeometryChunker::split(const osg::Geometry *geom, const std::vector<unsigned int> &indices,
+                            const std::vector<osg::Vec3> &centers, std::vector<unsigned int> &triangles,
+                            size_t begin, size_t end, osg::Group *parent)
+{
+    if (end - begin > chunkSize)
+    {
+        osg::BoundingBox bbox;
+        for (size_t t = begin; t < end; ++t)
+            bbox.expandBy(centers[triangles[t]]);
+        CenterLess less;
+        less.centers = &centers;
+        less.axis = 0;
+        for (int i = 1; i < 3; ++i)
+        {
+            if (bbox._max[i] - bbox._min[i] > bbox._max[less.axis] - bbox._min[less.axis])
+                less.axis = i;
+        }
+        const size_t middle = begin + (end - begin) / 2;
+        std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end, less);
+        split(geom, indices, centers, triangles, begin, middle, parent);
+        split(geom, indices, centers, triangles, middle, end, parent);
+        return;
+    }
+
+    osg::Geometry *chunk = makeChunk(geom, indices, triangles, begin, end);
+    if (!chunk)
+        return;
+    Job job;
+    job.geode = new osg::Geode;
+    job.geode->addDrawable(chunk);
+    job.geode->setCullCallback(new ChunkCullCallback(end - begin));
+    job.lod = new osg::LOD;
+    job.lod->setRangeMode(osg::LOD::PIXEL_SIZE_ON_SCREEN);
+    job.lod->addChild(job.geode.get(), 0.0f, FLT_MAX);
+    parent->addChild(job.lod.get());
+
+    mutex.lock();
+    pending.push_back(job);
+    condition.signal();
+    mutex.unlock();
+}
+
+osg::Geometry *GeometryChunker::makeChunk(const osg::Geometry *geom, const std::vector<unsigned int> &indices,
+                                          const std::vector<unsigned int> &triangles, size_t begin, size_t end)
+{
+    std::vector<unsigned int> vertices;
+    osg::DrawElementsUInt *prim = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES);
+    prim->reserve(3 * (end - begin));
+    for (size_t t = begin; t < end; ++t)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const unsigned int v = indices[3 * triangles[t] + i];
+            if (vertexMap[v] < 0)
+            {
+                vertexMap[v] = vertices.size();
+                vertices.push_back(v);
+            }
+            prim->push_back(vertexMap[v]);
+        }
+    }
+    for (size_t i = 0; i < vertices.size(); ++i)
+        vertexMap[vertices[i]] = -1;
+
+    osg::ref_ptr<osg::Geometry> chunk = new osg::Geometry;
+    chunk->addPrimitiveSet(prim);
+    if (!copyAttributes(geom, chunk.get(), vertices))
+        return NULL;
+    return chunk.release();
+}
+
+void GeometryChunker::run()
+{
+    for (;;)
+    {
+        mutex.lock();
+        while (running && pending.empty())
+            condition.wait(&mutex);
+        if (!running)
+        {
+            mutex.unlock();
+            return;
+        }
+        Job job = pending.front();
+        pending.pop_front();
+        mutex.unlock();
+
+        // the chunk is not modified after creation, reading it while it is drawn is fine
+        const osg::Geometry *detail = job.geode->getDrawable(0)->asGeometry();
+        osg::Geometry *coarse = simplifyChunk(detail, lodRatio);
+        if (!coarse)
+            continue;
+        job.geode = new osg::Geode;
+        job.geode->addDrawable(coarse);
+        job.geode->setCullCallback(new ChunkCullCallback(coarse->getPrimitiveSet(0)->getNumIndices() / 3));
+
+        mutex.lock();
+        finished.push_back(job);
+        mutex.unlock();
+    }
+}
+
+void GeometryChunker::addDrawnTriangles(unsigned int numTriangles)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(statsMutex);
+    drawnTriangles += numTriangles;
+}
+
+void GeometryChunker::update()
+{
+    if (!enabled)
+        return;
+
+    std::vector<Job> done;
+    mutex.lock();
+    done.swap(finished);
+    mutex.unlock();
+    for (size_t i = 0; i < done.size(); ++i)
+    {
+        osg::LOD *lod = done[i].lod.get();
+        // shaders have been applied to the detail level in the meantime
+        osg::Node *detail = lod->getChild(0);
+        done[i].geode->setStateSet(detail->getStateSet());
+        lod->setRange(0, lodPixels, FLT_MAX);
+        lod->addChild(done[i].geode.get(), 0.0f, lodPixels);
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < chunked.size();)
+    {
+        osg::ref_ptr<osg::Node> node;
+        if (!chunked[i].first.lock(node))
+        {
+            chunked[i] = chunked.back();
+            chunked.pop_back();
+            continue;
+        }
+        if (node->getNumParents() > 0)
+            total += chunked[i].second;
+        ++i;
+    }
+
+    double drawn;
+    statsMutex.lock();
+    drawn = drawnTriangles;
+    drawnTriangles = 0.0;
+    statsMutex.unlock();
+
+    osg::Stats *stats = VRViewer::instance()->getViewerStats();
+    if (total > 0.0 && stats && stats->collectStats("frame_rate"))
+    {
+        int fn = VRViewer::instance()->getFrameStamp()->getFrameNumber();
+        stats->setAttribute(fn, "Chunk triangles total", total);
+        stats->setAttribute(fn, "Chunk triangles drawn", drawn);
+        stats->setAttribute(fn, "Chunk triangles drawn fraction", drawn / total);
+    }
+}
@@ -0,0 +1,112 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/*! \file
+ \brief split large COVISE surfaces into culled chunks with a coarse level of detail
+
+ Geometries with more triangles than COVER.Plugin.COVISE.ChunkThreshold
+ are split at the median of the triangle centers until no chunk has more
+ than COVER.Plugin.COVISE.ChunkSize triangles. Every chunk gets its own
+ bounding volume and an osg::LOD, the coarse level is built by vertex
+ clustering on a worker thread and attached as soon as it is ready.
+
+ While the statistics are collected, the number of chunk triangles in the
+ scene and the number drawn after culling and level of detail are published
+ per frame as "Chunk triangles total", "Chunk triangles drawn" and
+ "Chunk triangles drawn fraction", the stats display shows the fraction.
+ */
+
+#ifndef GEOMETRY_CHUNKER
+#define GEOMETRY_CHUNKER
+
+#include <util/coExport.h>
+
+#include <osg/Vec3>
+#include <osg/LOD>
+#include <osg/Geode>
+#include <osg/ref_ptr>
+#include <osg/observer_ptr>
+#include <OpenThreads/Thread>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/Condition>
+
+#include <vector>
+#include <deque>
+
+namespace osg
+{
+class Node;
+class Group;
+class Geometry;
+}
+
+namespace opencover
+{
+
+class COVISEPLUGINEXPORT GeometryChunker : public OpenThreads::Thread
+{
+public:
+    static GeometryChunker *instance();
+    GeometryChunker();
+    virtual ~GeometryChunker();
+
+    bool isEnabled() const
+    {
+        return enabled;
+    }
+
+    /// returns a group of chunks replacing node or node itself if it is small enough,
+    /// node is not referenced by the chunks
+    osg::Node *process(osg::Node *node);
+
+    /// attach finished coarse levels and report statistics, called once per frame
+    void update();
+
+    /// called from the cull traversal of the chunks
+    void addDrawnTriangles(unsigned int numTriangles);
+
+    /// builds the coarse levels
+    virtual void run();
+
+private:
+    struct Job
+    {
+        osg::ref_ptr<osg::LOD> lod;
+        osg::ref_ptr<osg::Geode> geode;
+    };
+
+    void split(const osg::Geometry *geom, const std::vector<unsigned int> &indices,
+               const std::vector<osg::Vec3f> &centers, std::vector<unsigned int> &triangles,
+               size_t begin, size_t end, osg::Group *parent);
+    osg::Geometry *makeChunk(const osg::Geometry *geom, const std::vector<unsigned int> &indices,
+                             const std::vector<unsigned int> &triangles, size_t begin, size_t end);
+
+    bool enabled;
+    unsigned int threshold;
+    unsigned int chunkSize;
+    float lodPixels;
+    float lodRatio;
+
+    // vertex map of makeChunk, kept between calls to avoid reallocation
+    std::vector<int> vertexMap;
+
+    // chunked objects and their number of triangles
+    std::vector<std::pair<osg::observer_ptr<osg::Node>, unsigned int> > chunked;
+
+    // shared with the worker thread
+    OpenThreads::Mutex mutex;
+    OpenThreads::Condition condition;
+    std::deque<Job> pending;
+    std::vector<Job> finished;
+    bool running;
+
+    // shared with the cull threads
+    OpenThreads::Mutex statsMutex;
+    double drawnTriangles;
+};
+}
+#endif
@@ -52,6 +52,7 @@
 #include <osgUtil/TriStripVisitor>
 #include <cover/coVRFileManager.h>
 #include "VRCoviseGeometryManager.h"
+#include "VRCoviseArrowGlyphs.h"
 #include <cover/coVRLighting.h>
 #include <cover/VRSceneGraph.h>
 #include <cover/coVRMSController.h>
@@ -855,7 +856,7 @@ GeometryManager::addPolygon(const char *object_name,
             for (int n = 0; n < numv; n++)
             {
                 int v = v_l[i_l[i] + n];
-                tcArray->push_back(osg::Vec2(tx[v], ty[v]));
+                tcArray->push_back(osg::Vec2(tx[v], ty ? ty[v] : 0.f));
             }
         }
         geom->setTexCoordArray(0, tcArray);
@@ -1177,7 +1178,7 @@ GeometryManager::addTriangles(const char *object_name,
             {
                 int v = v_l[vn];
                 vn++;
-                tcArray->push_back(osg::Vec2(tx[v], ty[v]));
+                tcArray->push_back(osg::Vec2(tx[v], ty ? ty[v] : 0.f));
             }
         }
         geom->setTexCoordArray(0, tcArray);
@@ -1501,7 +1502,7 @@ GeometryManager::addQuads(const char *object_name,
             {
                 int v = v_l[vn];
                 vn++;
-                tcArray->push_back(osg::Vec2(tx[v], ty[v]));
+                tcArray->push_back(osg::Vec2(tx[v], ty ? ty[v] : 0.f));
             }
         }
         geom->setTexCoordArray(0, tcArray);
@@ -1918,7 +1919,7 @@ osg::Node *GeometryManager::addTriangleStrip(const char *object_name,
             for (int n = 0; n < numv; n++)
             {
                 int v = v_l[i_l[i] + n];
-                tcArray->push_back(osg::Vec2(tx[v], ty[v]));
+                tcArray->push_back(osg::Vec2(tx[v], ty ? ty[v] : 0.f));
             }
         }
         geom->setTexCoordArray(0, tcArray);
@@ -2536,6 +2537,101 @@ GeometryManager::addPoint(const char *object_name, int no_of_points,
     return ((osg::Node *)geode);
 }
 
+osg::Node *
+GeometryManager::addArrowGlyphs(const char *object_name, int no_of_points,
+                                float *x_c, float *y_c, float *z_c,
+                                float *u_c, float *v_c, float *w_c,
+                                int colorbinding, int colorpacking,
+                                float *r, float *g, float *b, int *pc, coMaterial *material,
+                                int num_sectors, float arrow_factor, float angle,
+                                float linewidth)
+{
+    if (no_of_points == 0)
+    {
+        osg::Group *g = new osg::Group(); // add a dummy object so that we don`t have missing timesteps if object is empty
+        g->setName(object_name);
+        return g;
+    }
+
+    bool transparent = false;
+    osg::Array *colors = NULL;
+    switch (colorbinding)
+    {
+    case Bind::PerVertex:
+    {
+        // 4 bytes per arrow, arrays are large here
+        osg::Vec4ubArray *colArr = new osg::Vec4ubArray(no_of_points);
+        for (int i = 0; i < no_of_points; i++)
+        {
+            float cr, cg, cb, ca = 1.f;
+            if (colorpacking == Pack::RGBA)
+            {
+                unpackRGBA(pc, i, &cr, &cg, &cb, &ca);
+                if (ca < 1.f)
+                    transparent = true;
+            }
+            else
+            {
+                cr = r[i];
+                cg = g[i];
+                cb = b[i];
+            }
+            (*colArr)[i].set((unsigned char)(cr * 255.f + 0.5f), (unsigned char)(cg * 255.f + 0.5f),
+                             (unsigned char)(cb * 255.f + 0.5f), (unsigned char)(ca * 255.f + 0.5f));
+        }
+        colors = colArr;
+    }
+    break;
+
+    case Bind::OverAll:
+    {
+        osg::Vec4Array *colArr = new osg::Vec4Array();
+        if (colorpacking == Pack::RGBA)
+        {
+            float cr, cg, cb, ca;
+            unpackRGBA(pc, 0, &cr, &cg, &cb, &ca);
+            if (ca < 1.f)
+                transparent = true;
+            colArr->push_back(osg::Vec4(cr, cg, cb, ca));
+        }
+        else
+            colArr->push_back(osg::Vec4(r[0], g[0], b[0], 1.0f));
+        colors = colArr;
+    }
+    break;
+
+    default:
+        if (material != NULL)
+        {
+            osg::Vec4Array *colArr = new osg::Vec4Array();
+            colArr->push_back(osg::Vec4(material->diffuseColor[0], material->diffuseColor[1], material->diffuseColor[2], 1.0f));
+            colors = colArr;
+        }
+        break;
+    }
+
+    osg::Geode *geode = new osg::Geode();
+    geode->setName(object_name);
+    geode->addDrawable(ArrowGlyphs::create(no_of_points, x_c, y_c, z_c, u_c, v_c, w_c, colors,
+                                           num_sectors, arrow_factor, angle));
+
+    osg::StateSet *geoState = geode->getOrCreateStateSet();
+    setDefaultMaterial(geoState, transparent, NULL, false);
+
+    osg::BlendFunc *blendFunc = new osg::BlendFunc();
+    blendFunc->setFunction(osg::BlendFunc::SRC_ALPHA, osg::BlendFunc::ONE_MINUS_SRC_ALPHA);
+    geoState->setAttributeAndModes(blendFunc, osg::StateAttribute::ON);
+    osg::AlphaFunc *alphaFunc = new osg::AlphaFunc();
+    alphaFunc->setFunction(osg::AlphaFunc::ALWAYS, 1.0);
+    geoState->setAttributeAndModes(alphaFunc, osg::StateAttribute::OFF);
+
+    osg::LineWidth *lineWidth = new osg::LineWidth(linewidth);
+    geoState->setAttributeAndModes(lineWidth, osg::StateAttribute::ON);
+
+    geode->setStateSet(geoState);
+    return geode;
+}
+
 osg::Node *
 GeometryManager::addSphere(const char *object_name, int no_of_points,
                            float *x_c, float *y_c, float *z_c,
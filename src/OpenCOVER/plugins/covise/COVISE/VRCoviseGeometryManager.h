@@ -162,6 +162,13 @@ public:
                         int colorbinding, int colorpacking, float *r, float *g, float *b, int *pc,
                         coMaterial *, float pointsize);
 
+    osg::Node *addArrowGlyphs(const char *object, int no_of_points,
+                              float *x_c, float *y_c, float *z_c,
+                              float *u_c, float *v_c, float *w_c,
+                              int colorbinding, int colorpacking, float *r, float *g, float *b, int *pc,
+                              coMaterial *, int num_sectors, float arrow_factor, float angle,
+                              float linewidth);
+
     osg::Node *addSphere(const char *object_name, int no_of_points,
                          float *x_c, float *y_c, float *z_c,
                          int iRenderMethod,
@@ -32,6 +32,7 @@
 #include <cover/input/VRKeys.h>
 #include "VRCoviseObjectManager.h"
 #include "VRCoviseGeometryManager.h"
+#include "VRCoviseGeometryChunker.h"
 #include <cover/coVRNavigationManager.h>
 #include <cover/coVRFileManager.h>
 #include <cover/VRSceneGraph.h>
@@ -52,6 +53,7 @@
 #include <cover/coVRTui.h>
 #include <cover/VRRegisterSceneGraph.h>
 #include <PluginUtil/coLOD.h>
+#include <PluginUtil/ColorBar.h>
 
 #include <OpenVRUI/coTrackerButtonInteraction.h>
 
@@ -68,6 +70,7 @@
 
 #include <stdio.h>
 #include <cstring>
+#include <vector>
 //#include <cover/coVRDePee.h>
 
 using namespace std;
@@ -393,6 +396,8 @@ void ObjectManager::addObject(const char *object, const coDistributedObject *dat
         fprintf(stderr, "--ObjectManager (%s)::addObject %s\n", getenv("HOST") ? getenv("HOST") : "unknown", object);
     const char *gtype;
 
+    removeStreamedSet(object);
+
     if ((!data_obj) && (coVRMSController::instance()->isMaster()))
     {
         data_obj = coDistributedObject::createFromShm(object);
@@ -419,6 +424,57 @@ void ObjectManager::addObject(const char *object, const coDistributedObject *dat
     delete ro;
 }
 
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void ObjectManager::addStreamedStep(const char *name, const char *element, int step, int numSteps)
+{
+    if (cover->debugLevel(4))
+        fprintf(stderr, "--ObjectManager::addStreamedStep %s: %s (%d/%d)\n", name, element, step, numSteps);
+
+    const coDistributedObject *data_obj = NULL;
+    if (coVRMSController::instance()->isMaster())
+    {
+        data_obj = coDistributedObject::createFromShm(element);
+    }
+    CoviseRenderObject *ro = new CoviseRenderObject(data_obj);
+
+    StreamedSetMap::iterator it = streamedSets.find(name);
+    bool first = (it == streamedSets.end());
+    if (first)
+    {
+        StreamedSet set;
+        set.sequence = (osg::Sequence *)GeometryManager::instance()->addGroup(name, true);
+        it = streamedSets.insert(std::make_pair(std::string(name), set)).first;
+    }
+    StreamedSet &set = it->second;
+
+    if (osg::Node *node = addGeometry(element, set.sequence.get(), ro, NULL, NULL, NULL, NULL, ro, NULL))
+    {
+        set.sequence->addChild(node);
+        set.elements.push_back(element);
+        if (set.sequence->getNumChildren() == 1)
+            VRSceneGraph::instance()->addNode(set.sequence.get(), (osg::Group *)NULL, ro);
+        else
+            coVRAnimationManager::instance()->addSequence(set.sequence.get());
+    }
+    delete ro;
+}
+
+void ObjectManager::removeStreamedSet(const char *name)
+{
+    StreamedSetMap::iterator it = streamedSets.find(name);
+    if (it == streamedSets.end())
+        return;
+
+    bool added = it->second.sequence->getNumChildren() > 0;
+    for (size_t i = 0; i < it->second.elements.size(); i++)
+        coVRPluginList::instance()->removeObject(it->second.elements[i].c_str(), false);
+    streamedSets.erase(it);
+    if (added)
+        removeGeometry(name, true);
+}
+
 void ObjectManager::handleInteractors(CoviseRenderObject *container, CoviseRenderObject *geomObj, CoviseRenderObject *normObj, CoviseRenderObject *colorObj, CoviseRenderObject *texObj) const
 {
 
@@ -484,6 +540,12 @@ void ObjectManager::deleteObject(const char *name, bool groupobject)
     //printf("ObjectManager::deleteObject\n");
     //printf("\t object = %s\n", name);
 
+    if (streamedSets.find(name) != streamedSets.end())
+    {
+        removeStreamedSet(name);
+        return;
+    }
+
     int i, n;
     for (i = 0; i < anzset; i++)
     {
@@ -674,6 +736,7 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
     int texW = 0, texH = 0; // texture width and height
     int pixS = 0; // size of pixels in texture map (= number of bytes per pixel)
     unsigned char *texImage = NULL; // texture map
+    std::vector<unsigned char> colormapImage; // texture map built from a COLORMAP attribute
 
 //fprintf(stderr, "++++++ObjectManager::addGeometry1  container=%s geometry=%s object =%s\n", container->getName(), geometry->getName(), object );
 #ifdef DBGPRINT
@@ -1375,7 +1438,64 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             vertexAttribute->getSize(no_va);
             vertexAttribute->getAddresses(xva, yva, zva);
         }
-        if (texture) // colors by texture map
+        if (texture && texture->isType("USTSDT")) // texture coordinates from Colors, colormap as texture map
+        {
+            if (vertexAttribute == NULL)
+            {
+                colorpacking = Pack::None;
+                colorbinding = Bind::None;
+            }
+
+            const char *colormap = texture->getAttribute("COLORMAP");
+            texture->getSize(no_t);
+            if (colormap && no_t > 0)
+            {
+                char *species = NULL;
+                float cmin, cmax;
+                int numColors = 0;
+                float *r = NULL, *g = NULL, *b = NULL, *a = NULL;
+                ColorBar::parseAttrib(colormap, species, cmin, cmax, numColors, r, g, b, a);
+                colormapImage.resize(4 * (numColors > 0 ? numColors : 0));
+                for (int i = 0; i < numColors; i++)
+                {
+                    colormapImage[4 * i] = (unsigned char)(r[i] * 255.f);
+                    colormapImage[4 * i + 1] = (unsigned char)(g[i] * 255.f);
+                    colormapImage[4 * i + 2] = (unsigned char)(b[i] * 255.f);
+                    colormapImage[4 * i + 3] = (unsigned char)(a[i] * 255.f);
+                }
+                delete[] species;
+                delete[] r;
+                delete[] g;
+                delete[] b;
+                delete[] a;
+
+                if (numColors > 0)
+                {
+                    texImage = &colormapImage[0];
+                    texW = numColors;
+                    texH = 1;
+                    pixS = 4;
+                    // one coordinate per vertex, t is 0
+                    float *ty, *tz;
+                    texture->getAddresses(t_c[0], ty, tz);
+                    t_c[1] = NULL;
+                    if (vertexAttribute == NULL)
+                    {
+                        colorbinding = Bind::PerVertex;
+                        colorpacking = Pack::Texture;
+                    }
+                }
+                else
+                {
+                    no_t = 0;
+                }
+            }
+            else
+            {
+                no_t = 0;
+            }
+        }
+        else if (texture) // colors by texture map
         {
             if (vertexAttribute == NULL) // if we have vertex attributes, allow color and texture to be mixed, otherwise change to
             {
@@ -1574,10 +1694,31 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             else if ((strcmp(gtype, "POINTS") == 0))
             {
                 const char *var = container ? container->getAttribute("VARIANT") : 0;
-                if (!var || strncmp(var, "GPGPU", 5))
+                // points and vectors from VectorField, drawn as instanced arrows
+                const char *glyphs = geometry->getAttribute("VECTOR_GLYPHS");
+                if (glyphs && no_n >= no_points && xn && yn && zn)
+                {
+                    int numSectors = 0;
+                    float arrowFactor = 0.2f, angle = 9.5f;
+                    if (sscanf(glyphs, "%d %f %f", &numSectors, &arrowFactor, &angle) < 1)
+                    {
+                        if (cover->debugLevel(2))
+                            cerr << "ObjectManager::addGeometry: sscanf VECTOR_GLYPHS failed" << endl;
+                    }
+                    newNode = GeometryManager::instance()->addArrowGlyphs(object, no_points,
+                                                                          x_c, y_c, z_c, xn, yn, zn,
+                                                                          colorbinding, colorpacking, rc, gc, bc, pc,
+                                                                          material, numSectors, arrowFactor, angle, linewidth);
+                }
+                else if (!var || strncmp(var, "GPGPU", 5))
+                {
+                    if (glyphs)
+                        cerr << "ObjectManager::addGeometry: no vectors for the arrows of " << object
+                             << ", connect vectorsOut of VectorField to DataIn1 of Collect" << endl;
                     newNode = GeometryManager::instance()->addPoint(object, no_points,
                                                                     x_c, y_c, z_c, colorbinding, colorpacking, rc, gc, bc, pc,
                                                                     material, pointsize);
+                }
             }
             else if (strcmp(gtype, "SPHERE") == 0)
             {
@@ -1586,6 +1727,20 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             }
         }
 
+        if (newNode && (strcmp(gtype, "POLYGN") == 0 || strcmp(gtype, "TRIANG") == 0
+                        || strcmp(gtype, "TRITRI") == 0 || strcmp(gtype, "QUADS") == 0))
+        {
+            // replace very large surfaces by spatial chunks with a coarse level of detail
+            osg::Node *chunks = GeometryChunker::instance()->process(newNode);
+            if (chunks != newNode)
+            {
+                // not referenced by anyone, drop it with its arrays
+                newNode->ref();
+                newNode->unref();
+                newNode = chunks;
+            }
+        }
+
         if (newNode)
         {
             if(depthPeeling)
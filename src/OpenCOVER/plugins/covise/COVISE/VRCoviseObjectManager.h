@@ -26,9 +26,12 @@
 
 #include <osg/Matrix>
 #include <osg/ColorMask>
+#include <osg/Sequence>
 
 #include <util/coMaterial.h>
 #include <map>
+#include <string>
+#include <vector>
 
 #define MAXSETS 8000
 
@@ -103,6 +106,16 @@ private:
     osg::ColorMask *noFrameBuffer;
     vrui::coTrackerButtonInteraction *interactionA; ///< interaction for first button
 
+    // timestep sets which are still being computed, replaced by the complete set
+    struct StreamedSet
+    {
+        osg::ref_ptr<osg::Sequence> sequence;
+        std::vector<std::string> elements;
+    };
+    typedef std::map<std::string, StreamedSet> StreamedSetMap;
+    StreamedSetMap streamedSets;
+    void removeStreamedSet(const char *name);
+
 public:
     static ObjectManager *instance();
 
@@ -111,6 +124,8 @@ public:
     void addCoviseMenu(const char *container, buttonSpecCell *);
     void deleteObject(const char *name, bool groupobj = true);
     void addObject(const char *name, const covise::coDistributedObject *obj = NULL);
+    /// add timestep step of numSteps of set name before the set itself has been created
+    void addStreamedStep(const char *name, const char *element, int step, int numSteps);
     void coviseError(const char *error);
 
     void update(void);
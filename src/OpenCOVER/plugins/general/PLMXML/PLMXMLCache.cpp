@@ -0,0 +1,206 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "PLMXMLCache.h"
+
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+#include <osgDB/FileUtils>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+// size and modification time of a file, false if it does not exist
+bool fileStat(const std::string &filename, double &size, long long &mtime)
+{
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0)
+        return false;
+    size = (double)st.st_size;
+    mtime = (long long)st.st_mtime;
+    return true;
+}
+
+// FNV-1a
+unsigned long long hash(const std::string &s)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < s.length(); ++i)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+struct Entry
+{
+    std::string key;
+    long long used;
+    double size;
+    bool operator<(const Entry &other) const
+    {
+        return used < other.used;
+    }
+};
+}
+
+PLMXMLCache::PLMXMLCache(const std::string &dir, double maxSizeMB)
+    : dir(dir)
+    , maxSize(maxSizeMB * 1024. * 1024.)
+    , entrySize(0.)
+{
+    osgDB::makeDirectory(dir);
+}
+
+std::string PLMXMLCache::key(const std::string &filename, const std::string &settings) const
+{
+    double size;
+    long long mtime;
+    if (!fileStat(filename, size, mtime))
+        return "";
+
+    std::stringstream id;
+    id << osgDB::getRealPath(filename) << "\n" << size << "\n" << mtime << "\n" << settings;
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", hash(id.str()));
+    return key;
+}
+
+std::string PLMXMLCache::path(const std::string &key, const char *suffix) const
+{
+    return dir + "/" + key + suffix;
+}
+
+osg::Node *PLMXMLCache::load(const std::string &key)
+{
+    std::ifstream in(path(key, ".parts").c_str());
+    if (!in)
+        return NULL;
+
+    // every part has to be unchanged
+    std::string parts, line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        double size, currentSize;
+        long long mtime, currentMtime;
+        std::string filename;
+        if (!(fields >> size >> mtime) || !std::getline(fields >> std::ws, filename)
+            || !fileStat(filename, currentSize, currentMtime) || currentSize != size || currentMtime != mtime)
+        {
+            remove(key);
+            return NULL;
+        }
+        parts += line + "\n";
+    }
+    in.close();
+
+    osg::Node *scene = osgDB::readNodeFile(path(key, ".osgb"));
+    if (!scene)
+    {
+        remove(key);
+        return NULL;
+    }
+    long long mtime;
+    fileStat(path(key, ".osgb"), entrySize, mtime);
+
+    // rewriting the part list marks the entry as used
+    writeParts(key, parts);
+    return scene;
+}
+
+bool PLMXMLCache::store(const std::string &key, osg::Node *scene, const std::vector<std::string> &parts)
+{
+    std::stringstream list;
+    list.precision(17);
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        double size;
+        long long mtime;
+        if (!fileStat(parts[i], size, mtime))
+            continue;
+        list << size << " " << mtime << " " << parts[i] << "\n";
+    }
+
+    if (!osgDB::writeNodeFile(*scene, path(key, ".osgb")))
+    {
+        remove(key);
+        return false;
+    }
+    long long mtime;
+    fileStat(path(key, ".osgb"), entrySize, mtime);
+    if (!writeParts(key, list.str()))
+    {
+        remove(key);
+        return false;
+    }
+
+    evict();
+    return true;
+}
+
+double PLMXMLCache::getEntrySizeMB() const
+{
+    return entrySize / 1024. / 1024.;
+}
+
+bool PLMXMLCache::writeParts(const std::string &key, const std::string &parts)
+{
+    std::ofstream out(path(key, ".parts").c_str());
+    out << parts;
+    out.close();
+    return !out.fail();
+}
+
+void PLMXMLCache::remove(const std::string &key)
+{
+    ::remove(path(key, ".osgb").c_str());
+    ::remove(path(key, ".parts").c_str());
+}
+
+void PLMXMLCache::evict()
+{
+    std::vector<Entry> entries;
+    osgDB::DirectoryContents contents = osgDB::getDirectoryContents(dir);
+    for (size_t i = 0; i < contents.size(); ++i)
+    {
+        if (osgDB::getFileExtension(contents[i]) != "osgb")
+            continue;
+        Entry entry;
+        entry.key = osgDB::getNameLessExtension(contents[i]);
+        double partsSize;
+        long long mtime;
+        if (!fileStat(path(entry.key, ".osgb"), entry.size, mtime)
+            || !fileStat(path(entry.key, ".parts"), partsSize, entry.used))
+        {
+            remove(entry.key);
+            continue;
+        }
+        entries.push_back(entry);
+    }
+
+    double total = 0.;
+    for (size_t i = 0; i < entries.size(); ++i)
+        total += entries[i].size;
+
+    // least recently used first, the newest entry is kept in any case
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i + 1 < entries.size() && total > maxSize; ++i)
+    {
+        remove(entries[i].key);
+        total -= entries[i].size;
+    }
+}
@@ -0,0 +1,50 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef PLMXML_CACHE_H
+#define PLMXML_CACHE_H
+
+#include <osg/Node>
+
+#include <string>
+#include <vector>
+
+// Cache of assembled PLMXML scenes in the OSG binary format.
+//
+// An entry is named by a hash of the path, size and modification time of
+// the PLMXML file and the loader settings. <key>.osgb holds the scene,
+// <key>.parts the size, modification time and path of every part file.
+// An entry is only used while none of its files changed. When the cache
+// exceeds its size, the least recently used entries are removed.
+class PLMXMLCache
+{
+public:
+    PLMXMLCache(const std::string &dir, double maxSizeMB);
+
+    // key for a PLMXML file, empty if the file does not exist
+    std::string key(const std::string &filename, const std::string &settings) const;
+
+    // scene of a valid entry or NULL
+    osg::Node *load(const std::string &key);
+
+    // store a scene and the part files it was built from
+    bool store(const std::string &key, osg::Node *scene, const std::vector<std::string> &parts);
+
+    // size of the last stored or loaded scene file
+    double getEntrySizeMB() const;
+
+private:
+    std::string path(const std::string &key, const char *suffix) const;
+    bool writeParts(const std::string &key, const std::string &parts);
+    void remove(const std::string &key);
+    void evict();
+
+    std::string dir;
+    double maxSize;
+    double entrySize;
+};
+#endif
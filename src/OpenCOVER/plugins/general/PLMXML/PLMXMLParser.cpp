@@ -35,6 +35,8 @@ PLMXMLParser::PLMXMLParser()
     m_Parser = NULL;
 
     doLoadAll = true;
+    doLoadAsync = false;
+    loadCallback = NULL;
     doLoadVRML = true;
     doLoadSTL = false;
     doUndoVRMLRotate = true;
@@ -376,7 +378,7 @@ void PLMXMLParser::addPart(char *id, osg::Group *parent)
                                 {
                                     if (doLoadAll)
                                     {
-                                        coVRFileManager::instance()->loadFile(fileName, NULL, node);
+                                        loadFile(fileName, node);
                                     }
                                     else
                                     {
@@ -389,7 +391,7 @@ void PLMXMLParser::addPart(char *id, osg::Group *parent)
                                     sprintf(tmpFile, "%s%s", filePath, fileName);
                                     if (doLoadAll)
                                     {
-                                        coVRFileManager::instance()->loadFile(tmpFile, NULL, node);
+                                        loadFile(tmpFile, node);
                                     }
                                     else
                                     {
@@ -517,7 +519,7 @@ void PLMXMLParser::addPart(char *id, osg::Group *parent)
                                         {
                                             if (doLoadAll)
                                             {
-                                                coVRFileManager::instance()->loadFile(fileName, NULL, node);
+                                                loadFile(fileName, node);
                                             }
                                             else
                                             {
@@ -530,7 +532,7 @@ void PLMXMLParser::addPart(char *id, osg::Group *parent)
                                             sprintf(tmpFile, "%s%s", filePath, fileName);
                                             if (doLoadAll)
                                             {
-                                                coVRFileManager::instance()->loadFile(tmpFile, NULL, node);
+                                                loadFile(tmpFile, node);
                                             }
                                             else
                                             {
@@ -585,6 +587,22 @@ void PLMXMLParser::addPart(char *id, osg::Group *parent)
     }
 }
 
+// load a part file, asynchronously the part appears after the document was parsed
+void PLMXMLParser::loadFile(const char *fileName, osg::Group *parent)
+{
+    partFiles.push_back(fileName);
+    partGroups.push_back(parent);
+#ifndef STANDALONE
+    if (doLoadAsync)
+        coVRFileManager::instance()->loadFileAsync(fileName, parent, loadCallback);
+    else
+        coVRFileManager::instance()->loadFile(fileName, NULL, parent);
+#else
+    (void)fileName;
+    (void)parent;
+#endif
+}
+
 const XMLCh *PLMXMLParser::getTransform(DOMElement *node)
 {
 
@@ -41,6 +41,7 @@ using namespace covise;
 using namespace opencover;
 
 #include <cover/coVRSelectionManager.h>
+#include <cover/coVRFileManager.h>
 
 struct ltstr
 {
@@ -80,6 +81,25 @@ public:
     {
         doLoadAll = l;
     };
+    void loadAsync(bool l)
+    {
+        doLoadAsync = l;
+    };
+    // notified about the parts loaded asynchronously
+    void setLoadCallback(coVRFileManager::LoadCallback *callback)
+    {
+        loadCallback = callback;
+    };
+    // part files loaded while parsing
+    const std::vector<std::string> &getPartFiles() const
+    {
+        return partFiles;
+    };
+    // groups the part files are loaded into, in the order of getPartFiles
+    const std::vector<osg::ref_ptr<osg::Group> > &getPartGroups() const
+    {
+        return partGroups;
+    };
     void loadSTL(bool l)
     {
         doLoadSTL = l;
@@ -97,8 +117,13 @@ private:
     void getChildrenPath(DOMElement *node, const char *path, std::vector<DOMNode *> *result);
     osg::MatrixTransform *getTransformNode(const char *id, DOMElement *node);
     const XMLCh *getTransform(DOMElement *node);
+    void loadFile(const char *fileName, osg::Group *parent);
     coTUISGBrowserTab *sGBrowserTab;
     bool doLoadAll;
+    bool doLoadAsync;
+    coVRFileManager::LoadCallback *loadCallback;
+    std::vector<std::string> partFiles;
+    std::vector<osg::ref_ptr<osg::Group> > partGroups;
     bool doLoadSTL;
     bool doLoadVRML;
     bool doUndoVRMLRotate;
@@ -29,18 +29,23 @@
 #include "PLMXMLPlugin.h"
 #include "PLMXMLParser.h"
 #include "PLMXMLSimVisitor.h"
+#include "PLMXMLCache.h"
 
 #include <cover/RenderObject.h>
 #include <cover/VRRegisterSceneGraph.h>
 
 #include <osg/Group>
 #include <osg/MatrixTransform>
+#include <osg/NodeVisitor>
+#include <osg/Timer>
 
 using namespace osg;
 #include <sys/types.h>
 #include <string.h>
+#include <stdlib.h>
 
 #include <PluginUtil/SimReference.h>
+#include <PluginUtil/FileReference.h>
 
 #include <PluginUtil/PluginMessageTypes.h>
 #include <net/tokenbuffer.h>
@@ -61,6 +66,106 @@ static FileHandler handlers[] = {
       "xml" }
 };
 
+namespace
+{
+
+// finds user data the .osgb writer cannot store
+class ReferenceVisitor : public osg::NodeVisitor
+{
+public:
+    ReferenceVisitor()
+        : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+        , found(false)
+    {
+    }
+
+    virtual void apply(osg::Node &node)
+    {
+        osg::Referenced *data = node.getUserData();
+        if (dynamic_cast<SimReference *>(data) || dynamic_cast<FileReference *>(data))
+            found = true;
+        else
+            traverse(node);
+    }
+
+    bool found;
+};
+}
+
+PLMXMLCacheWriter::PLMXMLCacheWriter(PLMXMLCache *cache, const std::string &key, const std::string &filename,
+                                     osg::Group *scene, double startTime)
+    : cache(cache)
+    , key(key)
+    , filename(filename)
+    , scene(scene)
+    , startTime(startTime)
+    , attached(false)
+    , done(false)
+{
+}
+
+void PLMXMLCacheWriter::setParts(const std::vector<std::string> &p, const std::vector<osg::ref_ptr<osg::Group> > &g)
+{
+    parts = p;
+    groups = g;
+}
+
+void PLMXMLCacheWriter::setAttached()
+{
+    attached = true;
+    update();
+}
+
+void PLMXMLCacheWriter::progress(int finished, int total)
+{
+    if (finished == total)
+        setAttached();
+}
+
+void PLMXMLCacheWriter::update()
+{
+    // readers that load in parts fill their groups during the next frames
+    if (attached && !done && !coVRFileManager::instance()->isReadingParts())
+        store();
+}
+
+void PLMXMLCacheWriter::store()
+{
+    if (done)
+        return;
+    done = true;
+
+    double loadTime = osg::Timer::instance()->time_s() - startTime;
+    // a part that could not be read would be missing in the cached scene,
+    // every loader attaches what it read to the group of the part
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        if (groups[i]->getNumChildren() == 0)
+        {
+            fprintf(stderr, "PLMXML: %s loaded in %.2f s, not cached: %s could not be loaded\n",
+                    filename.c_str(), loadTime, parts[i].c_str());
+            return;
+        }
+    }
+
+    // simulation and file references would be lost in the cached scene
+    ReferenceVisitor references;
+    scene->accept(references);
+    if (references.found)
+    {
+        fprintf(stderr, "PLMXML: %s loaded in %.2f s, not cached: scene has simulation or file references\n",
+                filename.c_str(), loadTime);
+        return;
+    }
+
+    double start = osg::Timer::instance()->time_s();
+    if (cache->store(key, scene.get(), parts))
+        fprintf(stderr, "PLMXML: %s loaded in %.2f s, cached in %.2f s (%.1f MB)\n",
+                filename.c_str(), loadTime, osg::Timer::instance()->time_s() - start, cache->getEntrySizeMB());
+    else
+        fprintf(stderr, "PLMXML: %s loaded in %.2f s, could not be cached\n", filename.c_str(), loadTime);
+}
+
 int PLMXMLPlugin::loadPLMXML(const char *filename, osg::Group *loadParent, const char *)
 {
     if (loadParent)
@@ -70,24 +175,73 @@ int PLMXMLPlugin::loadPLMXML(const char *filename, osg::Group *loadParent, const
     // read XML document here and add parts to currentGroup
 
     bool loadAll = coCoviseConfig::isOn("COVER.Plugin.PLMXML.LoadAll", true);
+    bool loadAsync = coCoviseConfig::isOn("COVER.Plugin.PLMXML.LoadAsync", true);
     bool loadSTL = coCoviseConfig::isOn("COVER.Plugin.PLMXML.LoadSTL", false);
     bool loadVRML = coCoviseConfig::isOn("COVER.Plugin.PLMXML.LoadVRML", true);
     bool undoVRMLRotate = coCoviseConfig::isOn("COVER.Plugin.PLMXML.UndoVRMLRotate", true);
 
+    double startTime = osg::Timer::instance()->time_s();
+
+    // parts loaded on demand are referenced by user data that cannot be
+    // written, only completely loaded assemblies are cached
+    std::string cacheKey;
+    osg::ref_ptr<osg::Group> cachedGroup;
+    if (plugin->cache && loadAll)
+    {
+        char settings[100];
+        snprintf(settings, sizeof(settings), "stl=%d vrml=%d undoVRMLRotate=%d", loadSTL, loadVRML, undoVRMLRotate);
+        cacheKey = plugin->cache->key(filename, settings);
+        if (!cacheKey.empty())
+        {
+            osg::ref_ptr<osg::Node> scene = plugin->cache->load(cacheKey);
+            cachedGroup = dynamic_cast<osg::Group *>(scene.get());
+        }
+    }
+
     // We need a single, dedicated root node for registration in vr-prepare.
     // If no registration is done, we can skip this part.
-    osg::Group *rootGroup = new osg::Group;
-    rootGroup->setName("PLMXML root");
+    osg::Group *rootGroup = cachedGroup.get();
+    if (!rootGroup)
+    {
+        rootGroup = new osg::Group;
+        rootGroup->setName("PLMXML root");
+    }
     currentGroup->addChild(rootGroup);
     currentGroup = rootGroup;
     VRRegisterSceneGraph::instance()->block();
 
-    PLMXMLParser *parser = new PLMXMLParser();
-    parser->loadAll(loadAll);
-    parser->loadSTL(loadSTL);
-    parser->loadVRML(loadVRML);
-    parser->undoVRMLRotate(undoVRMLRotate);
-    parser->parse(filename, currentGroup);
+    if (cachedGroup.valid())
+    {
+        fprintf(stderr, "PLMXML: %s loaded from cache in %.2f s (%.1f MB)\n",
+                filename, osg::Timer::instance()->time_s() - startTime, plugin->cache->getEntrySizeMB());
+    }
+    else
+    {
+        PLMXMLCacheWriter *writer = NULL;
+        if (!cacheKey.empty())
+            writer = new PLMXMLCacheWriter(plugin->cache, cacheKey, filename, rootGroup, startTime);
+
+        PLMXMLParser *parser = new PLMXMLParser();
+        parser->loadAll(loadAll);
+        parser->loadAsync(loadAsync);
+        parser->loadSTL(loadSTL);
+        parser->loadVRML(loadVRML);
+        parser->undoVRMLRotate(undoVRMLRotate);
+        parser->setLoadCallback(writer);
+        parser->parse(filename, currentGroup);
+
+        if (writer)
+        {
+            writer->setParts(parser->getPartFiles(), parser->getPartGroups());
+            // parts loaded asynchronously are attached in later frames
+            if (!loadAsync || parser->getPartFiles().empty())
+                writer->setAttached();
+            if (writer->isDone())
+                delete writer;
+            else
+                plugin->cacheWriters.push_back(writer);
+        }
+    }
 
     // register nodes
     VRRegisterSceneGraph::instance()->unblock();
@@ -109,6 +263,7 @@ int PLMXMLPlugin::unloadPLMXML(const char *filename, const char *)
 }
 
 PLMXMLPlugin::PLMXMLPlugin()
+    : cache(NULL)
 {
 }
 
@@ -123,11 +278,40 @@ bool PLMXMLPlugin::init()
 
     plugin = this;
 
+    if (coCoviseConfig::isOn("COVER.Plugin.PLMXML.Cache", true))
+    {
+#ifdef _WIN32
+        const char *home = getenv("USERPROFILE");
+#else
+        const char *home = getenv("HOME");
+#endif
+        std::string dir = home ? std::string(home) + "/.covise/plmxmlcache" : "";
+        dir = coCoviseConfig::getEntry("value", "COVER.Plugin.PLMXML.CacheDir", dir);
+        float size = coCoviseConfig::getFloat("COVER.Plugin.PLMXML.CacheSize", 4096.f);
+        if (!dir.empty())
+            cache = new PLMXMLCache(dir, size);
+    }
+
     coVRFileManager::instance()->registerFileHandler(&handlers[0]);
     coVRFileManager::instance()->registerFileHandler(&handlers[1]);
 
     return true;
 }
+
+void PLMXMLPlugin::preFrame()
+{
+    for (std::list<PLMXMLCacheWriter *>::iterator it = cacheWriters.begin(); it != cacheWriters.end();)
+    {
+        (*it)->update();
+        if ((*it)->isDone())
+        {
+            delete *it;
+            it = cacheWriters.erase(it);
+        }
+        else
+            ++it;
+    }
+}
 //---------------------------------------------------------------------------------------------
 void PLMXMLPlugin::addNode(osg::Node *node, RenderObject *render)
 {
@@ -156,6 +340,15 @@ PLMXMLPlugin::~PLMXMLPlugin()
 {
     coVRFileManager::instance()->unregisterFileHandler(&handlers[0]);
     coVRFileManager::instance()->unregisterFileHandler(&handlers[1]);
+
+    // writers of scenes still loading are referenced by coVRFileManager and use the cache
+    for (std::list<PLMXMLCacheWriter *>::iterator it = cacheWriters.begin(); it != cacheWriters.end(); ++it)
+    {
+        coVRFileManager::instance()->cancelAsyncLoads(*it);
+        delete *it;
+    }
+    cacheWriters.clear();
+    delete cache;
 }
 
 COVERPLUGIN(PLMXMLPlugin)
@@ -25,6 +25,7 @@ using namespace covise;
 using namespace opencover;
 
 #include <cover/coVRShader.h>
+#include <cover/coVRFileManager.h>
 #include "cover/coTabletUI.h"
 #include <util/coTabletUIMessages.h>
 #include <util/coRestraint.h>
@@ -32,6 +33,50 @@ using namespace opencover;
 #include <osg/Matrix>
 #include <osg/Material>
 
+#include <list>
+#include <string>
+#include <vector>
+
+class PLMXMLCache;
+
+// stores a scene in the cache as soon as all its parts are read
+class PLMXMLCacheWriter : public coVRFileManager::LoadCallback
+{
+public:
+    PLMXMLCacheWriter(PLMXMLCache *cache, const std::string &key, const std::string &filename,
+                      osg::Group *scene, double startTime);
+
+    // part files and the groups they are loaded into
+    void setParts(const std::vector<std::string> &parts, const std::vector<osg::ref_ptr<osg::Group> > &groups);
+    // all parts are attached or handed to a reader that loads them in parts
+    void setAttached();
+    // store the scene once the readers have finished
+    void update();
+    bool isAttached() const
+    {
+        return attached;
+    };
+    bool isDone() const
+    {
+        return done;
+    };
+
+    virtual void progress(int finished, int total);
+
+private:
+    void store();
+
+    PLMXMLCache *cache;
+    std::string key;
+    std::string filename;
+    osg::ref_ptr<osg::Group> scene;
+    std::vector<std::string> parts;
+    std::vector<osg::ref_ptr<osg::Group> > groups;
+    double startTime;
+    bool attached;
+    bool done;
+};
+
 class PLUGINEXPORT PLMXMLPlugin : public coVRPlugin, public coTUIListener
 {
 public:
@@ -41,6 +86,7 @@ public:
     ~PLMXMLPlugin();
 
     bool init();
+    void preFrame();
 
     static int loadPLMXML(const char *filename, osg::Group *loadParent, const char *ck = "");
     static int unloadPLMXML(const char *filename, const char *ck = "");
@@ -48,6 +94,8 @@ public:
     void addNode(osg::Node *, RenderObject *);
     //      virtual void tabletSwitchView(char *nodeName);
 private:
+    PLMXMLCache *cache;
+    std::list<PLMXMLCacheWriter *> cacheWriters;
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "ParallelRenderingServerIBVerbs.h"
 #include "ParallelRenderingClientSocket.h"
 #include "ParallelRenderingServerSocket.h"
+#include "ParallelRenderingCodec.h"
 
 #include "ParallelRenderingOGLTexQuadCompositor.h"
 
@@ -58,6 +59,13 @@ ParallelRendering::ParallelRendering()
 
     compositor = ((QString)config->getString("compositor", "COVER.ParallelRendering", "")).toStdString();
 
+    // socket interconnect only: raw, rle or yuv (lossy) and skipping of blocks unchanged since the last frame
+    std::string encodingName = ((QString)config->getString("encoding", "COVER.ParallelRendering", "raw")).toStdString();
+    ParallelRenderingCodec::Encoding encoding = ParallelRenderingCodec::encodingFromString(encodingName);
+    bool skipUnchanged = config->isOn("skipUnchanged", "COVER.ParallelRendering", false);
+    int blockSize = config->getInt("blockSize", "COVER.ParallelRendering", 64);
+    bool encoded = encoding != ParallelRenderingCodec::Raw || skipUnchanged;
+
     // Check if we are master
     if (number == 0)
     {
@@ -73,7 +81,7 @@ ParallelRendering::ParallelRendering()
         }
 
         if (!server)
-            server = new ParallelRenderingServerSocket(cover->numScreens, compositorRenders);
+            server = new ParallelRenderingServerSocket(cover->numScreens, compositorRenders, encoded);
 
         server->start();
 
@@ -104,7 +112,8 @@ ParallelRendering::ParallelRendering()
             }
 
             if (!client)
-                client = new ParallelRenderingClientSocket(number, const_cast<char *>(compositor.c_str()));
+                client = new ParallelRenderingClientSocket(number, const_cast<char *>(compositor.c_str()),
+                                                           encoded ? new ParallelRenderingCodec(encoding, skipUnchanged, blockSize) : NULL);
 
             client->start();
         }
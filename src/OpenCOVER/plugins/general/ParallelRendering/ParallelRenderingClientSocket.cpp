@@ -8,10 +8,29 @@
 #include <util/unixcompat.h>
 #include <cover/coVRPluginSupport.h>
 #include <ParallelRenderingClientSocket.h>
+#include "ParallelRenderingCodec.h"
+#include <OpenThreads/ScopedLock>
 #ifdef WIN32
 #include <Ws2tcpip.h>
 #endif
 
+class ParallelRenderingClientSocket::EncoderThread : public OpenThreads::Thread
+{
+public:
+    EncoderThread(ParallelRenderingClientSocket *client)
+        : client(client)
+    {
+    }
+
+    virtual void run()
+    {
+        client->encode();
+    }
+
+private:
+    ParallelRenderingClientSocket *client;
+};
+
 int ParallelRenderingClientSocket::client_connect(const char *servername, int port)
 {
 
@@ -73,8 +92,12 @@ int ParallelRenderingClientSocket::client_connect(const char *servername, int po
     return sockfd;
 }
 
-ParallelRenderingClientSocket::ParallelRenderingClientSocket(int number, const std::string &compositor)
+ParallelRenderingClientSocket::ParallelRenderingClientSocket(int number, const std::string &compositor, ParallelRenderingCodec *codec)
     : ParallelRenderingClient(number, compositor)
+    , codec(codec)
+    , encoder(NULL)
+    , current(NULL)
+    , quit(false)
 {
 
     cerr << "ParallelRenderingClientSocket::<init> info: creating client " << number
@@ -82,11 +105,29 @@ ParallelRenderingClientSocket::ParallelRenderingClientSocket(int number, const s
 
     this->externalPixelFormat = GL_BGRA;
 
-    lock.lock();
+    for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i)
+        freeFrames.push_back(&frames[i]);
+
+    if (codec)
+    {
+        encoder = new EncoderThread(this);
+        encoder->start();
+    }
 }
 
 ParallelRenderingClientSocket::~ParallelRenderingClientSocket()
 {
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+        quit = true;
+        condition.broadcast();
+    }
+    if (encoder)
+    {
+        encoder->join();
+        delete encoder;
+    }
+    delete codec;
 }
 
 void ParallelRenderingClientSocket::connectToServer()
@@ -97,36 +138,103 @@ void ParallelRenderingClientSocket::connectToServer()
     fd = client_connect(const_cast<char *>(compositor.c_str()), 18515 + number);
 }
 
-void ParallelRenderingClientSocket::run()
+ParallelRenderingClientSocket::Frame *ParallelRenderingClientSocket::take(std::deque<Frame *> &queue)
 {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+    while (!quit && queue.empty())
+        condition.wait(&mutex);
+    if (quit)
+        return NULL;
+    Frame *frame = queue.front();
+    queue.pop_front();
+    return frame;
+}
 
-    cerr << "ParallelRenderingClientSocket::run info: starting client " << number << endl;
+void ParallelRenderingClientSocket::put(std::deque<Frame *> &queue, Frame *frame)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+    queue.push_back(frame);
+    condition.broadcast();
+}
 
-    while (keepRunning)
-    {
-        lock.lock();
-        int bytesWritten = 0;
+void ParallelRenderingClientSocket::readBackImage()
+{
+    // waits while all frames are being encoded or sent
+    if (!current)
+        current = take(freeFrames);
+    if (!current)
+        return;
+
+    osg::Camera *camera = cover->screens[0].camera.get();
+    const osg::Viewport *vp = camera->getViewport();
+    current->width = (int)vp->width();
+    current->height = (int)vp->height();
+    current->pixels.resize((size_t)current->width * current->height * 4);
+
+    //FIXME Doesn't work for quad stereo
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, current->width, current->height, externalPixelFormat, GL_UNSIGNED_BYTE, &current->pixels[0]);
+}
 
-        int w = width;
-        int h = height;
+void ParallelRenderingClientSocket::send()
+{
+
+    if (!current)
+        return;
+    put(codec ? encodeFrames : sendFrames, current);
+    current = NULL;
+}
 
-        write(fd, &w, sizeof(int));
-        write(fd, &h, sizeof(int));
+void ParallelRenderingClientSocket::encode()
+{
+
+    while (Frame *frame = take(encodeFrames))
+    {
+        codec->encode(&frame->pixels[0], frame->width, frame->height, frame->packet);
+        put(sendFrames, frame);
+    }
+}
 
-        while (bytesWritten != w * h * 4)
+bool ParallelRenderingClientSocket::writeAll(const void *data, size_t size)
+{
+    const char *p = (const char *)data;
+    while (size > 0)
+    {
+        int n = write(fd, p, size);
+        if (n <= 0)
         {
-            int n = write(fd, image + bytesWritten, w * h * 4 - bytesWritten);
-            bytesWritten += n;
-            //printf(" wrote %d bytes\n", bytesWritten);
+            perror("ParallelRenderingClientSocket::write");
+            return false;
         }
-        //printf(" wrote %d bytes\n", bytesWritten);
-        sendLock.unlock();
+        p += n;
+        size -= n;
     }
+    return true;
 }
 
-void ParallelRenderingClientSocket::send()
+void ParallelRenderingClientSocket::run()
 {
 
-    sendLock.lock();
-    lock.unlock();
+    cerr << "ParallelRenderingClientSocket::run info: starting client " << number << endl;
+
+    while (keepRunning)
+    {
+        Frame *frame = take(sendFrames);
+        if (!frame)
+            break;
+
+        int header[3] = { frame->width, frame->height, (int)frame->packet.size() };
+        if (codec)
+        {
+            if (writeAll(header, sizeof(header)))
+                writeAll(&frame->packet[0], frame->packet.size());
+        }
+        else
+        {
+            if (writeAll(header, 2 * sizeof(int)))
+                writeAll(&frame->pixels[0], frame->pixels.size());
+        }
+
+        put(freeFrames, frame);
+    }
 }
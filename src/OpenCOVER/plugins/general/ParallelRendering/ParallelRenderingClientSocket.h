@@ -12,23 +12,64 @@
 
 #include "ParallelRenderingClient.h"
 
+#include <OpenThreads/Condition>
+
+#include <deque>
+#include <vector>
+
+class ParallelRenderingCodec;
+
+// Frames are read back on the draw thread, encoded on an encoder thread
+// (only with a codec) and written to the socket by the client thread, so
+// the next frame can be read back while the last ones are still on their way.
 class ParallelRenderingClientSocket : public ParallelRenderingClient
 {
 
 public:
-    ParallelRenderingClientSocket(int number, const std::string &compositor);
+    // without codec, raw frames are sent
+    ParallelRenderingClientSocket(int number, const std::string &compositor, ParallelRenderingCodec *codec = NULL);
     virtual ~ParallelRenderingClientSocket();
 
     virtual void connectToServer();
     virtual void run();
     virtual void send();
+    virtual void readBackImage();
 
 private:
+    struct Frame
+    {
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+        std::vector<char> packet;
+    };
+
+    class EncoderThread;
+    friend class EncoderThread;
+
     int client_connect(const char *servername, int port);
+    bool writeAll(const void *data, size_t size);
+
+    void encode();
+
+    // wait for a frame in a queue, NULL when quitting
+    Frame *take(std::deque<Frame *> &queue);
+    void put(std::deque<Frame *> &queue, Frame *frame);
 
     int fd;
-    OpenThreads::Mutex lock;
-    OpenThreads::Mutex sendLock;
+
+    ParallelRenderingCodec *codec;
+    EncoderThread *encoder;
+
+    Frame frames[3];
+    Frame *current; // read back, not yet sent
+    std::deque<Frame *> freeFrames;
+    std::deque<Frame *> encodeFrames;
+    std::deque<Frame *> sendFrames;
+    bool quit;
+
+    OpenThreads::Mutex mutex;
+    OpenThreads::Condition condition;
 };
 
 #endif
@@ -0,0 +1,377 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "ParallelRenderingCodec.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace
+{
+
+void appendInt(std::vector<char> &packet, int value)
+{
+    size_t size = packet.size();
+    packet.resize(size + sizeof(int));
+    memcpy(&packet[size], &value, sizeof(int));
+}
+
+bool readInt(const char *packet, size_t size, size_t &pos, int &value)
+{
+    if (pos + sizeof(int) > size)
+        return false;
+    memcpy(&value, packet + pos, sizeof(int));
+    pos += sizeof(int);
+    return true;
+}
+
+// control byte c < 128: c+1 elements follow,
+// c >= 128: the following element is repeated c-126 times
+template <typename T>
+void rleEncode(const T *in, size_t n, std::vector<char> &out)
+{
+    out.resize(n * (sizeof(T) + 1) + 1);
+    char *o = &out[0];
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t run = 1;
+        while (i + run < n && run < 129 && in[i + run] == in[i])
+            ++run;
+        if (run >= 2)
+        {
+            *o++ = (char)(unsigned char)(run + 126);
+            memcpy(o, &in[i], sizeof(T));
+            o += sizeof(T);
+            i += run;
+        }
+        else
+        {
+            size_t start = i;
+            do
+            {
+                ++i;
+            } while (i < n && i - start < 128 && !(i + 1 < n && in[i + 1] == in[i]));
+            *o++ = (char)(unsigned char)(i - start - 1);
+            memcpy(o, &in[start], (i - start) * sizeof(T));
+            o += (i - start) * sizeof(T);
+        }
+    }
+    out.resize(o - &out[0]);
+}
+
+template <typename T>
+bool rleDecode(const char *in, size_t size, T *out, size_t n)
+{
+    size_t i = 0, o = 0;
+    while (o < n)
+    {
+        if (i >= size)
+            return false;
+        unsigned c = (unsigned char)in[i++];
+        if (c < 128)
+        {
+            size_t len = c + 1;
+            if (o + len > n || i + len * sizeof(T) > size)
+                return false;
+            memcpy(&out[o], in + i, len * sizeof(T));
+            i += len * sizeof(T);
+            o += len;
+        }
+        else
+        {
+            size_t len = c - 126;
+            if (o + len > n || i + sizeof(T) > size)
+                return false;
+            T value;
+            memcpy(&value, in + i, sizeof(T));
+            i += sizeof(T);
+            for (size_t k = 0; k < len; ++k)
+                out[o++] = value;
+        }
+    }
+    return i == size;
+}
+
+inline unsigned char clamp(int value)
+{
+    return value < 0 ? 0 : value > 255 ? 255 : (unsigned char)value;
+}
+
+// BGRA block to Y plane followed by U and V subsampled 2x2 (BT.601, full range)
+void toYUV(const unsigned char *image, int stride, int w, int h, std::vector<unsigned char> &planes)
+{
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    planes.resize(w * h + 2 * cw * ch);
+    unsigned char *yp = &planes[0];
+    unsigned char *up = yp + w * h;
+    unsigned char *vp = up + cw * ch;
+
+    for (int j = 0; j < h; ++j)
+    {
+        const unsigned char *p = image + j * stride;
+        for (int i = 0; i < w; ++i, p += 4)
+            *yp++ = (unsigned char)((77 * p[2] + 150 * p[1] + 29 * p[0] + 128) >> 8);
+    }
+
+    for (int j = 0; j < h; j += 2)
+    {
+        for (int i = 0; i < w; i += 2)
+        {
+            int r = 0, g = 0, b = 0, count = 0;
+            for (int dj = 0; dj < 2 && j + dj < h; ++dj)
+            {
+                for (int di = 0; di < 2 && i + di < w; ++di)
+                {
+                    const unsigned char *p = image + (j + dj) * stride + (i + di) * 4;
+                    b += p[0];
+                    g += p[1];
+                    r += p[2];
+                    ++count;
+                }
+            }
+            r /= count;
+            g /= count;
+            b /= count;
+            *up++ = clamp((-43 * r - 85 * g + 128 * b + 32896) >> 8);
+            *vp++ = clamp((128 * r - 107 * g - 21 * b + 32896) >> 8);
+        }
+    }
+}
+
+void fromYUV(const unsigned char *planes, int w, int h, unsigned char *image, int stride)
+{
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    const unsigned char *yp = planes;
+    const unsigned char *up = yp + w * h;
+    const unsigned char *vp = up + cw * ch;
+
+    for (int j = 0; j < h; ++j)
+    {
+        unsigned char *p = image + j * stride;
+        for (int i = 0; i < w; ++i, p += 4)
+        {
+            int y = yp[j * w + i];
+            int u = up[(j / 2) * cw + i / 2] - 128;
+            int v = vp[(j / 2) * cw + i / 2] - 128;
+            p[0] = clamp(y + ((454 * u + 128) >> 8));
+            p[1] = clamp(y - ((88 * u + 183 * v + 128) >> 8));
+            p[2] = clamp(y + ((359 * v + 128) >> 8));
+            p[3] = 255;
+        }
+    }
+}
+}
+
+ParallelRenderingCodec::ParallelRenderingCodec(Encoding encoding, bool skipUnchanged, int blockSize)
+    : encoding(encoding)
+    , skipUnchanged(skipUnchanged)
+    , blockSize(blockSize > 0 ? blockSize : 64)
+    , width(0)
+    , height(0)
+{
+}
+
+ParallelRenderingCodec::Encoding ParallelRenderingCodec::encodingFromString(const std::string &name)
+{
+    if (name == "rle" || name == "RLE")
+        return RLE;
+    if (name == "yuv" || name == "YUV")
+        return YUV;
+    return Raw;
+}
+
+ParallelRenderingCodec::Encoding ParallelRenderingCodec::getEncoding() const
+{
+    return encoding;
+}
+
+void ParallelRenderingCodec::reset()
+{
+    previous.clear();
+}
+
+bool ParallelRenderingCodec::blockChanged(const unsigned char *image, int x, int y, int w, int h) const
+{
+    for (int j = y; j < y + h; ++j)
+    {
+        size_t offset = ((size_t)j * width + x) * 4;
+        if (memcmp(image + offset, &previous[offset], w * 4) != 0)
+            return true;
+    }
+    return false;
+}
+
+void ParallelRenderingCodec::encodeBlock(const unsigned char *image, int x, int y, int w, int h, std::vector<char> &packet)
+{
+    const unsigned char *origin = image + ((size_t)y * width + x) * 4;
+    int format = RawBlock;
+    const char *data = NULL;
+    size_t size = 0;
+
+    if (encoding == YUV)
+    {
+        toYUV(origin, width * 4, w, h, planes);
+        rleEncode(&planes[0], planes.size(), compressed);
+        if (compressed.size() < planes.size())
+        {
+            format = YUVRLEBlock;
+            data = &compressed[0];
+            size = compressed.size();
+        }
+        else
+        {
+            format = YUVBlock;
+            data = (const char *)&planes[0];
+            size = planes.size();
+        }
+    }
+    else
+    {
+        block.resize(w * h);
+        for (int j = 0; j < h; ++j)
+            memcpy(&block[j * w], origin + (size_t)j * width * 4, w * 4);
+        size = block.size() * 4;
+        data = (const char *)&block[0];
+        if (encoding == RLE)
+        {
+            rleEncode(&block[0], block.size(), compressed);
+            if (compressed.size() < size)
+            {
+                format = RLEBlock;
+                data = &compressed[0];
+                size = compressed.size();
+            }
+        }
+    }
+
+    appendInt(packet, format);
+    appendInt(packet, (int)size);
+    packet.insert(packet.end(), data, data + size);
+}
+
+size_t ParallelRenderingCodec::maxPacketSize(int width, int height)
+{
+    // block size and count, then per block of at least one pixel its index,
+    // format and length, blocks are never larger than uncompressed
+    size_t pixels = (size_t)width * height;
+    return 2 * sizeof(int) + pixels * 3 * sizeof(int) + pixels * 4;
+}
+
+void ParallelRenderingCodec::encode(const unsigned char *image, int width, int height, std::vector<char> &packet)
+{
+    if (width != this->width || height != this->height)
+    {
+        this->width = width;
+        this->height = height;
+        previous.clear();
+    }
+    bool all = !skipUnchanged || previous.empty();
+
+    packet.clear();
+    appendInt(packet, blockSize);
+    appendInt(packet, 0);
+
+    int blocksX = (width + blockSize - 1) / blockSize;
+    int numBlocks = 0;
+    for (int y = 0; y < height; y += blockSize)
+    {
+        int h = std::min(blockSize, height - y);
+        for (int x = 0; x < width; x += blockSize)
+        {
+            int w = std::min(blockSize, width - x);
+            if (!all && !blockChanged(image, x, y, w, h))
+                continue;
+
+            appendInt(packet, (y / blockSize) * blocksX + x / blockSize);
+            encodeBlock(image, x, y, w, h, packet);
+            ++numBlocks;
+
+            if (skipUnchanged && !all)
+            {
+                for (int j = y; j < y + h; ++j)
+                {
+                    size_t offset = ((size_t)j * width + x) * 4;
+                    memcpy(&previous[offset], image + offset, w * 4);
+                }
+            }
+        }
+    }
+    memcpy(&packet[sizeof(int)], &numBlocks, sizeof(int));
+
+    if (skipUnchanged && all)
+        previous.assign(image, image + (size_t)width * height * 4);
+}
+
+bool ParallelRenderingCodec::decode(const char *packet, size_t size, unsigned char *image, int width, int height)
+{
+    size_t pos = 0;
+    int blockSize = 0, numBlocks = 0;
+    if (!readInt(packet, size, pos, blockSize) || !readInt(packet, size, pos, numBlocks) || blockSize <= 0)
+        return false;
+
+    int blocksX = (width + blockSize - 1) / blockSize;
+    int blocksY = (height + blockSize - 1) / blockSize;
+    std::vector<unsigned int> pixels;
+    std::vector<unsigned char> planes;
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        int index = 0, format = 0, length = 0;
+        if (!readInt(packet, size, pos, index) || !readInt(packet, size, pos, format)
+            || !readInt(packet, size, pos, length) || index < 0 || index >= blocksX * blocksY
+            || length < 0 || pos + length > size)
+            return false;
+        const char *data = packet + pos;
+        pos += length;
+
+        int x = (index % blocksX) * blockSize;
+        int y = (index / blocksX) * blockSize;
+        int w = std::min(blockSize, width - x);
+        int h = std::min(blockSize, height - y);
+        unsigned char *origin = image + ((size_t)y * width + x) * 4;
+
+        if (format == RawBlock || format == RLEBlock)
+        {
+            pixels.resize(w * h);
+            if (format == RawBlock)
+            {
+                if ((size_t)length != pixels.size() * 4)
+                    return false;
+                memcpy(&pixels[0], data, length);
+            }
+            else if (!rleDecode(data, length, &pixels[0], pixels.size()))
+            {
+                return false;
+            }
+            for (int j = 0; j < h; ++j)
+                memcpy(origin + (size_t)j * width * 4, &pixels[j * w], w * 4);
+        }
+        else if (format == YUVBlock || format == YUVRLEBlock)
+        {
+            int cw = (w + 1) / 2, ch = (h + 1) / 2;
+            planes.resize(w * h + 2 * cw * ch);
+            if (format == YUVBlock)
+            {
+                if ((size_t)length != planes.size())
+                    return false;
+                memcpy(&planes[0], data, length);
+            }
+            else if (!rleDecode(data, length, &planes[0], planes.size()))
+            {
+                return false;
+            }
+            fromYUV(&planes[0], w, h, origin, width * 4);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return pos == size;
+}
@@ -0,0 +1,81 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef PARALLELRENDERING_CODEC_H
+#define PARALLELRENDERING_CODEC_H
+
+#include <string>
+#include <vector>
+
+// Compression of BGRA frames for the socket transport.
+//
+// A frame is split into square blocks. A packet holds the block size, the
+// number of blocks and for every block its index, its format, the length of
+// its data and the data. With skipUnchanged, only the blocks that differ
+// from the frame encoded before are contained, the receiver keeps the rest
+// of its image.
+//
+// RLE stores runs of equal pixels, which are frequent in rendered frames.
+// YUV converts to YUV 4:2:0 (1.5 instead of 4 bytes per pixel, lossy) and
+// stores runs of equal bytes in each plane. Blocks that would grow are
+// stored uncompressed.
+class ParallelRenderingCodec
+{
+public:
+    enum Encoding
+    {
+        Raw,
+        RLE,
+        YUV
+    };
+
+    ParallelRenderingCodec(Encoding encoding, bool skipUnchanged, int blockSize = 64);
+
+    // raw, rle or yuv, raw if unknown
+    static Encoding encodingFromString(const std::string &name);
+
+    Encoding getEncoding() const;
+
+    // encode a BGRA image
+    void encode(const unsigned char *image, int width, int height, std::vector<char> &packet);
+
+    // encode all blocks with the next frame
+    void reset();
+
+    // write the blocks of a packet to a BGRA image, false if the packet is malformed
+    static bool decode(const char *packet, size_t size, unsigned char *image, int width, int height);
+
+    // upper bound of the size of a packet of a width x height image
+    static size_t maxPacketSize(int width, int height);
+
+private:
+    enum BlockFormat
+    {
+        RawBlock,
+        RLEBlock,
+        YUVBlock,
+        YUVRLEBlock
+    };
+
+    bool blockChanged(const unsigned char *image, int x, int y, int w, int h) const;
+    void encodeBlock(const unsigned char *image, int x, int y, int w, int h, std::vector<char> &packet);
+
+    Encoding encoding;
+    bool skipUnchanged;
+    int blockSize;
+
+    // frame encoded before
+    std::vector<unsigned char> previous;
+    int width;
+    int height;
+
+    std::vector<unsigned int> block;
+    std::vector<unsigned char> planes;
+    std::vector<char> compressed;
+};
+
+#endif
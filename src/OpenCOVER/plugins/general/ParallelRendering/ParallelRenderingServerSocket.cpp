@@ -26,6 +26,27 @@
 #include <cover/coVRPluginSupport.h>
 #include <ParallelRenderingServerSocket.h>
 #include "ParallelRenderingOGLTexQuadCompositor.h"
+#include "ParallelRenderingCodec.h"
+
+// frames of clients are at most MaxFrameSize pixels wide and high
+static const int MaxFrameSize = 16384;
+
+// read size bytes from a blocking socket, false if it was closed or failed
+static bool readAll(int fd, void *data, size_t size)
+{
+    char *p = (char *)data;
+    while (size > 0)
+    {
+        ssize_t r = read(fd, p, size);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return false;
+        p += r;
+        size -= r;
+    }
+    return true;
+}
 
 int ParallelRenderingServerSocket::server_connect(int port)
 {
@@ -98,8 +119,10 @@ int ParallelRenderingServerSocket::server_connect(int port)
     return connfd;
 }
 
-ParallelRenderingServerSocket::ParallelRenderingServerSocket(int numClients, bool compositorRenders)
+ParallelRenderingServerSocket::ParallelRenderingServerSocket(int numClients, bool compositorRenders, bool encoded)
     : ParallelRenderingServer(numClients, compositorRenders)
+    , encoded(encoded)
+    , packets(numClients)
 {
 
     fd = new int[numClients];
@@ -123,7 +146,7 @@ ParallelRenderingServerSocket::~ParallelRenderingServerSocket()
 
     for (int index = startClient; index < numClients; index++)
     {
-        delete pixels[index];
+        delete[] pixels[index];
     }
 
     delete[] fd;
@@ -172,56 +195,103 @@ void ParallelRenderingServerSocket::receive()
 {
 
     int *received = new int[numClients];
+    int *expected = new int[numClients];
     for (int index = startClient; index < numClients; index++)
+    {
         received[index] = -1;
+        expected[index] = 0;
+    }
 
     fd_set socks;
-    FD_ZERO(&socks);
     bool done = false;
 
     while (!done)
     {
 
+        FD_ZERO(&socks);
         done = true;
+        int maxFd = -1;
         for (int index = startClient; index < numClients; index++)
         {
-            if (received[index] == -1 || received[index] != dimension[index].width * dimension[index].height * 4)
+            if (fd[index] >= 0 && (received[index] == -1 || received[index] != expected[index]))
             {
                 FD_SET(fd[index], &socks);
+                if (fd[index] > maxFd)
+                    maxFd = fd[index];
                 done = false;
             }
         }
+        if (done)
+            break;
 
         struct timeval timeout = { 0, 1000 };
-        int n = select(fd[numClients - 1] + 1, &socks, NULL, NULL, &timeout);
+        int n = select(maxFd + 1, &socks, NULL, NULL, &timeout);
 
         if (n > 0)
         {
             for (int index = startClient; index < numClients; index++)
             {
-                if (FD_ISSET(fd[index], &socks))
+                if (fd[index] >= 0 && FD_ISSET(fd[index], &socks))
                 {
                     if (received[index] == -1)
                     {
-                        int width, height;
-                        read(fd[index], &width, sizeof(int));
-                        read(fd[index], &height, sizeof(int));
+                        // width, height and with encoding the packet size
+                        int header[3] = { 0, 0, 0 };
+                        if (!readAll(fd[index], header, (encoded ? 3 : 2) * sizeof(int)))
+                        {
+                            dropClient(index, "connection lost");
+                            continue;
+                        }
+                        int width = header[0];
+                        int height = header[1];
+                        if (width <= 0 || height <= 0 || width > MaxFrameSize || height > MaxFrameSize)
+                        {
+                            dropClient(index, "invalid frame size");
+                            continue;
+                        }
+                        if (encoded && (header[2] <= 0 || (size_t)header[2] > ParallelRenderingCodec::maxPacketSize(width, height)))
+                        {
+                            dropClient(index, "invalid packet size");
+                            continue;
+                        }
                         if (dimension[index].width != width || dimension[index].height != height)
                         {
                             dimension[index].width = width;
                             dimension[index].height = height;
 
-                            delete pixels[index];
+                            delete[] pixels[index];
                             pixels[index] = new unsigned char[width * height * 4];
+                            memset(pixels[index], 0, width * height * 4);
+                        }
+                        if (encoded)
+                        {
+                            expected[index] = header[2];
+                            packets[index].resize(header[2]);
+                        }
+                        else
+                        {
+                            expected[index] = width * height * 4;
                         }
                         received[index] = 0;
                     }
                     else
                     {
-                        int r = read(fd[index], ((char *)pixels[index]) + received[index],
-                                     dimension[index].width * dimension[index].height * 4 - received[index]);
-                        received[index] += r;
+                        char *data = encoded ? &packets[index][0] : (char *)pixels[index];
+                        int r = read(fd[index], data + received[index], expected[index] - received[index]);
+                        if (r > 0)
+                            received[index] += r;
+                        else if (r == 0 || errno != EINTR)
+                        {
+                            dropClient(index, "connection lost");
+                            continue;
+                        }
                     }
+
+                    // unchanged blocks are kept from the last frame
+                    if (encoded && received[index] == expected[index]
+                        && !ParallelRenderingCodec::decode(&packets[index][0], packets[index].size(), pixels[index],
+                                                           dimension[index].width, dimension[index].height))
+                        dropClient(index, "invalid packet");
                 }
             }
         }
@@ -229,11 +299,20 @@ void ParallelRenderingServerSocket::receive()
             perror("select");
     }
 
-    delete received;
+    delete[] received;
+    delete[] expected;
 
     renderLock.unlock();
 }
 
+void ParallelRenderingServerSocket::dropClient(int index, const char *reason)
+{
+    // the image received last from the client stays on screen
+    cerr << "ParallelRenderingServerSocket::receive err: " << reason << ", dropping client " << index << endl;
+    close(fd[index]);
+    fd[index] = -1;
+}
+
 void ParallelRenderingServerSocket::render()
 {
 
@@ -10,11 +10,14 @@
 
 #include "ParallelRenderingServer.h"
 
+#include <vector>
+
 class ParallelRenderingServerSocket : public ParallelRenderingServer
 {
 
 public:
-    ParallelRenderingServerSocket(int numClients, bool compositorRenders);
+    // encoded: clients send packets of ParallelRenderingCodec instead of raw frames
+    ParallelRenderingServerSocket(int numClients, bool compositorRenders, bool encoded = false);
     virtual ~ParallelRenderingServerSocket();
 
     virtual void run();
@@ -24,8 +27,13 @@ public:
 protected:
     int server_connect(int port);
     void receive();
+    // close the connection to a client that sent invalid data or disconnected
+    void dropClient(int index, const char *reason);
     int *fd;
 
+    bool encoded;
+    std::vector<std::vector<char> > packets;
+
     OpenThreads::Mutex lock;
     OpenThreads::Mutex renderLock;
 };
@@ -72,7 +72,12 @@ static FileHandler handlers[] = {
       PointCloudPlugin::loadPTS,
       PointCloudPlugin::loadPTS,
       PointCloudPlugin::unloadPTS,
-      "c2m" }
+      "c2m" },
+    { NULL,
+      PointCloudPlugin::loadPTS,
+      PointCloudPlugin::loadPTS,
+      PointCloudPlugin::unloadPTS,
+      "ptso" }
 };
 
 bool PointCloudPlugin::init()
@@ -89,6 +94,7 @@ bool PointCloudPlugin::init()
     coVRFileManager::instance()->registerFileHandler(&handlers[2]);
     coVRFileManager::instance()->registerFileHandler(&handlers[3]);
     coVRFileManager::instance()->registerFileHandler(&handlers[4]);
+    coVRFileManager::instance()->registerFileHandler(&handlers[5]);
     //Create main menu button
     imanPluginInstanceMenuItem = new coSubMenuItem("Point Model Plugin");
     imanPluginInstanceMenuItem->setMenuListener(this);
@@ -215,7 +221,23 @@ void PointCloudPlugin::createGeodes(Group *parent, string &filename)
 {
     opencover::coVRShader *pointShader = opencover::coVRShaderList::instance()->get("Points");
     const char *cfile = filename.c_str();
-    if ((strcasecmp(cfile + strlen(cfile) - 3, "pts") == 0) || (strcasecmp(cfile + strlen(cfile) - 3, "ptx") == 0) || (strcasecmp(cfile + strlen(cfile) - 3, "xyz") == 0))
+    if (strlen(cfile) > 4 && strcasecmp(cfile + strlen(cfile) - 4, "ptso") == 0)
+    {
+        // level of detail octree: memory mapped, nodes are streamed in preFrame
+        PointCloudOctree *octree = new PointCloudOctree(filename, parent, pointShader);
+        if (!octree->isValid())
+        {
+            delete octree;
+            cout << "Error opening file" << endl;
+            return;
+        }
+        fileInfo fi;
+        fi.filename = filename;
+        fi.octree = octree;
+        files.push_back(fi);
+        return;
+    }
+    else if ((strcasecmp(cfile + strlen(cfile) - 3, "pts") == 0) || (strcasecmp(cfile + strlen(cfile) - 3, "ptx") == 0) || (strcasecmp(cfile + strlen(cfile) - 3, "xyz") == 0))
     {
         intensityOnly = false;
         intColor = false;
@@ -515,6 +537,7 @@ int PointCloudPlugin::unloadFile(std::string filename)
                     nit->node->getParent(0)->removeChild(nit->node);
             }
             fit->nodes.clear();
+            delete fit->octree;
             // remove the poinset data
             if (fit->pointSet)
             {
@@ -550,6 +573,7 @@ void PointCloudPlugin::clearData()
                 nit->node->getParent(0)->removeChild(nit->node);
         }
         fit->nodes.clear();
+        delete fit->octree;
         // remove the poinset data
         if (fit->pointSet)
         {
@@ -607,6 +631,11 @@ void PointCloudPlugin::preFrame()
 
     for (std::list<fileInfo>::iterator fit = files.begin(); fit != files.end(); fit++)
     {
+        if (fit->octree)
+        {
+            fit->octree->update();
+            continue;
+        }
         //TODO calc distance correctly
         for (std::list<nodeInfo>::iterator nit = fit->nodes.begin(); nit != fit->nodes.end(); nit++)
         {
@@ -37,6 +37,7 @@
 #include "Points.h"
 //#include "PointCloudDrawable.h"
 #include "PointCloudGeometry.h"
+#include "PointCloudOctree.h"
 
 namespace vrui
 {
@@ -60,10 +61,17 @@ public:
 class fileInfo
 {
 public:
+    fileInfo()
+        : pointSetSize(0)
+        , pointSet(NULL)
+        , octree(NULL)
+    {
+    }
     std::string filename;
     std::list<nodeInfo> nodes;
     int pointSetSize;
     PointSet *pointSet;
+    PointCloudOctree *octree; // level of detail files (.ptso) are streamed
 };
 
 /** Plugin
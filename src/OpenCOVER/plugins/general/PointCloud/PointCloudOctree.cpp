@@ -0,0 +1,453 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "PointCloudOctree.h"
+#include "PointCloudGeometry.h"
+
+#include <cover/coVRPluginSupport.h>
+#include <cover/coVRConfig.h>
+#include <cover/coVRShader.h>
+#include <config/CoviseConfig.h>
+#include <osg/Matrix>
+#include <osg/Transform>
+
+#include <iostream>
+#include <queue>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace osg;
+using namespace std;
+using namespace opencover;
+using covise::coCoviseConfig;
+
+PointCloudOctree::PointCloudOctree(const std::string &filename, osg::Group *parent, coVRShader *shader)
+    : data_(NULL)
+    , size_(0)
+#ifdef _WIN32
+    , file_(INVALID_HANDLE_VALUE)
+    , mapping_(NULL)
+#else
+    , fd_(-1)
+#endif
+    , header_(NULL)
+    , nodes_(NULL)
+    , shader_(shader)
+    , frame_(0)
+    , cachedPoints_(0)
+    , running_(true)
+{
+    pointBudget_ = coCoviseConfig::getInt("COVER.Plugin.PointCloud.PointBudget", 5000000);
+    pixelError_ = coCoviseConfig::getFloat("COVER.Plugin.PointCloud.PixelError", 2.0);
+
+    mapFile(filename);
+    if (!nodes_)
+        return;
+
+    Node empty;
+    empty.state = UNLOADED;
+    empty.pointSet = NULL;
+    empty.lastUsed = -1;
+    state_.resize(header_->numNodes, empty);
+
+    group_ = new osg::Group;
+    group_->setName(filename);
+    parent->addChild(group_.get());
+
+    start();
+}
+
+PointCloudOctree::~PointCloudOctree()
+{
+    if (isRunning())
+    {
+        mutex_.lock();
+        running_ = false;
+        requests_.clear();
+        condition_.signal();
+        mutex_.unlock();
+        join();
+    }
+    for (size_t i = 0; i < loaded_.size(); ++i)
+    {
+        delete[] loaded_[i].second->points;
+        delete[] loaded_[i].second->colors;
+        delete loaded_[i].second;
+    }
+    for (size_t i = 0; i < state_.size(); ++i)
+        freeNode(i);
+    if (group_.valid())
+    {
+        while (group_->getNumParents() > 0)
+            group_->getParent(0)->removeChild(group_.get());
+    }
+    unmapFile();
+}
+
+void PointCloudOctree::mapFile(const std::string &filename)
+{
+#ifdef _WIN32
+    file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        cerr << "PointCloudOctree: could not open " << filename << endl;
+        return;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file_, &size);
+    size_ = size.QuadPart;
+    mapping_ = CreateFileMapping(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_)
+        data_ = (const char *)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        cerr << "PointCloudOctree: could not open " << filename << endl;
+        return;
+    }
+    struct stat info;
+    if (fstat(fd_, &info) == 0)
+    {
+        size_ = info.st_size;
+        void *addr = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (addr != MAP_FAILED)
+        {
+            data_ = (const char *)addr;
+            // nodes are requested in screen space order, not sequentially
+            madvise(addr, size_, MADV_RANDOM);
+        }
+    }
+#endif
+    if (!data_)
+    {
+        cerr << "PointCloudOctree: could not map " << filename << endl;
+        return;
+    }
+
+    header_ = (const OctreeFileHeader *)data_;
+    if (size_ < sizeof(OctreeFileHeader)
+        || memcmp(header_->magic, POINT_OCTREE_MAGIC, 8) != 0
+        || header_->numNodes == 0
+        || header_->nodeTableOffset + header_->numNodes * sizeof(OctreeNodeRecord) > size_)
+    {
+        cerr << "PointCloudOctree: " << filename << " is not a valid octree file" << endl;
+        header_ = NULL;
+        return;
+    }
+    nodes_ = (const OctreeNodeRecord *)(data_ + header_->nodeTableOffset);
+    cerr << "PointCloudOctree: " << header_->numPoints << " points in "
+         << header_->numNodes << " nodes" << endl;
+}
+
+void PointCloudOctree::unmapFile()
+{
+#ifdef _WIN32
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapping_)
+        CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE)
+        CloseHandle(file_);
+#else
+    if (data_)
+        munmap((void *)data_, size_);
+    if (fd_ >= 0)
+        close(fd_);
+#endif
+    data_ = NULL;
+    header_ = NULL;
+    nodes_ = NULL;
+}
+
+// runs on the loader thread: the page faults happen here and not in the draw thread
+PointSet *PointCloudOctree::readNode(int node) const
+{
+    const OctreeNodeRecord &rec = nodes_[node];
+    PointSet *set = new PointSet;
+    set->size = rec.numPoints;
+    set->points = new ::Point[rec.numPoints];
+    set->colors = new Color[rec.numPoints];
+    set->xmin = rec.min[0];
+    set->ymin = rec.min[1];
+    set->zmin = rec.min[2];
+    set->xmax = rec.min[0] + rec.size;
+    set->ymax = rec.min[1] + rec.size;
+    set->zmax = rec.min[2] + rec.size;
+    if (rec.dataOffset + rec.numPoints * sizeof(OctreePoint) > size_)
+    {
+        set->size = 0;
+        return set;
+    }
+    const OctreePoint *src = (const OctreePoint *)(data_ + rec.dataOffset);
+    for (uint32_t i = 0; i < rec.numPoints; ++i)
+    {
+        set->points[i].x = src[i].x;
+        set->points[i].y = src[i].y;
+        set->points[i].z = src[i].z;
+        set->colors[i].r = (src[i].rgba & 0xff) / 255.0;
+        set->colors[i].g = ((src[i].rgba >> 8) & 0xff) / 255.0;
+        set->colors[i].b = ((src[i].rgba >> 16) & 0xff) / 255.0;
+    }
+    return set;
+}
+
+void PointCloudOctree::run()
+{
+    for (;;)
+    {
+        mutex_.lock();
+        while (running_ && requests_.empty())
+            condition_.wait(&mutex_);
+        if (!running_)
+        {
+            mutex_.unlock();
+            return;
+        }
+        int node = requests_.front();
+        requests_.pop_front();
+        mutex_.unlock();
+
+        PointSet *set = readNode(node);
+
+        mutex_.lock();
+        loaded_.push_back(std::make_pair(node, set));
+        mutex_.unlock();
+    }
+}
+
+void PointCloudOctree::freeNode(int node)
+{
+    Node &n = state_[node];
+    if (n.geode.valid())
+    {
+        if (n.state == ATTACHED)
+            group_->removeChild(n.geode.get());
+        n.geode = NULL;
+    }
+    if (n.pointSet)
+    {
+        cachedPoints_ -= n.pointSet->size;
+        delete[] n.pointSet->points;
+        delete[] n.pointSet->colors;
+        delete n.pointSet;
+        n.pointSet = NULL;
+    }
+    n.state = UNLOADED;
+}
+
+// a node is culled only if it is outside of the frustums of all channels and eyes
+bool PointCloudOctree::isVisible(const OctreeNodeRecord &rec, const std::vector<osg::Polytope> &frustums) const
+{
+    if (frustums.empty())
+        return true;
+    osg::BoundingBox box(rec.min[0], rec.min[1], rec.min[2],
+                         rec.min[0] + rec.size, rec.min[1] + rec.size, rec.min[2] + rec.size);
+    for (size_t i = 0; i < frustums.size(); ++i)
+    {
+        if (frustums[i].contains(box))
+            return true;
+    }
+    return false;
+}
+
+namespace
+{
+struct Candidate
+{
+    float priority;
+    int node;
+    bool operator<(const Candidate &other) const
+    {
+        return priority < other.priority;
+    }
+};
+}
+
+void PointCloudOctree::update()
+{
+    if (!isValid())
+        return;
+    ++frame_;
+
+    // take over what the loader thread has read
+    std::vector<std::pair<int, PointSet *> > loaded;
+    mutex_.lock();
+    loaded.swap(loaded_);
+    mutex_.unlock();
+    for (size_t i = 0; i < loaded.size(); ++i)
+    {
+        Node &n = state_[loaded[i].first];
+        if (n.pointSet)
+        {
+            // requested again while the loader was reading it
+            delete[] loaded[i].second->points;
+            delete[] loaded[i].second->colors;
+            delete loaded[i].second;
+            continue;
+        }
+        n.pointSet = loaded[i].second;
+        n.state = LOADED;
+        cached_.push_back(loaded[i].first);
+        cachedPoints_ += n.pointSet->size;
+        if (n.pointSet->size > 0)
+        {
+            PointCloudGeometry *drawable = new PointCloudGeometry(n.pointSet);
+            drawable->changeLod(1.0);
+            n.geode = new Geode();
+            n.geode->addDrawable(drawable);
+            if (shader_)
+                shader_->apply(n.geode.get(), drawable);
+        }
+    }
+
+    // viewer and screen in object coordinates
+    osg::NodePathList paths = group_->getParentalNodePaths();
+    if (paths.empty())
+        return;
+    osg::Matrix localToWorld = osg::computeLocalToWorld(paths[0]);
+    osg::Vec3 viewerWorld = cover->getViewerMat().getTrans();
+    osg::Vec3 viewer = osg::Matrix::inverse(localToWorld).preMult(viewerWorld);
+    float scale = localToWorld.getScale()[0];
+
+    float pixelsPerUnit = 1.0;
+    const coVRConfig *config = coVRConfig::instance();
+    if (!config->screens.empty() && !config->windows.empty() && config->screens[0].vsize > 0)
+    {
+        float screenDistance = (viewerWorld - config->screens[0].xyz).length();
+        pixelsPerUnit = config->windows[0].sy / config->screens[0].vsize * screenDistance;
+    }
+
+    // view frustums in object coordinates
+    std::vector<osg::Polytope> frustums;
+    for (size_t i = 0; i < config->channels.size(); ++i)
+    {
+        const channelStruct &chan = config->channels[i];
+        osg::Polytope frustum;
+        frustum.setToUnitFrustum();
+        frustum.transformProvidingInverse(localToWorld * chan.leftView * chan.leftProj);
+        frustums.push_back(frustum);
+        if (chan.rightView != chan.leftView || chan.rightProj != chan.leftProj)
+        {
+            frustum.setToUnitFrustum();
+            frustum.transformProvidingInverse(localToWorld * chan.rightView * chan.rightProj);
+            frustums.push_back(frustum);
+        }
+    }
+
+    // refine the nodes with the largest projected point spacing first,
+    // subtrees that cannot be seen are not entered
+    std::priority_queue<Candidate> candidates;
+    std::vector<int> selected;
+    Candidate root;
+    root.priority = FLT_MAX;
+    root.node = 0;
+    candidates.push(root);
+    size_t numPoints = 0;
+    while (!candidates.empty())
+    {
+        Candidate c = candidates.top();
+        candidates.pop();
+        const OctreeNodeRecord &rec = nodes_[c.node];
+        if (numPoints + rec.numPoints > pointBudget_)
+            break;
+        numPoints += rec.numPoints;
+        selected.push_back(c.node);
+        if (c.priority < pixelError_)
+            continue;
+        for (int i = 0; i < 8; ++i)
+        {
+            int child = rec.children[i];
+            if (child < 0)
+                continue;
+            const OctreeNodeRecord &crec = nodes_[child];
+            if (!isVisible(crec, frustums))
+                continue;
+            float half = 0.5f * crec.size;
+            osg::Vec3 center(crec.min[0] + half, crec.min[1] + half, crec.min[2] + half);
+            float distance = (center - viewer).length() - half * 1.7320508f;
+            distance = std::max(distance, 0.01f * crec.size) * scale;
+            Candidate cc;
+            cc.priority = crec.spacing * scale / distance * pixelsPerUnit;
+            cc.node = child;
+            candidates.push(cc);
+        }
+    }
+
+    // attach what is available, request the rest in priority order
+    std::deque<int> requests;
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+        Node &n = state_[selected[i]];
+        n.lastUsed = frame_;
+        if (n.state == UNLOADED || n.state == QUEUED)
+        {
+            n.state = QUEUED;
+            requests.push_back(selected[i]);
+        }
+        else if (n.state == LOADED)
+        {
+            if (n.geode.valid())
+                group_->addChild(n.geode.get());
+            n.state = ATTACHED;
+        }
+    }
+
+    // detach the nodes of the previous frame that are no longer used
+    for (size_t i = 0; i < selected_.size(); ++i)
+    {
+        Node &n = state_[selected_[i]];
+        if (n.lastUsed == frame_)
+            continue;
+        if (n.state == ATTACHED)
+        {
+            if (n.geode.valid())
+                group_->removeChild(n.geode.get());
+            n.state = LOADED;
+            cached_.push_back(selected_[i]);
+        }
+        else if (n.state == QUEUED)
+        {
+            n.state = UNLOADED;
+        }
+    }
+    selected_.swap(selected);
+
+    // keep up to twice the budget in memory
+    std::vector<std::pair<int, int> > cached;
+    for (size_t i = 0; i < cached_.size(); ++i)
+    {
+        const Node &n = state_[cached_[i]];
+        if (n.state == LOADED && n.lastUsed != frame_)
+            cached.push_back(std::make_pair(n.lastUsed, cached_[i]));
+    }
+    size_t freed = 0;
+    if (cachedPoints_ > 2 * pointBudget_)
+    {
+        std::sort(cached.begin(), cached.end());
+        for (; freed < cached.size() && cachedPoints_ > 2 * pointBudget_; ++freed)
+            freeNode(cached[freed].second);
+    }
+    cached_.clear();
+    for (size_t i = freed; i < cached.size(); ++i)
+        cached_.push_back(cached[i].second);
+
+    mutex_.lock();
+    requests_.swap(requests);
+    condition_.signal();
+    mutex_.unlock();
+}
@@ -0,0 +1,106 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef _POINTCLOUD_OCTREE_H_
+#define _POINTCLOUD_OCTREE_H_
+
+#include <osg/Group>
+#include <osg/Geode>
+#include <osg/ref_ptr>
+#include <osg/Polytope>
+#include <OpenThreads/Thread>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/Condition>
+
+#include <string>
+#include <vector>
+#include <deque>
+
+#include "Points.h"
+#include "PointOctree.h"
+
+namespace opencover
+{
+class coVRShader;
+}
+
+/** Level of detail rendering of a memory mapped .ptso octree
+ *
+ *  Every frame the nodes are selected by their screen space point spacing
+ *  under a point budget, missing nodes are read on a loader thread and
+ *  attached in a later frame. The selection descends from the root and
+ *  skips subtrees outside of all view frustums, only the nodes selected in
+ *  the previous frame and the cached nodes are visited besides.
+ */
+class PointCloudOctree : public OpenThreads::Thread
+{
+public:
+    PointCloudOctree(const std::string &filename, osg::Group *parent, opencover::coVRShader *shader);
+    virtual ~PointCloudOctree();
+
+    bool isValid() const
+    {
+        return nodes_ != NULL;
+    }
+
+    /// select the nodes to be drawn, called once per frame from preFrame
+    void update();
+
+    /// loader thread
+    virtual void run();
+
+private:
+    enum NodeState
+    {
+        UNLOADED,
+        QUEUED,
+        LOADED,
+        ATTACHED
+    };
+    struct Node
+    {
+        NodeState state;
+        PointSet *pointSet;
+        osg::ref_ptr<osg::Geode> geode;
+        int lastUsed;
+    };
+
+    void mapFile(const std::string &filename);
+    void unmapFile();
+    PointSet *readNode(int node) const;
+    void freeNode(int node);
+    bool isVisible(const OctreeNodeRecord &rec, const std::vector<osg::Polytope> &frustums) const;
+
+    const char *data_;
+    size_t size_;
+#ifdef _WIN32
+    void *file_;
+    void *mapping_;
+#else
+    int fd_;
+#endif
+    const OctreeFileHeader *header_;
+    const OctreeNodeRecord *nodes_;
+
+    std::vector<Node> state_;
+    std::vector<int> selected_; // nodes of the previous frame, QUEUED or ATTACHED
+    std::vector<int> cached_; // LOADED nodes that are not attached
+    osg::ref_ptr<osg::Group> group_;
+    opencover::coVRShader *shader_;
+    int frame_;
+    size_t pointBudget_;
+    size_t cachedPoints_;
+    float pixelError_;
+
+    // shared with the loader thread
+    OpenThreads::Mutex mutex_;
+    OpenThreads::Condition condition_;
+    std::deque<int> requests_;
+    std::vector<std::pair<int, PointSet *> > loaded_;
+    bool running_;
+};
+#endif
@@ -0,0 +1,556 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef _POINT_OCTREE_H_
+#define _POINT_OCTREE_H_
+
+// On-disk layout of the level of detail point cloud format (.ptso)
+//
+//   OctreeFileHeader
+//   OctreePoint[numPoints]       points of all nodes, node after node
+//   OctreeNodeRecord[numNodes]   node table, node 0 is the root
+//
+// Every node stores a random subset of the points inside its cube which
+// is not stored in any of its ancestors, so drawing a node adds detail
+// to what its parents show already. The file is meant to be memory
+// mapped, all records are naturally aligned and stored little endian.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#define POINT_OCTREE_MAGIC "PTSOCT01"
+
+struct OctreeFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numNodes;
+    uint64_t numPoints;
+    float min[3]; // bounding box of all points
+    float max[3];
+    uint64_t nodeTableOffset;
+};
+
+struct OctreeNodeRecord
+{
+    float min[3]; // corner of the node cube
+    float size; // edge length of the node cube
+    float spacing; // mean distance of the node's points
+    uint32_t numPoints;
+    uint64_t dataOffset; // file offset of the first OctreePoint
+    int32_t children[8]; // index into the node table, -1: no child
+};
+
+struct OctreePoint
+{
+    float x;
+    float y;
+    float z;
+    uint32_t rgba;
+};
+
+// builds the octree out of core: added points are spread randomly over
+// temporary bucket files next to the output file, so that reading them
+// bucket after bucket, each shuffled in memory, yields the points in random
+// order. This stream is sorted into the upper levels of the tree, and the
+// points below go to one temporary file per cube some levels further down.
+// Cubes with up to maxPointsInMemory points are built in memory, larger ones
+// are streamed again. Apart from the buckets, at most maxPointsInMemory
+// points and the points of the upper nodes are held in memory.
+class PointOctreeBuilder
+{
+public:
+    enum
+    {
+        MAX_DEPTH = 24,
+        NUM_BUCKETS = 256, // shuffle buckets, each has to fit into memory
+        STREAM_LEVELS = 3 // levels of the tree sorted into per streaming pass
+    };
+
+    PointOctreeBuilder(const char *filename, int maxPointsPerNode, size_t maxPointsInMemory = (size_t)1 << 24)
+        : filename_(filename)
+        , maxPoints_(maxPointsPerNode > 0 ? maxPointsPerNode : 1)
+        , memPoints_(std::max(maxPointsInMemory, (size_t)maxPoints_))
+        , random_(88172645463325252ULL)
+        , numPoints_(0)
+        , numTemp_(0)
+        , out_(NULL)
+        , outPos_(0)
+        , ok_(true)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            min_[i] = FLT_MAX;
+            max_[i] = -FLT_MAX;
+        }
+    }
+
+    ~PointOctreeBuilder()
+    {
+        for (size_t b = 0; b < buckets_.size(); ++b)
+        {
+            if (buckets_[b])
+                fclose(buckets_[b]);
+            remove(bucketNames_[b].c_str());
+        }
+        if (out_)
+            fclose(out_);
+    }
+
+    void add(const OctreePoint &p)
+    {
+        if (buckets_.empty())
+        {
+            for (int b = 0; b < NUM_BUCKETS; ++b)
+            {
+                bucketNames_.push_back(tempName());
+                buckets_.push_back(fopen(bucketNames_.back().c_str(), "w+b"));
+                if (!buckets_.back())
+                {
+                    std::cerr << "could not create " << bucketNames_.back() << std::endl;
+                    ok_ = false;
+                }
+            }
+        }
+        const float c[3] = { p.x, p.y, p.z };
+        for (int i = 0; i < 3; ++i)
+        {
+            if (c[i] < min_[i])
+                min_[i] = c[i];
+            if (c[i] > max_[i])
+                max_[i] = c[i];
+        }
+        FILE *bucket = buckets_[nextRandom() % NUM_BUCKETS];
+        if (!bucket || fwrite(&p, sizeof(p), 1, bucket) != 1)
+            ok_ = false;
+        ++numPoints_;
+    }
+
+    // adds points with members x, y, z and rgba
+    template <class P>
+    void add(const std::vector<P> &points)
+    {
+        for (size_t n = 0; n < points.size(); ++n)
+        {
+            OctreePoint p;
+            p.x = points[n].x;
+            p.y = points[n].y;
+            p.z = points[n].z;
+            p.rgba = points[n].rgba;
+            add(p);
+        }
+    }
+
+    bool write()
+    {
+        if (numPoints_ == 0)
+        {
+            std::cerr << "no points to write" << std::endl;
+            return false;
+        }
+        if (!ok_)
+        {
+            std::cerr << "could not store the points in temporary files" << std::endl;
+            return false;
+        }
+        for (size_t b = 0; b < buckets_.size(); ++b)
+        {
+            fclose(buckets_[b]);
+            buckets_[b] = NULL;
+        }
+
+        OctreeFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, POINT_OCTREE_MAGIC, 8);
+        header.version = 1;
+        header.numPoints = numPoints_;
+        memcpy(header.min, min_, sizeof(header.min));
+        memcpy(header.max, max_, sizeof(header.max));
+        float size = 0.0f;
+        for (int i = 0; i < 3; ++i)
+            size = std::max(size, max_[i] - min_[i]);
+        // points on the upper faces must fall inside the root cube
+        size *= 1.0001f;
+        if (size <= 0.0f)
+            size = 1.0f;
+
+        out_ = fopen(filename_.c_str(), "wb");
+        if (!out_)
+        {
+            std::cerr << "could not open " << filename_ << std::endl;
+            return false;
+        }
+        // the header is written again when the node table is complete
+        if (fwrite(&header, sizeof(header), 1, out_) != 1)
+            ok_ = false;
+        outPos_ = sizeof(header);
+        nodes_.clear();
+
+        Cube root;
+        memcpy(root.min, min_, sizeof(root.min));
+        root.size = size;
+        root.depth = 0;
+        root.count = numPoints_;
+        root.parent = -1;
+        root.slot = 0;
+        buildCube(root);
+
+        header.numNodes = nodes_.size();
+        header.nodeTableOffset = outPos_;
+        if (fwrite(&nodes_[0], sizeof(OctreeNodeRecord), nodes_.size(), out_) != nodes_.size())
+            ok_ = false;
+        if (fseek(out_, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, out_) != 1)
+            ok_ = false;
+        if (fclose(out_) != 0)
+            ok_ = false;
+        out_ = NULL;
+        if (!ok_)
+        {
+            std::cerr << "could not write " << filename_ << std::endl;
+            return false;
+        }
+        std::cout << "Octree with " << nodes_.size() << " nodes written" << std::endl;
+        return true;
+    }
+
+private:
+    // a cube whose points are in the shuffle buckets (root) or in a file
+    struct Cube
+    {
+        float min[3];
+        float size;
+        int depth;
+        uint64_t count;
+        int parent; // node of the parent, -1 for the root
+        int slot; // child slot in the parent node
+        std::string file;
+    };
+
+    // a node of the levels sorted into by a streaming pass
+    struct StreamNode
+    {
+        int node;
+        int depth;
+        float min[3];
+        float size;
+        std::vector<OctreePoint> points;
+        int children[8]; // StreamNode, -1: none
+        int cubes[8]; // Cube below the streamed levels, -1: none
+    };
+
+    std::string filename_;
+    size_t maxPoints_;
+    size_t memPoints_;
+    uint64_t random_;
+    uint64_t numPoints_;
+    int numTemp_;
+    float min_[3], max_[3];
+    std::vector<FILE *> buckets_;
+    std::vector<std::string> bucketNames_;
+    std::vector<OctreeNodeRecord> nodes_;
+    FILE *out_;
+    uint64_t outPos_;
+    bool ok_;
+
+    uint64_t nextRandom()
+    {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        return random_;
+    }
+
+    std::string tempName()
+    {
+        char suffix[32];
+        sprintf(suffix, ".tmp%d", numTemp_++);
+        return filename_ + suffix;
+    }
+
+    void shuffle(std::vector<OctreePoint> &points)
+    {
+        for (size_t n = points.size(); n > 1; --n)
+            std::swap(points[n - 1], points[nextRandom() % n]);
+    }
+
+    // reads a shuffle bucket or the next chunk of a cube file, false at the end
+    bool readChunk(const Cube &cube, FILE *&file, size_t &bucket, std::vector<OctreePoint> &points)
+    {
+        points.clear();
+        if (cube.parent >= 0)
+        {
+            points.resize(std::min(memPoints_, (size_t)1 << 20));
+            points.resize(fread(&points[0], sizeof(OctreePoint), points.size(), file));
+            return !points.empty();
+        }
+        while (points.empty() && bucket < bucketNames_.size())
+        {
+            file = fopen(bucketNames_[bucket].c_str(), "rb");
+            if (file)
+            {
+                fseek(file, 0, SEEK_END);
+                points.resize(ftell(file) / sizeof(OctreePoint));
+                fseek(file, 0, SEEK_SET);
+                if (!points.empty() && fread(&points[0], sizeof(OctreePoint), points.size(), file) != points.size())
+                    ok_ = false;
+                fclose(file);
+                file = NULL;
+            }
+            remove(bucketNames_[bucket].c_str());
+            ++bucket;
+            shuffle(points);
+        }
+        return !points.empty();
+    }
+
+    int newNode(const float *min, float size)
+    {
+        OctreeNodeRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        memcpy(rec.min, min, sizeof(rec.min));
+        rec.size = size;
+        for (int c = 0; c < 8; ++c)
+            rec.children[c] = -1;
+        nodes_.push_back(rec);
+        return nodes_.size() - 1;
+    }
+
+    void writePoints(const OctreePoint *points, size_t count)
+    {
+        if (count > 0 && fwrite(points, sizeof(OctreePoint), count, out_) != count)
+            ok_ = false;
+        outPos_ += count * sizeof(OctreePoint);
+    }
+
+    static int octant(const OctreePoint &p, const float *min, float half)
+    {
+        return (p.x >= min[0] + half ? 4 : 0) | (p.y >= min[1] + half ? 2 : 0) | (p.z >= min[2] + half ? 1 : 0);
+    }
+
+    static void childMin(const float *min, float half, int c, float *result)
+    {
+        result[0] = min[0] + ((c & 4) ? half : 0.0f);
+        result[1] = min[1] + ((c & 2) ? half : 0.0f);
+        result[2] = min[2] + ((c & 1) ? half : 0.0f);
+    }
+
+    // builds the subtree of a cube, its points arrive in random order
+    void buildCube(const Cube &cube)
+    {
+        FILE *file = NULL;
+        if (cube.parent >= 0)
+        {
+            file = fopen(cube.file.c_str(), "rb");
+            if (!file)
+            {
+                std::cerr << "could not open " << cube.file << std::endl;
+                ok_ = false;
+                return;
+            }
+        }
+        size_t bucket = 0;
+        std::vector<OctreePoint> points;
+
+        int node = -1;
+        if (cube.count <= memPoints_)
+        {
+            std::vector<OctreePoint> chunk;
+            while (readChunk(cube, file, bucket, chunk))
+                points.insert(points.end(), chunk.begin(), chunk.end());
+            if (cube.parent < 0)
+                shuffle(points);
+            node = buildInMemory(points, cube.min, cube.size, cube.depth);
+        }
+        else
+        {
+            std::vector<StreamNode> stream(1);
+            std::vector<Cube> cubes;
+            std::vector<FILE *> cubeFiles;
+            initStreamNode(stream[0], cube.min, cube.size, cube.depth);
+            while (readChunk(cube, file, bucket, points))
+            {
+                for (size_t n = 0; n < points.size(); ++n)
+                    insert(points[n], cube.depth, stream, cubes, cubeFiles);
+            }
+            for (size_t c = 0; c < cubeFiles.size(); ++c)
+            {
+                if (fclose(cubeFiles[c]) != 0)
+                    ok_ = false;
+            }
+            node = stream[0].node;
+
+            // the streamed nodes are complete, the cubes below are built one after the other
+            for (size_t s = 0; s < stream.size(); ++s)
+            {
+                OctreeNodeRecord &rec = nodes_[stream[s].node];
+                rec.numPoints = stream[s].points.size();
+                rec.spacing = rec.size / sqrtf((float)rec.numPoints);
+                rec.dataOffset = outPos_;
+                writePoints(&stream[s].points[0], stream[s].points.size());
+                std::vector<OctreePoint>().swap(stream[s].points);
+            }
+            for (size_t c = 0; c < cubes.size(); ++c)
+            {
+                buildCube(cubes[c]);
+                remove(cubes[c].file.c_str());
+            }
+        }
+        if (file)
+            fclose(file);
+        if (cube.parent >= 0)
+            nodes_[cube.parent].children[cube.slot] = node;
+    }
+
+    void initStreamNode(StreamNode &s, const float *min, float size, int depth)
+    {
+        s.node = newNode(min, size);
+        s.depth = depth;
+        memcpy(s.min, min, sizeof(s.min));
+        s.size = size;
+        for (int c = 0; c < 8; ++c)
+        {
+            s.children[c] = -1;
+            s.cubes[c] = -1;
+        }
+    }
+
+    // the first points reaching a node stay there, the others move on to the children
+    void insert(const OctreePoint &p, int baseDepth, std::vector<StreamNode> &stream,
+                std::vector<Cube> &cubes, std::vector<FILE *> &cubeFiles)
+    {
+        int s = 0;
+        for (;;)
+        {
+            StreamNode &sn = stream[s];
+            if (sn.points.size() < maxPoints_ || sn.depth >= MAX_DEPTH)
+            {
+                sn.points.push_back(p);
+                return;
+            }
+            const float half = 0.5f * sn.size;
+            const int c = octant(p, sn.min, half);
+            if (sn.depth + 1 < baseDepth + STREAM_LEVELS)
+            {
+                if (sn.children[c] < 0)
+                {
+                    float min[3];
+                    childMin(sn.min, half, c, min);
+                    StreamNode child;
+                    initStreamNode(child, min, half, sn.depth + 1);
+                    nodes_[sn.node].children[c] = child.node;
+                    sn.children[c] = stream.size();
+                    stream.push_back(child); // invalidates sn
+                }
+                s = stream[s].children[c];
+                continue;
+            }
+
+            if (sn.cubes[c] < 0)
+            {
+                Cube cube;
+                childMin(sn.min, half, c, cube.min);
+                cube.size = half;
+                cube.depth = sn.depth + 1;
+                cube.count = 0;
+                cube.parent = sn.node;
+                cube.slot = c;
+                cube.file = tempName();
+                sn.cubes[c] = cubes.size();
+                cubes.push_back(cube);
+                cubeFiles.push_back(fopen(cube.file.c_str(), "wb"));
+                if (!cubeFiles.back())
+                {
+                    std::cerr << "could not create " << cube.file << std::endl;
+                    ok_ = false;
+                }
+            }
+            const int index = sn.cubes[c];
+            ++cubes[index].count;
+            if (!cubeFiles[index] || fwrite(&p, sizeof(p), 1, cubeFiles[index]) != 1)
+                ok_ = false;
+            return;
+        }
+    }
+
+    // writes the subtree of points in random order, returns its root node
+    int buildInMemory(std::vector<OctreePoint> &points, const float *min, float size, int depth)
+    {
+        const size_t first = nodes_.size();
+        const int node = build(points, 0, points.size(), min, size, depth);
+        for (size_t n = first; n < nodes_.size(); ++n)
+            nodes_[n].dataOffset = outPos_ + nodes_[n].dataOffset * sizeof(OctreePoint);
+        writePoints(points.empty() ? NULL : &points[0], points.size());
+        return node;
+    }
+
+    struct Below
+    {
+        int axis;
+        float split;
+        bool operator()(const OctreePoint &p) const
+        {
+            const float c = axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+            return c < split;
+        }
+    };
+
+    size_t partition(std::vector<OctreePoint> &points, size_t begin, size_t end, int axis, float split)
+    {
+        Below below;
+        below.axis = axis;
+        below.split = split;
+        return std::partition(points.begin() + begin, points.begin() + end, below) - points.begin();
+    }
+
+    // returns the node index, the node's points are [begin, begin + numPoints)
+    int build(std::vector<OctreePoint> &points, size_t begin, size_t end, const float *min, float size, int depth)
+    {
+        int index = newNode(min, size);
+        size_t count = end - begin;
+        size_t keep = (count <= maxPoints_ || depth >= MAX_DEPTH) ? count : maxPoints_;
+        nodes_[index].numPoints = keep;
+        nodes_[index].spacing = size / sqrtf((float)keep);
+        nodes_[index].dataOffset = begin; // converted to a file offset in buildInMemory()
+
+        size_t rest = begin + keep;
+        if (rest == end)
+            return index;
+
+        // split the remaining points into the octants: x, then y, then z,
+        // the points of each octant stay in random order
+        const float half = 0.5f * size;
+        size_t bounds[9];
+        bounds[0] = rest;
+        bounds[8] = end;
+        bounds[4] = partition(points, bounds[0], bounds[8], 0, min[0] + half);
+        bounds[2] = partition(points, bounds[0], bounds[4], 1, min[1] + half);
+        bounds[6] = partition(points, bounds[4], bounds[8], 1, min[1] + half);
+        for (int c = 0; c < 8; c += 2)
+            bounds[c + 1] = partition(points, bounds[c], bounds[c + 2], 2, min[2] + half);
+
+        for (int c = 0; c < 8; ++c)
+        {
+            if (bounds[c] == bounds[c + 1])
+                continue;
+            float cmin[3];
+            childMin(min, half, c, cmin);
+            int child = build(points, bounds[c], bounds[c + 1], cmin, half, depth + 1);
+            nodes_[index].children[c] = child;
+        }
+        return index;
+    }
+};
+
+#endif
@@ -21,6 +21,8 @@
 
 #include <stdint.h>
 
+#include "../PointOctree.h"
+
 using namespace std;
 
 float min_x, min_y, min_z;
@@ -42,7 +44,8 @@ struct Point
     uint32_t rgba;
 };
 
-void ReadData(char *filename, std::vector<Point> &vec, formatTypes format)
+// with an octree, the points are passed on to it in chunks
+void ReadData(char *filename, std::vector<Point> &vec, formatTypes format, PointOctreeBuilder *octree = NULL)
 {
 
     FILE *inputFile;
@@ -177,13 +180,23 @@ void ReadData(char *filename, std::vector<Point> &vec, formatTypes format)
         {
             point.rgba = r | g << 8 | b << 16;
             vec.push_back(point);
+            if (octree && vec.size() >= 1000000)
+            {
+                octree->add(vec);
+                vec.clear();
+            }
         }
     }
 
     fclose(inputFile);
+    if (octree)
+    {
+        octree->add(vec);
+        vec.clear();
+    }
 }
 
-void ReadPTX(char *filename, std::vector<Point> &vec)
+void ReadPTX(char *filename, std::vector<Point> &vec, PointOctreeBuilder *octree = NULL)
 {
 
     FILE *inputFile;
@@ -313,11 +326,21 @@ void ReadPTX(char *filename, std::vector<Point> &vec)
                 point.z = p[2];
                 point.rgba = r | g << 8 | b << 16;
                 vec.push_back(point);
+                if (octree && vec.size() >= 1000000)
+                {
+                    octree->add(vec);
+                    vec.clear();
+                }
             }
         }
     }
 
     fclose(inputFile);
+    if (octree)
+    {
+        octree->add(vec);
+        vec.clear();
+    }
 }
 
 void WriteData(char *filename, std::vector<Point> &vec)
@@ -360,6 +383,7 @@ int main(int argc, char **argv)
     // TODO these values should be command line arguments
     int maxPointsPerCube = 250000; // note set to -1 if no max points per cube is specified
     int divisionSize = 16;
+    int maxPointsPerNode = 20000; // for level of detail octrees (.ptso)
     formatTypes format = FORMAT_IRGB;
     //format = FORMAT_RGB;
     std::vector<Point> vec;
@@ -368,26 +392,47 @@ int main(int argc, char **argv)
     min_x = min_y = min_z = FLT_MAX;
     max_x = max_y = max_z = FLT_MIN;
 
-    if (argc < 3) /* argc should be > 3 for correct execution */
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-nodesize") == 0)
+    {
+        maxPointsPerNode = atoi(argv[2]);
+        first = 3;
+    }
+
+    if (argc - first < 2) /* input and output file required */
     {
         printf("Minimal two params required. read README.txt\n");
     }
     else
     {
-        for (int i = 1; i < argc - 1; i++)
+        PointOctreeBuilder *octree = NULL;
+        int len = strlen(argv[argc - 1]);
+        if ((len > 5) && strcmp((argv[argc - 1] + len - 5), ".ptso") == 0)
+            octree = new PointOctreeBuilder(argv[argc - 1], maxPointsPerNode);
+        for (int i = first; i < argc - 1; i++)
         {
             printf("Reading in %s\n", argv[i]);
             int len = strlen(argv[i]);
             if ((len > 4) && strcmp((argv[i] + len - 4), ".ptx") == 0)
             {
-                ReadPTX(argv[i], vec);
+                ReadPTX(argv[i], vec, octree);
             }
             else
             {
-                ReadData(argv[i], vec, format);
+                ReadData(argv[i], vec, format, octree);
             }
         }
-        WriteData(argv[argc - 1], vec);
+        if (octree)
+        {
+            bool ok = octree->write();
+            delete octree;
+            if (!ok)
+                return 1;
+        }
+        else
+        {
+            WriteData(argv[argc - 1], vec);
+        }
     }
     return 0;
 }
@@ -18,6 +18,8 @@
 #include <map>
 #include <stdint.h>
 
+#include "../PointOctree.h"
+
 #if defined(__GNUC__) && !defined(__clang__)
 #include <parallel/algorithm>
 namespace alg = __gnu_parallel;
@@ -48,7 +50,8 @@ struct Point
 
 bool sortfunction(Point i, Point j) { return (i.l < j.l); };
 
-void ReadData(char *filename, std::vector<Point> &vec, formatTypes format)
+// with an octree, the points of each set are passed on to it right away
+void ReadData(char *filename, std::vector<Point> &vec, formatTypes format, PointOctreeBuilder *octree = NULL)
 {
 
     FILE *inputFile;
@@ -104,6 +107,11 @@ void ReadData(char *filename, std::vector<Point> &vec, formatTypes format)
             }
             delete[] coord;
             delete[] icolor;
+            if (octree)
+            {
+                octree->add(vec);
+                vec.clear();
+            }
         }
         file.close();
     }
@@ -257,6 +265,7 @@ int main(int argc, char **argv)
     // TODO these values should be command line arguments
     int maxPointsPerCube = 1550000; // note set to -1 if no max points per cube is specified
     int divisionSize = 25;
+    int maxPointsPerNode = 20000; // for level of detail octrees (.ptso)
     formatTypes format = FORMAT_IRGB;
     std::vector<Point> vec;
     std::map<int, int> lookUp;
@@ -264,21 +273,44 @@ int main(int argc, char **argv)
     min_x = min_y = min_z = FLT_MAX;
     max_x = max_y = max_z = FLT_MIN;
 
-    if (argc < 3) /* argc should be > 3 for correct execution */
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-nodesize") == 0)
+    {
+        maxPointsPerNode = atoi(argv[2]);
+        first = 3;
+    }
+
+    if (argc - first < 2) /* input and output file required */
     {
         printf("Minimal two params required. read README.txt\n");
     }
     else
     {
-        for (int i = 1; i < argc - 1; i++)
+        int len = strlen(argv[argc - 1]);
+        if ((len > 5) && strcmp((argv[argc - 1] + len - 5), ".ptso") == 0)
         {
-            printf("Reading in %s\n", argv[i]);
-            ReadData(argv[i], vec, format);
+            PointOctreeBuilder octree(argv[argc - 1], maxPointsPerNode);
+            for (int i = first; i < argc - 1; i++)
+            {
+                printf("Reading in %s\n", argv[i]);
+                ReadData(argv[i], vec, format, &octree);
+            }
+            printf("Building octree\n");
+            if (!octree.write())
+                return 1;
+        }
+        else
+        {
+            for (int i = first; i < argc - 1; i++)
+            {
+                printf("Reading in %s\n", argv[i]);
+                ReadData(argv[i], vec, format);
+            }
+            printf("Sorting data\n");
+            LabelData(divisionSize, vec, lookUp);
+            printf("Persisting data\n");
+            WriteData(argv[argc - 1], vec, lookUp, maxPointsPerCube);
         }
-        printf("Sorting data\n");
-        LabelData(divisionSize, vec, lookUp);
-        printf("Persisting data\n");
-        WriteData(argv[argc - 1], vec, lookUp, maxPointsPerCube);
     }
     return 0;
 }
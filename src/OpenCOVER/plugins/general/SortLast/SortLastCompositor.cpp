@@ -0,0 +1,256 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "SortLastCompositor.h"
+
+#include <cstring>
+
+// pixels at the far plane are background
+static const float farDepth = 1.0f;
+
+namespace
+{
+
+// run of transmitted pixels in a tile
+struct Run
+{
+    int skip; // background pixels before the run
+    int count;
+    int colorSize; // bytes per pixel, 4 with alpha
+    const unsigned char *color;
+    const char *depth; // unaligned floats, NULL without depth
+};
+
+// read the next run of a tile, pos and pixel are advanced behind the run
+bool nextRun(int flags, int end, const char *data, size_t size, size_t &pos, int &pixel, Run &run)
+{
+    if (flags & SortLastCompositor::Compressed)
+    {
+        int counts[2];
+        if (size - pos < sizeof(counts))
+            return false;
+        memcpy(counts, data + pos, sizeof(counts));
+        pos += sizeof(counts);
+        run.skip = counts[0];
+        run.count = counts[1];
+        if (run.skip < 0 || run.count < 0 || run.skip + run.count == 0
+            || run.skip > end - pixel || run.count > end - pixel - run.skip)
+            return false;
+    }
+    else
+    {
+        run.skip = 0;
+        run.count = end - pixel;
+    }
+
+    run.colorSize = (flags & SortLastCompositor::HasAlpha) ? 4 : 3;
+    size_t bytes = run.colorSize * (size_t)run.count;
+    if (flags & SortLastCompositor::HasDepth)
+        bytes += sizeof(float) * run.count;
+    if (size - pos < bytes)
+        return false;
+
+    run.color = (const unsigned char *)data + pos;
+    pos += run.colorSize * (size_t)run.count;
+    run.depth = NULL;
+    if (flags & SortLastCompositor::HasDepth)
+    {
+        run.depth = data + pos;
+        pos += sizeof(float) * run.count;
+    }
+    pixel += run.skip + run.count;
+    return true;
+}
+}
+
+void SortLastCompositor::binarySwap(int index, int numNodes, int numPixels,
+                                    std::vector<Step> &steps, int &ownBegin, int &ownEnd)
+{
+    steps.clear();
+    ownBegin = ownEnd = 0;
+
+    int pow2 = 1;
+    while (pow2 * 2 <= numNodes)
+        pow2 *= 2;
+
+    if (pow2 < numNodes)
+    {
+        Step fold;
+        fold.partner = -1;
+        fold.send = false;
+        fold.sendBegin = fold.sendEnd = 0;
+        fold.receive = false;
+        if (index >= pow2)
+        {
+            fold.partner = index - pow2;
+            fold.send = true;
+            fold.sendEnd = numPixels;
+        }
+        else if (index + pow2 < numNodes)
+        {
+            fold.partner = index + pow2;
+            fold.receive = true;
+        }
+        steps.push_back(fold);
+        if (index >= pow2)
+            return;
+    }
+
+    int begin = 0, end = numPixels;
+    for (int mask = 1; mask < pow2; mask *= 2)
+    {
+        int mid = begin + (end - begin) / 2;
+        Step step;
+        step.partner = index ^ mask;
+        step.send = true;
+        step.receive = true;
+        if (index & mask)
+        {
+            step.sendBegin = begin;
+            step.sendEnd = mid;
+            begin = mid;
+        }
+        else
+        {
+            step.sendBegin = mid;
+            step.sendEnd = end;
+            end = mid;
+        }
+        steps.push_back(step);
+    }
+    ownBegin = begin;
+    ownEnd = end;
+}
+
+void SortLastCompositor::encode(const unsigned char *color, const float *depth, int begin, int end,
+                                bool withDepth, bool compress, std::vector<char> &out)
+{
+    Header header;
+    header.begin = begin;
+    header.end = end;
+    header.flags = (withDepth ? HasDepth : 0) | (compress ? Compressed : 0);
+    // without depth and runs, the receiver needs alpha to tell background pixels
+    if (!withDepth && !compress)
+        header.flags |= HasAlpha;
+    append(out, &header, sizeof(header));
+
+    if (header.flags & HasAlpha)
+    {
+        size_t pos = out.size();
+        out.resize(pos + 4 * (size_t)(end - begin));
+        unsigned char *p = (unsigned char *)&out[pos];
+        for (int pixel = begin; pixel < end; ++pixel, p += 4)
+        {
+            memcpy(p, color + 3 * (size_t)pixel, 3);
+            p[3] = depth[pixel] < farDepth ? 255 : 0;
+        }
+        return;
+    }
+
+    if (!compress)
+    {
+        append(out, color + 3 * (size_t)begin, 3 * (size_t)(end - begin));
+        if (withDepth)
+            append(out, depth + begin, sizeof(float) * (end - begin));
+        return;
+    }
+
+    int pixel = begin;
+    while (pixel < end)
+    {
+        int first = pixel;
+        while (pixel < end && depth[pixel] >= farDepth)
+            ++pixel;
+        int counts[2];
+        counts[0] = pixel - first;
+        first = pixel;
+        while (pixel < end && depth[pixel] < farDepth)
+            ++pixel;
+        counts[1] = pixel - first;
+
+        append(out, counts, sizeof(counts));
+        append(out, color + 3 * (size_t)first, 3 * (size_t)counts[1]);
+        if (withDepth)
+            append(out, depth + first, sizeof(float) * counts[1]);
+    }
+}
+
+bool SortLastCompositor::composite(unsigned char *color, float *depth, int numPixels,
+                                   const char *data, size_t size)
+{
+    Header header;
+    if (!readHeader(data, size, numPixels, header) || !(header.flags & HasDepth))
+        return false;
+
+    size_t pos = sizeof(header);
+    int pixel = header.begin;
+    while (pixel < header.end)
+    {
+        Run run;
+        if (!nextRun(header.flags, header.end, data, size, pos, pixel, run))
+            return false;
+
+        int first = pixel - run.count;
+        for (int i = 0; i < run.count; ++i)
+        {
+            float d;
+            memcpy(&d, run.depth + sizeof(float) * i, sizeof(float));
+            if (d < depth[first + i])
+            {
+                depth[first + i] = d;
+                memcpy(color + 3 * (size_t)(first + i), run.color + run.colorSize * i, 3);
+            }
+        }
+    }
+    return true;
+}
+
+bool SortLastCompositor::decode(unsigned char *color4, int numPixels, const char *data, size_t size)
+{
+    Header header;
+    if (!readHeader(data, size, numPixels, header))
+        return false;
+
+    size_t pos = sizeof(header);
+    int pixel = header.begin;
+    while (pixel < header.end)
+    {
+        Run run;
+        if (!nextRun(header.flags, header.end, data, size, pos, pixel, run))
+            return false;
+
+        int first = pixel - run.count;
+        memset(color4 + 4 * (size_t)(first - run.skip), 0, 4 * (size_t)run.skip);
+        for (int i = 0; i < run.count; ++i)
+        {
+            unsigned char *p = color4 + 4 * (size_t)(first + i);
+            const unsigned char *c = run.color + run.colorSize * i;
+            p[0] = c[0];
+            p[1] = c[1];
+            p[2] = c[2];
+            p[3] = run.colorSize == 4 ? c[3] : 255;
+        }
+    }
+    return true;
+}
+
+bool SortLastCompositor::readHeader(const char *data, size_t size, int numPixels, Header &header)
+{
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    return header.begin >= 0 && header.begin <= header.end && header.end <= numPixels;
+}
+
+void SortLastCompositor::append(std::vector<char> &out, const void *data, size_t size)
+{
+    if (size == 0)
+        return;
+    size_t pos = out.size();
+    out.resize(pos + size);
+    memcpy(&out[pos], data, size);
+}
@@ -0,0 +1,70 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef SORTLASTCOMPOSITOR_H
+#define SORTLASTCOMPOSITOR_H
+
+#include <cstddef>
+#include <vector>
+
+// Depth compositing of images with 3 bytes of color and a float depth per
+// pixel, independent of OpenGL and MPI.
+//
+// Pixel spans are exchanged as tiles: a header with the span and flags,
+// followed by the pixels. Compressed tiles skip background pixels
+// (depth >= 1) as runs of (skip, count) pairs, each followed by count
+// pixels. Uncompressed tiles without depth carry an alpha byte per pixel
+// instead, 0 for background.
+class SortLastCompositor
+{
+public:
+    enum
+    {
+        HasDepth = 1,
+        Compressed = 2,
+        HasAlpha = 4
+    };
+
+    // one round of the binary swap, the same for both partners
+    struct Step
+    {
+        int partner; // index of the partner node
+        bool send; // send [sendBegin, sendEnd) to the partner
+        int sendBegin, sendEnd;
+        bool receive; // composite a tile from the partner
+    };
+
+    // Schedule of the binary swap for node index of numNodes.
+    // For a number of nodes that is not a power of two, the surplus nodes
+    // first fold their whole image into a partner and are idle afterwards.
+    // Afterwards, the node owns the final pixels in [ownBegin, ownEnd).
+    static void binarySwap(int index, int numNodes, int numPixels,
+                           std::vector<Step> &steps, int &ownBegin, int &ownEnd);
+
+    // append a tile with the pixels in [begin, end) to out
+    static void encode(const unsigned char *color, const float *depth, int begin, int end,
+                       bool withDepth, bool compress, std::vector<char> &out);
+
+    // composite a tile with depth into color/depth, keeping the nearer pixel
+    static bool composite(unsigned char *color, float *depth, int numPixels,
+                          const char *data, size_t size);
+
+    // copy a tile to an image with 4 bytes per pixel, alpha is 0 for background pixels
+    static bool decode(unsigned char *color4, int numPixels, const char *data, size_t size);
+
+private:
+    struct Header
+    {
+        int begin, end;
+        int flags;
+    };
+
+    static bool readHeader(const char *data, size_t size, int numPixels, Header &header);
+    static void append(std::vector<char> &out, const void *data, size_t size);
+};
+
+#endif // SORTLASTCOMPOSITOR_H
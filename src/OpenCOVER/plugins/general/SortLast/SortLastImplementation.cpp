@@ -7,9 +7,12 @@
 
 #include "SortLastImplementation.h"
 
+#include <config/coConfig.h>
 #include <config/coConfigString.h>
 
-SortLastImplementation::SortLastImplementation()
+SortLastImplementation::SortLastImplementation(const std::string &nodename, int session)
+    : nodename(nodename)
+    , session(session)
 {
     covise::coConfigString commMethodEntry("method", "COVER.Parallel.SortLast.Comm");
 
@@ -17,4 +20,17 @@ SortLastImplementation::SortLastImplementation()
         this->commMethod = Gather;
     else
         this->commMethod = Send;
+
+    covise::coConfigString compositeMethodEntry("method", "COVER.Parallel.SortLast.Composite");
+
+    if (compositeMethodEntry == "binaryswap")
+        this->compositeMethod = BinarySwap;
+    else
+        this->compositeMethod = CompositeOnMaster;
+
+    // Off by default: the slaves then composite the images of the previous frame,
+    // so the composited image lags one frame behind the master's own rendering
+    this->pipeline = covise::coConfig::getInstance()->isOn("COVER.Parallel.SortLast.Pipeline", false);
+    this->compress = covise::coConfig::getInstance()->isOn("COVER.Parallel.SortLast.Compress", true);
+    this->showTimings = covise::coConfig::getInstance()->isOn("COVER.Parallel.SortLast.Timings", false);
 }
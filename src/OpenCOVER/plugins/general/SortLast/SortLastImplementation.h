@@ -14,11 +14,7 @@
 class SortLastImplementation
 {
 public:
-    SortLastImplementation(const std::string &nodename, int session)
-        : nodename(nodename)
-        , session(session)
-    {
-    }
+    SortLastImplementation(const std::string &nodename, int session);
     virtual ~SortLastImplementation()
     {
     }
@@ -61,6 +57,32 @@ protected:
         Send,
         Gather
     } commMethod;
+
+    enum CompositeMethod
+    {
+        CompositeOnMaster, /// Slaves send their images to the master
+        BinarySwap /// Slaves composite among each other, the master gathers the tiles
+    } compositeMethod;
+
+    /// Composite the previous frame while the current one is read back, opt-in with
+    /// COVER.Parallel.SortLast.Pipeline: the image shown is one frame behind the
+    /// head tracking and interaction of the master
+    bool pipeline;
+    bool compress; /// Skip background pixels in the tiles
+    bool showTimings; /// Show the timings of the stages on the HUD
+
+    enum
+    {
+        CompositeTag = 0x534c,
+        TileTag
+    };
+
+    /// Timings of a slave in ms, sent in front of its final tile
+    struct StageTimes
+    {
+        float readback, composite, send;
+        int swapBytes;
+    };
 };
 
 #endif // SORTLASTIMPLEMENTATION_H
@@ -17,6 +17,7 @@
 #include <cover/coVRPluginSupport.h>
 #include <cover/coVRMSController.h>
 #include <cover/coVRConfig.h>
+#include <cover/coHud.h>
 #include <cstdlib>
 #include <climits>
 #include <algorithm>
@@ -29,6 +30,7 @@
 #include <osg/ShapeDrawable>
 #include <osg/Vec4f>
 #include <osg/Matrix>
+#include <osg/Timer>
 
 #include <sstream>
 
@@ -66,11 +68,20 @@ SortLastMaster::SortLastMaster(const std::string &nodename, int session)
     , fragmentShader(0)
     , frameCtr(0)
     , initPending(true)
+    , numTiles(0)
+    , glewInitialised(false)
+    , gatherTime(0.0f)
+    , drawTime(0.0f)
+    , tileBytes(0)
+    , hud(0)
+    , hudTime(0.0)
 {
+    memset(&this->slowestTimes, 0, sizeof(this->slowestTimes));
 }
 
 SortLastMaster::~SortLastMaster()
 {
+    delete this->hud;
     deleteBuffers();
 }
 
@@ -104,7 +115,7 @@ bool SortLastMaster::createContext(const std::list<std::string> &hostlist, int g
 
     this->session = groupIdentifier;
 
-    if (this->hostlist.size() != hostlist.size())
+    if (this->compositeMethod == CompositeOnMaster && this->hostlist.size() != hostlist.size())
     {
 
         deleteBuffers();
@@ -144,6 +155,23 @@ bool SortLastMaster::createContext(const std::list<std::string> &hostlist, int g
         exit(-1);
     }
 
+    // Slaves that own a part of the final image after the binary swap
+    this->numTiles = 0;
+    if (this->compositeMethod == BinarySwap)
+    {
+        for (int ctr = 0; ctr < this->hostlist.size() - 1; ++ctr)
+        {
+            std::vector<SortLastCompositor::Step> steps;
+            int ownBegin = 0, ownEnd = 0;
+            SortLastCompositor::binarySwap(ctr, this->hostlist.size() - 1, this->frame.width * this->frame.height,
+                                           steps, ownBegin, ownEnd);
+            if (ownBegin < ownEnd)
+                ++this->numTiles;
+        }
+        LOG_CERR("SortLastMaster::createContext info: gathering " << this->numTiles << " tiles"
+                 << (this->pipeline ? " with one frame latency" : "") << std::endl);
+    }
+
     std::stringstream fSource;
 
     fSource << "uniform sampler2D textures[" << (this->hostlist.size() - 1) * 2 << "]; \n";
@@ -205,6 +233,40 @@ bool SortLastMaster::init()
     return true;
 }
 
+void SortLastMaster::preFrame()
+{
+    if (this->compositeMethod != BinarySwap || !this->showTimings)
+        return;
+
+    double now = opencover::cover->frameTime();
+    if (this->hud && now - this->hudTime < 0.5)
+        return;
+    this->hudTime = now;
+
+    if (!this->hud)
+    {
+        this->hud = new opencover::coHud();
+        this->hud->show();
+    }
+
+    std::stringstream line1, line2, line3;
+    line1.setf(std::ios::fixed);
+    line1.precision(1);
+    line2.setf(std::ios::fixed);
+    line2.precision(1);
+    line3.setf(std::ios::fixed);
+    line3.precision(1);
+    line1 << "SortLast: binary swap of " << this->hostlist.size() - 1 << " slaves"
+          << (this->pipeline ? ", pipelined" : "") << (this->compress ? ", compressed" : "");
+    line2 << "slaves: readback " << this->slowestTimes.readback << " ms, composite " << this->slowestTimes.composite
+          << " ms, send " << this->slowestTimes.send << " ms";
+    line3 << "master: gather " << this->gatherTime << " ms, draw " << this->drawTime << " ms, "
+          << (this->slowestTimes.swapBytes + this->tileBytes) / 1024 << " kB per frame";
+    this->hud->setText1(line1.str());
+    this->hud->setText2(line2.str());
+    this->hud->setText3(line3.str());
+}
+
 void SortLastMaster::preSwapBuffers(int window)
 {
 
@@ -217,7 +279,10 @@ void SortLastMaster::preSwapBuffers(int window)
     //    }
 
     //compositeSimpleReadback();
-    compositeSimpleShader();
+    if (this->compositeMethod == BinarySwap)
+        compositeTiles();
+    else
+        compositeSimpleShader();
 }
 
 void SortLastMaster::initTextures()
@@ -481,6 +546,80 @@ void SortLastMaster::compositeSimpleShader()
     glUseProgram(currentProgram);
 }
 
+void SortLastMaster::compositeTiles()
+{
+
+    osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+    const int numPixels = this->frame.width * this->frame.height;
+    this->tileImage.resize(4 * numPixels);
+
+    MPI_Comm comm = opencover::coVRMSController::instance()->getAppCommunicator();
+    memset(&this->slowestTimes, 0, sizeof(this->slowestTimes));
+    this->tileBytes = 0;
+
+    // Decode the tiles in the order they arrive
+    for (int ctr = 0; ctr < this->numTiles; ++ctr)
+    {
+        MPI_Status status;
+        int count = 0;
+        MPI_Probe(MPI_ANY_SOURCE, TileTag, comm, &status);
+        MPI_Get_count(&status, MPI_BYTE, &count);
+        this->tileBuffer.resize(std::max(count, 1));
+        MPI_Recv(&this->tileBuffer[0], count, MPI_BYTE, status.MPI_SOURCE, TileTag, comm, &status);
+
+        StageTimes times;
+        if (count < (int)sizeof(times)
+            || !SortLastCompositor::decode(&this->tileImage[0], numPixels,
+                                           &this->tileBuffer[sizeof(times)], count - sizeof(times)))
+        {
+            LOG_CERR("SortLastMaster::compositeTiles err: invalid tile from node " << status.MPI_SOURCE << std::endl);
+            continue;
+        }
+
+        memcpy(&times, &this->tileBuffer[0], sizeof(times));
+        this->slowestTimes.readback = std::max(this->slowestTimes.readback, times.readback);
+        this->slowestTimes.composite = std::max(this->slowestTimes.composite, times.composite);
+        this->slowestTimes.send = std::max(this->slowestTimes.send, times.send);
+        this->slowestTimes.swapBytes += times.swapBytes;
+        this->tileBytes += count;
+    }
+
+    osg::Timer_t gatherTick = osg::Timer::instance()->tick();
+
+    if (!this->glewInitialised)
+    {
+        glewInit();
+        this->glewInitialised = true;
+    }
+
+    GLint currentProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+    glUseProgram(0);
+
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_BLEND);
+    // Where all slaves rendered background, the image of the master stays visible
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0.0f);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glWindowPos2i(0, 0);
+    glDrawPixels(this->frame.width, this->frame.height, GL_BGRA, GL_UNSIGNED_BYTE, &this->tileImage[0]);
+
+    glPopClientAttrib();
+    glPopAttrib();
+    glUseProgram(currentProgram);
+
+    this->gatherTime = osg::Timer::instance()->delta_m(startTick, gatherTick);
+    this->drawTime = osg::Timer::instance()->delta_m(gatherTick, osg::Timer::instance()->tick());
+}
+
 void SortLastMaster::deleteBuffers()
 {
     if (this->frameBuffers)
@@ -9,6 +9,7 @@
 #define SORTLASTMASTER_H
 
 #include "SortLastImplementation.h"
+#include "SortLastCompositor.h"
 
 #include <GL/gl.h>
 
@@ -17,6 +18,11 @@
 #include <vector>
 #include <mpi.h>
 
+namespace opencover
+{
+class coHud;
+}
+
 #define SL_DEPTH_TEXTURE_MODE_F32
 //#define SL_DEPTH_TEXTURE_MODE_I32
 //#define SL_DEPTH_TEXTURE_MODE_I24
@@ -57,6 +63,7 @@ public:
     virtual ~SortLastMaster();
 
     virtual bool init();
+    virtual void preFrame();
     virtual void preSwapBuffers(int windowNumber);
 
     virtual bool initialiseAsMaster();
@@ -75,6 +82,7 @@ private:
 
     void compositeSimpleReadback();
     void compositeSimpleShader();
+    void compositeTiles();
 
     template <typename T>
     struct Buffer : BufferTypeTraits<T>
@@ -123,6 +131,19 @@ private:
     int session;
 
     bool initPending;
+
+    // Tiles composited by the slaves with binary swap
+    int numTiles;
+    std::vector<unsigned char> tileImage; /// BGRA, alpha 0 where all slaves rendered background
+    std::vector<char> tileBuffer;
+    bool glewInitialised;
+
+    StageTimes slowestTimes; /// Maximum over the slaves
+    float gatherTime, drawTime;
+    int tileBytes;
+
+    opencover::coHud *hud;
+    double hudTime;
 };
 
 #endif // SORTLASTMASTER_H
@@ -15,6 +15,8 @@
  **                                                                          **
 \****************************************************************************/
 
+#include <GL/glew.h>
+
 #include "SortLastSlave.h"
 #include <cover/coVRPluginSupport.h>
 #include <cover/RenderObject.h>
@@ -35,6 +37,10 @@
 #include <osg/Matrix>
 #include <osg/PolygonMode>
 #include <osg/StateSet>
+#include <osg/Timer>
+
+#include <algorithm>
+#include <cstring>
 
 #include <mpi.h>
 //#define MPI_BCAST
@@ -62,7 +68,14 @@ SortLastSlave::SortLastSlave(const std::string &nodename, int session)
     , index(0)
     , inFrame(false)
     , group(0)
+    , ownBegin(0)
+    , ownEnd(0)
+    , pboSize(0)
+    , currentPbo(0)
+    , previousValid(false)
+    , tilePending(false)
 {
+    pbos[0] = pbos[1] = 0;
 
     std::cerr << "SortLastSlave::<init> info: starting plugin" << std::endl;
 
@@ -174,12 +187,26 @@ bool SortLastSlave::createContext(const std::list<std::string> &hostlist, int)
     this->pixels = new GLubyte[this->frame.width * this->frame.height * 3];
     this->depth = new GLfloat[this->frame.width * this->frame.height];
 
+    if (this->compositeMethod == BinarySwap)
+    {
+        SortLastCompositor::binarySwap(this->index - 1, this->hostlist.size() - 1, this->frame.width * this->frame.height,
+                                       this->steps, this->ownBegin, this->ownEnd);
+        LOG_CERR("SortLastSlave::createContext info: binary swap in " << this->steps.size() << " rounds, "
+                 << "owning pixels " << this->ownBegin << "-" << this->ownEnd << std::endl);
+    }
+
     return true;
 }
 
 void SortLastSlave::preSwapBuffers(int)
 {
 
+    if (this->compositeMethod == BinarySwap)
+    {
+        compositeBinarySwap();
+        return;
+    }
+
     if (opencover::coVRConfig::instance()->windows[0].sx != width || opencover::coVRConfig::instance()->windows[0].sy != height)
     {
         width = opencover::coVRConfig::instance()->windows[0].sx;
@@ -204,3 +231,152 @@ void SortLastSlave::preSwapBuffers(int)
 
     this->inFrame = false;
 }
+
+
+void SortLastSlave::compositeBinarySwap()
+{
+
+    const int width = this->frame.width;
+    const int height = this->frame.height;
+    const int numPixels = width * height;
+    // depth is read behind the color, aligned for the floats
+    const size_t colorSize = (3 * (size_t)numPixels + 3) & ~(size_t)3;
+    const size_t size = colorSize + sizeof(GLfloat) * numPixels;
+
+    osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+    if (this->pboSize != size)
+    {
+        if (this->pbos[0] == 0)
+        {
+            glewInit();
+            glGenBuffers(2, this->pbos);
+        }
+        for (int ctr = 0; ctr < 2; ++ctr)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, this->pbos[ctr]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, 0, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        this->pboSize = size;
+        this->previousValid = false;
+        this->swapColor.resize(3 * numPixels);
+        this->swapDepth.resize(numPixels);
+    }
+
+    // Start the transfer of the current frame into a pixel buffer object
+    GLint packAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadBuffer(GL_BACK);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, this->pbos[this->currentPbo]);
+    glReadPixels(0, 0, width, height, GL_BGR, GL_UNSIGNED_BYTE, (GLvoid *)0);
+    glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, (GLvoid *)colorSize);
+
+    // In the pipeline, the previous frame is composited while the GPU transfers the current one:
+    // this hides the readback, but the master shows the slaves' image of the frame before
+    int readPbo = this->currentPbo;
+    bool valid = true;
+    if (this->pipeline)
+    {
+        readPbo = 1 - this->currentPbo;
+        valid = this->previousValid;
+    }
+
+    if (valid)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, this->pbos[readPbo]);
+        const char *mapped = (const char *)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (mapped)
+        {
+            memcpy(&this->swapColor[0], mapped, 3 * (size_t)numPixels);
+            memcpy(&this->swapDepth[0], mapped + colorSize, sizeof(GLfloat) * numPixels);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+    if (!valid)
+    {
+        // Nothing to show yet, every slave has to take part in the exchange anyway
+        std::fill(this->swapColor.begin(), this->swapColor.end(), 0);
+        std::fill(this->swapDepth.begin(), this->swapDepth.end(), 1.0f);
+    }
+
+    this->previousValid = true;
+    this->currentPbo = 1 - this->currentPbo;
+
+    osg::Timer_t readbackTick = osg::Timer::instance()->tick();
+
+    // Binary swap with the other slaves
+    MPI_Comm comm = opencover::coVRMSController::instance()->getAppCommunicator();
+    int swapBytes = 0;
+
+    for (size_t ctr = 0; ctr < this->steps.size(); ++ctr)
+    {
+        const SortLastCompositor::Step &step = this->steps[ctr];
+        int partner = this->hostlist[step.partner + 1];
+        MPI_Request request;
+
+        if (step.send)
+        {
+            this->sendBuffer.clear();
+            SortLastCompositor::encode(&this->swapColor[0], &this->swapDepth[0], step.sendBegin, step.sendEnd,
+                                       true, this->compress, this->sendBuffer);
+            MPI_Isend(&this->sendBuffer[0], (int)this->sendBuffer.size(), MPI_BYTE, partner, CompositeTag, comm, &request);
+            swapBytes += this->sendBuffer.size();
+        }
+
+        if (step.receive)
+        {
+            MPI_Status status;
+            int count = 0;
+            MPI_Probe(partner, CompositeTag, comm, &status);
+            MPI_Get_count(&status, MPI_BYTE, &count);
+            this->receiveBuffer.resize(count);
+            MPI_Recv(&this->receiveBuffer[0], count, MPI_BYTE, partner, CompositeTag, comm, &status);
+
+            if (!SortLastCompositor::composite(&this->swapColor[0], &this->swapDepth[0], numPixels,
+                                               &this->receiveBuffer[0], count))
+            {
+                LOG_CERR("SortLastSlave::compositeBinarySwap err: invalid tile from node " << partner << std::endl);
+            }
+        }
+
+        if (step.send)
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+    }
+
+    osg::Timer_t compositeTick = osg::Timer::instance()->tick();
+
+    // Send the own part of the final image to the master without waiting for it
+    if (this->tilePending)
+    {
+        MPI_Wait(&this->tileRequest, MPI_STATUS_IGNORE);
+        this->tilePending = false;
+    }
+
+    if (this->ownBegin < this->ownEnd)
+    {
+        this->tileBuffer.resize(sizeof(StageTimes));
+        SortLastCompositor::encode(&this->swapColor[0], &this->swapDepth[0], this->ownBegin, this->ownEnd,
+                                   false, this->compress, this->tileBuffer);
+
+        StageTimes times;
+        times.readback = osg::Timer::instance()->delta_m(startTick, readbackTick);
+        times.composite = osg::Timer::instance()->delta_m(readbackTick, compositeTick);
+        times.send = osg::Timer::instance()->delta_m(compositeTick, osg::Timer::instance()->tick());
+        times.swapBytes = swapBytes;
+        memcpy(&this->tileBuffer[0], &times, sizeof(times));
+
+        MPI_Isend(&this->tileBuffer[0], (int)this->tileBuffer.size(), MPI_BYTE, this->hostlist[0], TileTag, comm, &this->tileRequest);
+        this->tilePending = true;
+    }
+
+    this->inFrame = false;
+}
@@ -9,12 +9,15 @@
 #define SORTLASTSLAVE_H
 
 #include "SortLastImplementation.h"
+#include "SortLastCompositor.h"
 
 #include <osgText/Text>
 #include <osg/MatrixTransform>
 
 #include <cassert>
 #include <list>
+#include <vector>
+#include <mpi.h>
 
 class SortLastSlave : public SortLastImplementation
 {
@@ -34,6 +37,8 @@ public:
     virtual bool createContext(const std::list<std::string> &hostlist, int groupIdentifier);
 
 private:
+    void compositeBinarySwap();
+
     int index;
 
     int width, height;
@@ -49,6 +54,22 @@ private:
 
     osg::ref_ptr<osgText::Text> text;
     osg::ref_ptr<osg::MatrixTransform> group;
+
+    // Binary swap
+    std::vector<SortLastCompositor::Step> steps;
+    int ownBegin, ownEnd;
+
+    GLuint pbos[2]; /// Color and depth of the current and the previous frame
+    size_t pboSize;
+    int currentPbo;
+    bool previousValid;
+
+    std::vector<unsigned char> swapColor;
+    std::vector<float> swapDepth;
+    std::vector<char> sendBuffer, receiveBuffer, tileBuffer;
+
+    MPI_Request tileRequest;
+    bool tilePending;
 };
 
 #endif // SORTLASTSLAVE_H
@@ -702,6 +702,11 @@ bool SystemCover::getPreloadSwitch()
     return preload;
 }
 
+int SystemCover::getInlineLoaderThreads()
+{
+    return coCoviseConfig::getInt("COVER.Plugin.Vrml97.InlineLoaderThreads", 4);
+}
+
 float SystemCover::getSyncInterval()
 {
     return coVRCollaboration::instance()->getSyncInterval();
@@ -101,6 +101,7 @@ public:
     virtual bool getHeadlight();
     virtual void setHeadlight(bool enable);
     virtual bool getPreloadSwitch();
+    virtual int getInlineLoaderThreads();
     virtual float getSyncInterval();
 
     virtual void addViewpoint(VrmlScene *scene, VrmlNodeViewpoint *viewpoint);
@@ -545,6 +545,7 @@ static int oldNumVert = 0;
 static int numPoly = 0;
 static int oldNumPoly = 0;
 static bool UseFieldOfViewForScaling = false;
+static bool RenderOnChange = false;
 
 int textureMode = -1;
 static int textureQuality = 0;
@@ -667,6 +668,9 @@ ViewerOsg::ViewerOsg(VrmlScene *s, Group *rootNode)
 
     d_selectMode = false;
     UseFieldOfViewForScaling = coCoviseConfig::isOn("COVER.Plugin.Vrml97.UseFieldOfViewForScaling", false);
+    // off by default: the scene only tracks that some node changed, a node that
+    // changes without notifying the scene would not be rendered any more
+    RenderOnChange = coCoviseConfig::isOn("COVER.Plugin.Vrml97.RenderOnChange", false);
 
     currentTransform.makeIdentity();
 
@@ -5137,9 +5141,31 @@ void ViewerOsg::update(double timeNow)
     }
     if (d_scene)
     {
+        bool stats = VRViewer::instance()->getStats() && VRViewer::instance()->getStats()->collectStats("plugin");
+        double beginTime = stats ? VRViewer::instance()->elapsedTime() : 0.;
+
         currentTransform.makeIdentity();
         d_scene->update(timeNow);
-        redraw();
+        double updateTime = stats ? VRViewer::instance()->elapsedTime() : 0.;
+
+        // the VRML tree only has to be traversed if events changed it or if
+        // nodes want to be rendered every frame
+        if (!RenderOnChange || d_scene->needsRender())
+        {
+            redraw();
+        }
+        else
+        {
+            setVrmlBaseMat();
+        }
+
+        if (stats)
+        {
+            int fn = VRViewer::instance()->getFrameStamp()->getFrameNumber();
+            double endTime = VRViewer::instance()->elapsedTime();
+            VRViewer::instance()->getStats()->setAttribute(fn, "Vrml97 update time taken", updateTime - beginTime);
+            VRViewer::instance()->getStats()->setAttribute(fn, "Vrml97 render time taken", endTime - updateTime);
+        }
     }
     //,j,k;
     for (int i = 0; i < numCameras; i++)
@@ -5722,15 +5748,20 @@ void ViewerOsg::update(double timeNow)
         cerr << "END ViewerOsg::update" << endl;
 }
 
+void ViewerOsg::setVrmlBaseMat()
+{
+    vrmlBaseMat = cover->getBaseMat();
+    Matrix transformMat = VRMLRoot->getMatrix();
+    vrmlBaseMat.preMult(transformMat);
+}
+
 void ViewerOsg::redraw()
 {
     if (cover->debugLevel(5))
         cerr << "ViewerOsg::redraw" << endl;
     //double start = System::the->time();
 
-    vrmlBaseMat = cover->getBaseMat();
-    Matrix transformMat = VRMLRoot->getMatrix();
-    vrmlBaseMat.preMult(transformMat);
+    setVrmlBaseMat();
 
     //cerr << "ViewerOsg::redraw" << endl;
     d_scene->render(this);
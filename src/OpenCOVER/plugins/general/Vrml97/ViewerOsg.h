@@ -387,6 +387,9 @@ private:
     void beginGeometry();
     void endGeometry();
 
+    // base matrix of the VRML scene in world coordinates
+    void setVrmlBaseMat();
+
     bool d_selectMode;
 
     double d_renderTime, d_renderTime1;
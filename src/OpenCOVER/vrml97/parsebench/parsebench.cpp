@@ -0,0 +1,275 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Parsing large VRML files as exported by CAD tools
+ *
+ * A world of n Inline files is written, each with an IndexedFaceSet of
+ * v vertices, normals and triangles, together with a single file holding
+ * all of the geometry. The single file is parsed with VrmlScene::readWrl
+ * and the throughput is reported in MB/s. Then the world is loaded, which
+ * parses the Inline files one after the other, while j threads read the
+ * next files ahead (j = 0: no reading ahead).
+ */
+
+#include <vrml97/vrml/System.h>
+#include <vrml97/vrml/VrmlScene.h>
+#include <vrml97/vrml/VrmlNamespace.h>
+#include <vrml97/vrml/VrmlMFNode.h>
+#include <vrml97/vrml/Doc.h>
+#include <vrml97/vrml/FilePrefetch.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include <string>
+#include <vector>
+
+using namespace vrml;
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// System without a renderer
+class BenchSystem : public System
+{
+public:
+    BenchSystem(int numThreads)
+        : numThreads(numThreads)
+    {
+    }
+    virtual double time()
+    {
+        return now();
+    }
+    virtual const char *remoteFetch(const char *)
+    {
+        return NULL;
+    }
+    virtual void setBuiltInFunctionState(const char *, int) {}
+    virtual void setBuiltInFunctionValue(const char *, float) {}
+    virtual void callBuiltInFunctionCallback(const char *) {}
+    virtual void setSyncMode(const char *) {}
+    virtual bool isMaster()
+    {
+        return true;
+    }
+    virtual void becomeMaster() {}
+    virtual void setTimeStep(int) {}
+    virtual void setActivePerson(int) {}
+    virtual Player *getPlayer()
+    {
+        return NULL;
+    }
+    virtual VrmlMessage *newMessage(size_t size)
+    {
+        return new VrmlMessage(size);
+    }
+    virtual void sendAndDeleteMessage(VrmlMessage *msg)
+    {
+        delete msg;
+    }
+    virtual bool hasRemoteConnection()
+    {
+        return false;
+    }
+    virtual void setHeadlight(bool) {}
+    virtual void addViewpoint(VrmlScene *, VrmlNodeViewpoint *) {}
+    virtual bool removeViewpoint(VrmlScene *, const VrmlNodeViewpoint *)
+    {
+        return false;
+    }
+    virtual bool setViewpoint(VrmlScene *, const VrmlNodeViewpoint *)
+    {
+        return false;
+    }
+    virtual void setCurrentFile(const char *) {}
+    virtual void setMenuVisibility(bool) {}
+    virtual void createMenu() {}
+    virtual void destroyMenu() {}
+    virtual void setNavigationType(NavigationType) {}
+    virtual void setNavigationStepSize(double) {}
+    virtual void setNavigationDriveSpeed(double) {}
+    virtual void setNearFar(float, float) {}
+    virtual bool getViewerPositionAndOrientation(float *, float *)
+    {
+        return false;
+    }
+    virtual bool getLocalViewerPositionAndOrientation(float *, float *)
+    {
+        return false;
+    }
+    virtual bool getViewerFeetPositionAndOrientation(float *, float *)
+    {
+        return false;
+    }
+    virtual bool getPositionAndOrientationFromMatrix(const double *, float *, float *)
+    {
+        return false;
+    }
+    virtual void transformByMatrix(const double *, float *, float *) {}
+    virtual void getInvBaseMat(double *) {}
+    virtual void getPositionAndOrientationOfOrigin(const double *, float *, float *) {}
+    virtual int getInlineLoaderThreads()
+    {
+        return numThreads;
+    }
+
+private:
+    int numThreads;
+};
+
+// a cylinder of v vertices, different for every part
+static void writeShape(FILE *fp, int index, int numVertices)
+{
+    int ring = 64;
+    int rows = numVertices / ring;
+    if (rows < 2)
+        rows = 2;
+    float x0 = 3.f * (float)(index % 100), z0 = 3.f * (float)(index / 100);
+
+    fprintf(fp, "Shape {\n appearance Appearance { material Material { diffuseColor 0.8 0.8 0.8 } }\n");
+    fprintf(fp, " geometry IndexedFaceSet {\n  coord Coordinate { point [\n");
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int i = 0; i < ring; ++i)
+        {
+            float a = 2.f * (float)M_PI * i / ring;
+            fprintf(fp, "   %.6f %.6f %.6f,\n", x0 + cosf(a), 0.01f * r, z0 + sinf(a));
+        }
+    }
+    fprintf(fp, "  ] }\n  normal Normal { vector [\n");
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int i = 0; i < ring; ++i)
+        {
+            float a = 2.f * (float)M_PI * i / ring;
+            fprintf(fp, "   %.6f 0 %.6f,\n", cosf(a), sinf(a));
+        }
+    }
+    fprintf(fp, "  ] }\n  coordIndex [\n");
+    for (int r = 0; r + 1 < rows; ++r)
+    {
+        for (int i = 0; i < ring; ++i)
+        {
+            int a = r * ring + i, b = r * ring + (i + 1) % ring;
+            fprintf(fp, "   %d %d %d -1 %d %d %d -1\n", a, b, b + ring, a, b + ring, a + ring);
+        }
+    }
+    fprintf(fp, "  ]\n  normalPerVertex TRUE\n }\n}\n");
+}
+
+static long fileSize(const std::string &filename)
+{
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0)
+        return 0;
+    return (long)st.st_size;
+}
+
+int main(int argc, char **argv)
+{
+    int numParts = 200;
+    int numVertices = 20000;
+    int numThreads = 4;
+    std::string dir = "/tmp/parsebench";
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numParts = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-v") && i + 1 < argc)
+            numVertices = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+            numThreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            dir = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [-n parts] [-v vertices per part] [-j loader threads] [-d directory]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numParts < 1 || numVertices < 1 || numThreads < 0)
+        return 1;
+
+    System::the = new BenchSystem(numThreads);
+
+    mkdir(dir.c_str(), 0755);
+    std::string single = dir + "/single.wrl";
+    std::string world = dir + "/world.wrl";
+    std::vector<std::string> files;
+    FILE *singleFp = fopen(single.c_str(), "w");
+    FILE *worldFp = fopen(world.c_str(), "w");
+    if (!singleFp || !worldFp)
+    {
+        fprintf(stderr, "cannot write to %s\n", dir.c_str());
+        return 1;
+    }
+    fprintf(singleFp, "#VRML V2.0 utf8\n");
+    fprintf(worldFp, "#VRML V2.0 utf8\n");
+    for (int p = 0; p < numParts; ++p)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "part%05d.wrl", p);
+        files.push_back(dir + "/" + name);
+        FILE *fp = fopen(files.back().c_str(), "w");
+        if (!fp)
+        {
+            fprintf(stderr, "cannot write %s\n", files.back().c_str());
+            return 1;
+        }
+        fprintf(fp, "#VRML V2.0 utf8\n");
+        writeShape(fp, p, numVertices);
+        fclose(fp);
+        writeShape(singleFp, p, numVertices);
+        fprintf(worldFp, "Inline { url \"%s\" }\n", name);
+    }
+    fclose(singleFp);
+    fclose(worldFp);
+
+    double mb = fileSize(single) / 1024. / 1024.;
+    printf("%d parts with %d vertices, %.1f MB\n", numParts, numVertices, mb);
+
+    bool ok = true;
+    double start = now();
+    VrmlNamespace ns;
+    Doc doc(single.c_str());
+    VrmlMFNode *nodes = VrmlScene::readWrl(&doc, &ns);
+    double parse = now() - start;
+    if (!nodes || nodes->size() != numParts)
+    {
+        fprintf(stderr, "single file: %d of %d shapes parsed\n", nodes ? nodes->size() : 0, numParts);
+        ok = false;
+    }
+    delete nodes;
+    printf("single file:  %8.3f s %8.1f MB/s\n", parse, mb / parse);
+
+    start = now();
+    VrmlScene *scene = new VrmlScene(world.c_str());
+    double load = now() - start;
+    printf("Inline world: %8.3f s %8.1f MB/s, %d loader threads\n", load, mb / load,
+           FilePrefetch::instance()->getNumThreads());
+    delete scene;
+
+    for (size_t i = 0; i < files.size(); ++i)
+        unlink(files[i].c_str());
+    unlink(single.c_str());
+    unlink(world.c_str());
+    rmdir(dir.c_str());
+
+    printf("%s\n", ok ? "all parts parsed" : "parts MISSING");
+    return ok ? 0 : 1;
+}
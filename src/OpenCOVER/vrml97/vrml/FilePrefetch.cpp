@@ -0,0 +1,222 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "FilePrefetch.h"
+#include "System.h"
+
+#if HAVE_LIBPNG || HAVE_ZLIB
+#include <zlib.h>
+#endif
+#include <stdio.h>
+
+using namespace vrml;
+
+FilePrefetch::FilePrefetch(int numThreads, size_t maxBytes)
+    : numThreads(numThreads)
+    , maxBytes(maxBytes)
+    , bytes(0)
+    , quit(false)
+{
+#ifdef _WIN32
+    this->numThreads = 0;
+#else
+    if (this->numThreads < 0)
+        this->numThreads = 0;
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&queueCond, NULL);
+    pthread_cond_init(&doneCond, NULL);
+    for (int i = 0; i < this->numThreads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, work, this) == 0)
+            threads.push_back(thread);
+    }
+    this->numThreads = (int)threads.size();
+#endif
+}
+
+FilePrefetch::~FilePrefetch()
+{
+#ifndef _WIN32
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&queueCond);
+    pthread_mutex_unlock(&mutex);
+    for (size_t i = 0; i < threads.size(); ++i)
+        pthread_join(threads[i], NULL);
+    pthread_cond_destroy(&doneCond);
+    pthread_cond_destroy(&queueCond);
+    pthread_mutex_destroy(&mutex);
+#endif
+    for (std::map<std::string, File *>::iterator it = files.begin(); it != files.end(); ++it)
+        delete it->second;
+}
+
+FilePrefetch *FilePrefetch::instance()
+{
+    static FilePrefetch *prefetch = new FilePrefetch(System::the ? System::the->getInlineLoaderThreads() : 0,
+                                                     512 * 1024 * 1024);
+    return prefetch;
+}
+
+int FilePrefetch::getNumThreads() const
+{
+    return numThreads;
+}
+
+void FilePrefetch::add(const std::string &filename)
+{
+#ifndef _WIN32
+    if (numThreads == 0)
+        return;
+
+    pthread_mutex_lock(&mutex);
+    if (files.find(filename) == files.end())
+    {
+        File *file = new File;
+        file->filename = filename;
+        files[filename] = file;
+        queued.push_back(file);
+        pthread_cond_signal(&queueCond);
+    }
+    pthread_mutex_unlock(&mutex);
+#else
+    (void)filename;
+#endif
+}
+
+bool FilePrefetch::take(const std::string &filename, std::vector<char> &data)
+{
+#ifndef _WIN32
+    if (numThreads == 0)
+        return false;
+
+    pthread_mutex_lock(&mutex);
+    std::map<std::string, File *>::iterator it = files.find(filename);
+    if (it == files.end())
+    {
+        pthread_mutex_unlock(&mutex);
+        return false;
+    }
+    File *file = it->second;
+    files.erase(it);
+
+    bool ok = false;
+    if (!file->reading && !file->done)
+    {
+        // not started, reading it here is as fast as waiting for a thread
+        for (std::deque<File *>::iterator q = queued.begin(); q != queued.end(); ++q)
+        {
+            if (*q == file)
+            {
+                queued.erase(q);
+                break;
+            }
+        }
+    }
+    else
+    {
+        while (!file->done)
+            pthread_cond_wait(&doneCond, &mutex);
+        ok = file->ok;
+        bytes -= file->data.size();
+        data.swap(file->data);
+        pthread_cond_broadcast(&queueCond);
+    }
+    pthread_mutex_unlock(&mutex);
+    delete file;
+    return ok;
+#else
+    (void)filename;
+    (void)data;
+    return false;
+#endif
+}
+
+void FilePrefetch::clear()
+{
+#ifndef _WIN32
+    pthread_mutex_lock(&mutex);
+    for (std::map<std::string, File *>::iterator it = files.begin(); it != files.end(); ++it)
+    {
+        if (it->second->reading && !it->second->done)
+            it->second->dropped = true;
+        else
+            delete it->second;
+    }
+    files.clear();
+    queued.clear();
+    bytes = 0;
+    pthread_cond_broadcast(&queueCond);
+    pthread_mutex_unlock(&mutex);
+#endif
+}
+
+bool FilePrefetch::read(File *file)
+{
+#if HAVE_LIBPNG || HAVE_ZLIB
+    gzFile gz = gzopen(file->filename.c_str(), "rb");
+    if (!gz)
+        return false;
+    char buf[65536];
+    int n = 0;
+    while ((n = gzread(gz, buf, sizeof(buf))) > 0)
+        file->data.insert(file->data.end(), buf, buf + n);
+    gzclose(gz);
+#else
+    FILE *fp = fopen(file->filename.c_str(), "rb");
+    if (!fp)
+        return false;
+    char buf[65536];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        file->data.insert(file->data.end(), buf, buf + n);
+    fclose(fp);
+#endif
+    return n == 0;
+}
+
+#ifndef _WIN32
+void *FilePrefetch::work(void *prefetch)
+{
+    static_cast<FilePrefetch *>(prefetch)->work();
+    return NULL;
+}
+
+void FilePrefetch::work()
+{
+    pthread_mutex_lock(&mutex);
+    for (;;)
+    {
+        while (!quit && (queued.empty() || bytes >= maxBytes))
+            pthread_cond_wait(&queueCond, &mutex);
+        if (quit)
+            break;
+
+        File *file = queued.front();
+        queued.pop_front();
+        file->reading = true;
+        pthread_mutex_unlock(&mutex);
+
+        bool ok = read(file);
+
+        pthread_mutex_lock(&mutex);
+        if (file->dropped)
+        {
+            delete file;
+            continue;
+        }
+        file->ok = ok;
+        file->done = true;
+        if (!ok)
+            std::vector<char>().swap(file->data);
+        bytes += file->data.size();
+        pthread_cond_broadcast(&doneCond);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+#endif
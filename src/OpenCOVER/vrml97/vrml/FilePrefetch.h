@@ -0,0 +1,92 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef FILE_PREFETCH_H
+#define FILE_PREFETCH_H
+//
+//  Read (and uncompress) local VRML files in background threads
+//
+
+#include "config.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vrml
+{
+
+// The parser is not reentrant, so Inline files are parsed one after the
+// other. While one file is parsed, the files of the Inlines found so far
+// are read and uncompressed by a pool of threads. The threads stop
+// reading ahead while more than maxBytes are waiting to be parsed.
+class VRMLEXPORT FilePrefetch
+{
+public:
+    FilePrefetch(int numThreads, size_t maxBytes);
+    ~FilePrefetch();
+
+    // prefetcher of the VRML library, threads as configured by System
+    static FilePrefetch *instance();
+
+    // queue a local file, files are read in the order they were added
+    void add(const std::string &filename);
+
+    // move the contents of a file added before to data, waits while the
+    // file is being read; false if the file was not added, not yet started
+    // or could not be read
+    bool take(const std::string &filename, std::vector<char> &data);
+
+    // drop all files not taken
+    void clear();
+
+    int getNumThreads() const;
+
+private:
+    struct File
+    {
+        File()
+            : reading(false)
+            , done(false)
+            , ok(false)
+            , dropped(false)
+        {
+        }
+        std::string filename;
+        std::vector<char> data;
+        bool reading;
+        bool done;
+        bool ok;
+        bool dropped; // cleared while being read
+    };
+
+    static bool read(File *file);
+
+    int numThreads;
+    size_t maxBytes;
+    size_t bytes; // read but not yet taken
+    std::map<std::string, File *> files;
+    std::deque<File *> queued;
+    bool quit;
+
+#ifndef _WIN32
+    static void *work(void *prefetch);
+    void work();
+
+    std::vector<pthread_t> threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t queueCond; // files queued or memory released
+    pthread_cond_t doneCond; // a file was read
+#endif
+};
+}
+#endif
@@ -126,6 +126,11 @@ public:
     {
         return true;
     };
+    // threads reading Inline files ahead of the parser, 0 to read them when needed
+    virtual int getInlineLoaderThreads()
+    {
+        return 0;
+    };
 
     virtual void addViewpoint(VrmlScene *scene, VrmlNodeViewpoint *viewpoint) = 0;
     virtual bool removeViewpoint(VrmlScene *scene, const VrmlNodeViewpoint *viewpoint) = 0;
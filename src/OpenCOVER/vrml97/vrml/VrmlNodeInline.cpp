@@ -23,12 +23,24 @@
 #include "VrmlScene.h"
 #include "Viewer.h"
 #include "System.h"
+#include "FilePrefetch.h"
 #include <errno.h>
 
 #include <string>
 
 using namespace vrml;
 
+// document being parsed
+extern Doc *yyDocument;
+
+// files handled by the VRML parser, all others are passed to System::getInline
+static bool isVrmlUrl(const char *url)
+{
+    int slen = (int)strlen(url);
+    const char *end = url + slen;
+    return (slen > 4) && (strncmp(end - 4, ".wrl", 4) == 0 || strncmp(end - 4, ".wrz", 4) == 0 || strncmp(end - 4, ".WRL", 4) == 0 || strncmp(end - 4, ".WRZ", 4) == 0 || (slen > 5 && strncmp(end - 5, ".VRML", 5) == 0) || (slen > 5 && strncmp(end - 5, ".vrml", 5) == 0) || (slen > 7 && strncmp(end - 7, ".wrl.gz", 7) == 0) || (slen > 5 && strncmp(end - 5, ".x3dv", 5) == 0) || (slen > 8 && strncmp(end - 8, ".x3dv.gz", 8) == 0) || (slen > 6 && strncmp(end - 6, ".x3dvz", 6) == 0));
+}
+
 static VrmlNode *creator(VrmlScene *scene)
 {
     return new VrmlNodeInline(scene);
@@ -113,6 +125,17 @@ void VrmlNodeInline::setField(const char *fieldName,
         TRY_FIELD(url, MFString)
     else
         VrmlNodeGroup::setField(fieldName, fieldValue);
+
+    // While the document containing the Inline is parsed, start reading
+    // the file. It is parsed when the Inline is added to the scene.
+    if (yyDocument && strcmp(fieldName, "url") == 0 && d_url.size() > 0 && d_url.get(0)
+        && strncmp(name(), "Cached", 6) != 0 && FilePrefetch::instance()->getNumThreads() > 0)
+    {
+        Doc url;
+        url.seturl(d_url.get(0), yyDocument);
+        if (isVrmlUrl(url.url()) && strcmp(url.urlProtocol(), "file") == 0 && url.localName())
+            FilePrefetch::instance()->add(url.localName());
+    }
 }
 
 const VrmlField *VrmlNodeInline::getField(const char *fieldName) const
@@ -193,9 +216,7 @@ void VrmlNodeInline::load(const char *relativeUrl)
             setModified();
             sgObject = d_scene->getCachedInline(d_url.get(0)); // relative files in cache
         }
-        int slen = (int)strlen(url.url());
-        const char *end = url.url() + slen;
-        if ((sgObject == 0L) && !((slen > 4) && (strncmp(end - 4, ".wrl", 4) == 0 || strncmp(end - 4, ".wrz", 4) == 0 || strncmp(end - 4, ".WRL", 4) == 0 || strncmp(end - 4, ".WRZ", 4) == 0 || (slen > 5 && strncmp(end - 5, ".VRML", 5) == 0) || (slen > 5 && strncmp(end - 5, ".vrml", 5) == 0) || (slen > 7 && strncmp(end - 7, ".wrl.gz", 7) == 0) || (slen > 5 && strncmp(end - 5, ".x3dv", 5) == 0) || (slen > 8 && strncmp(end - 8, ".x3dv.gz", 8) == 0) || (slen > 6 && strncmp(end - 6, ".x3dvz", 6) == 0))))
+        if ((sgObject == 0L) && !isVrmlUrl(url.url()))
         {
             sgObject = System::the->getInline(url.url());
             setModified();
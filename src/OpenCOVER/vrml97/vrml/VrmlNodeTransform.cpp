@@ -178,7 +178,7 @@ void VrmlNodeTransform::setField(const char *fieldName,
         TRY_FIELD(translation, SFVec3f)
     else
         VrmlNodeGroup::setField(fieldName, fieldValue);
-    d_modified = true;
+    setModified();
 }
 
 const VrmlField *VrmlNodeTransform::getField(const char *fieldName) const
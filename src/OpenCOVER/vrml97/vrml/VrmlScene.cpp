@@ -24,6 +24,7 @@
 #include "VrmlScene.h"
 
 #include "Doc.h"
+#include "FilePrefetch.h"
 #include "Viewer.h"
 #include "System.h"
 
@@ -89,6 +90,7 @@ VrmlScene::VrmlScene(const char *sceneUrl, const char *localCopy)
     , d_urlLocal(0)
     , d_namespace(0)
     , d_modified(false)
+    , d_nodesModified(true)
     , d_newView(false)
     , d_deltaTime(DEFAULT_DELTA)
     , d_pendingUrl(0)
@@ -435,9 +437,13 @@ bool VrmlScene::load(const char *url, const char *localCopy, bool replace)
 
         System::the->setCurrentFile(url);
 
+        // Inlines not loaded while adding the world are not read ahead
+        FilePrefetch::instance()->clear();
+
         return true; // Success.
     }
 
+    FilePrefetch::instance()->clear();
     delete tryUrl;
     return false;
 }
@@ -552,18 +558,23 @@ void FillEncryptedVrmlBuffer(FILE *file)
     }
 }
 
+void SwapVrmlBuffer(vector<char> &buffer)
+{
+    vrmlBuffer.swap(buffer);
+    vrmlBufferActualPosition = vrmlBuffer.begin();
+}
+
 int ReadFromVrmlBuffer(char *buffer, int bufSize)
 {
 
     if (vrmlBufferActualPosition == vrmlBuffer.end())
         return 0;
 
-    int result = 0;
-    for (result = 0; result < bufSize && (vrmlBufferActualPosition != vrmlBuffer.end());)
-    {
-        buffer[result++] = *vrmlBufferActualPosition;
-        vrmlBufferActualPosition++;
-    }
+    int result = (int)(vrmlBuffer.end() - vrmlBufferActualPosition);
+    if (result > bufSize)
+        result = bufSize;
+    memcpy(buffer, &*vrmlBufferActualPosition, result);
+    vrmlBufferActualPosition += result;
     return result;
 }
 }
@@ -581,6 +592,21 @@ VrmlMFNode *VrmlScene::readWrl(Doc *tryUrl, VrmlNamespace *ns, bool *encrypted)
 
     System::the->debug("readWRL %s\n", tryUrl->url());
 
+    // Inline files may have been read ahead, encrypted files are
+    // handled below
+    std::vector<char> prefetched;
+    if (strcmp(tryUrl->urlProtocol(), "file") == 0 && tryUrl->localName()
+        && FilePrefetch::instance()->take(tryUrl->localName(), prefetched)
+        && !(prefetched.size() >= 4 && (unsigned char)prefetched[0] == 0xde && (unsigned char)prefetched[1] == 0xad
+             && (unsigned char)prefetched[2] == 0xc0 && (unsigned char)prefetched[3] == 0xde))
+    {
+        VrmlNamespace nodeDefs;
+        SwapVrmlBuffer(prefetched);
+        result = readFunction(ReadFromVrmlBuffer, tryUrl, ns ? ns : &nodeDefs);
+        ResetVrmlBuffer();
+        return result;
+    }
+
 // Should verify MIME type...
 #if HAVE_LIBPNG
     if ((YYIN = tryUrl->gzopen("rb")) != 0)
@@ -1309,6 +1335,10 @@ void VrmlScene::render(Viewer *viewer)
 
     clearModified();
 
+    // Nodes that have to be rendered every frame do not clear their flag,
+    // without them the scene is only rendered again after the next change
+    d_nodesModified = d_nodes.isModified();
+
     cache->save();
 
     // If any events were generated during render (ugly...) do an update
@@ -197,6 +197,13 @@ public:
         return d_modified;
     }
 
+    // Returns true if render() has work to do: the scene changed since the
+    // last render or nodes that are checked every frame stayed modified
+    bool needsRender()
+    {
+        return d_modified || d_nodesModified || d_newView || resetVPFlag;
+    }
+
     // Time until next update needed
     void setDelta(double d)
     {
@@ -315,6 +322,9 @@ protected:
     // Need render
     bool d_modified;
 
+    // Nodes still modified after the last render (e.g. enabled ProximitySensors)
+    bool d_nodesModified;
+
     // New viewpoint has been bound
     bool d_newView;
 
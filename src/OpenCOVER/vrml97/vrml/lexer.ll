@@ -173,9 +173,10 @@ unsigned int strAllocSize=SALL;
 unsigned int boolAllocSize=BALL;
 
 
-#define addInt(i) {mfInts[intSize]=i; intSize++; if(intSize>=intAllocSize) {int *oldData = mfInts; mfInts = new int[intAllocSize+IALL]; memcpy(mfInts,oldData,intAllocSize*sizeof(int)); intAllocSize+=IALL; delete[] oldData;}}
-#define addFloat(i) {mfFloats[floatSize]=i; floatSize++; if(floatSize>=floatAllocSize) {float *oldData = mfFloats; mfFloats = new float[floatAllocSize+FALL]; memcpy(mfFloats,oldData,floatAllocSize*sizeof(float)); floatAllocSize+=FALL; delete[] oldData;}}
-#define addDouble(i) {mfDoubles[doubleSize]=i; doubleSize++; if(doubleSize>=doubleAllocSize) {double *oldData = mfDoubles; mfDoubles = new double[doubleAllocSize+DALL]; memcpy(mfDoubles,oldData,doubleAllocSize*sizeof(double)); doubleAllocSize+=DALL; delete[] oldData;}}
+   /* The buffers grow geometrically, huge fields are copied only a few times */
+#define addInt(i) {mfInts[intSize]=i; intSize++; if(intSize>=intAllocSize) {int *oldData = mfInts; mfInts = new int[2*intAllocSize]; memcpy(mfInts,oldData,intAllocSize*sizeof(int)); intAllocSize*=2; delete[] oldData;}}
+#define addFloat(i) {mfFloats[floatSize]=i; floatSize++; if(floatSize>=floatAllocSize) {float *oldData = mfFloats; mfFloats = new float[2*floatAllocSize]; memcpy(mfFloats,oldData,floatAllocSize*sizeof(float)); floatAllocSize*=2; delete[] oldData;}}
+#define addDouble(i) {mfDoubles[doubleSize]=i; doubleSize++; if(doubleSize>=doubleAllocSize) {double *oldData = mfDoubles; mfDoubles = new double[2*doubleAllocSize]; memcpy(mfDoubles,oldData,doubleAllocSize*sizeof(double)); doubleAllocSize*=2; delete[] oldData;}}
 #define addStr(i) {mfStrs[strSize]=i; strSize++; if(strSize>=strAllocSize) {const char **oldData = mfStrs; mfStrs = new const char*[strAllocSize+SALL]; memcpy(mfStrs,oldData,strAllocSize*sizeof(const char*)); strAllocSize+=SALL; delete[] oldData;}}
 #define addBool(i) {fprintf(stderr, "addbool");mfBools[boolSize]=i; boolSize++; if(boolSize>=boolAllocSize) {bool *oldData = mfBools; mfBools = new bool[boolAllocSize+BALL]; memcpy(mfBools,oldData,boolAllocSize*sizeof(bool)); boolAllocSize+=BALL; delete[] oldData;}}
 
@@ -210,6 +211,181 @@ static char *skip_ws(char *s)
    return s;
 }
 
+static const double powersOf10[] = {
+   1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool isNumberEnd(char c)
+{
+   return c == '\0' || c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+   /* Parse a decimal number starting at s.  Numbers with up to 15 */
+   /* significant digits and exponents up to 22 are converted exactly */
+   /* with one multiplication or division, all others with strtod. */
+   /* Returns the end of the number or 0 if it is malformed. */
+static const char *parseDouble(const char *s, double *value)
+{
+   const char *start = s;
+   bool negative = false;
+   if (*s == '-' || *s == '+')
+      negative = (*s++ == '-');
+
+   unsigned long long mantissa = 0;
+   int digits = 0, exponent = 0;
+   bool haveDigits = false;
+   for (; *s >= '0' && *s <= '9'; ++s)
+   {
+      haveDigits = true;
+      if (mantissa || *s != '0')
+      {
+         if (digits < 19)
+         {
+            mantissa = 10 * mantissa + (*s - '0');
+            ++digits;
+         }
+         else
+            ++exponent;
+      }
+   }
+   if (*s == '.')
+   {
+      for (++s; *s >= '0' && *s <= '9'; ++s)
+      {
+         haveDigits = true;
+         if (digits < 19)
+         {
+            mantissa = 10 * mantissa + (*s - '0');
+            if (mantissa)
+               ++digits;
+            --exponent;
+         }
+      }
+   }
+   if (!haveDigits)
+      return 0;
+   if (*s == 'e' || *s == 'E')
+   {
+      ++s;
+      bool negativeExponent = false;
+      if (*s == '-' || *s == '+')
+         negativeExponent = (*s++ == '-');
+      if (*s < '0' || *s > '9')
+         return 0;
+      int e = 0;
+      for (; *s >= '0' && *s <= '9'; ++s)
+      {
+         if (e < 10000)
+            e = 10 * e + (*s - '0');
+      }
+      exponent += negativeExponent ? -e : e;
+   }
+   if (!isNumberEnd(*s))
+      return 0;
+
+   if (digits <= 15 && exponent >= -22 && exponent <= 22)
+   {
+      double v = (double)mantissa;
+      if (exponent < 0)
+         v /= powersOf10[-exponent];
+      else
+         v *= powersOf10[exponent];
+      *value = negative ? -v : v;
+   }
+   else
+   {
+      *value = strtod(start, 0);
+   }
+   return s;
+}
+
+   /* Parse an integer starting at s, hex and octal numbers as strtol */
+static const char *parseInt(const char *s, int *value)
+{
+   const char *start = s;
+   bool negative = false;
+   if (*s == '-' || *s == '+')
+      negative = (*s++ == '-');
+
+   if (*s == '0' && s[1] != '\0' && !isNumberEnd(s[1]))
+   {
+      char *end = 0;
+      *value = (int)strtol(start, &end, 0);
+      return (end != start && isNumberEnd(*end)) ? end : 0;
+   }
+
+   long long v = 0;
+   int digits = 0;
+   for (; *s >= '0' && *s <= '9'; ++s, ++digits)
+   {
+      if (digits < 18)
+         v = 10 * v + (*s - '0');
+   }
+   if (digits == 0 || !isNumberEnd(*s))
+      return 0;
+   if (digits > 10)
+      *value = (int)strtol(start, 0, 10);
+   else
+      *value = (int)(negative ? -v : v);
+   return s;
+}
+
+   /* Add the numbers in s, separated by blanks or commas, to the MF */
+   /* buffer of the field type being parsed */
+static void scanNumbers(const char *s)
+{
+   for (;;)
+   {
+      while (*s == ' ' || *s == '\t' || *s == '\r' || *s == ',')
+         ++s;
+      if (*s == '\0')
+         return;
+
+      const char *end = 0;
+      switch (expectToken)
+      {
+         case MF_INT32:
+         {
+            int i = 0;
+            end = parseInt(s, &i);
+            if (end)
+               addInt(i);
+            break;
+         }
+         case MF_DOUBLE:
+         case MF_TIME:
+         case MF_VEC2D:
+         case MF_VEC3D:
+         {
+            double d = 0.;
+            end = parseDouble(s, &d);
+            if (end)
+               addDouble(d);
+            break;
+         }
+         default:
+         {
+            double f = 0.;
+            end = parseDouble(s, &f);
+            if (end)
+               addFloat((float)f);
+            break;
+         }
+      }
+
+      if (!end)
+      {
+         end = s;
+         while (!isNumberEnd(*end))
+            ++end;
+         System::the->warn("Error near line %d: \"%.*s\" is not a number\n",
+                           currentLineNumber, (int)(end - s), s);
+      }
+      s = end;
+   }
+}
+
 
 %}
 
@@ -224,6 +400,9 @@ static char *skip_ws(char *s)
 %x MFB MFC MFCR MFD MFF MFI MFR MFS MFT MFV2 MFV3 MFV2D MFV3D
 %x IN_SFS IN_MFS IN_SFIMG
 
+   /* Inside the brackets of MF fields of numbers: */
+%x MFN
+
 bool (TRUE|FALSE)
 
    /* Big hairy expression for floating point numbers: 1.E36*/
@@ -408,6 +587,8 @@ idRestChar  ([^\x00-\x20\x22\x23\x27\x2c\x2e\x5b-\x5d\x7b\x7d])
 <MFB,MFC,MFCR,MFD,MFF,MFI,MFR,MFS,MFT,MFV2,MFV3,MFV2D,MFV3D>\[ { 
                                                if (parsing_mf) yyerror("Double [");
                                                parsing_mf = 1;
+                                               if (expectToken != MF_BOOL && expectToken != VRML_MF_STRING)
+                                                  BEGIN MFN;
                                                /* mfInts.erase(mfInts.begin(), mfInts.end());
                                                   mfFloats.erase(mfFloats.begin(), mfFloats.end());
                                                   mfStrs.erase(mfStrs.begin(), mfStrs.end());
@@ -415,11 +596,18 @@ idRestChar  ([^\x00-\x20\x22\x23\x27\x2c\x2e\x5b-\x5d\x7b\x7d])
                                                */
                                                intSize=0;
                                                floatSize=0;
+                                               doubleSize=0;
                                                strSize=0;
                                                boolSize=0;
                                              }
 
-<MFB,MFC,MFCR,MFD,MFF,MFI,MFR,MFS,MFT,MFV2,MFV3,MFV2D,MFV3D>\]   { 
+   /* A number and the separators after it are matched as one token and */
+   /* converted by hand.  Matching whole runs of numbers would make a */
+   /* field written on a single line one huge token, which flex rescans */
+   /* every time it refills its buffer. */
+<MFN>[-+0-9.eExXa-fA-F]+[, \t\r]*     { scanNumbers(yytext); }
+
+<MFB,MFC,MFCR,MFD,MFF,MFI,MFR,MFS,MFT,MFV2,MFV3,MFV2D,MFV3D,MFN>\]   { 
                                                if (! parsing_mf) yyerror("Unmatched ]");
                                                int fieldType = expectToken;
                                                switch (fieldType) {
@@ -1333,7 +1521,7 @@ idRestChar  ([^\x00-\x20\x22\x23\x27\x2c\x2e\x5b-\x5d\x7b\x7d])
 
    /* Whitespace rules apply to all start states except inside strings: */
 
-<INITIAL,NODE,SFB,SFC,SFCR,SFD,SFF,SFIMG,SFI,SFR,SFS,SFT,SFV2,SFV3,SFV2D,SFV3D,MFB,MFC,MFCR,MFD,MFF,MFI,MFR,MFS,MFT,MFV2,MFV3,MFV2D,MFV3D,IN_SFIMG>{
+<INITIAL,NODE,SFB,SFC,SFCR,SFD,SFF,SFIMG,SFI,SFR,SFS,SFT,SFV2,SFV3,SFV2D,SFV3D,MFB,MFC,MFCR,MFD,MFF,MFI,MFR,MFS,MFT,MFV2,MFV3,MFV2D,MFV3D,MFN,IN_SFIMG>{
   {wsnnl}+                ;
 
         /* This is also whitespace, but we'll keep track of line number */
@@ -19,6 +19,16 @@
 #include <do/coDoData.h>
 #include <do/coDoPolygons.h>
 #include <do/coDoUnstructuredGrid.h>
+#include <do/coDoNeighborList.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace covise
 {
@@ -32,6 +42,72 @@ using namespace covise;
 
 #define NODES_IN_ELEM(i) (((i) == num_elem - 1) ? num_conn - elem_list[(i)] : elem_list[(i) + 1] - elem_list[(i)])
 
+namespace
+{
+
+// serial scatter over the cells: without a cached vertex->cell list and
+// with a single thread this is faster than building the list for a gather
+void scatterAlgo(int num_elem, int num_conn, int num_point,
+                 const int *elem_list, const int *conn_list,
+                 int numComp, const float *in_data_0, const float *in_data_1, const float *in_data_2,
+                 float *out_data_0, float *out_data_1, float *out_data_2)
+{
+    // != 0 to prevent div/0 errors
+    std::vector<float> weight_num(num_point, 1.0e-30f);
+    float *out[3] = { out_data_0, out_data_1, out_data_2 };
+    for (int c = 0; c < numComp; c++)
+        std::fill(out[c], out[c] + num_point, 0.0f);
+
+    if (numComp == 1)
+    {
+        for (int i = 0; i < num_elem; i++)
+        {
+            const int end = elem_list[i] + NODES_IN_ELEM(i);
+            for (int j = elem_list[i]; j < end; j++)
+            {
+                const int vertex = conn_list[j];
+                weight_num[vertex] += 1.0f;
+                out_data_0[vertex] += in_data_0[i];
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < num_elem; i++)
+        {
+            const int end = elem_list[i] + NODES_IN_ELEM(i);
+            for (int j = elem_list[i]; j < end; j++)
+            {
+                const int vertex = conn_list[j];
+                weight_num[vertex] += 1.0f;
+                out_data_0[vertex] += in_data_0[i];
+                out_data_1[vertex] += in_data_1[i];
+                out_data_2[vertex] += in_data_2[i];
+            }
+        }
+    }
+
+    // divide value sum by 'weight' (# adjacent cells)
+    for (int vertex = 0; vertex < num_point; vertex++)
+    {
+        if (weight_num[vertex] >= 1.0f)
+        {
+            for (int c = 0; c < numComp; c++)
+                out[c][vertex] /= weight_num[vertex];
+        }
+    }
+}
+}
+
+coCellToVertIndex::coCellToVertIndex(int num_elem, int num_conn, int num_point,
+                                     const int *elem_list, const int *conn_list)
+    : numElem(num_elem)
+    , numConn(num_conn)
+{
+    coDoNeighborList::buildVertexCells(num_elem, num_conn, num_point, elem_list, conn_list, NULL,
+                                       index, cells);
+}
+
 ////// workin' routines
 bool
 coCellToVert::interpolate(bool unstructured, int num_elem, int num_conn, int num_point,
@@ -110,85 +186,132 @@ coCellToVert::simpleAlgo(int num_elem, int num_conn, int num_point,
                          int numComp, const float *in_data_0, const float *in_data_1, const float *in_data_2,
                          float *out_data_0, float *out_data_1, float *out_data_2)
 {
-    int i, j, n, vertex;
     enum
     {
         SCALAR = 1,
         VECTOR = 3
     };
 
-    float *weight_num;
-    weight_num = new float[num_point];
-
-    if (!weight_num)
-        return false;
+    const coCellToVertIndex *index = NULL;
+    if (vertexCells && vertexCells->fits(num_elem, num_conn, num_point))
+        index = vertexCells;
 
-    // reset everything to 0, != 0 to prevent div/0 errors
-    for (vertex = 0; vertex < num_point; vertex++)
-        weight_num[vertex] = 1.0e-30f;
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    if (!index && numThreads <= 1)
+    {
+        scatterAlgo(num_elem, num_conn, num_point, elem_list, conn_list,
+                    numComp, in_data_0, in_data_1, in_data_2,
+                    out_data_0, out_data_1, out_data_2);
+        return true;
+    }
 
-    if (numComp == SCALAR)
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_0[vertex] = 0.0;
+    // gather instead of scatter: every connectivity entry is listed for its
+    // vertex with ascending cell numbers, so each vertex sums up its cells in
+    // the same order as a serial loop over the cells and can be handled by
+    // its own thread without any synchronization
+    std::vector<int> cell_idx, cells;
+    const int *idx = NULL, *cell = NULL;
+    if (index)
+    {
+        idx = &index->index[0];
+        cell = index->cells.empty() ? NULL : &index->cells[0];
+    }
     else
     {
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_0[vertex] = 0.0;
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_1[vertex] = 0.0;
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_2[vertex] = 0.0;
+        coDoNeighborList::buildVertexCells(num_elem, num_conn, num_point, elem_list, conn_list, NULL,
+                                           cell_idx, cells);
+        idx = num_point > 0 ? &cell_idx[0] : NULL;
+        cell = cells.empty() ? NULL : &cells[0];
     }
 
+    // weight != 0 to prevent div/0 errors
     if (numComp == SCALAR)
-        for (i = 0; i < num_elem; i++)
+    {
+#pragma omp parallel for schedule(static, 4096)
+        for (int vertex = 0; vertex < num_point; vertex++)
         {
-            n = NODES_IN_ELEM(i);
-            for (j = 0; j < n; j++)
+            float weight_num = 1.0e-30f;
+            float sum_0 = 0.0f;
+            for (int k = idx[vertex]; k < idx[vertex + 1]; k++)
             {
-                vertex = conn_list[elem_list[i] + j];
-                weight_num[vertex] += 1.0;
-                out_data_0[vertex] += in_data_0[i];
+                weight_num += 1.0f;
+                sum_0 += in_data_0[cell[k]];
             }
+
+            // divide value sum by 'weight' (# adjacent cells)
+            out_data_0[vertex] = (weight_num >= 1.0f) ? sum_0 / weight_num : sum_0;
         }
+    }
     else
-        for (i = 0; i < num_elem; i++)
+    {
+#ifdef __SSE__
+        // the three components are summed up in the lanes of one register:
+        // every lane sees the same additions as the scalar loop, and only one
+        // cache line instead of three is fetched per cell
+        std::vector<float> packed(4 * (size_t)num_elem);
+        float *in_4 = num_elem > 0 ? &packed[0] : NULL;
+#pragma omp parallel for schedule(static, 4096)
+        for (int i = 0; i < num_elem; i++)
         {
-            n = NODES_IN_ELEM(i);
-            for (j = 0; j < n; j++)
-            {
-                vertex = conn_list[elem_list[i] + j];
-                weight_num[vertex] += 1.0;
-                out_data_0[vertex] += in_data_0[i];
-                out_data_1[vertex] += in_data_1[i];
-                out_data_2[vertex] += in_data_2[i];
-            }
+            in_4[4 * (size_t)i] = in_data_0[i];
+            in_4[4 * (size_t)i + 1] = in_data_1[i];
+            in_4[4 * (size_t)i + 2] = in_data_2[i];
+            in_4[4 * (size_t)i + 3] = 0.0f;
         }
 
-    // divide value sum by 'weight' (# adjacent cells)
+#pragma omp parallel for schedule(static, 4096)
+        for (int vertex = 0; vertex < num_point; vertex++)
+        {
+            float weight_num = 1.0e-30f;
+            __m128 sum = _mm_setzero_ps();
+            for (int k = idx[vertex]; k < idx[vertex + 1]; k++)
+            {
+                weight_num += 1.0f;
+                sum = _mm_add_ps(sum, _mm_loadu_ps(in_4 + 4 * (size_t)cell[k]));
+            }
 
-    if (numComp == SCALAR)
-    {
-        for (vertex = 0; vertex < num_point; vertex++)
-            if (weight_num[vertex] >= 1.0)
-                out_data_0[vertex] /= weight_num[vertex];
-    }
-    else
-    {
-        for (vertex = 0; vertex < num_point; vertex++)
+            if (weight_num >= 1.0f)
+                sum = _mm_div_ps(sum, _mm_set1_ps(weight_num));
+            float out[4];
+            _mm_storeu_ps(out, sum);
+            out_data_0[vertex] = out[0];
+            out_data_1[vertex] = out[1];
+            out_data_2[vertex] = out[2];
+        }
+#else
+#pragma omp parallel for schedule(static, 4096)
+        for (int vertex = 0; vertex < num_point; vertex++)
         {
-            if (weight_num[vertex] >= 1.0)
+            float weight_num = 1.0e-30f;
+            float sum_0 = 0.0f, sum_1 = 0.0f, sum_2 = 0.0f;
+            for (int k = idx[vertex]; k < idx[vertex + 1]; k++)
+            {
+                const int c = cell[k];
+                weight_num += 1.0f;
+                sum_0 += in_data_0[c];
+                sum_1 += in_data_1[c];
+                sum_2 += in_data_2[c];
+            }
+
+            if (weight_num >= 1.0f)
             {
-                out_data_0[vertex] /= weight_num[vertex];
-                out_data_1[vertex] /= weight_num[vertex];
-                out_data_2[vertex] /= weight_num[vertex];
+                out_data_0[vertex] = sum_0 / weight_num;
+                out_data_1[vertex] = sum_1 / weight_num;
+                out_data_2[vertex] = sum_2 / weight_num;
+            }
+            else
+            {
+                out_data_0[vertex] = sum_0;
+                out_data_1[vertex] = sum_1;
+                out_data_2[vertex] = sum_2;
             }
         }
+#endif
     }
 
-    // clean up
-    delete[] weight_num;
-
     return true;
 }
 
@@ -204,25 +327,18 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
 
     // now go through all elements and calculate their center
 
-    int *ePtr = (int *)elem_list;
-    int *tPtr = (int *)type_list;
-
-    int el_type;
-    int elem, num_vert_elem;
-    int vert, vertex, *vertex_id;
-
-    float *xc, *yc, *zc;
-
     float *cell_center_0 = new float[num_elem];
     float *cell_center_1 = new float[num_elem];
     float *cell_center_2 = new float[num_elem];
 
     //static const int num_vertices_per_element[] = {0,2,3,4,4,5,6,8};
 
-    for (elem = 0; elem < num_elem; elem++)
+#pragma omp parallel for schedule(static, 4096)
+    for (int elem = 0; elem < num_elem; elem++)
     {
-        el_type = *tPtr++; // get this elements type (then go on to the next one)
+        int el_type = type_list[elem]; // get this elements type
         //num_vert_elem = num_vertices_per_element[el_type];
+        int num_vert_elem;
         if (elem == num_elem - 1)
         {
             num_vert_elem = num_conn - elem_list[elem];
@@ -233,16 +349,10 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
         }
 
         // # of vertices in current element
-        vertex_id = (int *)conn_list + (*ePtr++); // get ptr to the first vertex-id of current element
-        // then go on to the next one
-
-        // place where to store the calculated center-coordinates in
-        xc = &cell_center_0[elem];
-        yc = &cell_center_1[elem];
-        zc = &cell_center_2[elem];
+        const int *vertex_id = conn_list + elem_list[elem]; // get ptr to the first vertex-id of current element
 
-        // reset
-        (*xc) = (*yc) = (*zc) = 0.0;
+        // the center is accumulated here and stored at the end
+        float xc = 0.0, yc = 0.0, zc = 0.0;
 
         //FIXME doesn't make sense for Polyhedrons
         // the center can be calculated now
@@ -251,7 +361,7 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
             int num_averaged = 0;
             int facestart = conn_list[elem_list[elem]];
             bool face_done = true;
-            for (vert = 0; vert < num_vert_elem; vert++)
+            for (int vert = 0; vert < num_vert_elem; vert++)
             {
                 int cur_vert = conn_list[elem_list[elem] + vert];
                 if (face_done)
@@ -264,64 +374,58 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
                     face_done = true;
                     continue;
                 }
-                (*xc) += xcoord[cur_vert];
-                (*yc) += ycoord[cur_vert];
-                (*zc) += zcoord[cur_vert];
+                xc += xcoord[cur_vert];
+                yc += ycoord[cur_vert];
+                zc += zcoord[cur_vert];
                 ++num_averaged;
             }
-            (*xc) /= num_averaged;
-            (*yc) /= num_averaged;
-            (*zc) /= num_averaged;
+            xc /= num_averaged;
+            yc /= num_averaged;
+            zc /= num_averaged;
         }
         else
         {
-            for (vert = 0; vert < num_vert_elem; vert++)
+            for (int vert = 0; vert < num_vert_elem; vert++)
             {
-                (*xc) += xcoord[*vertex_id];
-                (*yc) += ycoord[*vertex_id];
-                (*zc) += zcoord[*vertex_id];
+                xc += xcoord[*vertex_id];
+                yc += ycoord[*vertex_id];
+                zc += zcoord[*vertex_id];
                 vertex_id++;
             }
-            (*xc) /= num_vert_elem;
-            (*yc) /= num_vert_elem;
-            (*zc) /= num_vert_elem;
+            xc /= num_vert_elem;
+            yc /= num_vert_elem;
+            zc /= num_vert_elem;
         }
-    }
-
-    int actIndex = 0;
-    int ni, cp;
-
-    int *niPtr = (int *)neighbour_idx + 1;
-    int *cellPtr = (int *)neighbour_cells;
 
-    double weight_sum, weight;
-    double value_sum_0, value_sum_1, value_sum_2;
-    float vx, vy, vz, ccx, ccy, ccz;
+        cell_center_0[elem] = xc;
+        cell_center_1[elem] = yc;
+        cell_center_2[elem] = zc;
+    }
 
-    for (vertex = 0; vertex < num_point; vertex++)
+    // every vertex gathers the values of its neighbour cells independently
+#pragma omp parallel for schedule(static, 4096)
+    for (int vertex = 0; vertex < num_point; vertex++)
     {
-        weight_sum = 0.0;
-        value_sum_0 = 0.0;
-        value_sum_1 = 0.0;
-        value_sum_2 = 0.0;
-
-        vx = xcoord[vertex];
-        vy = ycoord[vertex];
-        vz = zcoord[vertex];
+        double weight_sum = 0.0;
+        double value_sum_0 = 0.0;
+        double value_sum_1 = 0.0;
+        double value_sum_2 = 0.0;
 
-        ni = *niPtr;
+        const float vx = xcoord[vertex];
+        const float vy = ycoord[vertex];
+        const float vz = zcoord[vertex];
 
-        while (actIndex < ni) // loop over neighbour cells
+        for (int actIndex = neighbour_idx[vertex]; actIndex < neighbour_idx[vertex + 1]; actIndex++) // loop over neighbour cells
         {
-            cp = *cellPtr;
-            ccx = cell_center_0[cp];
-            ccy = cell_center_1[cp];
-            ccz = cell_center_2[cp];
+            const int cp = neighbour_cells[actIndex];
+            const float ccx = cell_center_0[cp];
+            const float ccy = cell_center_1[cp];
+            const float ccz = cell_center_2[cp];
 
             // cells with 0 volume are not weigthed
             //XXX: was soll das?
             //weight = (weight==0.0) ? 0 : (1.0/weight);
-            weight = sqr(vx - ccx) + sqr(vy - ccy) + sqr(vz - ccz);
+            const double weight = sqr(vx - ccx) + sqr(vy - ccy) + sqr(vz - ccz);
             weight_sum += weight;
 
             if (numComp == 1)
@@ -332,12 +436,8 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
                 value_sum_1 += weight * in_data_1[cp];
                 value_sum_2 += weight * in_data_2[cp];
             }
-
-            actIndex++;
-            cellPtr++;
         }
 
-        niPtr++;
         if (weight_sum == 0)
             weight_sum = 1.0;
 
@@ -351,6 +451,10 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
         }
     }
 
+    delete[] cell_center_0;
+    delete[] cell_center_1;
+    delete[] cell_center_2;
+
     return true;
 }
 
@@ -436,10 +540,25 @@ coCellToVert::interpolate(const coDistributedObject *geo_in,
     else
         return NULL;
 
+    // the list of a grid is kept when the grid is interpolated again
+    const coCellToVertIndex *arrayIndex = vertexCells;
+    if (indexCache && algo_option == SIMPLE && geo_in->getName())
+    {
+        coCellToVertIndex **index = indexCache->lookup(geo_in->getName());
+        if (index)
+        {
+            if (!*index)
+                *index = new coCellToVertIndex(num_elem, num_conn, num_point, elem_list, conn_list);
+            vertexCells = *index;
+        }
+    }
+
     bool unstructured = (dynamic_cast<const coDoUnstructuredGrid *>(geo_in) != NULL);
-    return interpolate(unstructured, num_elem, num_conn, num_point,
-                       elem_list, conn_list, type_list, neighbour_cells, neighbour_idx, xcoord, ycoord, zcoord,
-                       numComp, dataSize, in_data_0, in_data_1, in_data_2, objName, algo_option);
+    coDistributedObject *data_return = interpolate(unstructured, num_elem, num_conn, num_point,
+                                                   elem_list, conn_list, type_list, neighbour_cells, neighbour_idx, xcoord, ycoord, zcoord,
+                                                   numComp, dataSize, in_data_0, in_data_1, in_data_2, objName, algo_option);
+    vertexCells = arrayIndex;
+    return data_return;
 }
 
 coDistributedObject *
@@ -18,15 +18,44 @@
 // ++**********************************************************************/
 
 #include <covise/covise.h>
+#include "coIndexCache.h"
+#include <vector>
 
 namespace covise
 {
 
 class coDistributedObject;
 
+/// vertex->cell list of a grid, kept by a module in a coIndexCache
+class ALGEXPORT coCellToVertIndex
+{
+public:
+    coCellToVertIndex(int num_elem, int num_conn, int num_point,
+                      const int *elem_list, const int *conn_list);
+
+    bool fits(int num_elem, int num_conn, int num_point) const
+    {
+        return num_elem == numElem && num_conn == numConn && num_point + 1 == (int)index.size();
+    }
+
+    size_t getMemorySize() const
+    {
+        return (index.size() + cells.size()) * sizeof(int);
+    }
+
+    std::vector<int> index; // start of the cells of each vertex in cells
+    std::vector<int> cells; // cells using a vertex, ascending per vertex
+
+private:
+    int numElem, numConn;
+};
+
 class ALGEXPORT coCellToVert
 {
 private:
+    coIndexCache<coCellToVertIndex> *indexCache;
+    const coCellToVertIndex *vertexCells;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     //
     // Original algorithm by Andreas Werner: + Assume data value related to center of elements.
@@ -58,6 +87,25 @@ private:
                     float *out_data_0, float *out_data_1, float *out_data_2);
 
 public:
+    //
+    //  cache: vertex->cell lists of the grids of previous executions,
+    //         looked up by grid name, NULL: build the list in every call
+    //
+    coCellToVert(coIndexCache<coCellToVertIndex> *cache = NULL)
+        : indexCache(cache)
+        , vertexCells(NULL)
+    {
+    }
+
+    //
+    //  vertex->cell list for the following interpolations of plain arrays,
+    //  NULL: build it in every call
+    //
+    void setIndex(const coCellToVertIndex *index)
+    {
+        vertexCells = index;
+    }
+
     typedef enum
     {
         SQR_WEIGHT = 1,
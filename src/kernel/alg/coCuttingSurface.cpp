@@ -104,6 +104,96 @@ void AttributeContainer::addAttributes(coDistributedObject *p_obj, const char *p
     p_obj->addAttribute("Probe2D", probeAttr);
 }
 
+//========================= CellBlockIndex ===========================
+
+CellBlockIndex::CellBlockIndex(int n_elem, int n_conn, const int *p_el, const int *p_cl,
+                               const float *p_x_in, const float *p_y_in, const float *p_z_in)
+{
+    int num_blocks = (n_elem + BlockSize - 1) / BlockSize;
+    bounds.resize(6 * num_blocks);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int block = 0; block < num_blocks; block++)
+    {
+        float *box = &bounds[6 * block];
+        box[0] = box[1] = box[2] = FLT_MAX;
+        box[3] = box[4] = box[5] = -FLT_MAX;
+
+        // the connectivity of the cells of a block is contiguous
+        int begin = block * BlockSize;
+        int end = begin + BlockSize;
+        int conn_end = (end < n_elem) ? p_el[end] : n_conn;
+        for (int c = p_el[begin]; c < conn_end; c++)
+        {
+            int node = p_cl[c];
+            if (p_x_in[node] < box[0])
+                box[0] = p_x_in[node];
+            if (p_y_in[node] < box[1])
+                box[1] = p_y_in[node];
+            if (p_z_in[node] < box[2])
+                box[2] = p_z_in[node];
+            if (p_x_in[node] > box[3])
+                box[3] = p_x_in[node];
+            if (p_y_in[node] > box[4])
+                box[4] = p_y_in[node];
+            if (p_z_in[node] > box[5])
+                box[5] = p_z_in[node];
+        }
+    }
+}
+
+bool CellBlockIndex::isCut(int block, int option, float planei, float planej, float planek,
+                           float distance, float radius) const
+{
+    const float *box = &bounds[6 * block];
+    if (box[0] > box[3])
+        return false; // no nodes
+
+    float center[3], extent[3];
+    for (int i = 0; i < 3; i++)
+    {
+        center[i] = 0.5f * (box[i] + box[i + 3]);
+        extent[i] = 0.5f * (box[i + 3] - box[i]);
+    }
+
+    // range of the signed distance of the nodes within the box
+    float min_dist, max_dist, scale;
+    if (option == 0)
+    {
+        float c = planei * center[0] + planej * center[1] + planek * center[2] - distance;
+        float e = fabs(planei) * extent[0] + fabs(planej) * extent[1] + fabs(planek) * extent[2];
+        min_dist = c - e;
+        max_dist = c + e;
+        scale = fabs(c) + e + fabs(distance);
+    }
+    else
+    {
+        // sphere around (planei, planej, planek), cylinders ignore their axis
+        float point[3] = { planei, planej, planek };
+        float near2 = 0.f, far2 = 0.f;
+        for (int i = 0; i < 3; i++)
+        {
+            if (option == i + 2)
+                continue;
+            float d = fabs(point[i] - center[i]);
+            float n = (d > extent[i]) ? d - extent[i] : 0.f;
+            float f = d + extent[i];
+            near2 += n * n;
+            far2 += f * f;
+        }
+        min_dist = sqrt(near2) - radius;
+        max_dist = sqrt(far2) - radius;
+        scale = sqrt(far2) + radius;
+    }
+
+    // nodes with a distance >= 0 are above the surface,
+    // allow for the rounding of the distances of the nodes
+    float margin = 1e-5f * scale;
+    return min_dist - margin < 0.f && max_dist + margin >= 0.f;
+}
+
 //========================= Plane ====================================
 
 Plane::Plane()
@@ -120,7 +210,8 @@ Plane::Plane(int n_elem, int n_nodes, int Type, int *p_el,
              float vertexRatio, int maxPoly,
              float planei_, float planej_, float planek_, float startx_,
              float starty_, float startz_, float myDistance_, float radius_,
-             int gennormals_, int option_, int genstrips_, char *ib)
+             int gennormals_, int option_, int genstrips_, char *ib,
+             const CellBlockIndex *index)
     : planei(planei_)
     , planej(planej_)
     , planek(planek_)
@@ -137,7 +228,6 @@ Plane::Plane(int n_elem, int n_nodes, int Type, int *p_el,
 
     unstr_ = true;
     maxPolyPerVertex = maxPoly;
-    NodeInfo *node;
     int i;
     iblank = ib;
     el = p_el;
@@ -161,72 +251,25 @@ Plane::Plane(int n_elem, int n_nodes, int Type, int *p_el,
     num_elem = n_elem;
     //    node_table   = (NodeInfo *)malloc(n_nodes*sizeof(NodeInfo));
     node_table = new NodeInfo[num_nodes];
-    node = node_table;
-    float tmpi, tmpj, tmpk;
     cur_line_elem = 0;
-    if (option == 0)
+    cell_index = NULL;
+    if (index && index->getNumBlocks() == (num_elem + CellBlockIndex::BlockSize - 1) / CellBlockIndex::BlockSize)
+        cell_index = index;
+    num_visited = num_elem;
+    // with a cell index, only the nodes of cut cells are initialized in createPlane
+    if (!cell_index)
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (i = 0; i < n_nodes; i++)
         {
+            NodeInfo *node = node_table + i;
             node->targets[0] = 0;
             // Calculate the myDistance of each node
-            // to the Cuttingplane
-            node->dist = (planei * x_in[i] + planej * y_in[i] + planek * z_in[i] - myDistance);
-            node->side = (node->dist >= 0 ? 1 : 0);
-            node++;
-        }
-    }
-    else if (option == 1) //sphere
-    {
-        for (i = 0; i < n_nodes; i++)
-        {
-            node->targets[0] = 0; // Calculate the myDistance of each node
-            // to the Cuttingsphere
-            tmpi = planei - x_in[i];
-            tmpj = planej - y_in[i];
-            tmpk = planek - z_in[i];
-            node->dist = sqrt(tmpi * tmpi + tmpj * tmpj + tmpk * tmpk) - radius;
-            node->side = (node->dist >= 0 ? 1 : 0);
-            node++;
-        }
-    }
-    else if (option == 2) //cylinder-X
-    {
-        for (i = 0; i < n_nodes; i++)
-        {
-            node->targets[0] = 0; // Calculate the myDistance of each node
-            // to the Cuttingsphere
-            tmpj = planej - y_in[i]; // start <-> plane
-            tmpk = planek - z_in[i];
-            node->dist = sqrt(tmpk * tmpk + tmpj * tmpj) - radius;
-            node->side = (node->dist >= 0 ? 1 : 0);
-            node++;
-        }
-    }
-    else if (option == 3) //cylinder-Y
-    {
-        for (i = 0; i < n_nodes; i++)
-        {
-            node->targets[0] = 0; // Calculate the myDistance of each node
-            // to the Cuttingsphere
-            tmpi = planei - x_in[i]; // start <-> plane
-            tmpk = planek - z_in[i];
-            node->dist = sqrt(tmpi * tmpi + tmpk * tmpk) - radius;
-            node->side = (node->dist >= 0 ? 1 : 0);
-            node++;
-        }
-    }
-    else if (option == 4) //cylinder-Z
-    {
-        for (i = 0; i < n_nodes; i++)
-        {
-            node->targets[0] = 0; // Calcuulate the myDistance of each node
-            // to the Cuttingsphere
-            tmpi = planei - x_in[i]; // start <-> plane
-            tmpj = planej - y_in[i];
-            node->dist = sqrt(tmpi * tmpi + tmpj * tmpj) - radius;
+            // to the Cuttingsurface
+            node->dist = distance(i);
             node->side = (node->dist >= 0 ? 1 : 0);
-            node++;
         }
     }
     num_triangles = num_vertices = num_coords = 0;
@@ -321,6 +364,8 @@ void Plane::initialize()
     I_Data_p = NULL;
     node_table = NULL;
     iblank = NULL;
+    cell_index = NULL;
+    num_visited = 0;
 }
 
 Plane::~Plane()
@@ -359,53 +404,64 @@ Plane::~Plane()
 
 bool Plane::createPlane()
 {
-    // 1 = above; 0 = below
-    for (int element = 0; element < num_elem; element++)
+    std::vector<int> cells;
+    findCutCells(cells);
+
+    if (cell_index)
     {
-        if (iblank == NULL || iblank[element] != '\0')
+        for (size_t c = 0; c < cells.size(); c++)
         {
-            int elementtype = tl[element];
-            int bitmap = 0; // index in the MarchingCubes table
-            int i = UnstructuredGrid_Num_Nodes[elementtype];
-            // number of nodes for current element
+            int element = cells[c];
             int *node_list = cl + el[element];
-            // pointer to nodes of current element
-            int *node = node_list + i;
-            // node = pointer to last node of current element
-            while (i--)
-                bitmap |= node_table[*--node].side << i;
-            // bitmap is now an index to the Cuttingtable
-            if (Cutting_Info[elementtype])
+            for (int i = 0; i < UnstructuredGrid_Num_Nodes[tl[element]]; i++)
             {
-                cutting_info *C_Info = Cutting_Info[elementtype] + bitmap;
-                int numIntersections = C_Info->nvert;
-                if (numIntersections)
-                {
-                    int *polygon_nodes = C_Info->node_pairs;
-                    num_triangles += numIntersections - 2;
-                    int *firstvertex = vertex;
-                    for (i = 0; i < numIntersections; i++)
-                    {
-                        int n1 = node_list[*polygon_nodes++];
-                        int n2 = node_list[*polygon_nodes++];
-                        if (i > 2)
-                        {
-                            *vertex++ = *firstvertex;
-                            *vertex = *(vertex - 2);
-                            vertex++;
-                        }
-                        if (n1 < n2)
-                        {
-                            if (!add_vertex(n1, n2))
-                                return false;
-                        }
-                        else
-                        {
-                            if (!add_vertex(n2, n1))
-                                return false;
-                        }
-                    }
-                }
+                NodeInfo *node = node_table + node_list[i];
+                node->targets[0] = 0;
+                node->dist = distance(node_list[i]);
+                node->side = (node->dist >= 0 ? 1 : 0);
+            }
+        }
+    }
+
+    // 1 = above; 0 = below
+    for (size_t c = 0; c < cells.size(); c++)
+    {
+        int element = cells[c];
+        int elementtype = tl[element];
+        int bitmap = 0; // index in the MarchingCubes table
+        int i = UnstructuredGrid_Num_Nodes[elementtype];
+        // number of nodes for current element
+        int *node_list = cl + el[element];
+        // pointer to nodes of current element
+        int *node = node_list + i;
+        // node = pointer to last node of current element
+        while (i--)
+            bitmap |= node_table[*--node].side << i;
+        // bitmap is now an index to the Cuttingtable
+        cutting_info *C_Info = Cutting_Info[elementtype] + bitmap;
+        int numIntersections = C_Info->nvert;
+        int *polygon_nodes = C_Info->node_pairs;
+        num_triangles += numIntersections - 2;
+        int *firstvertex = vertex;
+        for (i = 0; i < numIntersections; i++)
+        {
+            int n1 = node_list[*polygon_nodes++];
+            int n2 = node_list[*polygon_nodes++];
+            if (i > 2)
+            {
+                *vertex++ = *firstvertex;
+                *vertex = *(vertex - 2);
+                vertex++;
+            }
+            if (n1 < n2)
+            {
+                if (!add_vertex(n1, n2))
+                    return false;
+            }
+            else
+            {
+                if (!add_vertex(n2, n1))
+                    return false;
             }
         }
     }
@@ -417,6 +473,79 @@ bool Plane::createPlane()
     return true;
 }
 
+float Plane::distance(int i) const
+{
+    float tmpi, tmpj, tmpk;
+    switch (option)
+    {
+    case 1: //sphere
+        tmpi = planei - x_in[i];
+        tmpj = planej - y_in[i];
+        tmpk = planek - z_in[i];
+        return sqrt(tmpi * tmpi + tmpj * tmpj + tmpk * tmpk) - radius;
+    case 2: //cylinder-X
+        tmpj = planej - y_in[i]; // start <-> plane
+        tmpk = planek - z_in[i];
+        return sqrt(tmpk * tmpk + tmpj * tmpj) - radius;
+    case 3: //cylinder-Y
+        tmpi = planei - x_in[i]; // start <-> plane
+        tmpk = planek - z_in[i];
+        return sqrt(tmpi * tmpi + tmpk * tmpk) - radius;
+    case 4: //cylinder-Z
+        tmpi = planei - x_in[i]; // start <-> plane
+        tmpj = planej - y_in[i];
+        return sqrt(tmpi * tmpi + tmpj * tmpj) - radius;
+    default: //plane
+        return planei * x_in[i] + planej * y_in[i] + planek * z_in[i] - myDistance;
+    }
+}
+
+void Plane::findCutCells(std::vector<int> &cells)
+{
+    int num_blocks = (num_elem + CellBlockIndex::BlockSize - 1) / CellBlockIndex::BlockSize;
+
+    // blocks are classified in parallel, their cells are concatenated in order
+    std::vector<std::vector<int> > block_cells(num_blocks);
+    int visited = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+ : visited)
+#endif
+    for (int block = 0; block < num_blocks; block++)
+    {
+        if (cell_index && !cell_index->isCut(block, option, planei, planej, planek, myDistance, radius))
+            continue;
+
+        int begin = block * CellBlockIndex::BlockSize;
+        int end = begin + CellBlockIndex::BlockSize;
+        if (end > num_elem)
+            end = num_elem;
+        visited += end - begin;
+
+        for (int element = begin; element < end; element++)
+        {
+            if (iblank != NULL && iblank[element] == '\0')
+                continue;
+            int elementtype = tl[element];
+            if (!Cutting_Info[elementtype])
+                continue;
+            int bitmap = 0;
+            const int *node_list = cl + el[element];
+            for (int i = 0; i < UnstructuredGrid_Num_Nodes[elementtype]; i++)
+            {
+                int side = cell_index ? (distance(node_list[i]) >= 0 ? 1 : 0) : node_table[node_list[i]].side;
+                bitmap |= side << i;
+            }
+            if (Cutting_Info[elementtype][bitmap].nvert)
+                block_cells[block].push_back(element);
+        }
+    }
+    num_visited = visited;
+
+    cells.clear();
+    for (int block = 0; block < num_blocks; block++)
+        cells.insert(cells.end(), block_cells[block].begin(), block_cells[block].end());
+}
+
 // return false if  no  space left
 bool Plane::add_vertex(int n1, int n2)
 {
@@ -9,6 +9,7 @@
 #define CO_CUTTINGSURFACE_H
 
 #include <map>
+#include <vector>
 
 #include "CuttingSurfaceGPMUtil.h"
 
@@ -69,6 +70,34 @@ public:
     void addAttributes(coDistributedObject *p_obj, const char *probeAttr);
 };
 
+/// Bounding boxes of blocks of consecutive cells of an unstructured grid
+///
+/// Built once per grid and kept by the module between executions,
+/// so that a cutting surface only visits the cells of blocks it may cut.
+class ALGEXPORT CellBlockIndex
+{
+public:
+    enum
+    {
+        BlockSize = 256
+    };
+
+    CellBlockIndex(int n_elem, int n_conn, const int *p_el, const int *p_cl,
+                   const float *p_x_in, const float *p_y_in, const float *p_z_in);
+
+    int getNumBlocks() const
+    {
+        return (int)(bounds.size() / 6);
+    }
+
+    // may the surface cut cells of the block, parameters as for Plane
+    bool isCut(int block, int option, float planei, float planej, float planek,
+               float distance, float radius) const;
+
+private:
+    std::vector<float> bounds; // min x, y, z and max x, y, z for each block
+};
+
 class ALGEXPORT Plane
 {
     friend class Isoline;
@@ -152,6 +181,14 @@ private:
 
     float x_minb, y_minb, z_minb, x_maxb, y_maxb, z_maxb;
 
+    const CellBlockIndex *cell_index;
+    int num_visited;
+
+    // signed distance of a node to the cutting surface
+    float distance(int node) const;
+    // cells cut by the surface in the order of the grid
+    void findCutCells(std::vector<int> &cells);
+
     static float gsin(float angle);
     static float gcos(float angle);
     static int trs2pol(int nb_con, int nb_tr, int *trv, int *tr_list, int *plv, int *pol_list);
@@ -214,7 +251,8 @@ public:
           float vertexRatio, int maxPoly,
           float planei_, float planej_, float planek_, float startx_,
           float starty_, float startz_, float myDistance_, float radius_,
-          int gennormals_, int option_, int genstrips_, char *ib);
+          int gennormals_, int option_, int genstrips_, char *ib,
+          const CellBlockIndex *index = NULL);
     virtual ~Plane();
 
     int cur_line_elem; // counter for line elements
@@ -224,6 +262,12 @@ public:
     virtual bool createPlane();
     virtual void createStrips();
 
+    // number of cells visited by createPlane
+    int getNumVisitedCells() const
+    {
+        return num_visited;
+    }
+
     virtual void createcoDistributedObjects(const char *Data_name_scal, const char *Data_name_vect,
                                             const char *Normal_name, const char *Triangle_name,
                                             AttributeContainer &gridAttrs, AttributeContainer &dataAttrs);
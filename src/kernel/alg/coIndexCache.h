@@ -0,0 +1,97 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef CO_INDEX_CACHE_H
+#define CO_INDEX_CACHE_H
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace covise
+{
+
+/// Search indices of grids, kept by a module between executions
+///
+/// An index is only built when the same objects are searched for the
+/// second time, objects that are searched only once do not pay for it.
+/// Indices that were not looked up during an execution are dropped at
+/// its end.
+template <class Index>
+class coIndexCache
+{
+public:
+    coIndexCache()
+    {
+    }
+
+    ~coIndexCache()
+    {
+        for (typename IndexMap::iterator it = indices.begin(); it != indices.end(); ++it)
+            delete it->second;
+    }
+
+    // call before the objects of an execution are handled
+    void beginExecution()
+    {
+        used.clear();
+    }
+
+    // delete the indices that were not looked up since beginExecution
+    void endExecution()
+    {
+        typename IndexMap::iterator it = indices.begin();
+        while (it != indices.end())
+        {
+            if (used.find(it->first) == used.end())
+            {
+                delete it->second;
+                indices.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // NULL when name is looked up for the first time, otherwise the slot
+    // for its index, which holds NULL until the caller has built the index
+    Index **lookup(const std::string &name)
+    {
+        used.insert(name);
+        typename IndexMap::iterator it = indices.find(name);
+        if (it == indices.end())
+        {
+            indices[name] = NULL;
+            return NULL;
+        }
+        return &it->second;
+    }
+
+    // memory of all built indices, Index has to provide getMemorySize()
+    size_t getMemorySize() const
+    {
+        size_t memory = 0;
+        for (typename IndexMap::const_iterator it = indices.begin(); it != indices.end(); ++it)
+        {
+            if (it->second)
+                memory += it->second->getMemorySize();
+        }
+        return memory;
+    }
+
+private:
+    typedef std::map<std::string, Index *> IndexMap;
+    IndexMap indices;
+    std::set<std::string> used;
+
+    coIndexCache(const coIndexCache &);
+    coIndexCache &operator=(const coIndexCache &);
+};
+}
+#endif
@@ -15,6 +15,10 @@
 #include <api/coOutputPort.h>
 #include <api/coModule.h>
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 using namespace covise;
 
 #define ADDVERTEX                \
@@ -72,6 +76,132 @@ static int readConfig(const char *varName, int defaultValue)
 }
 }
 
+//========================= SpanSpaceIndex ===========================
+
+namespace
+{
+// about sqrt(n) buckets of about sqrt(n) cells:
+// the buckets below the isovalue and one bucket are searched completely
+int spanSpaceBuckets(int n_elem)
+{
+    return std::max(1, (int)sqrt((double)n_elem));
+}
+
+// orders cell numbers by a value of the cells
+struct CellValueLess
+{
+    const float *values;
+    bool descending;
+
+    CellValueLess(const float *v, bool desc)
+        : values(v)
+        , descending(desc)
+    {
+    }
+    bool operator()(int a, int b) const
+    {
+        return descending ? values[a] > values[b] : values[a] < values[b];
+    }
+};
+}
+
+SpanSpaceIndex::SpanSpaceIndex(int n_elem, int n_conn, const int *p_el, const int *p_cl, const int *p_tl,
+                               const float *p_i_in)
+    : standard_cells(false)
+    , polyhedral_cells(false)
+{
+    std::vector<float> cell_min(n_elem), cell_max(n_elem);
+    int num_standard = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : num_standard)
+#endif
+    for (int element = 0; element < n_elem; element++)
+    {
+        if (UnstructuredGrid_Num_Nodes[p_tl[element]] != -1)
+            num_standard++;
+
+        float lo = FLT_MAX, hi = -FLT_MAX;
+        int conn_end = (element < n_elem - 1) ? p_el[element + 1] : n_conn;
+        for (int c = p_el[element]; c < conn_end; c++)
+        {
+            float v = p_i_in[p_cl[c]];
+            // NaN is below every isovalue, as in the search without an index
+            if (v != v)
+                v = -FLT_MAX;
+            if (v < lo)
+                lo = v;
+            if (v > hi)
+                hi = v;
+        }
+        cell_min[element] = lo;
+        cell_max[element] = hi;
+    }
+    standard_cells = num_standard > 0;
+    polyhedral_cells = num_standard < n_elem;
+
+    cells.resize(n_elem);
+    for (int element = 0; element < n_elem; element++)
+        cells[element] = element;
+    if (n_elem > 0)
+        std::sort(cells.begin(), cells.end(), CellValueLess(&cell_min[0], false));
+
+    int num_buckets = spanSpaceBuckets(n_elem);
+    int bucket_size = (n_elem + num_buckets - 1) / num_buckets;
+    bucket_start.clear();
+    bucket_min.clear();
+    for (int begin = 0; begin < n_elem; begin += bucket_size)
+    {
+        bucket_start.push_back(begin);
+        bucket_min.push_back(cell_min[cells[begin]]);
+    }
+    bucket_start.push_back(n_elem);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int bucket = 0; bucket < (int)bucket_min.size(); bucket++)
+    {
+        std::sort(cells.begin() + bucket_start[bucket], cells.begin() + bucket_start[bucket + 1],
+                  CellValueLess(&cell_max[0], true));
+    }
+
+    minima.resize(n_elem);
+    maxima.resize(n_elem);
+    for (int i = 0; i < n_elem; i++)
+    {
+        minima[i] = cell_min[cells[i]];
+        maxima[i] = cell_max[cells[i]];
+    }
+}
+
+size_t SpanSpaceIndex::getMemorySize(int n_elem)
+{
+    size_t num_buckets = spanSpaceBuckets(n_elem);
+    return (size_t)n_elem * (sizeof(int) + 2 * sizeof(float))
+           + (num_buckets + 1) * sizeof(int) + num_buckets * sizeof(float);
+}
+
+void SpanSpaceIndex::findActiveCells(float isovalue, std::vector<int> &active) const
+{
+    active.clear();
+
+    int num_buckets = (int)bucket_min.size();
+    for (int bucket = 0; bucket < num_buckets && bucket_min[bucket] <= isovalue; bucket++)
+    {
+        // all minima of the bucket are below the isovalue if the next bucket starts below it
+        bool below = bucket + 1 < num_buckets && bucket_min[bucket + 1] <= isovalue;
+        for (int i = bucket_start[bucket]; i < bucket_start[bucket + 1] && maxima[i] >= isovalue; i++)
+        {
+            if (below || minima[i] <= isovalue)
+                active.push_back(cells[i]);
+        }
+    }
+
+    // same output as a search of all cells
+    std::sort(active.begin(), active.end());
+}
+
 IsoPlane::IsoPlane()
     : vertice_list(NULL)
     , coords_x(NULL)
@@ -82,6 +212,8 @@ IsoPlane::IsoPlane()
     , V_Data_W(NULL)
     , S_Data(NULL)
     , node_table(NULL)
+    , span_index(NULL)
+    , num_visited(0)
 {
     if (maxTriPerVertex < 0)
         maxTriPerVertex = readConfig("Module.IsoSurface.MaxTrianglesPerVertex", 17);
@@ -92,7 +224,7 @@ IsoPlane::IsoPlane(int n_elem, int n_nodes, int Type, float cutVertexRatio,
                    const float *xin, const float *yin, const float *zin,
                    const float *sin, const float *iin,
                    const float *uin, const float *vin, const float *win, float isovalue,
-                   bool isConnected, char *ib)
+                   bool isConnected, char *ib, const SpanSpaceIndex *index)
     :
 
     el(ell)
@@ -117,6 +249,8 @@ IsoPlane::IsoPlane(int n_elem, int n_nodes, int Type, float cutVertexRatio,
     , node_table(NULL)
     , _isovalue(isovalue)
     , _isConnected(isConnected)
+    , span_index(index)
+    , num_visited(n_elem)
 {
     iblank = ib;
     if (maxTriPerVertex < 0)
@@ -130,14 +264,18 @@ IsoPlane::IsoPlane(int n_elem, int n_nodes, int Type, float cutVertexRatio,
     //node_table   = (NodeInfo *)malloc(n_nodes*sizeof(NodeInfo));
     node_table = new NodeInfo[n_nodes];
     node = node_table;
-    for (i = 0; i < n_nodes; i++)
+    // with an index, only the nodes of the active cells are set in createIsoPlane
+    if (!span_index)
     {
-        node->targets[0] = 0;
-        // Calculate the distance of each node
-        // to the Isovalue
-        node->dist = (i_in[i] - isovalue);
-        node->side = (node->dist >= 0 ? 1 : 0);
-        node++;
+        for (i = 0; i < n_nodes; i++)
+        {
+            node->targets[0] = 0;
+            // Calculate the distance of each node
+            // to the Isovalue
+            node->dist = (i_in[i] - isovalue);
+            node->side = (node->dist >= 0 ? 1 : 0);
+            node++;
+        }
     }
     num_triangles = num_vertices = num_coords = 0;
 
@@ -179,7 +317,7 @@ IsoPlane::IsoPlane(int n_elem, int n_nodes, int Type, /*float cutVertexRatio,*/
                    const float *xin, const float *yin, const float *zin,
                    const float *sin, const float *iin,
                    const float *uin, const float *vin, const float *win, float isovalue,
-                   bool isConnected, char *ib)
+                   bool isConnected, char *ib, const SpanSpaceIndex *index)
     :
 
     el(ell)
@@ -204,6 +342,8 @@ IsoPlane::IsoPlane(int n_elem, int n_nodes, int Type, /*float cutVertexRatio,*/
     , node_table(NULL)
     , _isovalue(isovalue)
     , _isConnected(isConnected)
+    , span_index(index)
+    , num_visited(n_elem)
 {
     iblank = ib;
 
@@ -242,8 +382,8 @@ POLYHEDRON_IsoPlane::POLYHEDRON_IsoPlane(int n_elem, int n_conn, int n_nodes, in
                                          const float *x_in, const float *y_in, const float *z_in,
                                          const float *s_in, const float *i_in,
                                          const float *u_in, const float *v_in, const float *w_in, float isovalue,
-                                         bool isConnected, char *ib)
-    : IsoPlane(n_elem, n_nodes, Type, el, cl, tl, x_in, y_in, z_in, s_in, i_in, u_in, v_in, w_in, isovalue, isConnected, ib)
+                                         bool isConnected, char *ib, const SpanSpaceIndex *index)
+    : IsoPlane(n_elem, n_nodes, Type, el, cl, tl, x_in, y_in, z_in, s_in, i_in, u_in, v_in, w_in, isovalue, isConnected, ib, index)
 {
     num_conn = n_conn;
     elem_out = NULL;
@@ -357,8 +497,32 @@ bool IsoPlane::createIsoPlane()
     standard_cells_found = false;
     polyhedral_cells_found = false;
 
-    for (element = 0; element < num_elem; element++)
+    std::vector<int> active;
+    if (span_index)
+    {
+        span_index->findActiveCells(_isovalue, active);
+        num_visited = (int)active.size();
+        standard_cells_found = span_index->hasStandardCells();
+        polyhedral_cells_found = span_index->hasPolyhedralCells();
+
+        // polyhedral cells are skipped below and have no fixed number of nodes
+        for (size_t c = 0; c < active.size(); c++)
+        {
+            const int *cell_nodes = cl + el[active[c]];
+            for (int n = 0; n < UnstructuredGrid_Num_Nodes[tl[active[c]]]; n++)
+            {
+                NodeInfo *node_info = node_table + cell_nodes[n];
+                node_info->targets[0] = 0;
+                node_info->dist = (i_in[cell_nodes[n]] - _isovalue);
+                node_info->side = (node_info->dist >= 0 ? 1 : 0);
+            }
+        }
+    }
+    int num_cells = span_index ? (int)active.size() : num_elem;
+
+    for (int c = 0; c < num_cells; c++)
     {
+        element = span_index ? active[c] : c;
         if (iblank == NULL || iblank[element] != '\0')
         {
             elementtype = tl[element];
@@ -2832,8 +2996,17 @@ bool POLYHEDRON_IsoPlane::createIsoPlane()
     temp_vdata_out.clear();
     temp_wdata_out.clear();
 
-    for (element = 0; element < num_elem; element++)
+    std::vector<int> active;
+    if (span_index)
+    {
+        span_index->findActiveCells(_isovalue, active);
+        num_visited = (int)active.size();
+    }
+    int num_cells = span_index ? (int)active.size() : num_elem;
+
+    for (int c = 0; c < num_cells; c++)
     {
+        element = span_index ? active[c] : c;
         start_vertex_set = false;
         cell_intersection = false;
 
@@ -10,6 +10,7 @@
 
 #include <util/coTypes.h>
 #include <cstdlib>
+#include <vector>
 #include <alg/IsoSurfaceGPMUtil.h>
 
 namespace covise
@@ -31,6 +32,47 @@ typedef struct cutting_info_s
     int nvert;
 } cutting_info;
 
+/// Span space index of the cells of an unstructured grid
+///
+/// Built once per grid and iso data and kept by the module between
+/// executions, so that a new isovalue only visits the cells it cuts.
+/// The cells are sorted by the minimum of their iso data into buckets,
+/// within a bucket by descending maximum. For an isovalue, the buckets
+/// starting above it are skipped, the others are searched until the first
+/// cell ending below it.
+class ALGEXPORT SpanSpaceIndex
+{
+public:
+    SpanSpaceIndex(int n_elem, int n_conn, const int *p_el, const int *p_cl, const int *p_tl,
+                   const float *p_i_in);
+
+    // memory of an index for a grid with n_elem cells in bytes
+    static size_t getMemorySize(int n_elem);
+    size_t getMemorySize() const
+    {
+        return getMemorySize((int)cells.size());
+    }
+
+    // cells with minimum <= isovalue <= maximum in the order of the grid
+    void findActiveCells(float isovalue, std::vector<int> &active) const;
+
+    bool hasStandardCells() const
+    {
+        return standard_cells;
+    }
+    bool hasPolyhedralCells() const
+    {
+        return polyhedral_cells;
+    }
+
+private:
+    std::vector<int> cells; // cell numbers, by bucket
+    std::vector<float> minima, maxima; // iso data range of these cells
+    std::vector<int> bucket_start; // first entry of each bucket and the end
+    std::vector<float> bucket_min; // lowest minimum of each bucket
+    bool standard_cells, polyhedral_cells;
+};
+
 class ALGEXPORT IsoPlane
 {
     friend class STR_IsoPlane;
@@ -85,6 +127,9 @@ private:
     bool _isConnected;
     char *iblank;
 
+    const SpanSpaceIndex *span_index;
+    int num_visited;
+
     // Maximal number of triangles attached to one Vertex.
     // configure at IsoSurface.MAX_TRI_PER_VERT
     // starting value for
@@ -108,13 +153,13 @@ public:
              const float *x_in, const float *y_in, const float *z_in,
              const float *s_in, const float *i_in,
              const float *u_in, const float *v_in, const float *w_in, float isovalue,
-             bool isConnected, char *ib);
+             bool isConnected, char *ib, const SpanSpaceIndex *index = NULL);
     IsoPlane(int n_elem, int n_nodes, int Type, /*float cutVertexRatio,*/
              const int *el, const int *cl, const int *tl,
              const float *x_in, const float *y_in, const float *z_in,
              const float *s_in, const float *i_in,
              const float *u_in, const float *v_in, const float *w_in, float isovalue,
-             bool isConnected, char *ib);
+             bool isConnected, char *ib, const SpanSpaceIndex *index = NULL);
     virtual ~IsoPlane();
     void createNormals(int genstrips);
     void createStrips(int gennormals);
@@ -137,6 +182,11 @@ public:
     {
         return num_triangles;
     }
+    // number of cells visited by createIsoPlane
+    int getNumVisitedCells() const
+    {
+        return num_visited;
+    }
     float *getXout()
     {
         return coords_x;
@@ -248,7 +298,7 @@ public:
                         const float *x_in, const float *y_in, const float *z_in,
                         const float *s_in, const float *i_in,
                         const float *u_in, const float *v_in, const float *w_in, float isovalue,
-                        bool isConnected, char *ib);
+                        bool isConnected, char *ib, const SpanSpaceIndex *index = NULL);
 
     ~POLYHEDRON_IsoPlane();
 
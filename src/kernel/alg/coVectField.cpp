@@ -8,6 +8,7 @@
 #include "coVectField.h"
 #include <sysdep/math.h>
 #include <do/coDoLines.h>
+#include <do/coDoPoints.h>
 #include <do/coDoPolygons.h>
 #include <do/coDoTriangleStrips.h>
 #include <do/coDoSet.h>
@@ -38,6 +39,8 @@ coVectField::coVectField(int num_points, float *_x_in, float *_y_in, float *_z_i
     num_scalar = 0;
     lines_out = NULL;
     u_scalar_data = NULL;
+    points_out = NULL;
+    vectors_out = NULL;
     s_in = NULL;
     n_x = n_y = n_z = NULL;
 }
@@ -66,6 +69,8 @@ coVectField::coVectField(int grd_type, float *_x_in, float *_y_in, float *_z_in,
     num_scalar = 0;
     lines_out = NULL;
     u_scalar_data = NULL;
+    points_out = NULL;
+    vectors_out = NULL;
     s_in = NULL;
     n_x = n_y = n_z = NULL;
 }
@@ -96,6 +101,8 @@ coVectField::coVectField(float *_x_in, float *_y_in, float *_z_in, float *_u_in,
     num_scalar = 0;
     lines_out = NULL;
     u_scalar_data = NULL;
+    points_out = NULL;
+    vectors_out = NULL;
     s_in = NULL;
     n_x = n_y = n_z = NULL;
 }
@@ -238,6 +245,187 @@ void coVectField::compute_vectorfields(float scale_, int length, int fasten_para
     }
 }
 
+void coVectField::compute_vectorglyphs(float scale_, int length, int fasten,
+                                       const coObjInfo *objInfoPoints, const coObjInfo *objInfoVectors,
+                                       const coObjInfo *objInfoFloat)
+{
+    scale = scale_;
+    length_param = length;
+    fasten_param = fasten;
+
+    points_out = NULL;
+    vectors_out = NULL;
+    u_scalar_data = NULL;
+    num_scalar = numc;
+
+#ifndef YAC
+    if (!objInfoPoints || !objInfoPoints->getName() || !objInfoVectors || !objInfoVectors->getName())
+#else
+    if (!objInfoPoints || !objInfoVectors)
+#endif
+        return;
+
+    float *x_p, *y_p, *z_p, *u_p, *v_p, *w_p, *mag = NULL;
+    points_out = new coDoPoints(*objInfoPoints, numc);
+    points_out->getAddresses(&x_p, &y_p, &z_p);
+    vectors_out = new coDoVec3(*objInfoVectors, numc);
+    vectors_out->getAddresses(&u_p, &v_p, &w_p);
+#ifndef YAC
+    if (objInfoFloat && objInfoFloat->getName())
+#else
+    if (objInfoFloat)
+#endif
+    {
+        u_scalar_data = new coDoFloat(*objInfoFloat, numc);
+        if (u_scalar_data->objectOk())
+            u_scalar_data->getAddress(&mag);
+    }
+
+    float p[3], d[3], len;
+    for (int i = 0; i < numc; i++)
+    {
+        glyph_base(i, p);
+
+        len = scaled_vector(i, d);
+        if (mag)
+            mag[i] = len;
+
+        if (fasten_param == on_the_middle)
+        {
+            p[0] -= d[0] / 2;
+            p[1] -= d[1] / 2;
+            p[2] -= d[2] / 2;
+        }
+
+        x_p[i] = p[0];
+        y_p[i] = p[1];
+        z_p[i] = p[2];
+        u_p[i] = d[0];
+        v_p[i] = d[1];
+        w_p[i] = d[2];
+    }
+}
+
+void coVectField::compute_vectors(const coObjInfo *objInfoVectors)
+{
+    vectors_out = NULL;
+#ifndef YAC
+    if (!objInfoVectors || !objInfoVectors->getName() || !lines_out)
+#else
+    if (!objInfoVectors || !lines_out)
+#endif
+        return;
+
+    float *u_p, *v_p, *w_p;
+    vectors_out = new coDoVec3(*objInfoVectors, numc * (2 + num_sectors_));
+    vectors_out->getAddresses(&u_p, &v_p, &w_p);
+
+    float d[3];
+    int vertsPerArrow = 2 + numc_line_2_ + numc_line_3_;
+    for (int i = 0; i < numc; i++)
+    {
+        scaled_vector(i, d);
+        for (int j = l_l[i]; j < l_l[i] + vertsPerArrow; j++)
+        {
+            u_p[v_l[j]] = d[0];
+            v_p[v_l[j]] = d[1];
+            w_p[v_l[j]] = d[2];
+        }
+    }
+}
+
+float coVectField::scaled_vector(int i, float d[3])
+{
+    d[0] = u_in[i];
+    d[1] = v_in[i];
+    d[2] = w_in[i];
+    float len = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+    float factor;
+    switch (length_param)
+    {
+    case S_U:
+        factor = len > 0 ? scale / len : 0.f;
+        break;
+    case S_DATA:
+        factor = len > 0 ? scale * s_in[i] / len : 0.f;
+        break;
+    default:
+        factor = scale;
+        break;
+    }
+    d[0] *= factor;
+    d[1] *= factor;
+    d[2] *= factor;
+
+    if (n_x && n_y && n_z)
+        project_vector(i, d, length_param == S_U);
+
+    return len;
+}
+
+void coVectField::glyph_base(int n, float p[3])
+{
+    if (!i_dim && !j_dim && !k_dim)
+    {
+        p[0] = x_in[n];
+        p[1] = y_in[n];
+        p[2] = z_in[n];
+        return;
+    }
+
+    int i = n / (j_dim * k_dim);
+    int j = (n / k_dim) % j_dim;
+    int k = n % k_dim;
+    if (grdtype == STR_GRD)
+    {
+        p[0] = x_in[n];
+        p[1] = y_in[n];
+        p[2] = z_in[n];
+    }
+    else if (grdtype == RCT_GRD)
+    {
+        p[0] = x_in[i];
+        p[1] = y_in[j];
+        p[2] = z_in[k];
+    }
+    else
+    {
+        p[0] = i_dim > 1 ? min_max[0] + ((float)i / (float)(i_dim - 1.0)) * (min_max[1] - min_max[0]) : min_max[0];
+        p[1] = j_dim > 1 ? min_max[2] + ((float)j / (float)(j_dim - 1.0)) * (min_max[3] - min_max[2]) : min_max[2];
+        p[2] = k_dim > 1 ? min_max[4] + ((float)k / (float)(k_dim - 1.0)) * (min_max[5] - min_max[4]) : min_max[4];
+    }
+}
+
+// same as project_lines for a single vector, leaves the normals unchanged
+void coVectField::project_vector(int i, float d[3], int keepLength)
+{
+    float n_len = sqrt(n_x[i] * n_x[i] + n_y[i] * n_y[i] + n_z[i] * n_z[i]);
+    if (n_len > 0.0)
+    {
+        float n[3] = { n_x[i] / n_len, n_y[i] / n_len, n_z[i] / n_len };
+        float old_len = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        float s = d[0] * n[0] + d[1] * n[1] + d[2] * n[2];
+        d[0] -= n[0] * s;
+        d[1] -= n[1] * s;
+        d[2] -= n[2] * s;
+        if (keepLength)
+        {
+            float new_len = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            if (new_len > 0)
+            {
+                d[0] *= old_len / new_len;
+                d[1] *= old_len / new_len;
+                d[2] *= old_len / new_len;
+            }
+        }
+    }
+    else
+    {
+        d[0] = d[1] = d[2] = 0.f;
+    }
+}
+
 /*coVectField::coVectField(coDistributedObject *obj1, char *out_name1, coDistributedObject *obj2, char* out_name2, float Scale, int Length_param, int Fasten_param, int num_sectors_):
 angle_(9.5*M_PI/180.0),cos_a_(cos(angle_)),sin_a_(sin(angle_)),
 arrow_factor_(0.20),cosenos_(0),senos_(0),
@@ -9,6 +9,7 @@
 #include <string>
 #include <do/coDoData.h>
 #include <do/coDoLines.h>
+#include <do/coDoPoints.h>
 
 #ifndef YAC
 #include "coColors.h"
@@ -28,6 +29,7 @@ namespace covise
 
 class coDistributedObject;
 class coDoLines;
+class coDoPoints;
 class coDoColormap;
 class ScalarContainer;
 
@@ -38,6 +40,8 @@ private:
     int num_scalar;
     coDoLines *lines_out;
     coDoFloat *u_scalar_data;
+    coDoPoints *points_out;
+    coDoVec3 *vectors_out;
 
     //data for arrows
     float angle_;
@@ -76,6 +80,12 @@ private:
 
     void project_lines(int keepLength);
 
+    // glyph output: base point of vector i and projection of a single vector
+    void glyph_base(int i, float p[3]);
+    void project_vector(int i, float d[3], int keepLength);
+    // vector i scaled according to length_param and projected, returns its magnitude
+    float scaled_vector(int i, float d[3]);
+
 public:
     /// Unstructured Grid C'tor
     coVectField(int num_points,
@@ -123,6 +133,16 @@ public:
     void compute_vectorfields(float scale_, int length, int fasten_param, int num_sectors,
                               float arrow_factor, float angle, const coObjInfo *objInfoLines, const coObjInfo *objInfoFloat, ValFlag = PER_VERTEX);
 
+    /// compact output for instanced arrows: one point per vector (the foot
+    /// of the arrow), the scaled vector and its magnitude per point
+    void compute_vectorglyphs(float scale, int length_param, int fasten_param,
+                              const coObjInfo *objInfoPoints, const coObjInfo *objInfoVectors,
+                              const coObjInfo *objInfoFloat);
+
+    /// after compute_vectorfields: the scaled vector of its arrow at every
+    /// point of the lines, i.e. per vertex like the scalar output
+    void compute_vectors(const coObjInfo *objInfoVectors);
+
     float *get_scalar_data()
     {
         return s_out;
@@ -139,6 +159,14 @@ public:
     {
         return u_scalar_data;
     }
+    coDoPoints *get_obj_points()
+    {
+        return points_out;
+    }
+    coDoVec3 *get_obj_vectors()
+    {
+        return vectors_out;
+    }
 };
 
 #ifndef YAC
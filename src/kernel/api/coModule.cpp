@@ -71,6 +71,7 @@ coModule::coModule(int argc, char *argv[], const char *desc, bool propagate)
     d_autoParamInit = 0;
     d_execFlag = 0;
     d_execGracePeriod = 1.0;
+    d_streamTimesteps = false;
     _propagateObjectName = propagate;
     // declare the name of our module if given here
     if (desc)
@@ -353,6 +354,8 @@ void coModule::init(int argc, char *argv[])
 
     //send description
     initDescription();
+    if (d_streamTimesteps)
+        Covise::accept_stream_steps();
     // call the user's postInst() if he has one
     postInst();
 }
@@ -693,10 +696,35 @@ void coModule::localCompute(void *)
             }
         }
     }
+    sendStreamSteps();
     for (i = 0; i < d_numElem; i++)
         elemList[i]->postCompute();
 }
 
+void coModule::sendStreamSteps()
+{
+    int step = Covise::get_stream_step();
+    if (step < 0)
+        return;
+
+    for (int i = 0; i < d_numElem; i++)
+    {
+        if (elemList[i]->kind() == coUifElem::OUTPORT)
+        {
+            coOutputPort *port = (coOutputPort *)elemList[i];
+            if (port->getCurrentObject())
+                Covise::send_stream_step(port->getName(), port->getCurrentObject()->getName(),
+                                         step, Covise::get_stream_num_steps());
+        }
+    }
+}
+
+void coModule::streamTimestep(coOutputPort *port, const coDistributedObject *obj, int step, int numSteps)
+{
+    if (port && obj && obj->getName())
+        Covise::send_stream_step(port->getName(), obj->getName(), step, numSteps);
+}
+
 void
 coModule::localAddObject(void *callbackData)
 {
@@ -125,12 +125,19 @@ protected:
     coUifElem *elemList[Covise::MAX_PORTS];
     int d_numElem;
 
+    // whether the controller may execute the module for single streamed timesteps,
+    // compute() has to produce the timestep as element of the complete set
+    bool d_streamTimesteps;
+
     // our internal 'pre-compute' sets all non-immediate parameters
     virtual void localCompute(void *callbackData);
 
     // internal callback called if ADD_OBJECT messages arrive
     virtual void localAddObject(void *callbackData);
 
+    // forward the output objects of a streamed timestep execution
+    void sendStreamSteps();
+
 public:
     /// return values for call-back functions
     enum
@@ -228,6 +235,11 @@ public:
     /// stop the pipeline: do not execute Modules behind this one
     void stopPipeline();
 
+    /// hand timestep step of numSteps to the following modules before compute() has finished,
+    /// obj has to become element step of the set at port. Ignored unless the controller
+    /// streams timesteps (System.Controller.StreamTimesteps)
+    void streamTimestep(coOutputPort *port, const coDistributedObject *obj, int step, int numSteps);
+
     // --------------------- Covise Main-Loop et al -------------------------
 
     /// add Boolean Port : return NULL on error
@@ -312,11 +324,17 @@ public:
     }
 };
 
-#define MODULE_MAIN(Category, Module)           \
-    int main(int argc, char *argv[])            \
-    {                                           \
-        coModule *app = new Module(argc, argv); \
-        app->start(argc, argv);                 \
+// coModuleMain is also the entry point for the module launcher of the CRB
+#define MODULE_MAIN(Category, Module)                             \
+    extern "C" COEXPORT int coModuleMain(int argc, char *argv[]) \
+    {                                                             \
+        coModule *app = new Module(argc, argv);                   \
+        app->start(argc, argv);                                   \
+        return 0;                                                 \
+    }                                                             \
+    int main(int argc, char *argv[])                              \
+    {                                                             \
+        return coModuleMain(argc, argv);                          \
     }
 
 #define COMODULE
@@ -29,6 +29,9 @@ coSimpleModule::coSimpleModule(int argc, char *argv[], const char *desc, bool pr
     multiblock_flag = 0;
 
     portLeader = 0;
+
+    // timesteps are computed as set elements
+    d_streamTimesteps = true;
     return;
 }
 
@@ -179,6 +182,26 @@ void coSimpleModule::localCompute(void *callbackData)
     }
     postHandleObjects(originalOutPorts);
 
+    if (Covise::get_stream_step() >= 0)
+    {
+        // remember which inputs this timestep was computed from
+        const coDistributedObject **inObjs = new const coDistributedObject *[numInPorts + 1];
+        for (i = 0; i < numInPorts; i++)
+            inObjs[i] = originalInPorts[i]->getCurrentObject();
+        std::string key = inputKey(inObjs, numInPorts);
+        delete[] inObjs;
+        for (i = 0; i < no; i++)
+        {
+            if (originalOutPorts[i]->getCurrentObject())
+                streamed_objects[originalOutPorts[i]->getCurrentObject()->getName()] = key;
+        }
+        sendStreamSteps();
+    }
+    else
+    {
+        streamed_objects.clear();
+    }
+
     // clean up
     delete[] originalInPorts;
     delete[] originalOutPorts;
@@ -192,6 +215,57 @@ void coSimpleModule::localCompute(void *callbackData)
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
+std::string coSimpleModule::inputKey(const coDistributedObject *const *inObjs, int num) const
+{
+    std::string key;
+    for (int i = 0; i < num; i++)
+    {
+        if (inObjs[i] && inObjs[i]->getName())
+            key += inObjs[i]->getName();
+        key += "\n";
+    }
+    return key;
+}
+
+// use the objects computed for a streamed timestep if they were computed from the same inputs
+bool coSimpleModule::reuseStreamed(const coDistributedObject *const *inObjs, coOutputPort **outPorts)
+{
+    if (streamed_objects.empty())
+        return false;
+
+    std::string key = inputKey(inObjs, numInPorts);
+    bool reuse = true;
+    int i;
+    for (i = 0; i < numOutPorts; i++)
+    {
+        std::map<std::string, std::string>::iterator it = streamed_objects.find(outPorts[i]->getObjName());
+        if (it == streamed_objects.end() || it->second != key)
+            reuse = false;
+    }
+
+    for (i = 0; i < numOutPorts; i++)
+    {
+        std::map<std::string, std::string>::iterator it = streamed_objects.find(outPorts[i]->getObjName());
+        if (it == streamed_objects.end())
+            continue;
+        coDistributedObject *obj = const_cast<coDistributedObject *>(coDistributedObject::createFromShm(coObjInfo(it->first.c_str())));
+        if (reuse)
+        {
+            outPorts[i]->setCurrentObject(obj);
+        }
+        else if (obj)
+        {
+            // stale: recomputed under the same name
+            obj->destroy();
+            delete obj;
+        }
+        streamed_objects.erase(it);
+    }
+    return reuse;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
 void coSimpleModule::swapObjects(coInputPort **inPorts, coOutputPort **outPorts)
 {
     // swap:  inPorts>objs   outPorts>objnames
@@ -454,8 +528,17 @@ int coSimpleModule::handleObjects(coInputPort **inPorts, coOutputPort **outPorts
             }
 
             // handle
+            bool reused = false;
+            if (timestep_flag && object_level == 1 && !streamed_objects.empty())
+            {
+                const coDistributedObject **inObjs = new const coDistributedObject *[numInPorts + 1];
+                for (i = 0; i < numInPorts; i++)
+                    inObjs[i] = newInPorts[i]->getCurrentObject();
+                reused = reuseStreamed(inObjs, newOutPorts);
+                delete[] inObjs;
+            }
 
-            if (handleObjects(newInPorts, newOutPorts) != CONTINUE_PIPELINE)
+            if (!reused && handleObjects(newInPorts, newOutPorts) != CONTINUE_PIPELINE)
                 continueExec = false;
 
             // post
@@ -18,6 +18,9 @@
 #include <appl/ApplInterface.h>
 #include "coModule.h"
 
+#include <map>
+#include <string>
+
 namespace covise
 {
 
@@ -62,6 +65,12 @@ private:
     // number of elements in each currently traversed level of set hierarchy
     std::vector<int> num_elements;
 
+    // output objects of streamed timestep executions and the names of their inputs,
+    // they become the set elements of the complete execution
+    std::map<std::string, std::string> streamed_objects;
+    std::string inputKey(const coDistributedObject *const *inObjs, int num) const;
+    bool reuseStreamed(const coDistributedObject *const *inObjs, coOutputPort **outPorts);
+
 protected:
     virtual void localCompute(void *callbackData);
 
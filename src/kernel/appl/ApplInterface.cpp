@@ -95,6 +95,9 @@ void *Covise::afterFinishCallbackData = 0L;
 void *Covise::pipelineFinishUserData = 0L;
 void *Covise::pipelineFinishCallbackData = 0L;
 int Covise::pipeline_state_once = 0;
+int Covise::stream_step_ = -1;
+int Covise::stream_num_steps_ = 0;
+bool Covise::executing_ = false;
 int Covise::renderMode_ = 0;
 char *Covise::objNameToAdd_ = NULL;
 char *Covise::objNameToDelete_ = NULL;
@@ -875,6 +878,10 @@ void Covise::main_loop()
 #endif
             break;
 
+        case COVISE_MESSAGE_FINPART:
+            doStreamStep(applMsg);
+            break;
+
         case COVISE_MESSAGE_GENERIC:
             generic(applMsg);
             break;
@@ -951,6 +958,10 @@ void Covise::progress_main_loop()
 #endif
                 break;
 
+            case COVISE_MESSAGE_FINPART:
+                doStreamStep(applMsg);
+                break;
+
             case COVISE_MESSAGE_GENERIC:
                 generic(applMsg);
                 break;
@@ -1024,6 +1035,10 @@ void Covise::do_one_event()
         callFeedbackCallback(applMsg);
         break;
 
+    case COVISE_MESSAGE_FINPART:
+        doStreamStep(applMsg);
+        break;
+
     case COVISE_MESSAGE_GENERIC:
         generic(applMsg);
         break;
@@ -1148,6 +1163,10 @@ int Covise::check_and_handle_event(float time)
             break;
         }
 
+        case COVISE_MESSAGE_FINPART:
+            doStreamStep(applMsg);
+            break;
+
         case COVISE_MESSAGE_GENERIC:
             //	  cerr << "Covise::check_and_handle_event() : GENERIC" << endl;
             generic(applMsg);
@@ -1548,8 +1567,10 @@ void Covise::doStart(Message *m)
     //cerr << msg->data << endl;
 
     // call back the function provided by the user
+    executing_ = true;
     if (startCallbackFunc != NULL)
         callStartCallback();
+    executing_ = false;
 
     msg->create_finall_message();
 
@@ -1569,6 +1590,80 @@ void Covise::doStart(Message *m)
     }
 }
 
+//=====================================================================
+// execute a single timestep of a streamed execution: the controller sends
+// "step\nnum_steps\n" followed by a start message for this timestep
+//=====================================================================
+void Covise::doStreamStep(Message *m)
+{
+    // events may be handled during compute(): do not start another execution,
+    // the timestep is computed again in the complete execution anyway
+    if (!m || !m->data || executing_)
+        return;
+
+    int step = -1, num_steps = 0;
+    char *content = m->data;
+    if (sscanf(content, "%d\n%d\n", &step, &num_steps) != 2 || step < 0)
+        return;
+    for (int i = 0; i < 2 && content; i++)
+    {
+        content = strchr(content, '\n');
+        if (content)
+            content++;
+    }
+    if (!content || !*content)
+        return;
+
+    Message start;
+    start.sender = m->sender;
+    start.send_type = m->send_type;
+    start.type = COVISE_MESSAGE_START;
+    start.data = content;
+    start.length = (int)strlen(content) + 1;
+    start.conn = m->conn;
+
+    msg = new CtlMessage(&start);
+    stream_step_ = step;
+    stream_num_steps_ = num_steps;
+
+    // no FINALL: the module is started again for the complete execution
+    startCallbackData = (void *)&start;
+    executing_ = true;
+    if (startCallbackFunc != NULL)
+        callStartCallback();
+    executing_ = false;
+
+    stream_step_ = -1;
+    stream_num_steps_ = 0;
+    start.data = NULL;
+    msg->delete_data();
+    delete msg;
+    msg = NULL;
+}
+
+void Covise::send_stream_step(const char *port, const char *obj_name, int step, int num_steps)
+{
+    if (!port || !obj_name || !m_name || !h_name || !instance)
+        return;
+
+    char *buf = new char[strlen(m_name) + strlen(instance) + strlen(h_name) + strlen(port) + strlen(obj_name) + 64];
+    sprintf(buf, "%s\n%s\n%s\n%d\n%d\n1\n%s\n%s\n", m_name, instance, h_name, step, num_steps, port, obj_name);
+    send_ctl_message(COVISE_MESSAGE_FINPART, buf);
+    delete[] buf;
+}
+
+// a FINPART for timestep -1 without objects
+void Covise::accept_stream_steps()
+{
+    if (!m_name || !h_name || !instance)
+        return;
+
+    char *buf = new char[strlen(m_name) + strlen(instance) + strlen(h_name) + 64];
+    sprintf(buf, "%s\n%s\n%s\n-1\n0\n0\n", m_name, instance, h_name);
+    send_ctl_message(COVISE_MESSAGE_FINPART, buf);
+    delete[] buf;
+}
+
 void
 Covise::doAddObject()
 {
@@ -58,6 +58,12 @@ private:
 
     static int pipeline_state_once;
 
+    // timestep of a streamed execution, -1 for a complete execution
+    static int stream_step_;
+    static int stream_num_steps_;
+    // set while the start callback runs, streamed timesteps arriving then are dropped
+    static bool executing_;
+
     // private member funcs
     static void doParam(Message *m);
     static void doPortReply(Message *m);
@@ -67,6 +73,7 @@ private:
 
     static void doStartWithoutFinish(Message *m);
     static void doStart(Message *m);
+    static void doStreamStep(Message *m);
     static void doAddObject();
     static void doGeneric(Message *m);
     static void doSync(Message *m);
@@ -411,6 +418,26 @@ public:
     //
     static void partobjects_initialized(void);
 
+    //
+    // Streamed timesteps: with System.Controller.StreamTimesteps enabled
+    // the controller forwards timesteps to the following modules and
+    // renderers while this module is still executing
+    //
+    /// tell the controller that object obj_name at port is timestep step of num_steps
+    static void send_stream_step(const char *port, const char *obj_name, int step, int num_steps);
+    /// tell the controller that this module can execute single timesteps,
+    /// other modules are only started for complete executions
+    static void accept_stream_steps();
+    /// timestep processed by the current execution or -1 for a complete execution
+    static int get_stream_step()
+    {
+        return stream_step_;
+    }
+    static int get_stream_num_steps()
+    {
+        return stream_num_steps_;
+    }
+
     // Add Interactor for feedback
     static void addInteractor(coDistributedObject *obj, const char *name, const char *value);
 };
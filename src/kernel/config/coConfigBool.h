@@ -34,6 +34,9 @@ public:
 
     coConfigBool &operator=(bool);
 
+    /// convert a config value string as done for coConfigBool entries
+    static bool parseValue(const QString &value);
+
 protected:
     virtual bool fromString(const QString &value) const;
     virtual QString toString(const bool &value) const;
@@ -34,6 +34,9 @@ public:
 
     coConfigFloat &operator=(float);
 
+    /// convert a config value string as done for coConfigFloat entries
+    static float parseValue(const QString &value);
+
 protected:
     virtual float fromString(const QString &value) const;
     virtual QString toString(const float &value) const;
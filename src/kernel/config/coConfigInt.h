@@ -34,6 +34,9 @@ public:
 
     coConfigInt &operator=(int);
 
+    /// convert a config value string as done for coConfigInt entries
+    static int parseValue(const QString &value);
+
 protected:
     virtual int fromString(const QString &value) const;
     virtual QString toString(const int &value) const;
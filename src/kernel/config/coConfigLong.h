@@ -34,6 +34,9 @@ public:
 
     coConfigLong &operator=(long);
 
+    /// convert a config value string as done for coConfigLong entries
+    static long parseValue(const QString &value);
+
 protected:
     virtual long fromString(const QString &value) const;
     virtual QString toString(const long &value) const;
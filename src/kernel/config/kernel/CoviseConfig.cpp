@@ -9,6 +9,7 @@
 #include <config/CoviseConfig.h>
 
 #include <config/coConfig.h>
+#include "coConfigCache.h"
 
 #include <iostream>
 using namespace std;
@@ -16,6 +17,25 @@ using namespace covise;
 
 #include <QString>
 
+namespace
+{
+
+// look up the value string of a config entry, from the cache if possible
+bool lookup(const std::string &variable, const std::string &entry, std::string &value)
+{
+    coConfigCache *cache = coConfigCache::instance();
+    bool exists = false;
+    if (cache->find(variable, entry, value, exists))
+        return exists;
+
+    QString val = coConfig::getInstance()->getValue(QString::fromStdString(variable), QString::fromStdString(entry));
+    exists = !val.isNull();
+    value = exists ? val.toStdString() : std::string();
+    cache->insert(variable, entry, value, exists);
+    return exists;
+}
+}
+
 coCoviseConfig::coCoviseConfig()
 {
 }
@@ -63,9 +83,8 @@ std::string coCoviseConfig::getEntry(const std::string &variable, const std::str
 
 std::string coCoviseConfig::getEntry(const std::string &variable, const std::string &entry, const std::string &defaultValue, bool *exists)
 {
-    QString val = coConfig::getInstance()->getValue(QString::fromStdString(variable), QString::fromStdString(entry));
-
-    if (val.isNull())
+    std::string val;
+    if (!lookup(variable, entry, val))
     {
         if (exists)
             *exists = false;
@@ -75,10 +94,9 @@ std::string coCoviseConfig::getEntry(const std::string &variable, const std::str
     if (exists)
         *exists = true;
 
-    COCONFIGDBG("coCoviseConfig::getEntry info: " << entry.c_str() << "/" << variable.c_str() << " = "
-                                                  << (!val.isNull() ? qPrintable(val) : "*NULL*"));
+    COCONFIGDBG("coCoviseConfig::getEntry info: " << entry.c_str() << "/" << variable.c_str() << " = " << val.c_str());
 
-    return val.toStdString();
+    return val;
 }
 
 /**
@@ -104,14 +122,15 @@ int coCoviseConfig::getInt(const std::string &entry, int defaultValue, bool *exi
 int coCoviseConfig::getInt(const std::string &variable, const std::string &entry, int defaultValue, bool *exists)
 {
     COCONFIGDBG("coCoviseConfig::getInt info: enter " << entry.c_str() << "/" << variable.c_str() << " default " << defaultValue);
-    coConfigInt val = coConfig::getInstance()->getInt(QString::fromStdString(variable), QString::fromStdString(entry));
-    COCONFIGDBG("coCoviseConfig::getInt info: " << entry.c_str() << "/" << variable.c_str() << " = " << val
-                                                << " (" << val.hasValidValue() << ")");
+    std::string val;
+    bool found = lookup(variable, entry, val);
+    COCONFIGDBG("coCoviseConfig::getInt info: " << entry.c_str() << "/" << variable.c_str() << " = " << val.c_str()
+                                              << " (" << found << ")");
     if (exists)
-        *exists = val.hasValidValue();
+        *exists = found;
 
-    if (val.hasValidValue())
-        return val;
+    if (found)
+        return coConfigInt::parseValue(QString::fromStdString(val));
     else
         return defaultValue;
 }
@@ -139,14 +158,15 @@ long coCoviseConfig::getLong(const std::string &entry, long defaultValue, bool *
 long coCoviseConfig::getLong(const std::string &variable, const std::string &entry, long defaultValue, bool *exists)
 {
     COCONFIGDBG("coCoviseConfig::getLong info: enter " << entry.c_str() << "/" << variable.c_str() << " default " << defaultValue);
-    coConfigLong val = coConfig::getInstance()->getLong(QString::fromStdString(variable), QString::fromStdString(entry));
-    COCONFIGDBG("coCoviseConfig::getLong info: " << entry.c_str() << "/" << variable.c_str() << " = " << val
-                                                 << " (" << val.hasValidValue() << ")");
+    std::string val;
+    bool found = lookup(variable, entry, val);
+    COCONFIGDBG("coCoviseConfig::getLong info: " << entry.c_str() << "/" << variable.c_str() << " = " << val.c_str()
+                                              << " (" << found << ")");
     if (exists)
-        *exists = val.hasValidValue();
+        *exists = found;
 
-    if (val.hasValidValue())
-        return val;
+    if (found)
+        return coConfigLong::parseValue(QString::fromStdString(val));
     else
         return defaultValue;
 }
@@ -175,14 +195,15 @@ bool coCoviseConfig::isOn(const std::string &entry, bool defaultValue, bool *exi
 bool coCoviseConfig::isOn(const std::string &variable, const std::string &entry, bool defaultValue, bool *exists)
 {
     COCONFIGDBG("coCoviseConfig::isOn info: enter " << entry.c_str() << "/" << variable.c_str() << " default " << defaultValue);
-    coConfigBool val = coConfig::getInstance()->getBool(QString::fromStdString(variable), QString::fromStdString(entry));
-    COCONFIGDBG("coCoviseConfig::isOn info: " << entry.c_str() << "/" << variable.c_str() << " = " << val
-                                              << " (" << val.hasValidValue() << ")");
+    std::string val;
+    bool found = lookup(variable, entry, val);
+    COCONFIGDBG("coCoviseConfig::isOn info: " << entry.c_str() << "/" << variable.c_str() << " = " << val.c_str()
+                                              << " (" << found << ")");
     if (exists)
-        *exists = val.hasValidValue();
+        *exists = found;
 
-    if (val.hasValidValue())
-        return val;
+    if (found)
+        return coConfigBool::parseValue(QString::fromStdString(val));
     else
         return defaultValue;
 }
@@ -210,14 +231,15 @@ float coCoviseConfig::getFloat(const std::string &entry, float defaultValue, boo
 float coCoviseConfig::getFloat(const std::string &variable, const std::string &entry, float defaultValue, bool *exists)
 {
     COCONFIGDBG("coCoviseConfig::getFloat info: enter " << entry.c_str() << "/" << variable.c_str() << " default " << defaultValue);
-    coConfigFloat val = coConfig::getInstance()->getFloat(QString::fromStdString(variable), QString::fromStdString(entry));
-    COCONFIGDBG("coCoviseConfig::getFloat info: " << entry.c_str() << " = " << val
-                                                  << " (" << val.hasValidValue() << ")");
+    std::string val;
+    bool found = lookup(variable, entry, val);
+    COCONFIGDBG("coCoviseConfig::getFloat info: " << entry.c_str() << "/" << variable.c_str() << " = " << val.c_str()
+                                              << " (" << found << ")");
     if (exists)
-        *exists = val.hasValidValue();
+        *exists = found;
 
-    if (val.hasValidValue())
-        return val;
+    if (found)
+        return coConfigFloat::parseValue(QString::fromStdString(val));
     else
         return defaultValue;
 }
@@ -7,6 +7,7 @@
 
 #include <config/coConfigLog.h>
 #include <config/coConfig.h>
+#include "coConfigCache.h"
 
 #include <math.h>
 
@@ -83,6 +84,9 @@ bool coConfig::setActiveHost(const QString &host)
 
     if (hostnames.contains(host.toLower()))
     {
+        if (host.toLower() != activeHostname)
+            coConfigCache::instance()->disable();
+
         //cerr << "coConfig::setActiveHost info: setting active host "
         //     << host << endl;
         activeHostname = host.toLower();
@@ -104,6 +108,7 @@ bool coConfig::setActiveHost(const QString &host)
 
 void coConfig::reload()
 {
+    coConfigCache::instance()->disable();
 
     COCONFIGDBG("coConfig::reload info: reloading config");
 
@@ -524,6 +529,7 @@ void coConfig::setValueForHost(const QString &variable, const QString &value, co
                                const QString &targetHost, bool move,
                                const QString &config, const QString &configGroup)
 {
+    coConfigCache::instance()->disable();
 
     coConfigEntryString oldValue = getValue(variable, section);
 
@@ -584,6 +590,7 @@ void coConfig::setValueForHost(const QString &variable, const QString &value, co
 void coConfig::setValueInConfig(const QString &variable, const QString &value, const QString &section,
                                 const QString &configGroup, const QString &config, bool move)
 {
+    coConfigCache::instance()->disable();
 
     setValueForHost(variable, value, section, 0, move, config, configGroup);
 }
@@ -605,6 +612,7 @@ void coConfig::setValueInConfig(const QString &variable, const QString &value, c
 void coConfig::setValue(const QString &variable, const QString &value, const QString &section,
                         const QString &config, bool move)
 {
+    coConfigCache::instance()->disable();
 
     setValueForHost(variable, value, section, 0, move, config);
 }
@@ -621,6 +629,7 @@ void coConfig::setValue(const QString &variable, const QString &value, const QSt
  */
 void coConfig::setValue(const QString &simpleVariable, const QString &value)
 {
+    coConfigCache::instance()->disable();
     setValue("value", value, simpleVariable);
 }
 
@@ -642,6 +651,7 @@ bool coConfig::deleteValueForHost(const QString &variable, const QString &sectio
                                   const QString &targetHost,
                                   const QString &config, const QString &configGroup)
 {
+    coConfigCache::instance()->disable();
 
     coConfigGroup *group;
     QString groupName;
@@ -686,6 +696,7 @@ bool coConfig::deleteValueForHost(const QString &variable, const QString &sectio
 bool coConfig::deleteValueInConfig(const QString &variable, const QString &section,
                                    const QString &configGroup, const QString &config)
 {
+    coConfigCache::instance()->disable();
 
     return deleteValueForHost(variable, section, 0, config, configGroup);
 }
@@ -702,6 +713,7 @@ bool coConfig::deleteValueInConfig(const QString &variable, const QString &secti
  */
 bool coConfig::deleteValue(const QString &variable, const QString &section, const QString &config)
 {
+    coConfigCache::instance()->disable();
     return deleteValueForHost(variable, section, 0, config);
 }
 
@@ -714,6 +726,7 @@ bool coConfig::deleteValue(const QString &variable, const QString &section, cons
  */
 bool coConfig::deleteValue(const QString &simpleVariable)
 {
+    coConfigCache::instance()->disable();
     return deleteValue("value", simpleVariable);
 }
 
@@ -730,6 +743,7 @@ bool coConfig::deleteValue(const QString &simpleVariable)
 bool coConfig::deleteSectionForHost(const QString &section, const QString &targetHost,
                                     const QString &config, const QString &configGroup)
 {
+    coConfigCache::instance()->disable();
 
     coConfigGroup *group;
     QString groupName;
@@ -771,6 +785,7 @@ bool coConfig::deleteSectionForHost(const QString &section, const QString &targe
  */
 bool coConfig::deleteSectionInConfig(const QString &section, const QString &configGroup, const QString &config)
 {
+    coConfigCache::instance()->disable();
 
     return deleteSectionForHost(section, 0, config, configGroup);
 }
@@ -785,6 +800,7 @@ bool coConfig::deleteSectionInConfig(const QString &section, const QString &conf
  */
 bool coConfig::deleteSection(const QString &section, const QString &config)
 {
+    coConfigCache::instance()->disable();
     return deleteSectionForHost(section, 0, config);
 }
 
@@ -885,6 +901,7 @@ bool coConfig::isAdminMode()
  */
 void coConfig::addConfig(const QString &filename, const QString &name, bool create)
 {
+    coConfigCache::instance()->disable();
     configGroups["config"]->addConfig(filename, name, create);
 }
 
@@ -895,6 +912,7 @@ void coConfig::addConfig(const QString &filename, const QString &name, bool crea
  */
 void coConfig::addConfig(coConfigGroup *group)
 {
+    coConfigCache::instance()->disable();
     configGroups.insert(group->getGroupName(), group);
     this->hostnames.append(group->getHostnameList());
     this->hostnames.removeDuplicates();
@@ -907,6 +925,7 @@ void coConfig::addConfig(coConfigGroup *group)
  */
 void coConfig::removeConfig(const QString &name)
 {
+    coConfigCache::instance()->disable();
     configGroups["config"]->removeConfig(name);
 
     this->hostnames.clear();
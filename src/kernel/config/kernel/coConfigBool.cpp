@@ -61,6 +61,11 @@ coConfigBool::~coConfigBool()
 }
 
 bool coConfigBool::fromString(const QString &value) const
+{
+    return parseValue(value);
+}
+
+bool coConfigBool::parseValue(const QString &value)
 {
     return (value.toLower() == "on" || value.toLower() == "true" || value.toInt() > 0);
 }
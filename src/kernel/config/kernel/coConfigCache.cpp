@@ -0,0 +1,508 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coConfigCache.h"
+
+#include <config/coConfigLog.h>
+#include <config/coConfigConstants.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace covise;
+
+coConfigCache *coConfigCache::cache = NULL;
+
+// cache file layout, native byte order:
+//   "COCONFIG", version, byte order mark
+//   id of the config (host, arch, file names)
+//   number of config files, for each: name, mtime, size
+//   number of buckets (power of 2), bucket offsets (0: empty)
+//   entries: hash, key length, value length (NOVALUE: does not exist), key, value
+static const char magic[] = "COCONFIG";
+static const quint32 version = 1;
+static const quint32 byteOrder = 0x01020304;
+static const quint32 NOVALUE = 0xffffffff;
+
+static bool get32(const uchar *data, size_t size, size_t &pos, quint32 &v)
+{
+    if (pos + sizeof(v) > size)
+        return false;
+    memcpy(&v, data + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+static bool get64(const uchar *data, size_t size, size_t &pos, qint64 &v)
+{
+    if (pos + sizeof(v) > size)
+        return false;
+    memcpy(&v, data + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+static bool getString(const uchar *data, size_t size, size_t &pos, std::string &s)
+{
+    quint32 len;
+    if (!get32(data, size, pos, len) || pos + len > size)
+        return false;
+    s.assign((const char *)data + pos, len);
+    pos += len;
+    return true;
+}
+
+static void put32(std::string &buf, quint32 v)
+{
+    buf.append((const char *)&v, sizeof(v));
+}
+
+static void put64(std::string &buf, qint64 v)
+{
+    buf.append((const char *)&v, sizeof(v));
+}
+
+static void putString(std::string &buf, const std::string &s)
+{
+    put32(buf, (quint32)s.length());
+    buf.append(s);
+}
+
+static void saveCache()
+{
+    coConfigCache::instance()->save();
+}
+
+coConfigCache *coConfigCache::instance()
+{
+    if (!cache)
+        cache = new coConfigCache();
+    return cache;
+}
+
+coConfigCache::coConfigCache()
+    : enabled(true)
+    , dirty(false)
+    , lastSave(0)
+    , numHits(0)
+    , numMisses(0)
+    , mapData(NULL)
+    , mapSize(0)
+    , indexOffset(0)
+{
+    QString env = QString(getenv("COCONFIG_CACHE")).toLower();
+    if (env == "0" || env == "off" || env == "false")
+        enabled = false;
+
+    QString localPath = coConfigDefaultPaths::getDefaultLocalConfigFilePath();
+    if (localPath.isEmpty() || !QDir(localPath).exists())
+        enabled = false;
+
+    if (!enabled)
+        return;
+
+    id = makeId();
+    QString name = QString("config-%1-%2.cache").arg(coConfigConstants::getHostname()).arg(hash(id), 8, 16, QChar('0'));
+    cacheFileName = QDir(localPath).filePath(name).toLocal8Bit().constData();
+
+    open();
+    atexit(saveCache);
+}
+
+coConfigCache::~coConfigCache()
+{
+    if (mapData)
+        cacheFile.unmap(const_cast<uchar *>(mapData));
+}
+
+std::string coConfigCache::makeKey(const std::string &variable, const std::string &section)
+{
+    char rank[16];
+    snprintf(rank, sizeof(rank), "%d", coConfigConstants::getRank());
+    std::string key(section);
+    key += '\n';
+    key += variable;
+    key += '\n';
+    key += rank;
+    return key;
+}
+
+unsigned int coConfigCache::hash(const std::string &key)
+{
+    // FNV-1a
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < key.length(); ++i)
+    {
+        h ^= (unsigned char)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+std::string coConfigCache::makeId()
+{
+    QString s = "host=" + coConfigConstants::getHostname();
+    s += "\narch=" + coConfigConstants::getArchList().join(" ");
+    s += "\nglobal=" + coConfigDefaultPaths::getDefaultGlobalConfigFileName();
+    s += "\nlocal=" + coConfigDefaultPaths::getDefaultLocalConfigFileName();
+    s += "\npath=" + coConfigDefaultPaths::getSearchPath().join(":");
+    return s.toUtf8().constData();
+}
+
+coConfigCache::File coConfigCache::makeFile(const std::string &name)
+{
+    File f;
+    f.name = name;
+    QFileInfo info(QString::fromUtf8(name.c_str()));
+    if (info.exists())
+    {
+        f.mtime = info.lastModified().toMSecsSinceEpoch();
+        f.size = info.size();
+    }
+    else
+    {
+        f.mtime = -1;
+        f.size = -1;
+    }
+    return f;
+}
+
+bool coConfigCache::sameFile(const File &a, const File &b)
+{
+    return a.name == b.name && a.mtime == b.mtime && a.size == b.size;
+}
+
+bool coConfigCache::sameFiles(const std::vector<File> &a, const std::vector<File> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (!sameFile(a[i], b[i]))
+            return false;
+    }
+    return true;
+}
+
+size_t coConfigCache::readHeader(const uchar *data, size_t size, std::vector<File> &fileList) const
+{
+    size_t pos = 0;
+    if (size < 8 || memcmp(data, magic, 8) != 0)
+        return 0;
+    pos += 8;
+
+    quint32 v, order;
+    if (!get32(data, size, pos, v) || v != version || !get32(data, size, pos, order) || order != byteOrder)
+        return 0;
+
+    std::string fileId;
+    if (!getString(data, size, pos, fileId) || fileId != id)
+        return 0;
+
+    quint32 numFiles;
+    if (!get32(data, size, pos, numFiles))
+        return 0;
+    fileList.clear();
+    for (quint32 i = 0; i < numFiles; ++i)
+    {
+        File f;
+        if (!getString(data, size, pos, f.name) || !get64(data, size, pos, f.mtime) || !get64(data, size, pos, f.size))
+            return 0;
+        fileList.push_back(f);
+    }
+
+    // check the bucket array
+    size_t index = pos;
+    quint32 numBuckets;
+    if (!get32(data, size, pos, numBuckets) || numBuckets == 0 || (numBuckets & (numBuckets - 1)))
+        return 0;
+    if (pos + (size_t)numBuckets * sizeof(quint32) > size)
+        return 0;
+
+    return index;
+}
+
+bool coConfigCache::open()
+{
+    cacheFile.setFileName(QString::fromLocal8Bit(cacheFileName.c_str()));
+    if (!cacheFile.open(QIODevice::ReadOnly))
+        return false;
+
+    mapSize = cacheFile.size();
+    mapData = mapSize > 0 ? cacheFile.map(0, mapSize) : NULL;
+    if (!mapData)
+    {
+        cacheFile.close();
+        return false;
+    }
+
+    std::vector<File> cached;
+    indexOffset = readHeader(mapData, mapSize, cached);
+    bool valid = indexOffset != 0;
+    for (size_t i = 0; valid && i < cached.size(); ++i)
+        valid = sameFile(makeFile(cached[i].name), cached[i]);
+
+    if (!valid)
+    {
+        COCONFIGDBG_DEFAULT("coConfigCache::open info: " << cacheFileName.c_str() << " is out of date");
+        cacheFile.unmap(const_cast<uchar *>(mapData));
+        cacheFile.close();
+        mapData = NULL;
+        mapSize = 0;
+        indexOffset = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool coConfigCache::lookupMapped(const std::string &key, Entry &entry) const
+{
+    if (!mapData)
+        return false;
+
+    size_t pos = indexOffset;
+    quint32 numBuckets;
+    get32(mapData, mapSize, pos, numBuckets);
+    const size_t buckets = pos;
+    const quint32 h = hash(key);
+    for (quint32 b = h & (numBuckets - 1), n = 0; n < numBuckets; b = (b + 1) & (numBuckets - 1), ++n)
+    {
+        pos = buckets + b * sizeof(quint32);
+        quint32 offset;
+        get32(mapData, mapSize, pos, offset);
+        if (offset == 0)
+            return false;
+
+        pos = offset;
+        quint32 eh, keyLen, valueLen;
+        if (!get32(mapData, mapSize, pos, eh) || !get32(mapData, mapSize, pos, keyLen) || !get32(mapData, mapSize, pos, valueLen))
+            return false;
+        if (eh != h || keyLen != key.length())
+            continue;
+        if (pos + keyLen > mapSize || memcmp(mapData + pos, key.data(), keyLen) != 0)
+            continue;
+        pos += keyLen;
+
+        entry.exists = valueLen != NOVALUE;
+        if (entry.exists)
+        {
+            if (pos + valueLen > mapSize)
+                return false;
+            entry.value.assign((const char *)mapData + pos, valueLen);
+        }
+        else
+        {
+            entry.value.clear();
+        }
+        return true;
+    }
+    return false;
+}
+
+void coConfigCache::readEntries(const uchar *data, size_t size, size_t index)
+{
+    size_t pos = index;
+    quint32 numBuckets;
+    if (!get32(data, size, pos, numBuckets))
+        return;
+    const size_t buckets = pos;
+    for (quint32 b = 0; b < numBuckets; ++b)
+    {
+        pos = buckets + b * sizeof(quint32);
+        quint32 offset;
+        if (!get32(data, size, pos, offset))
+            return;
+        if (offset == 0)
+            continue;
+
+        pos = offset;
+        quint32 h, keyLen, valueLen;
+        if (!get32(data, size, pos, h) || !get32(data, size, pos, keyLen) || !get32(data, size, pos, valueLen))
+            return;
+        if (pos + keyLen > size || (valueLen != NOVALUE && pos + keyLen + valueLen > size))
+            return;
+
+        std::string key((const char *)data + pos, keyLen);
+        if (entries.find(key) != entries.end())
+            continue;
+        Entry &e = entries[key];
+        e.exists = valueLen != NOVALUE;
+        if (e.exists)
+            e.value.assign((const char *)data + pos + keyLen, valueLen);
+    }
+}
+
+bool coConfigCache::find(const std::string &variable, const std::string &section,
+                         std::string &value, bool &exists)
+{
+    if (!enabled)
+        return false;
+
+    std::string key = makeKey(variable, section);
+    unordered_map<std::string, Entry>::const_iterator it = entries.find(key);
+    if (it != entries.end())
+    {
+        ++numHits;
+        value = it->second.value;
+        exists = it->second.exists;
+        return true;
+    }
+
+    Entry e;
+    if (lookupMapped(key, e))
+    {
+        ++numHits;
+        value = e.value;
+        exists = e.exists;
+        return true;
+    }
+
+    ++numMisses;
+    return false;
+}
+
+void coConfigCache::insert(const std::string &variable, const std::string &section,
+                           const std::string &value, bool exists)
+{
+    if (!enabled)
+        return;
+
+    Entry &e = entries[makeKey(variable, section)];
+    e.value = value;
+    e.exists = exists;
+    dirty = true;
+
+    // lookups come in bursts during startup, don't rewrite the file for each of them
+    if (time(NULL) != lastSave)
+        save();
+}
+
+void coConfigCache::disable()
+{
+    if (!enabled)
+        return;
+
+    COCONFIGDBG("coConfigCache::disable info: configuration modified, not using " << cacheFileName.c_str());
+    enabled = false;
+    dirty = false;
+    entries.clear();
+}
+
+void coConfigCache::addFile(const QString &filename)
+{
+    File f = makeFile(QFileInfo(filename).absoluteFilePath().toUtf8().constData());
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (files[i].name == f.name)
+            return;
+    }
+    files.push_back(f);
+}
+
+void coConfigCache::save()
+{
+    // only values resolved from the XML files are new, so files is known then
+    if (!enabled || !dirty || files.empty())
+        return;
+    dirty = false;
+    lastSave = time(NULL);
+
+    // keep the values of the current cache file, another process may have replaced it meanwhile
+    if (mapData)
+        readEntries(mapData, mapSize, indexOffset);
+    if (FILE *fp = fopen(cacheFileName.c_str(), "rb"))
+    {
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        if (size > 0)
+        {
+            std::vector<uchar> data(size);
+            std::vector<File> cached;
+            size_t index = 0;
+            if (fread(&data[0], 1, size, fp) == (size_t)size)
+                index = readHeader(&data[0], size, cached);
+            if (index && sameFiles(cached, files))
+                readEntries(&data[0], size, index);
+        }
+        fclose(fp);
+    }
+
+    std::string buf(magic, 8);
+    put32(buf, version);
+    put32(buf, byteOrder);
+    putString(buf, id);
+    put32(buf, (quint32)files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        putString(buf, files[i].name);
+        put64(buf, files[i].mtime);
+        put64(buf, files[i].size);
+    }
+
+    // open addressing with at most 50% load
+    quint32 numBuckets = 16;
+    while (numBuckets < 2 * entries.size())
+        numBuckets *= 2;
+    put32(buf, numBuckets);
+    const size_t buckets = buf.length();
+    buf.append(numBuckets * sizeof(quint32), '\0');
+    for (unordered_map<std::string, Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        const quint32 h = hash(it->first);
+        const quint32 offset = (quint32)buf.length();
+        put32(buf, h);
+        put32(buf, (quint32)it->first.length());
+        put32(buf, it->second.exists ? (quint32)it->second.value.length() : NOVALUE);
+        buf.append(it->first);
+        if (it->second.exists)
+            buf.append(it->second.value);
+
+        for (quint32 b = h & (numBuckets - 1);; b = (b + 1) & (numBuckets - 1))
+        {
+            size_t pos = buckets + b * sizeof(quint32);
+            quint32 used;
+            get32((const uchar *)buf.data(), buf.length(), pos, used);
+            if (used == 0)
+            {
+                memcpy(&buf[pos - sizeof(used)], &offset, sizeof(offset));
+                break;
+            }
+        }
+    }
+
+    // write to a temporary file and rename, readers always see a complete file
+    char suffix[32];
+#ifdef _WIN32
+    snprintf(suffix, sizeof(suffix), ".%d", (int)_getpid());
+#else
+    snprintf(suffix, sizeof(suffix), ".%d", (int)getpid());
+#endif
+    std::string tmpName = cacheFileName + suffix;
+    FILE *fp = fopen(tmpName.c_str(), "wb");
+    if (!fp)
+        return;
+    bool ok = fwrite(buf.data(), 1, buf.length(), fp) == buf.length();
+    ok = fclose(fp) == 0 && ok;
+#ifdef _WIN32
+    if (ok)
+        remove(cacheFileName.c_str());
+#endif
+    if (!ok || rename(tmpName.c_str(), cacheFileName.c_str()) != 0)
+        remove(tmpName.c_str());
+}
@@ -0,0 +1,136 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef COCONFIGCACHE_H
+#define COCONFIGCACHE_H
+
+#include <alg/unordered_set.h>
+
+#include <QFile>
+#include <QString>
+
+#include <string>
+#include <vector>
+#include <time.h>
+
+namespace covise
+{
+
+/**
+ * Cache of resolved config values for coCoviseConfig.
+ *
+ * Every value looked up with coCoviseConfig is remembered in a hash table,
+ * including values that do not exist. When new values have been added, the
+ * table is written to a binary cache file in the local config directory,
+ * at most once per second and at exit, together with the modification
+ * times of all XML files that were read. Processes which are killed thus
+ * keep their values as well. Later processes map
+ * this file and answer lookups from its hash index without parsing the XML
+ * configuration. coConfig is only loaded on a miss.
+ *
+ * The cache is discarded when one of the config files changed and is
+ * disabled for the rest of the process when the configuration is modified
+ * at runtime. Set COCONFIG_CACHE=0 to disable it.
+ */
+class coConfigCache
+{
+public:
+    static coConfigCache *instance();
+
+    // returns false if the value is not cached
+    bool find(const std::string &variable, const std::string &section,
+              std::string &value, bool &exists);
+    void insert(const std::string &variable, const std::string &section,
+                const std::string &value, bool exists);
+
+    // the configuration was changed, don't use or write the cache anymore
+    void disable();
+
+    // a config file has been read by coConfigRoot
+    void addFile(const QString &filename);
+
+    // write new values to the cache file
+    void save();
+
+    bool isEnabled() const
+    {
+        return enabled;
+    }
+    bool isMapped() const
+    {
+        return mapData != NULL;
+    }
+    int getNumHits() const
+    {
+        return numHits;
+    }
+    int getNumMisses() const
+    {
+        return numMisses;
+    }
+
+private:
+    coConfigCache();
+    ~coConfigCache();
+
+    struct Entry
+    {
+        std::string value;
+        bool exists;
+    };
+
+    struct File
+    {
+        std::string name; // UTF-8
+        qint64 mtime; // -1 if the file does not exist
+        qint64 size;
+    };
+
+    static std::string makeKey(const std::string &variable, const std::string &section);
+    static unsigned int hash(const std::string &key);
+
+    // identification of the config files used by this process
+    static std::string makeId();
+
+    // stat a config file
+    static File makeFile(const std::string &name);
+
+    // map the cache file and check that it is up to date
+    bool open();
+
+    static bool sameFile(const File &a, const File &b);
+    static bool sameFiles(const std::vector<File> &a, const std::vector<File> &b);
+
+    // read the header of a cache file, returns the offset of the hash index or 0 if invalid
+    size_t readHeader(const uchar *data, size_t size, std::vector<File> &fileList) const;
+
+    bool lookupMapped(const std::string &key, Entry &entry) const;
+
+    // copy all entries of a valid cache file to entries
+    void readEntries(const uchar *data, size_t size, size_t index);
+
+    bool enabled;
+    bool dirty;
+    time_t lastSave;
+    int numHits;
+    int numMisses;
+
+    std::string id;
+    std::string cacheFileName;
+    std::vector<File> files;
+
+    QFile cacheFile;
+    const uchar *mapData;
+    size_t mapSize;
+    size_t indexOffset;
+
+    unordered_map<std::string, Entry> entries;
+
+    static coConfigCache *cache;
+};
+}
+#endif
@@ -62,6 +62,11 @@ coConfigFloat::~coConfigFloat()
 }
 
 float coConfigFloat::fromString(const QString &value) const
+{
+    return parseValue(value);
+}
+
+float coConfigFloat::parseValue(const QString &value)
 {
     return value.toFloat();
 }
@@ -62,6 +62,11 @@ coConfigInt::~coConfigInt()
 }
 
 int coConfigInt::fromString(const QString &value) const
+{
+    return parseValue(value);
+}
+
+int coConfigInt::parseValue(const QString &value)
 {
     QString v = value.toLower();
     int mult = 1;
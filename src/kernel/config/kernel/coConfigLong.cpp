@@ -62,6 +62,11 @@ coConfigLong::~coConfigLong()
 }
 
 long coConfigLong::fromString(const QString &value) const
+{
+    return parseValue(value);
+}
+
+long coConfigLong::parseValue(const QString &value)
 {
     QString v = value.toLower();
     long mult = 1;
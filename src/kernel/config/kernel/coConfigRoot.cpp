@@ -11,6 +11,7 @@
 #include <config/coConfigLog.h>
 #include <config/coConfigConstants.h>
 #include "coConfigRootErrorHandler.h"
+#include "coConfigCache.h"
 
 #include <QFileInfo>
 #include <QDir>
@@ -201,6 +202,8 @@ void coConfigXercesRoot::load(bool create)
     }
     else
     {
+        // the cache has to be invalidated when the file is created
+        coConfigCache::instance()->addFile(configfile.filePath());
 
         if (create)
         {
@@ -795,6 +798,7 @@ xercesc::DOMNode *coConfigXercesRoot::loadFile(const QString &filename)
     //create Parser, get Schema file and return element
     xercesc::DOMElement *globalConfigElement = 0;
     QString schemaFile;
+    coConfigCache::instance()->addFile(filename);
     if (!QFileInfo(filename).isFile())
     {
         COCONFIGDBG("coConfigRoot::loadFile err: non existent filename: " << filename);
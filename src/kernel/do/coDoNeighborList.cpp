@@ -0,0 +1,694 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coDoNeighborList.h"
+#include "coDoUnstructuredGrid.h"
+
+#include <algorithm>
+#include <climits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/****************************************************************
+ **                                                              **
+ **   Neighbor List Class                                        **
+ **                                                              **
+ **   Description  : Companion object of coDoUnstructuredGrid    **
+ **                  holding the vertex->cell list and a hashed  **
+ **                  face table in shared memory                 **
+ **                                                              **
+ **   Classes      : coDoNeighborList                            **
+ **                                                              **
+\****************************************************************/
+
+using namespace covise;
+
+namespace
+{
+
+// faces of the standard 3D cells, vertex numbering as in DomainSurface
+const int faceTet[4][4] = { { 0, 2, 1, -1 }, { 0, 1, 3, -1 }, { 3, 1, 2, -1 }, { 0, 3, 2, -1 } };
+const int facePyra[5][4] = { { 0, 1, 4, -1 }, { 0, 4, 3, -1 }, { 2, 3, 4, -1 }, { 1, 2, 4, -1 }, { 0, 3, 2, 1 } };
+const int facePrism[5][4] = { { 0, 2, 5, 3 }, { 5, 4, 3, -1 }, { 0, 3, 4, 1 }, { 0, 1, 2, -1 }, { 2, 5, 4, 1 } };
+const int faceHexa[6][4] = { { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 4, 5, 6, 7 }, { 0, 4, 7, 3 }, { 1, 2, 6, 5 }, { 0, 3, 2, 1 } };
+
+int numChunks(int n)
+{
+    int nchunks = 1;
+#ifdef _OPENMP
+    nchunks = omp_get_max_threads();
+#endif
+    if (n < 65536 || nchunks < 1)
+        nchunks = 1;
+    return nchunks;
+}
+
+// parallel exclusive prefix sum, returns the total
+int exclusiveScan(int *a, int n)
+{
+    const int nchunks = numChunks(n);
+    const int chunk = (n + nchunks - 1) / nchunks;
+    std::vector<int> sums(nchunks + 1, 0);
+#pragma omp parallel for
+    for (int c = 0; c < nchunks; c++)
+    {
+        const int end = std::min(n, (c + 1) * chunk);
+        int sum = 0;
+        for (int i = c * chunk; i < end; i++)
+            sum += a[i];
+        sums[c + 1] = sum;
+    }
+    for (int c = 0; c < nchunks; c++)
+        sums[c + 1] += sums[c];
+#pragma omp parallel for
+    for (int c = 0; c < nchunks; c++)
+    {
+        const int end = std::min(n, (c + 1) * chunk);
+        int run = sums[c];
+        for (int i = c * chunk; i < end; i++)
+        {
+            const int v = a[i];
+            a[i] = run;
+            run += v;
+        }
+    }
+    return sums[nchunks];
+}
+
+// keep the three smallest distinct vertices of a face
+inline void insertKey(int *key, int v)
+{
+    if (v == key[0] || v == key[1] || v == key[2])
+        return;
+    if (v < key[0])
+    {
+        key[2] = key[1];
+        key[1] = key[0];
+        key[0] = v;
+    }
+    else if (v < key[1])
+    {
+        key[2] = key[1];
+        key[1] = v;
+    }
+    else if (v < key[2])
+    {
+        key[2] = v;
+    }
+}
+
+// returns false for faces with less than three distinct vertices
+inline bool finishKey(int *key)
+{
+    if (key[2] == INT_MAX)
+    {
+        key[0] = key[1] = key[2] = -1;
+        return false;
+    }
+    return true;
+}
+
+inline unsigned int faceHash(const int *key)
+{
+    unsigned int h = (unsigned int)key[0] * 73856093u;
+    h ^= (unsigned int)key[1] * 19349663u;
+    h ^= (unsigned int)key[2] * 83492791u;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+int nextPow2(int n)
+{
+    int p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+// number of faces of cell i, their keys are stored to 'keys' if not NULL
+int cellFaces(int i, int nelem, int nconn, const int *el, const int *cl, const int *tl, int *keys)
+{
+    const int *conn = cl + el[i];
+    const int (*table)[4] = NULL;
+    int nfaces = 0;
+    switch (tl[i])
+    {
+    case TYPE_TETRAHEDER:
+        table = faceTet;
+        nfaces = 4;
+        break;
+    case TYPE_PYRAMID:
+        table = facePyra;
+        nfaces = 5;
+        break;
+    case TYPE_PRISM:
+        table = facePrism;
+        nfaces = 5;
+        break;
+    case TYPE_HEXAEDER:
+        table = faceHexa;
+        nfaces = 6;
+        break;
+    case TYPE_POLYHEDRON:
+    {
+        // faces are closed by repeating their start vertex
+        const int end = (i < nelem - 1) ? el[i + 1] : nconn;
+        int start = -1;
+        int key[3] = { INT_MAX, INT_MAX, INT_MAX };
+        for (int j = el[i]; j < end; j++)
+        {
+            if (start == -1)
+            {
+                start = cl[j];
+                key[0] = key[1] = key[2] = INT_MAX;
+                insertKey(key, start);
+            }
+            else if (cl[j] == start)
+            {
+                if (keys)
+                {
+                    finishKey(key);
+                    keys[3 * nfaces] = key[0];
+                    keys[3 * nfaces + 1] = key[1];
+                    keys[3 * nfaces + 2] = key[2];
+                }
+                nfaces++;
+                start = -1;
+            }
+            else
+            {
+                insertKey(key, cl[j]);
+            }
+        }
+        return nfaces;
+    }
+    default:
+        // 2D cells, bars and points do not have faces
+        return 0;
+    }
+
+    if (keys)
+    {
+        for (int f = 0; f < nfaces; f++)
+        {
+            int *key = keys + 3 * f;
+            key[0] = key[1] = key[2] = INT_MAX;
+            for (int n = 0; n < 4 && table[f][n] >= 0; n++)
+                insertKey(key, conn[table[f][n]]);
+            finishKey(key);
+        }
+    }
+    return nfaces;
+}
+}
+
+coDistributedObject *coDoNeighborList::virtualCtor(coShmArray *arr)
+{
+    return new coDoNeighborList(coObjInfo(), arr);
+}
+
+int coDoNeighborList::getObjInfo(int no, coDoInfo **il) const
+{
+    if (no == SHM_OBJ)
+    {
+        (*il)[0].description = "Number of Elements";
+        (*il)[1].description = "Number of Coordinates";
+        (*il)[2].description = "Vertex Index";
+        (*il)[3].description = "Vertex Cells";
+        (*il)[4].description = "Face Buckets";
+        (*il)[5].description = "Face Keys";
+        (*il)[6].description = "Face Cells";
+        return SHM_OBJ;
+    }
+    else
+    {
+        print_error(__LINE__, __FILE__, "number wrong for object info");
+        return 0;
+    }
+}
+
+coDoNeighborList::coDoNeighborList(const coObjInfo &info, coShmArray *arr)
+    : coDistributedObject(info, "NBLIST")
+{
+    if (createFromShm(arr) == 0)
+    {
+        print_comment(__LINE__, __FILE__, "createFromShm == 0");
+        new_ok = 0;
+    }
+}
+
+coDoNeighborList::coDoNeighborList(const coObjInfo &info, int nelem, int ncoord, int nVertexCells,
+                                   int nBuckets, int nFaceSlots)
+    : coDistributedObject(info, "NBLIST")
+{
+    vertexIndex.set_length(ncoord + 1);
+    vertexCells.set_length(nVertexCells);
+    faceBuckets.set_length(nBuckets > 0 ? nBuckets + 1 : 0);
+    faceKeys.set_length(3 * nFaceSlots);
+    faceCells.set_length(2 * nFaceSlots);
+
+    covise_data_list dl[SHM_OBJ];
+    dl[0].type = INTSHM;
+    dl[0].ptr = (void *)&numElem;
+    dl[1].type = INTSHM;
+    dl[1].ptr = (void *)&numCoord;
+    dl[2].type = INTSHMARRAY;
+    dl[2].ptr = (void *)&vertexIndex;
+    dl[3].type = INTSHMARRAY;
+    dl[3].ptr = (void *)&vertexCells;
+    dl[4].type = INTSHMARRAY;
+    dl[4].ptr = (void *)&faceBuckets;
+    dl[5].type = INTSHMARRAY;
+    dl[5].ptr = (void *)&faceKeys;
+    dl[6].type = INTSHMARRAY;
+    dl[6].ptr = (void *)&faceCells;
+    new_ok = store_shared_dl(SHM_OBJ, dl) != 0;
+    if (!new_ok)
+        return;
+
+    numElem = nelem;
+    numCoord = ncoord;
+}
+
+coDoNeighborList::coDoNeighborList(const coObjInfo &info, const coDoUnstructuredGrid *grid, bool withFaces)
+    : coDistributedObject(info, "NBLIST")
+{
+    int nelem, nconn, ncoord;
+    int *el, *cl, *tl = NULL;
+    float *x, *y, *z;
+    grid->getGridSize(&nelem, &nconn, &ncoord);
+    grid->getAddresses(&el, &cl, &x, &y, &z);
+    if (grid->hasTypeList())
+        grid->getTypeList(&tl);
+
+    std::vector<int> index, cells;
+    buildVertexCells(nelem, nconn, ncoord, el, cl, tl, index, cells);
+
+    int maxCells = 0;
+    for (int v = 0; v < ncoord; v++)
+        maxCells = std::max(maxCells, index[v + 1] - index[v]);
+
+    std::vector<int> buckets, keys, pairs;
+    if (withFaces && tl && maxCells > FaceTableValence)
+        buildFaceTable(nelem, nconn, el, cl, tl, buckets, keys, pairs);
+
+    vertexIndex.set_length(ncoord + 1);
+    vertexCells.set_length((int)cells.size());
+    faceBuckets.set_length((int)buckets.size());
+    faceKeys.set_length((int)keys.size());
+    faceCells.set_length((int)pairs.size());
+
+    covise_data_list dl[SHM_OBJ];
+    dl[0].type = INTSHM;
+    dl[0].ptr = (void *)&numElem;
+    dl[1].type = INTSHM;
+    dl[1].ptr = (void *)&numCoord;
+    dl[2].type = INTSHMARRAY;
+    dl[2].ptr = (void *)&vertexIndex;
+    dl[3].type = INTSHMARRAY;
+    dl[3].ptr = (void *)&vertexCells;
+    dl[4].type = INTSHMARRAY;
+    dl[4].ptr = (void *)&faceBuckets;
+    dl[5].type = INTSHMARRAY;
+    dl[5].ptr = (void *)&faceKeys;
+    dl[6].type = INTSHMARRAY;
+    dl[6].ptr = (void *)&faceCells;
+    new_ok = store_shared_dl(SHM_OBJ, dl) != 0;
+    if (!new_ok)
+        return;
+
+    numElem = nelem;
+    numCoord = ncoord;
+    memcpy(vertexIndex.getDataPtr(), &index[0], (ncoord + 1) * sizeof(int));
+    if (!cells.empty())
+        memcpy(vertexCells.getDataPtr(), &cells[0], cells.size() * sizeof(int));
+    if (!buckets.empty())
+        memcpy(faceBuckets.getDataPtr(), &buckets[0], buckets.size() * sizeof(int));
+    if (!keys.empty())
+    {
+        memcpy(faceKeys.getDataPtr(), &keys[0], keys.size() * sizeof(int));
+        memcpy(faceCells.getDataPtr(), &pairs[0], pairs.size() * sizeof(int));
+    }
+}
+
+void coDoNeighborList::buildFaceTable(int nelem, int nconn, const int *el, const int *cl, const int *tl,
+                                      std::vector<int> &buckets, std::vector<int> &slotKeys, std::vector<int> &slotCells)
+{
+    buckets.clear();
+    slotKeys.clear();
+    slotCells.clear();
+    if (!tl || nelem <= 0)
+        return;
+
+    // faces: count, collect keys and sort them into hash buckets
+    std::vector<int> faceStart(nelem + 1, 0);
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (int i = 0; i < nelem; i++)
+        faceStart[i] = cellFaces(i, nelem, nconn, el, cl, tl, NULL);
+    const int nfaces = exclusiveScan(&faceStart[0], nelem + 1);
+
+    std::vector<int> keys(3 * nfaces + 1), faceCell(nfaces + 1);
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (int i = 0; i < nelem; i++)
+    {
+        cellFaces(i, nelem, nconn, el, cl, tl, &keys[3 * faceStart[i]]);
+        for (int f = faceStart[i]; f < faceStart[i + 1]; f++)
+            faceCell[f] = i;
+    }
+
+    const int nbuckets = std::max(1, std::min(4096, nfaces / 1024));
+    const int nchunks = numChunks(nfaces);
+    const int chunk = (nfaces + nchunks - 1) / nchunks;
+    std::vector<int> hist(nchunks * nbuckets, 0);
+#pragma omp parallel for
+    for (int c = 0; c < nchunks; c++)
+    {
+        const int end = std::min(nfaces, (c + 1) * chunk);
+        int *h = &hist[c * nbuckets];
+        for (int f = c * chunk; f < end; f++)
+        {
+            if (keys[3 * f] >= 0)
+                h[faceHash(&keys[3 * f]) % nbuckets]++;
+        }
+    }
+
+    // stable counting sort: bucket-major, chunk-minor keeps faces ordered by cell
+    buckets.resize(nbuckets + 1, 0);
+    std::vector<int> orderStart(nbuckets + 1, 0);
+    int total = 0;
+    for (int b = 0; b < nbuckets; b++)
+    {
+        orderStart[b] = total;
+        for (int c = 0; c < nchunks; c++)
+        {
+            const int n = hist[c * nbuckets + b];
+            hist[c * nbuckets + b] = total;
+            total += n;
+        }
+        const int count = total - orderStart[b];
+        buckets[b] = count > 0 ? nextPow2(count + count / 3 + 1) : 0;
+    }
+    orderStart[nbuckets] = total;
+    std::vector<int> order(total + 1);
+#pragma omp parallel for
+    for (int c = 0; c < nchunks; c++)
+    {
+        const int end = std::min(nfaces, (c + 1) * chunk);
+        int *h = &hist[c * nbuckets];
+        for (int f = c * chunk; f < end; f++)
+        {
+            if (keys[3 * f] >= 0)
+                order[h[faceHash(&keys[3 * f]) % nbuckets]++] = f;
+        }
+    }
+    const int nslots = exclusiveScan(&buckets[0], nbuckets + 1);
+    slotKeys.resize(3 * nslots);
+    slotCells.resize(2 * nslots);
+
+    // the buckets are independent sub-tables and are filled concurrently
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int b = 0; b < nbuckets; b++)
+    {
+        const int begin = buckets[b];
+        const int size = buckets[b + 1] - begin;
+        if (size == 0)
+            continue;
+        int *bucketKeys = &slotKeys[3 * begin];
+        int *bucketCells = &slotCells[2 * begin];
+        memset(bucketKeys, -1, 3 * size * sizeof(int));
+        memset(bucketCells, -1, 2 * size * sizeof(int));
+
+        const unsigned int mask = size - 1;
+        for (int o = orderStart[b]; o < orderStart[b + 1]; o++)
+        {
+            const int f = order[o];
+            const int *key = &keys[3 * f];
+            unsigned int s = (faceHash(key) / nbuckets) & mask;
+            for (;;)
+            {
+                int *k = bucketKeys + 3 * s;
+                if (k[0] == -1)
+                {
+                    k[0] = key[0];
+                    k[1] = key[1];
+                    k[2] = key[2];
+                    bucketCells[2 * s] = faceCell[f];
+                    break;
+                }
+                if (k[0] == key[0] && k[1] == key[1] && k[2] == key[2])
+                {
+                    // more than two cells at one face: keep the first pair
+                    if (bucketCells[2 * s + 1] == -1 && bucketCells[2 * s] != faceCell[f])
+                        bucketCells[2 * s + 1] = faceCell[f];
+                    break;
+                }
+                s = (s + 1) & mask;
+            }
+        }
+    }
+}
+
+coDoNeighborList *coDoNeighborList::cloneObject(const coObjInfo &newinfo) const
+{
+    const int nbuckets = faceBuckets.get_length() > 0 ? faceBuckets.get_length() - 1 : 0;
+    const int nslots = faceCells.get_length() / 2;
+    coDoNeighborList *nbl = new coDoNeighborList(newinfo, numElem, numCoord, vertexCells.get_length(),
+                                                 nbuckets, nslots);
+    int *vc, *vi, *nvc, *nvi;
+    getAddresses(&vc, &vi);
+    nbl->getAddresses(&nvc, &nvi);
+    memcpy(nvi, vi, vertexIndex.get_length() * sizeof(int));
+    memcpy(nvc, vc, vertexCells.get_length() * sizeof(int));
+    if (nbuckets > 0)
+    {
+        memcpy(nbl->faceBuckets.getDataPtr(), faceBuckets.getDataPtr(), faceBuckets.get_length() * sizeof(int));
+        memcpy(nbl->faceKeys.getDataPtr(), faceKeys.getDataPtr(), faceKeys.get_length() * sizeof(int));
+        memcpy(nbl->faceCells.getDataPtr(), faceCells.getDataPtr(), faceCells.get_length() * sizeof(int));
+    }
+    return nbl;
+}
+
+int coDoNeighborList::rebuildFromShm()
+{
+    if (shmarr == NULL)
+    {
+        cerr << "called rebuildFromShm without shmarray\n";
+        print_exit(__LINE__, __FILE__, 1);
+    }
+
+    covise_data_list dl[SHM_OBJ];
+    dl[0].type = INTSHM;
+    dl[0].ptr = (void *)&numElem;
+    dl[1].type = INTSHM;
+    dl[1].ptr = (void *)&numCoord;
+    dl[2].type = INTSHMARRAY;
+    dl[2].ptr = (void *)&vertexIndex;
+    dl[3].type = INTSHMARRAY;
+    dl[3].ptr = (void *)&vertexCells;
+    dl[4].type = INTSHMARRAY;
+    dl[4].ptr = (void *)&faceBuckets;
+    dl[5].type = INTSHMARRAY;
+    dl[5].ptr = (void *)&faceKeys;
+    dl[6].type = INTSHMARRAY;
+    dl[6].ptr = (void *)&faceCells;
+    return restore_shared_dl(SHM_OBJ, dl);
+}
+
+int coDoNeighborList::getFaceNeighbor(int element, int num_nodes, const int *face_nodes) const
+{
+    return findFaceNeighbor((const int *)faceBuckets.getDataPtr(), faceBuckets.get_length() - 1,
+                            (const int *)faceKeys.getDataPtr(), (const int *)faceCells.getDataPtr(),
+                            element, num_nodes, face_nodes);
+}
+
+int coDoNeighborList::findFaceNeighbor(const int *buckets, int nbuckets, const int *slotKeys, const int *slotCells,
+                                       int element, int num_nodes, const int *face_nodes)
+{
+    if (nbuckets < 1)
+        return NOT_IN_TABLE;
+
+    int key[3] = { INT_MAX, INT_MAX, INT_MAX };
+    for (int n = 0; n < num_nodes; n++)
+    {
+        if (face_nodes[n] < 0)
+            return NOT_IN_TABLE;
+        insertKey(key, face_nodes[n]);
+    }
+    if (!finishKey(key))
+        return NOT_IN_TABLE;
+
+    // every face of a 3D cell is in the table, boundary faces with one cell
+    const unsigned int h = faceHash(key);
+    const int b = h % nbuckets;
+    const int begin = buckets[b];
+    const int size = buckets[b + 1] - begin;
+    const unsigned int mask = size - 1;
+    unsigned int s = (h / nbuckets) & mask;
+    for (int probe = 0; probe < size; probe++)
+    {
+        const int *k = slotKeys + 3 * (begin + s);
+        if (k[0] == -1)
+            break;
+        if (k[0] == key[0] && k[1] == key[1] && k[2] == key[2])
+        {
+            const int *cells = slotCells + 2 * (begin + s);
+            if (cells[0] != element && cells[1] != element)
+                return NOT_IN_TABLE;
+            return (cells[0] == element) ? cells[1] : cells[0];
+        }
+        s = (s + 1) & mask;
+    }
+    return NOT_IN_TABLE;
+}
+
+void coDoNeighborList::buildVertexCells(int nelem, int nconn, int ncoord,
+                                        const int *el, const int *cl, const int *tl,
+                                        std::vector<int> &index, std::vector<int> &cells)
+{
+    index.assign(ncoord + 1, 0);
+    cells.clear();
+    if (ncoord == 0)
+        return;
+
+    // The cells are split into chunks, the vertices into ranges. Every chunk
+    // counts and then scatters its (vertex, cell) pairs by vertex range,
+    // range-major and chunk-minor, so the pairs of a range are in ascending
+    // cell order. Every range is then sorted by vertex by one thread. Each
+    // pass touches every list entry once, independent of the thread count.
+    // Polyhedral cells repeat vertices in their face lists, they are counted
+    // only once per vertex. A single part needs no pair buffer, the cells
+    // are counted and listed straight from the connectivity.
+    const int nparts = numChunks(nconn);
+    if (nparts == 1)
+    {
+        std::vector<int> last_cell(tl ? ncoord : 0, -1);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            if (pass == 1)
+            {
+                const int total = exclusiveScan(&index[0], ncoord + 1);
+                cells.resize(total);
+                std::fill(last_cell.begin(), last_cell.end(), -1);
+            }
+            std::vector<int> cursor;
+            if (pass == 1)
+                cursor.assign(index.begin(), index.end() - 1);
+            for (int i = 0; i < nelem; i++)
+            {
+                const bool poly = tl && tl[i] == TYPE_POLYHEDRON;
+                const int end = (i < nelem - 1) ? el[i + 1] : nconn;
+                for (int j = el[i]; j < end; j++)
+                {
+                    const int v = cl[j];
+                    if ((unsigned int)v >= (unsigned int)ncoord)
+                        continue;
+                    if (poly)
+                    {
+                        if (last_cell[v] == i)
+                            continue;
+                        last_cell[v] = i;
+                    }
+                    if (pass == 0)
+                        index[v]++;
+                    else
+                        cells[cursor[v]++] = i;
+                }
+            }
+        }
+        return;
+    }
+
+    std::vector<int> offset(nparts * nparts + 1, 0);
+    int *off = &offset[0];
+#pragma omp parallel for
+    for (int c = 0; c < nparts; c++)
+    {
+        const int ebegin = (int)((long long)nelem * c / nparts);
+        const int eend = (int)((long long)nelem * (c + 1) / nparts);
+        const int jbegin = ebegin < nelem ? el[ebegin] : nconn;
+        const int jend = eend < nelem ? el[eend] : nconn;
+        for (int j = jbegin; j < jend; j++)
+        {
+            const int v = cl[j];
+            if ((unsigned int)v < (unsigned int)ncoord)
+                off[(int)((long long)v * nparts / ncoord) * nparts + c]++;
+        }
+    }
+    const int npairs = exclusiveScan(off, nparts * nparts + 1);
+
+    std::vector<int> pair_vertex(npairs + 1), pair_cell(npairs + 1);
+    int *pv = &pair_vertex[0];
+    int *pc = &pair_cell[0];
+#pragma omp parallel for
+    for (int c = 0; c < nparts; c++)
+    {
+        std::vector<int> next(nparts);
+        for (int r = 0; r < nparts; r++)
+            next[r] = off[r * nparts + c];
+        const int ebegin = (int)((long long)nelem * c / nparts);
+        const int eend = (int)((long long)nelem * (c + 1) / nparts);
+        for (int i = ebegin; i < eend; i++)
+        {
+            const int end = (i < nelem - 1) ? el[i + 1] : nconn;
+            for (int j = el[i]; j < end; j++)
+            {
+                const int v = cl[j];
+                if ((unsigned int)v >= (unsigned int)ncoord)
+                    continue;
+                const int pos = next[(int)((long long)v * nparts / ncoord)]++;
+                pv[pos] = v;
+                pc[pos] = i;
+            }
+        }
+    }
+
+    std::vector<int> last_cell(ncoord, -1);
+    int *count = &index[0];
+    int *last = &last_cell[0];
+#pragma omp parallel for
+    for (int r = 0; r < nparts; r++)
+    {
+        for (int k = off[r * nparts]; k < off[(r + 1) * nparts]; k++)
+        {
+            const int v = pv[k], i = pc[k];
+            if (tl && tl[i] == TYPE_POLYHEDRON)
+            {
+                if (last[v] == i)
+                    continue;
+                last[v] = i;
+            }
+            count[v]++;
+        }
+    }
+    const int total = exclusiveScan(count, ncoord + 1);
+
+    cells.resize(total + 1);
+    std::vector<int> cursor(index.begin(), index.end() - 1);
+    int *next = &cursor[0];
+    int *cell = &cells[0];
+    if (tl)
+        std::fill(last_cell.begin(), last_cell.end(), -1);
+#pragma omp parallel for
+    for (int r = 0; r < nparts; r++)
+    {
+        for (int k = off[r * nparts]; k < off[(r + 1) * nparts]; k++)
+        {
+            const int v = pv[k], i = pc[k];
+            if (tl && tl[i] == TYPE_POLYHEDRON)
+            {
+                if (last[v] == i)
+                    continue;
+                last[v] = i;
+            }
+            cell[next[v]++] = i;
+        }
+    }
+    cells.resize(total);
+}
@@ -0,0 +1,164 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef CO_DO_NEIGHBORLIST_H
+#define CO_DO_NEIGHBORLIST_H
+
+#include "coDistributedObject.h"
+#include <vector>
+
+/****************************************************************
+ **                                                              **
+ **   Neighbor List Class                                        **
+ **                                                              **
+ **   Description  : Companion object of coDoUnstructuredGrid    **
+ **                  holding the vertex->cell list and a hashed  **
+ **                  face table in shared memory, so that        **
+ **                  several modules can share the adjacency     **
+ **                  information of one grid                     **
+ **                                                              **
+ **   Classes      : coDoNeighborList                            **
+ **                                                              **
+\****************************************************************/
+namespace covise
+{
+
+class coDoUnstructuredGrid;
+
+class DOEXPORT coDoNeighborList : public coDistributedObject
+{
+    friend class coDoInitializer;
+    static coDistributedObject *virtualCtor(coShmArray *arr);
+
+private:
+    enum
+    {
+        SHM_OBJ = 7
+    };
+    coIntShm numElem; // number of cells of the grid
+    coIntShm numCoord; // number of vertices of the grid
+    coIntShmArray vertexIndex; // start of the cells of each vertex in vertexCells (length numCoord+1)
+    coIntShmArray vertexCells; // cells using a vertex, ascending per vertex
+    coIntShmArray faceBuckets; // start of each bucket's slots in the face table (length #buckets+1)
+    coIntShmArray faceKeys; // three smallest distinct face vertices per slot, -1: empty slot
+    coIntShmArray faceCells; // the two cells sharing the face of a slot, -1: boundary
+
+protected:
+    int rebuildFromShm();
+    int getObjInfo(int, coDoInfo **) const;
+    coDoNeighborList *cloneObject(const coObjInfo &newinfo) const;
+
+public:
+    coDoNeighborList(const coObjInfo &info)
+        : coDistributedObject(info, "NBLIST")
+    {
+        if (info.getName())
+        {
+            if (getShmArray() != 0)
+            {
+                if (rebuildFromShm() == 0)
+                {
+                    print_comment(__LINE__, __FILE__, "rebuildFromShm == 0");
+                }
+            }
+            else
+            {
+                print_comment(__LINE__, __FILE__, "object %s doesn't exist", name);
+                new_ok = 0;
+            }
+        }
+    };
+
+    coDoNeighborList(const coObjInfo &info, coShmArray *arr);
+
+    /** build the adjacency information of a grid in parallel
+       * @param grid      grid to analyse
+       * @param withFaces also build the hashed face table, if the grid has a vertex
+       *                  of more than FaceTableValence cells
+       */
+    coDoNeighborList(const coObjInfo &info, const coDoUnstructuredGrid *grid, bool withFaces = true);
+
+    /// used by cloneObject and deserialization: only allocate the arrays
+    coDoNeighborList(const coObjInfo &info, int nelem, int ncoord, int nVertexCells,
+                     int nBuckets, int nFaceSlots);
+
+    int getNumElements() const
+    {
+        return numElem;
+    }
+
+    int getNumPoints() const
+    {
+        return numCoord;
+    }
+
+    /// vertex->cell list in the same format as coDoUnstructuredGrid::getNeighborList
+    void getAddresses(int **vertex_cells, int **vertex_index) const
+    {
+        *vertex_cells = (int *)vertexCells.getDataPtr();
+        *vertex_index = (int *)vertexIndex.getDataPtr();
+    }
+
+    int getNumVertexCells() const
+    {
+        return vertexCells.get_length();
+    }
+
+    bool hasFaceTable() const
+    {
+        return faceBuckets.get_length() > 1;
+    }
+
+    enum
+    {
+        // building and querying the table costs a few cache misses per face,
+        // searching the cells at a face vertex is faster up to about this
+        // number of cells per vertex (DomainSurfaceBench)
+        FaceTableValence = 100
+    };
+
+    enum
+    {
+        NO_NEIGHBOR = -1, // boundary face: in the table, but used by one cell only
+        NOT_IN_TABLE = -2 // no table, degenerated face or face of more than two cells
+    };
+
+    /** look up the cell on the other side of a face
+       * @param element     cell the face belongs to
+       * @param num_nodes   number of face vertices
+       * @param face_nodes  face vertices in arbitrary order
+       * @return  neighbor cell, NO_NEIGHBOR for boundary faces, NOT_IN_TABLE if the face is unknown
+       */
+    int getFaceNeighbor(int element, int num_nodes, const int *face_nodes) const;
+
+    /** parallel counting sort of the cells by vertex
+       *  cells of each vertex are listed in ascending order, polyhedral
+       *  cells are listed only once per vertex - identical to
+       *  coDoUnstructuredGrid::computeNeighborList
+       */
+    static void buildVertexCells(int nelem, int nconn, int ncoord,
+                                 const int *el, const int *cl, const int *tl,
+                                 std::vector<int> &index, std::vector<int> &cells);
+
+    /** parallel construction of the face table: the faces of all 3D cells
+       *  are sorted into hash buckets by a counting sort, then every bucket
+       *  is filled by one thread without locking
+       * @param buckets  start of each bucket's slots (length #buckets+1)
+       * @param keys     three smallest distinct face vertices per slot, -1: empty slot
+       * @param cells    the two cells sharing the face of a slot, -1: boundary
+       */
+    static void buildFaceTable(int nelem, int nconn, const int *el, const int *cl, const int *tl,
+                               std::vector<int> &buckets, std::vector<int> &keys, std::vector<int> &cells);
+
+    /// getFaceNeighbor on a table built by buildFaceTable, nbuckets is buckets.size()-1
+    static int findFaceNeighbor(const int *buckets, int nbuckets, const int *keys, const int *cells,
+                                int element, int num_nodes, const int *face_nodes);
+
+    virtual ~coDoNeighborList(){};
+};
+}
+#endif
@@ -7,6 +7,7 @@
 
 #include "coDoUnstructuredGrid.h"
 #include "coDoOctTree.h"
+#include "coDoNeighborList.h"
 #include "covise_gridmethods.h"
 
 // in this list the TYPE_... definitions in covise_unstrgrd.h can be
@@ -115,6 +116,7 @@ coDoUnstructuredGrid::~coDoUnstructuredGrid()
 coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info, coShmArray *arr)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , neighbor_list(NULL)
     , lnl(NULL)
     , lnli(NULL)
 {
@@ -132,6 +134,7 @@ coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info,
                                            float *zc)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , neighbor_list(NULL)
     , hastypes(0)
     , hasneighbors(0)
     , lnl(NULL)
@@ -207,6 +210,7 @@ coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info,
                                            float *zc, int *tl)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , neighbor_list(NULL)
     , lnl(NULL)
     , lnli(NULL)
 {
@@ -281,6 +285,7 @@ coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info,
                                            int nelem, int nconn, int ncoord, int ht)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , neighbor_list(NULL)
     , lnl(NULL)
     , lnli(NULL)
 {
@@ -450,101 +455,36 @@ int coDoUnstructuredGrid::rebuildFromShm()
 
 void coDoUnstructuredGrid::computeNeighborList() const
 {
-
-    int ja, j, i, offset, *tmpl1;
-    int old_elem_index;
-    int next_elem_index;
-
     el = (int *)elements.getDataPtr();
     cl = (int *)connections.getDataPtr();
     tl = (int *)elementtypes.getDataPtr();
-    lnli = new int[(int)numcoord + 1];
-    tmpl1 = new int[(int)numcoord];
-    memset(lnli, 0, (int)numcoord * sizeof(int));
 
-    // Calculation of the number of cells that contain a certain vertex
-    int *used_vertex_list;
-
-    used_vertex_list = new int[(int)numcoord];
-    memset(used_vertex_list, -1, (int)numcoord * sizeof(int));
-
-    for (i = 0; i < numelem; i++)
+    if (neighbor_list)
     {
-        // Polyhedral cells
-        if (UnstructuredGrid_Num_Nodes[tl[i]] == -1)
-        {
-            next_elem_index = (i < numelem - 1) ? el[i + 1] : numconn;
-            for (j = el[i]; j < next_elem_index; j++)
-            {
-                if (used_vertex_list[cl[j]] != i)
-                {
-                    used_vertex_list[cl[j]] = i;
-                    lnli[cl[j]]++;
-                }
-            }
-        }
-
-        // Standard cells
-        else
-        {
-            next_elem_index = (i < numelem - 1) ? el[i + 1] : numconn;
-            for (j = el[i]; j < next_elem_index; j++)
-            {
-                used_vertex_list[cl[j]] = i;
-                lnli[cl[j]]++;
-            }
-        }
-    }
-
-    //create the position list for cuc list -> cuc_pos
-    j = ja = 0;
-    for (i = 0; i < (int)numcoord; i++)
-    {
-        j += lnli[i];
-        lnli[i] = ja;
-        tmpl1[i] = ja;
-        ja = j;
+        ((const coDoNeighborList *)neighbor_list)->getAddresses(&lnl, &lnli);
+        return;
     }
-    lnli[i] = ja;
-    lnl = new int[ja];
-    memset(used_vertex_list, -1, (int)numcoord * sizeof(int));
-    old_elem_index = el[0];
 
-    //fill the cuc list
-    for (i = 0; i < (int)numelem; i++)
-    {
-        // Polyhedral cells
-        if (UnstructuredGrid_Num_Nodes[tl[i]] == -1)
-        {
-            next_elem_index = (i < numelem - 1) ? el[i + 1] : numconn;
-            offset = next_elem_index - old_elem_index;
-            for (j = 0; j < offset; j++)
-            {
-                if (used_vertex_list[cl[el[i] + j]] != i)
-                {
-                    used_vertex_list[cl[el[i] + j]] = i;
-                    lnl[tmpl1[cl[el[i] + j]]] = i;
-                    tmpl1[cl[el[i] + j]]++;
-                }
-            }
-            old_elem_index = next_elem_index;
-        }
+    // lists all elements that contain a certain vertex consecutively,
+    // built by a parallel counting sort
+    vector<int> index, cells;
+    coDoNeighborList::buildVertexCells(numelem, numconn, numcoord,
+                                       el, cl, hasTypeList() ? tl : NULL, index, cells);
+    lnli = new int[(int)numcoord + 1];
+    memcpy(lnli, &index[0], ((int)numcoord + 1) * sizeof(int));
+    lnl = new int[cells.size() + 1];
+    if (!cells.empty())
+        memcpy(lnl, &cells[0], cells.size() * sizeof(int));
+}
 
-        // Standard cells
-        else
-        {
-            offset = UnstructuredGrid_Num_Nodes[tl[i]];
-            for (j = 0; j < offset; j++)
-            {
-                used_vertex_list[cl[el[i] + j]] = i;
-                lnl[tmpl1[cl[el[i] + j]]] = i; // eam:  lists all elements that contain a certain vertex consecutively
-                tmpl1[cl[el[i] + j]]++;
-            }
-            old_elem_index += offset;
-        }
-    }
-    delete[] tmpl1;
-    delete[] used_vertex_list;
+int coDoUnstructuredGrid::getHashedNeighbor(int element, int num_nodes, const int *face_nodes) const
+{
+    if (!neighbor_list)
+        return coDoNeighborList::NOT_IN_TABLE;
+    const coDoNeighborList *nbl = (const coDoNeighborList *)neighbor_list;
+    if (!nbl->hasFaceTable())
+        return coDoNeighborList::NOT_IN_TABLE;
+    return nbl->getFaceNeighbor(element, num_nodes, face_nodes);
 }
 
 int coDoUnstructuredGrid::getNeighbor(int element, vector<int> face_nodes_list)
@@ -559,6 +499,9 @@ int coDoUnstructuredGrid::getNeighbor(int element, vector<int> face_nodes_list)
 
     int *found_nodes;
 
+    ce = getHashedNeighbor(element, (int)face_nodes_list.size(), &face_nodes_list[0]);
+    if (ce != coDoNeighborList::NOT_IN_TABLE)
+        return ce;
     ce = -1;
 
     n1 = face_nodes_list[0];
@@ -643,6 +586,12 @@ int coDoUnstructuredGrid::getNeighbor(int element, int n1, int n2, int n3, int n
     int i, n;
     int next_elem_index;
 
+    // interior and boundary faces are resolved by the face table,
+    // only degenerated faces fall through to the search
+    const int face_nodes[] = { n1, n2, n3, n4 };
+    if ((ce = getHashedNeighbor(element, 4, face_nodes)) != coDoNeighborList::NOT_IN_TABLE)
+        return ce;
+
     f2 = f3 = f4 = 0;
     for (i = lnli[n1]; i < lnli[n1 + 1]; i++)
     {
@@ -750,6 +699,10 @@ int coDoUnstructuredGrid::getNeighbor(int element, int n1, int n2, int n3)
     int i, n;
     int next_elem_index;
 
+    const int face_nodes[] = { n1, n2, n3 };
+    if ((ce = getHashedNeighbor(element, 3, face_nodes)) != coDoNeighborList::NOT_IN_TABLE)
+        return ce;
+
     f2 = f3 = 0;
     for (i = lnli[n1]; i < lnli[n1 + 1]; i++)
     {
@@ -1864,6 +1817,27 @@ const coDoOctTree *coDoUnstructuredGrid::GetOctTree(const coDistributedObject *r
     return (coDoOctTree *)(oct_tree);
 }
 
+const coDoNeighborList *coDoUnstructuredGrid::GetNeighborList(const coDistributedObject *reuseNeighborList,
+                                                              const char *neighborListSurname) const
+{
+    if (!neighbor_list)
+    {
+        // lists computed before live on the heap
+        freeNeighborList();
+        if (reuseNeighborList)
+        {
+            neighbor_list = reuseNeighborList;
+        }
+        else if (neighborListSurname)
+        {
+            char nblname[256];
+            snprintf(nblname, sizeof(nblname), "%s_NBL_%s", name, neighborListSurname);
+            neighbor_list = new coDoNeighborList(coObjInfo(nblname), this);
+        }
+    }
+    return (const coDoNeighborList *)(neighbor_list);
+}
+
 void
 coDoUnstructuredGrid::compressConnectivity()
 {
@@ -56,6 +56,7 @@ namespace covise
 DOEXPORT extern int UnstructuredGrid_Num_Nodes[20];
 
 class coDoOctTree;
+class coDoNeighborList;
 
 class DOEXPORT coDoUnstructuredGrid : public coDoGrid
 {
@@ -80,6 +81,7 @@ private:
     coIntShmArray neighborlist; // neighborlist list (length numneighbor)
     coIntShmArray neighborindex; // neighborindex list (length numcoord)
     mutable const coDistributedObject *oct_tree;
+    mutable const coDistributedObject *neighbor_list; // shared vertex->cell and face adjacency
 
     int testACell(float *v_interp, const float *point,
                   int cell, int no_arrays, int array_dim,
@@ -92,6 +94,7 @@ private:
       */
 
     void MakeOctTree(const char *octSurname) const;
+    int getHashedNeighbor(int element, int num_nodes, const int *face_nodes) const;
 
     int hastypes;
     int hasneighbors;
@@ -110,6 +113,7 @@ public:
     coDoUnstructuredGrid(const coObjInfo &info)
         : coDoGrid(info)
         , oct_tree(NULL)
+        , neighbor_list(NULL)
         , lnl(0)
         , lnli(0)
     {
@@ -149,9 +153,13 @@ public:
 
     void freeNeighborList() const
     {
-        delete[] lnl;
+        // lists taken from the neighbor list object live in shared memory
+        if (!neighbor_list)
+        {
+            delete[] lnl;
+            delete[] lnli;
+        }
         lnl = NULL;
-        delete[] lnli;
         lnli = NULL;
     };
 
@@ -260,6 +268,13 @@ public:
     const coDoOctTree *GetOctTree(const coDistributedObject *reuseOctTree,
                                   const char *OctTreeSurname) const;
 
+    // shared neighbor list: like the oct-tree, this is either reused from
+    // an earlier execution or created in shared memory with the given surname.
+    // Once set, getNeighborList and getNeighbor work on the shared lists and
+    // use its hashed face table instead of searching the cells of a vertex.
+    const coDoNeighborList *GetNeighborList(const coDistributedObject *reuseNeighborList,
+                                            const char *neighborListSurname) const;
+
     // checks all hexahedron elements if their connectivity
     // leads to PRISMs, QUADs or TETRAHEDRONs and fix them
     void compressConnectivity();
@@ -20,6 +20,7 @@
 #include "coDoGeometry.h"
 #include "coDoOctTree.h"
 #include "coDoOctTreeP.h"
+#include "coDoNeighborList.h"
 #include "coDoData.h"
 #include "coDoIntArr.h"
 #include "coDoText.h"
@@ -70,6 +71,7 @@ coDoInitializer::coDoInitializer()
     coDistributedObject::set_vconstr("UNSGRD", coDoUnstructuredGrid::virtualCtor);
     coDistributedObject::set_vconstr("OCTREE", coDoOctTree::virtualCtor);
     coDistributedObject::set_vconstr("OCTREP", coDoOctTreeP::virtualCtor);
+    coDistributedObject::set_vconstr("NBLIST", coDoNeighborList::virtualCtor);
     coDistributedObject::set_vconstr("POINTS", coDoPoints::virtualCtor);
     coDistributedObject::set_vconstr("SPHERES", coDoSpheres::virtualCtor);
     coDistributedObject::set_vconstr("LINES", coDoLines::virtualCtor);
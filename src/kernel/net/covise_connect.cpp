@@ -48,7 +48,14 @@ typedef SSL_METHOD *CONST_SSL_METHOD_P;
 #include <util/coErr.h>
 #include <config/CoviseConfig.h>
 
+#ifdef __linux__
+#define HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #include <iostream>
+#include <algorithm>
+#include <climits>
 
 using namespace std;
 using namespace covise;
@@ -116,6 +123,8 @@ Connection::Connection()
     sock = NULL;
     convert_to = DF_NONE;
     message_to_do = 0;
+    ready_list = NULL;
+    ready_queued = false;
     //		   LOGINFO( "message_to_do == 0");
     read_buf = new char[READ_BUFFER_SIZE];
     bytes_to_process = 0;
@@ -130,6 +139,8 @@ Connection::Connection(int sfd)
 {
     send_type = Message::STDINOUT;
     message_to_do = 0;
+    ready_list = NULL;
+    ready_queued = false;
     remove_socket = 0L;
     read_buf = new char[READ_BUFFER_SIZE];
     sock = new Socket(sfd, sfd);
@@ -153,6 +164,24 @@ Connection::~Connection() // close connection (for subclasses)
     delete sock;
 }
 
+// messages up to this size are sent from a copy on the stack
+#define SMALL_MSG_BUFFER_SIZE 1024
+
+// message data space is a multiple of 16 bytes, the buffer the message
+// already holds is kept if it is large enough: a receive loop that reuses
+// its Message does not allocate
+char *Connection::alloc_msg_data(char *old_data, int old_length, int length)
+{
+    int capacity = length + ((length % 16 != 0) * (16 - length % 16));
+    if (old_data)
+    {
+        if (old_length >= capacity)
+            return old_data;
+        delete[] old_data;
+    }
+    return new char[capacity];
+}
+
 // give socket id
 int Connection::get_id(void (*remove_func)(int))
 {
@@ -687,48 +716,22 @@ int Connection::send(const void *buf, unsigned nbyte)
 
 int Connection::send_msg_fast(const Message *msg)
 {
-    int bytes_written = 0;
-    int offset = 0;
-
     //Compose COVISE header
     header_int[0] = sender_id;
     header_int[1] = send_type;
     header_int[2] = msg->type;
     header_int[3] = msg->length;
 
-    int ret = sock->write(header_int, 4 * SIZEOF_IEEE_INT);
-    if (ret < 0)
-    {
-        return ret;
-    }
-
-    bytes_written += ret;
-
-    while (offset < msg->length)
-    {
-        if (msg->length - offset < WRITE_BUFFER_SIZE)
-        {
-            ret = sock->write((void *)&(msg->data[offset]), msg->length - offset);
-        }
-        else
-        {
-            ret = sock->write((void *)&(msg->data[offset]), WRITE_BUFFER_SIZE);
-        }
-        if (ret < 0)
-        {
-            return ret;
-        }
-        bytes_written += ret;
-        offset += ret;
-    }
-    return bytes_written;
+    // header and data in one system call
+    return sock->writev(header_int, 4 * SIZEOF_IEEE_INT, msg->data, msg->length);
 }
 
 int Connection::send_msg(const Message *msg)
 {
-    int retval = 0, tmp_bytes_written;
-    char write_buf[WRITE_BUFFER_SIZE];
-    int *write_buf_int;
+    int retval = 0;
+    // small messages are still copied behind the header, this is cheaper
+    // than having the kernel gather two buffers
+    int write_buf_int[SMALL_MSG_BUFFER_SIZE / sizeof(int)];
 
     if (!sock)
         return 0;
@@ -742,13 +745,12 @@ int Connection::send_msg(const Message *msg)
     tmp_buf[2] = msg->type;
     tmp_buf[3] = msg->length;
 #ifdef _CRAYT3E
-    converter.int_array_to_exch(tmp_buf, write_buf, 4);
+    converter.int_array_to_exch(tmp_buf, (char *)write_buf_int, 4);
 #else
-    conv_array_int_c8i4(tmp_buf, (int *)write_buf, 4, START_EVEN);
+    conv_array_int_c8i4(tmp_buf, write_buf_int, 4, START_EVEN);
 #endif
 #else
     //Compose COVISE header
-    write_buf_int = (int *)write_buf;
     write_buf_int[0] = sender_id;
     write_buf_int[1] = send_type;
     write_buf_int[2] = msg->type;
@@ -757,49 +759,22 @@ int Connection::send_msg(const Message *msg)
 #endif
 
     if (msg->length == 0)
-        retval = sock->write(write_buf, 4 * SIZEOF_IEEE_INT);
+        retval = sock->write(write_buf_int, 4 * SIZEOF_IEEE_INT);
     else
     {
 #ifdef SHOWMSG
         LOGINFO("msg->length: %d", msg->length);
 #endif
-        // Decide wether the message including the COVISE header
-        // fits into one packet
-        if (msg->length < WRITE_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT)
+        if (msg->length <= SMALL_MSG_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT)
         {
-            // Write data to socket for data blocks smaller than the
-            // socket write-buffer reduced by the size of the COVISE
-            // header
-            memcpy(&write_buf[4 * SIZEOF_IEEE_INT], msg->data, msg->length);
-            retval = sock->write(write_buf, 4 * SIZEOF_IEEE_INT + msg->length);
+            memcpy(&write_buf_int[4], msg->data, msg->length);
+            retval = sock->write(write_buf_int, 4 * SIZEOF_IEEE_INT + msg->length);
         }
         else
         {
-            // Message and COVISE header summed-up size is bigger than one network
-            // packet. Therefore it is transmitted in multiple pakets.
-
-            // Copy data block of size WRITE_BUFFER_SIZE to send buffer
-            memcpy(&write_buf[16], msg->data, WRITE_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT);
-#ifdef SHOWMSG
-            LOGINFO("write_buf: %d %d %d %d", write_buf_int[0], write_buf_int[1], write_buf_int[2], write_buf_int[3]);
-#endif
-            //Send first packet of size WRITE_BUFFER_SIZE
-            retval = sock->write(write_buf, WRITE_BUFFER_SIZE);
-#ifdef CRAY
-            tmp_bytes_written = sock->writea(&msg->data[WRITE_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT],
-                                             msg->length - (WRITE_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT));
-#else
-            // Send next packet with remaining data. Thnis code assumes that an overall
-            // message size does never exceed 2x WRITE_BUFFER_SIZE.
-            tmp_bytes_written = sock->write(&msg->data[WRITE_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT],
-                                            msg->length - (WRITE_BUFFER_SIZE - 4 * SIZEOF_IEEE_INT));
-#endif
-            // Check if the socket was invalidated while transmitting multiple packets.
-            // Otherwise returned the summed-up amount of bytes as return value
-            if (tmp_bytes_written == COVISE_SOCKET_INVALID)
-                return COVISE_SOCKET_INVALID;
-            else
-                retval += tmp_bytes_written;
+            // the header and the data are written with one system call
+            // without copying the data into a send buffer first
+            retval = sock->writev(write_buf_int, 4 * SIZEOF_IEEE_INT, msg->data, msg->length);
         }
     }
     return retval;
@@ -830,12 +805,8 @@ int Connection::recv_msg_fast(Message *msg)
     msg->length = header_int[3];
 
     //Extend buffer if necessary, which is costly
-    if (existing_buffer_len < msg->length)
-    {
-        //Realloc
-        delete[] msg -> data;
-        msg->data = new char[msg->length];
-    }
+    if (msg->length > 0)
+        msg->data = alloc_msg_data(msg->data, existing_buffer_len, msg->length);
 
     //Now read data in 64K blocks
     char *buffer = msg->data;
@@ -877,6 +848,9 @@ int Connection::recv_msg(Message *msg)
 #ifdef CRAY
     int tmp_buf[4];
 #endif
+    // msg->data might not have been allocated by recv_msg, so only
+    // msg->length bytes of it are known to be usable
+    int old_length = msg->length;
 
     msg->sender = msg->length = 0;
     msg->send_type = Message::UNDEFINED;
@@ -989,14 +963,9 @@ int Connection::recv_msg(Message *msg)
         read_buf_ptr += 4 * SIZEOF_IEEE_INT;
         if (msg->length > 0) // if msg->length == 0, no data will be received
         {
-            if (msg->data)
-            {
-                delete[] msg -> data;
-                msg->data = NULL;
-            }
-            // bring message data space to 16 byte alignment
-            data_length = msg->length + ((msg->length % 16 != 0) * (16 - msg->length % 16));
-            msg->data = new char[data_length];
+            // message data space is brought to 16 byte alignment, the
+            // previous buffer of msg is reused if possible
+            msg->data = alloc_msg_data(msg->data, old_length, msg->length);
             if (msg->length > bytes_to_process)
             {
                 bytes_read = bytes_to_process;
@@ -1007,6 +976,31 @@ int Connection::recv_msg(Message *msg)
                     memcpy(msg->data, read_buf_ptr, bytes_read);
                 bytes_to_process = 0;
                 bytes_to_read = msg->length - bytes_read;
+                if (bytes_to_read < READ_BUFFER_SIZE)
+                {
+                    // read the rest together with whatever follows it,
+                    // this saves a read call per message in a burst
+                    data_length = 0;
+                    while (data_length < bytes_to_read)
+                    {
+                        tmp_read = sock->Read(&read_buf[data_length], READ_BUFFER_SIZE - data_length);
+                        if (tmp_read < 0)
+                        {
+                            delete[] msg -> data;
+                            msg->data = NULL;
+                            return 0;
+                        }
+                        data_length += tmp_read;
+                    }
+                    memcpy(&msg->data[bytes_read], read_buf, bytes_to_read);
+                    bytes_to_process = data_length - bytes_to_read;
+                    if (bytes_to_process > 0)
+                        memmove(read_buf, &read_buf[bytes_to_read], bytes_to_process);
+                    // an incomplete header is completed by the next call
+                    if (bytes_to_process >= 16)
+                        set_message_to_do();
+                    return msg->length;
+                }
                 read_data = &msg->data[bytes_read];
                 while (bytes_read < msg->length)
                 {
@@ -1062,7 +1056,7 @@ int Connection::recv_msg(Message *msg)
                     }
                     bytes_to_process += tmp_read;
                 }
-                message_to_do = 1;
+                set_message_to_do();
 #ifdef SHOWMSG
                 LOGINFO("message_to_do = 1");
 #endif
@@ -1107,7 +1101,7 @@ int Connection::recv_msg(Message *msg)
                     }
                     bytes_to_process += tmp_read;
                 }
-                message_to_do = 1;
+                set_message_to_do();
 #ifdef SHOWMSG
                 LOGINFO("message_to_do = 1");
 #endif
@@ -1156,23 +1150,38 @@ int Connection::check_for_input(float time)
     return 0;
 }
 
+void Connection::set_message_to_do()
+{
+    message_to_do = 1;
+    if (ready_list)
+        ready_list->queue_ready(this);
+}
+
 ConnectionList::ConnectionList()
 {
     connlist = new List<Connection>;
     open_sock = 0;
     maxfd = 0;
     FD_ZERO(&fdvar);
+    init_epoll();
 }
 
 ConnectionList::ConnectionList(ServerConnection *o_s)
 {
     connlist = new List<Connection>;
     FD_ZERO(&fdvar); // the field for the select call is initiallized
+    maxfd = 0;
+    init_epoll();
     open_sock = o_s;
     if (open_sock->listen() < 0)
     {
         fprintf(stderr, "ConnectionList: listen failure\n");
     }
+    if (epollfd >= 0)
+    {
+        epoll_add(open_sock);
+        return;
+    }
     int id = open_sock->get_id();
     maxfd = id;
     FD_SET(id, &fdvar);
@@ -1200,10 +1209,15 @@ ConnectionList::~ConnectionList()
     connlist->reset();
     while ((ptr = connlist->next()))
     {
+        unqueue_ready(ptr);
         ptr->close_inform();
         delete ptr;
     }
     delete connlist;
+#ifdef HAVE_EPOLL
+    if (epollfd >= 0)
+        ::close(epollfd);
+#endif
     return;
 }
 
@@ -1216,12 +1230,21 @@ void ConnectionList::add_open_conn(ServerConnection *c)
 { // add a connection and update the
     // field for the select call
     if (open_sock)
+    {
+        if (epollfd >= 0)
+            epoll_remove(open_sock);
         delete open_sock;
+    }
     open_sock = c;
     if (open_sock->listen() < 0)
     {
         fprintf(stderr, "ConnectionList: listen failure\n");
     }
+    if (epollfd >= 0)
+    {
+        epoll_add(c);
+        return;
+    }
     if (c->get_id() > maxfd)
         maxfd = c->get_id();
     FD_SET(c->get_id(), &fdvar);
@@ -1231,6 +1254,14 @@ void ConnectionList::add_open_conn(ServerConnection *c)
 void ConnectionList::add(Connection *c) // add a connection and update the
 { //c->print();
     connlist->add(c); // field for the select call
+    c->ready_list = this;
+    if (c->has_message())
+        queue_ready(c);
+    if (epollfd >= 0)
+    {
+        epoll_add(c);
+        return;
+    }
     if (c->get_id() > maxfd)
         maxfd = c->get_id();
     FD_SET(c->get_id(), &fdvar);
@@ -1240,12 +1271,127 @@ void ConnectionList::add(Connection *c) // add a connection and update the
 void ConnectionList::remove(Connection *c) // remove a connection and update
 {
     connlist->remove(c); // the field for the select call
+    unqueue_ready(c);
+    if (epollfd >= 0)
+    {
+        epoll_remove(c);
+        return;
+    }
     FD_CLR(c->get_id(), &fdvar);
     return;
 }
 
+// a connection is queued when recv_msg leaves a message in its read buffer,
+// it stays queued until it is found without a message
+void ConnectionList::queue_ready(Connection *c)
+{
+    if (c->ready_queued)
+        return;
+    c->ready_queued = true;
+    ready.push_back(c);
+}
+
+void ConnectionList::unqueue_ready(Connection *c)
+{
+    if (c->ready_list == this)
+        c->ready_list = NULL;
+    if (!c->ready_queued)
+        return;
+    c->ready_queued = false;
+    ready.erase(std::remove(ready.begin(), ready.end(), c), ready.end());
+}
+
+// epoll is used on Linux unless System.Network useEpoll="false",
+// select is limited to FD_SETSIZE sockets and has to scan all of them
+void ConnectionList::init_epoll()
+{
+    epollfd = -1;
+    epoll_stale = false;
+#ifdef HAVE_EPOLL
+    if (!coCoviseConfig::isOn("useEpoll", "System.Network", true, 0))
+        return;
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd < 0)
+    {
+        LOGINFO("epoll_create1 failed, using select: %s", Socket::coStrerror(Socket::getErrno()));
+    }
+#endif
+}
+
+void ConnectionList::epoll_add(Connection *c)
+{
+#ifdef HAVE_EPOLL
+    int fd = c->get_id();
+    if (fd < 0)
+        return;
+    if (fd >= (int)fdconn.size())
+        fdconn.resize(fd + 1, NULL);
+    fdconn[fd] = c;
+
+    // level triggered: a socket stays ready until all messages have been read,
+    // callers read one message per check_for_input
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        if (errno != EEXIST || epoll_ctl(epollfd, EPOLL_CTL_MOD, fd, &ev) < 0)
+            LOGINFO("epoll_ctl failed for socket %d: %s", fd, Socket::coStrerror(Socket::getErrno()));
+    }
+#else
+    (void)c;
+#endif
+}
+
+void ConnectionList::epoll_remove(Connection *c)
+{
+#ifdef HAVE_EPOLL
+    int fd = c->get_id();
+    if (fd < 0)
+    {
+        // the socket has been closed already: a copy inherited by a child
+        // process might still be registered, start over with a new epoll set
+        for (size_t i = 0; i < fdconn.size(); ++i)
+        {
+            if (fdconn[i] == c)
+                fdconn[i] = NULL;
+        }
+        epoll_stale = true;
+        return;
+    }
+    if (fd < (int)fdconn.size() && fdconn[fd] == c)
+        fdconn[fd] = NULL;
+    if (epoll_ctl(epollfd, EPOLL_CTL_DEL, fd, NULL) < 0)
+        epoll_stale = true;
+#else
+    (void)c;
+#endif
+}
+
+void ConnectionList::epoll_rebuild()
+{
+#ifdef HAVE_EPOLL
+    ::close(epollfd);
+    epoll_stale = false;
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd < 0)
+    {
+        LOGINFO("epoll_create1 failed: %s", Socket::coStrerror(Socket::getErrno()));
+        return;
+    }
+    std::vector<Connection *> registered;
+    registered.swap(fdconn);
+    for (size_t i = 0; i < registered.size(); ++i)
+    {
+        if (registered[i] && registered[i]->get_id() == (int)i)
+            epoll_add(registered[i]);
+    }
+#endif
+}
+
 // aw 04/2000: Check whether PPID==1 or no sockets left: prevent hanging
-static void checkPPIDandFD(fd_set &actSet, int maxfd)
+static void checkPPIDandFD(int numFD)
 {
 #ifndef _WIN32
     if (getppid() == 1)
@@ -1256,11 +1402,6 @@ static void checkPPIDandFD(fd_set &actSet, int maxfd)
     }
 #endif
 
-    int numFD = 0;
-    for (int j = 0; j <= maxfd; j++)
-        if (FD_ISSET(j, &actSet))
-            numFD++;
-
     if (numFD == 0)
     {
         std::cerr << "Process " << getpid()
@@ -1280,18 +1421,84 @@ Connection *ConnectionList::wait_for_input()
     return found;
 }
 
+// only the ready sockets are looked at: epoll_wait hands out one of them,
+// level triggered sockets which stay ready are queued at the end of
+// epoll's ready list, so all connections are served in turn
+Connection *ConnectionList::check_epoll(float time, int numconn)
+{
+#ifdef HAVE_EPOLL
+    if (epoll_stale)
+        epoll_rebuild();
+    if (epollfd < 0)
+        return NULL;
+
+    struct epoll_event ev;
+    // clamped to INT_MAX ms (24 days), larger timeouts would overflow
+    int timeout = 0;
+    if (time >= INT_MAX / 1000.0f)
+        timeout = INT_MAX;
+    else if (time > 0.0f)
+        timeout = std::max(1, (int)(time * 1000.0f));
+    int i;
+    do
+    {
+        i = epoll_wait(epollfd, &ev, 1, timeout);
+    } while (i == -1 && errno == EINTR);
+
+    // nothing? this might be a hanger ... better check it!
+    if (i <= 0 && numconn > 0)
+        checkPPIDandFD(numconn + (open_sock ? 1 : 0));
+
+    if (i > 0)
+    {
+        int fd = ev.data.fd;
+        Connection *ptr = fd < (int)fdconn.size() ? fdconn[fd] : NULL;
+        if (!ptr || ptr->get_id() != fd)
+        {
+            // event of a socket which was closed without being removed
+            epoll_stale = true;
+            return NULL;
+        }
+        if (ptr == open_sock)
+        {
+            this->add(open_sock->spawn_connection());
+            return NULL;
+        }
+        return ptr;
+    }
+    else if (i < 0)
+    {
+        LOGINFO("epoll_wait failed: %s\n", Socket::coStrerror(Socket::getErrno()));
+        coPerror("epoll_wait failed");
+    }
+#else
+    (void)time;
+    (void)numconn;
+#endif
+    return NULL;
+}
+
 Connection *ConnectionList::check_for_input(float time)
 {
-    int numconn = 0;
-    // if we already have a pending message, we return it
-    connlist->reset();
-    while (Connection *ptr = connlist->next())
+    int numconn = connlist->count();
+    // if we already have a pending message, we return it: only the queued
+    // connections are looked at, a connection with more buffered messages
+    // goes to the end of the queue, so that all of them are served in turn
+    while (!ready.empty())
     {
-        ++numconn;
+        Connection *ptr = ready.front();
+        ready.pop_front();
         if (ptr->has_message())
+        {
+            ready.push_back(ptr);
             return ptr;
+        }
+        ptr->ready_queued = false;
     }
 
+    if (epollfd >= 0)
+        return check_epoll(time, numconn);
+
     fd_set fdread;
     int i;
     do
@@ -1321,7 +1528,13 @@ Connection *ConnectionList::check_for_input(float time)
 
     // nothing? this might be a hanger ... better check it!
     if (i <= 0 && numconn > 0)
-        checkPPIDandFD(fdvar, maxfd);
+    {
+        int numFD = 0;
+        for (int j = 0; j <= maxfd; j++)
+            if (FD_ISSET(j, &fdvar))
+                numFD++;
+        checkPPIDandFD(numFD);
+    }
 
     // find the connection that has the read attempt
     if (i > 0)
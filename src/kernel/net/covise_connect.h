@@ -9,6 +9,8 @@
 #define EC_CONNECTION_H
 
 #include <iostream>
+#include <vector>
+#include <deque>
 
 #include <fcntl.h>
 #ifdef _WIN32
@@ -124,6 +126,9 @@ protected:
     int peer_id_; // id of the peer process
     int peer_type_; // type of peer
     int message_to_do; // if more than one message has been read
+    class ConnectionList *ready_list; // list that is told about buffered messages
+    bool ready_queued; // in the ready queue of ready_list
+    void set_message_to_do(); // a complete header is left in read_buf
     int bytes_to_process;
     unsigned long tru;
     char *read_buf;
@@ -132,6 +137,7 @@ protected:
     void (*remove_socket)(int);
     int get_id();
     int *header_int;
+    char *alloc_msg_data(char *old_data, int old_length, int length);
 
 public:
     char convert_to; // to what format do we need to convert data?
@@ -311,10 +317,23 @@ public:
 
 class NETEXPORT ConnectionList // list connections in a way that select can be used
 {
+    friend class Connection;
     List<Connection> *connlist; // list of connections
     fd_set fdvar; // field for select call
     int maxfd; // maximum socket id
     ServerConnection *open_sock; // socket for listening
+    int epollfd; // epoll instance, -1 if select is used
+    bool epoll_stale; // a socket was closed before it was removed
+    std::vector<Connection *> fdconn; // connection for each socket id in the epoll set
+    std::deque<Connection *> ready; // connections that might have a buffered message
+    void queue_ready(Connection *c);
+    void unqueue_ready(Connection *c);
+    void init_epoll();
+    void epoll_add(Connection *c);
+    void epoll_remove(Connection *c);
+    void epoll_rebuild();
+    Connection *check_epoll(float time, int numconn);
+
 public:
     ConnectionList(); // constructor
     ConnectionList(ServerConnection *); // constructor (listens always at port)
@@ -342,6 +361,10 @@ public:
     };
     //Connection at(int index);					  // get specific entry from listpos i
     int count(); // returns the number of current elements
+    bool uses_epoll() const // true if epoll is used instead of select
+    {
+        return epollfd >= 0;
+    };
 };
 
 #ifdef HAVE_OPENSSL
@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #endif
 
 #ifdef CRAY
@@ -47,6 +48,8 @@
 #include "covise_socket.h"
 #include "covise_host.h"
 
+#include <vector>
+
 using std::cerr;
 using std::endl;
 
@@ -879,6 +882,103 @@ int Socket::write(const void *buf, unsigned nbyte)
     return no_of_bytes;
 }
 
+int Socket::writev(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2)
+{
+    unsigned total = nbyte1 + nbyte2;
+    unsigned written = 0;
+    char tmp_str[255];
+#ifdef _WIN32
+    WSABUF bufs[2];
+    bufs[0].buf = (char *)buf1;
+    bufs[0].len = nbyte1;
+    bufs[1].buf = (char *)buf2;
+    bufs[1].len = nbyte2;
+#else
+    struct iovec bufs[2];
+    bufs[0].iov_base = (void *)buf1;
+    bufs[0].iov_len = nbyte1;
+    bufs[1].iov_base = (void *)buf2;
+    bufs[1].iov_len = nbyte2;
+#endif
+    int first = 0;
+    int count = nbyte2 > 0 ? 2 : 1;
+    while (written < total)
+    {
+        int no_of_bytes = 0;
+        do
+        {
+            errno = 0;
+#ifdef _WIN32
+            DWORD sent = 0;
+            if (WSASend(sock_id, &bufs[first], count - first, &sent, 0, NULL, NULL) == 0)
+                no_of_bytes = sent;
+            else
+                no_of_bytes = -1;
+#else
+            no_of_bytes = ::writev(sock_id, &bufs[first], count - first);
+#endif
+#ifdef WIN32
+        } while ((no_of_bytes < 0) && ((getErrno() == WSAEINPROGRESS) || (getErrno() == WSAEINTR) || (getErrno() == WSAEWOULDBLOCK)));
+#else
+        } while ((no_of_bytes < 0) && ((errno == EAGAIN) || (errno == EINTR)));
+#endif
+        if (no_of_bytes < 0)
+        {
+#ifdef _WIN32
+            sprintf(tmp_str, "Socket send error = %d", WSAGetLastError());
+            LOGERROR(tmp_str);
+#else
+            if (errno == EPIPE)
+                return COVISE_SOCKET_INVALID;
+            if (errno == ECONNRESET)
+                return COVISE_SOCKET_INVALID;
+            sprintf(tmp_str, "Socket write error = %d: %s, no_of_bytes = %d", errno, coStrerror(errno), no_of_bytes);
+            LOGERROR(tmp_str);
+#endif
+            fprintf(stderr, "error writing on socket to %s:%d: %s\n", host->getAddress(), port, coStrerror(getErrno()));
+            LOGERROR("write returns <= 0: close socket.");
+            return COVISE_SOCKET_INVALID;
+        }
+        written += no_of_bytes;
+
+        // skip what has been written after a partial write
+        unsigned done = no_of_bytes;
+        while (first < count)
+        {
+#ifdef _WIN32
+            unsigned len = bufs[first].len;
+#else
+            unsigned len = bufs[first].iov_len;
+#endif
+            if (done < len)
+                break;
+            done -= len;
+            ++first;
+        }
+        if (first < count)
+        {
+#ifdef _WIN32
+            bufs[first].buf += done;
+            bufs[first].len -= done;
+#else
+            bufs[first].iov_base = (char *)bufs[first].iov_base + done;
+            bufs[first].iov_len -= done;
+#endif
+        }
+    }
+    return written;
+}
+
+int Socket::write_joined(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2)
+{
+    std::vector<char> buf(nbyte1 + nbyte2);
+    if (nbyte1 > 0)
+        memcpy(&buf[0], buf1, nbyte1);
+    if (nbyte2 > 0)
+        memcpy(&buf[nbyte1], buf2, nbyte2);
+    return write(buf.empty() ? NULL : &buf[0], nbyte1 + nbyte2);
+}
+
 #ifdef CRAY
 struct iosw wrstat;
 
@@ -1214,6 +1314,11 @@ int UDPSocket::write(const void *buf, unsigned nbyte)
 {
     return (sendto(sock_id, (char *)buf, nbyte, 0, (sockaddr *)(void *)&s_addr_in, sizeof(struct sockaddr_in)));
 }
+// a message has to stay in one datagram
+int UDPSocket::writev(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2)
+{
+    return write_joined(buf1, nbyte1, buf2, nbyte2);
+}
 int UDPSocket::read(void *buf, unsigned nbyte)
 {
     return (recvfrom(sock_id, (char *)buf, nbyte, 0, NULL, 0));
@@ -1315,6 +1420,10 @@ int MulticastSocket::write(const void *buf, unsigned nbyte)
 {
     return (sendto(sock_id, (char *)buf, nbyte, 0, (sockaddr *)(void *)&s_addr_in, sizeof(struct sockaddr_in)));
 }
+int MulticastSocket::writev(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2)
+{
+    return write_joined(buf1, nbyte1, buf2, nbyte2);
+}
 int MulticastSocket::read(void *buf, unsigned nbyte)
 {
     return (recvfrom(sock_id, (char *)buf, nbyte, 0, NULL, 0));
@@ -1514,6 +1623,18 @@ int SSLSocket::write(const void *buf, unsigned int nbyte)
     return no_of_bytes;
 }
 
+// header and data are sent as two SSL records, the data is not copied
+int SSLSocket::writev(const void *buf1, unsigned int nbyte1, const void *buf2, unsigned int nbyte2)
+{
+    int ret = write(buf1, nbyte1);
+    if (ret < 0 || nbyte2 == 0)
+        return ret;
+    int ret2 = write(buf2, nbyte2);
+    if (ret2 < 0)
+        return ret2;
+    return ret + ret2;
+}
+
 int SSLSocket::connect(sockaddr_in addr /*, int retries, double timeout*/)
 {
     try
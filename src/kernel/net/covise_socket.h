@@ -135,6 +135,8 @@ protected:
     int port;
     int setTCPOptions();
     bool connected;
+    // copy both buffers into one and write it, for sockets which have to keep them together
+    int write_joined(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2);
 
 public:
     // connect as client
@@ -176,6 +178,8 @@ public:
     int setNonBlocking(bool on);
     //int read_non_blocking(void *buf, unsigned nbyte);
     virtual int write(const void *buf, unsigned nbyte);
+    // write two buffers with one system call, returns the number of bytes written
+    virtual int writev(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2);
 #ifdef CRAY
     int writea(const void *buf, unsigned nbyte);
 #endif
@@ -225,6 +229,7 @@ public:
     //int accept(SSLSocket* sock);
 
     int write(const void *buf, unsigned int nbyte);
+    int writev(const void *buf1, unsigned int nbyte1, const void *buf2, unsigned int nbyte2);
     int connect(sockaddr_in addr /*, int retries, double timeout*/);
 
     SSLServerConnection *spawnConnection(SSLConnection::PasswordCallback *cb, void *userData);
@@ -246,6 +251,7 @@ public:
     ~UDPSocket();
     int read(void *buf, unsigned nbyte);
     int write(const void *buf, unsigned nbyte);
+    int writev(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2);
 };
 
 #ifdef HAVEMULTICAST
@@ -258,6 +264,7 @@ public:
     ~MulticastSocket();
     int read(void *buf, unsigned nbyte);
     int write(const void *buf, unsigned nbyte);
+    int writev(const void *buf1, unsigned nbyte1, const void *buf2, unsigned nbyte2);
     int get_ttl()
     {
         return ttl;
@@ -198,7 +198,8 @@ enum covise_msg_type
     COVISE_MESSAGE_CRB_EXEC_MEMCHECK, // 131
     COVISE_MESSAGE_SSLDAEMON, // 132
     COVISE_MESSAGE_VISENSO_UI, // 133
-    COVISE_MESSAGE_LAST_DUMMY_MESSAGE // 134
+    COVISE_MESSAGE_VRB_REGISTRY_ENTRIES_CHANGED, // 134
+    COVISE_MESSAGE_LAST_DUMMY_MESSAGE // 135
 };
 
 #ifdef DEFINE_MSG_TYPES
@@ -337,6 +338,7 @@ COVISEEXPORT const char *covise_msg_types_array[] = {
     "CRB_EXEC_MEMCHECK", // 131
     "SSLDAEMON", // 132
     "VISENSO_UI", // 133
+    "VRB_REGISTRY_ENTRIES_CHANGED", // 134
     "GIVE_ME_A_NAME",
     "GIVE_ME_A_NAME",
     "GIVE_ME_A_NAME",
@@ -12,6 +12,8 @@
 #define TABLET_REMOVE 2
 #define TABLET_SET_VALUE 3
 #define TABLET_QUIT 4
+// several messages in one: number of messages, then length and content of each
+#define TABLET_BATCH 5
 
 ////////////////////////////////////////////////////////////
 // EVENTS
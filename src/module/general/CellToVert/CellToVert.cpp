@@ -18,6 +18,7 @@
 #include <util/coviseCompat.h>
 #include <alg/coCellToVert.h>
 #include <do/coDoData.h>
+#include <util/coWristWatch.h>
 
 using namespace covise;
 
@@ -42,6 +43,16 @@ CellToVert::CellToVert(int argc, char *argv[])
     setCopyAttributes(1);
 }
 
+void CellToVert::preHandleObjects(coInputPort **)
+{
+    vertexCells.beginExecution();
+}
+
+void CellToVert::postHandleObjects(coOutputPort **)
+{
+    vertexCells.endExecution();
+}
+
 ////// hello
 int CellToVert::compute(const char *)
 {
@@ -57,9 +68,11 @@ int CellToVert::compute(const char *)
     else
         algo_option = coCellToVert::SIMPLE;
 
-    coCellToVert fct;
+    coCellToVert fct(&vertexCells);
     // here we go
+    coWristWatch ww;
     returnObject = fct.interpolate(grid_in->getCurrentObject(), data_in->getCurrentObject(), data_out->getObjName(), algo_option);
+    Covise::sendInfo("interpolation: %6.3f s", ww.elapsed());
 
     if (!returnObject)
     {
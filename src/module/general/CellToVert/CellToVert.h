@@ -30,6 +30,7 @@
 #include <api/coSimpleModule.h>
 using namespace covise;
 #include <util/coviseCompat.h>
+#include <alg/coCellToVert.h>
 
 class CellToVert;
 
@@ -41,6 +42,12 @@ private:
     coOutputPort *data_out;
     coChoiceParam *algorithm;
 
+    // vertex->cell lists of the grids interpolated again
+    coIndexCache<coCellToVertIndex> vertexCells;
+
+    virtual void preHandleObjects(coInputPort **);
+    virtual void postHandleObjects(coOutputPort **);
+
 public:
     CellToVert(int argc, char *argv[]);
 
@@ -53,7 +53,7 @@ Collect::Collect(int argc, char *argv[])
     p_norm = addInputPort("DataIn1", "Vec3", "Normals");
     p_norm->setRequired(0);
 
-    p_text = addInputPort("TextureIn0", "Texture", "Textures");
+    p_text = addInputPort("TextureIn0", "Texture|Float", "Textures or texture coordinates");
     p_text->setRequired(0);
 
     p_vertex = addInputPort("VertexAttribIn0", "Vec3|Float", "Vertex Attribute 0");
@@ -31,10 +31,14 @@
 #include <do/coDoPixelImage.h>
 #include <do/coDoTexture.h>
 #include <api/coFeedback.h>
+#include <util/coWristWatch.h>
 
 // Data values of more than  NoDataColorPercent*FLT_MAX are non-data values
 static const float NoDataColorPercent = 0.01f;
 
+// objects with fewer values are processed by one thread
+static const int MinParallelValues = 65536;
+
 //////////////////////////////////////////////////////////////////////
 //
 // initialize parameters and ports for "Colors" appearance
@@ -73,6 +77,12 @@ void Colors::initCOLORS()
 
     p_annotation = addStringParam("annotation", "Colormap Annotation String");
     p_annotation->setValue("Colors");
+
+    // texture coordinates: no RGBA colors, the colormap is applied as texture
+    const char *outputModeChoices[] = { "RGBA", "TextureCoordinates" };
+    p_outputMode = addChoiceParam("OutputMode", "Create RGBA colors or only texture coordinates");
+    p_outputMode->setValue(2, outputModeChoices,
+                           coCoviseConfig::isOn("Module.Colors.TextureCoordinates", false) ? OUTPUT_TEXTURE : OUTPUT_RGBA);
     p_spikeAlgo = NULL;
 
     // new parameters for Spike removal: only if configured
@@ -136,7 +146,7 @@ void Colors::initCOLORS()
     // Output ports
     p_color = addOutputPort("DataOut0", "RGBA", "Data as colors");
     p_color->setDependencyPort(p_data);
-    p_texture = addOutputPort("TextureOut0", "Texture", "Data or colormap as texture");
+    p_texture = addOutputPort("TextureOut0", "Texture|Float", "Data or colormap as texture");
 
     p_cmapOut = addOutputPort("ColormapOut0", "ColorMap", "Colormap Output");
 }
@@ -346,6 +356,10 @@ Colors::Colors(int argc, char *argv[])
 {
     d_noDataColor = 0x00000000;
     colormaps = NULL;
+    p_outputMode = NULL;
+    d_range.spikeAlgo = SPIKE_NONE;
+    d_range.spikeBot = d_range.spikeTop = 0.f;
+    d_range.min = d_range.max = 0.f;
     numColormaps = 0;
     textureComponents = 3;
     if (coCoviseConfig::isOn("Module.Colors.TransparentTextures", true))
@@ -583,17 +597,53 @@ void Colors::getMinMax(const recObj &base, float &min, float &max)
     // run over own object
     else
     {
-        for (i = 0; i < base.numElem; i++)
+        const float *data = base.data;
+        const int numElem = base.numElem;
+        const float startMin = min, startMax = max;
+#ifdef _OPENMP
+#pragma omp parallel if (numElem >= MinParallelValues)
+#endif
         {
-            // do not care about FLT_MAX elements in min/max calc.
-            if ((base.data[i] < NoDataColorPercent * FLT_MAX) && (base.data[i] < min))
-                min = base.data[i];
-            if ((base.data[i] < NoDataColorPercent * FLT_MAX) && (base.data[i] > max))
-                max = base.data[i];
+            float threadMin = startMin, threadMax = startMax;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int i = 0; i < numElem; i++)
+            {
+                // do not care about FLT_MAX elements in min/max calc.
+                if ((data[i] < NoDataColorPercent * FLT_MAX) && (data[i] < threadMin))
+                    threadMin = data[i];
+                if ((data[i] < NoDataColorPercent * FLT_MAX) && (data[i] > threadMax))
+                    threadMax = data[i];
+            }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            {
+                if (threadMin < min)
+                    min = threadMin;
+                if (threadMax > max)
+                    max = threadMax;
+            }
         }
     }
 }
 
+int Colors::countValues(const recObj &base)
+{
+    if (base.obj == NULL)
+        return 0;
+
+    if (base.subObj)
+    {
+        int num = 0;
+        for (int i = 0; i < base.numElem; i++)
+            num += countValues(base.subObj[i]);
+        return num;
+    }
+    return base.numElem;
+}
+
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // ++++
@@ -658,9 +708,13 @@ coDistributedObject *Colors::createColors(recObj &base, recObj &alpha, FlColor *
             int *dPtr;
             res->getAddress(&dPtr);
             unsigned int *packed = (unsigned int *)dPtr;
-            unsigned char r, g, b, a;
-            for (i = 0; i < base.numElem; i++)
+            const int numElem = base.numElem;
+#ifdef _OPENMP
+#pragma omp parallel for if (numElem >= MinParallelValues)
+#endif
+            for (int i = 0; i < numElem; i++)
             {
+                unsigned char r, g, b, a;
                 if (data[i] >= NoDataColorPercent * FLT_MAX)
                 {
                     packed[i] = d_noDataColor;
@@ -728,7 +782,11 @@ coDistributedObject *Colors::createColors(recObj &base, recObj &alpha, FlColor *
                 txCoord[0] = new float[base.numElem];
                 txCoord[1] = new float[base.numElem];
 
-                for (i = 0; i < base.numElem; i++)
+                const int numElem = base.numElem;
+#ifdef _OPENMP
+#pragma omp parallel for if (numElem >= MinParallelValues)
+#endif
+                for (int i = 0; i < numElem; i++)
                 {
                     float tx = (data[i] - min) * fact;
                     if (tx < 0.0)
@@ -772,6 +830,35 @@ coDistributedObject *Colors::createColors(recObj &base, recObj &alpha, FlColor *
             }
             return texture;
         }
+        // texture coordinates only: the renderer creates the texture from the COLORMAP attribute
+        else if (outStyle == TEX_COORD)
+        {
+            coDoFloat *res = new coDoFloat(name, data ? base.numElem : 0);
+            if (data)
+            {
+                float *coord;
+                res->getAddress(&coord);
+                float fact = 1.0f / (max - min);
+                const int numElem = base.numElem;
+#ifdef _OPENMP
+#pragma omp parallel for if (numElem >= MinParallelValues)
+#endif
+                for (int i = 0; i < numElem; i++)
+                {
+                    float tx = (data[i] - min) * fact;
+                    if (tx < 0.0)
+                        tx = 0.0;
+                    if (tx > 1.0)
+                        tx = 1.0;
+                    coord[i] = tx;
+                }
+            }
+            if (base.obj)
+            {
+                res->copyAllAttributes(base.obj);
+            }
+            return res;
+        }
     }
 
     return NULL;
@@ -836,6 +923,8 @@ int Colors::compute(const char *)
     float min = 0.0;
     float max = 0.0;
     const char *annotation = NULL; // What's written at the Map
+    bool rangeCached = false; // min/max taken from the last execution
+    coWristWatch ww;
 
     int index = p_colorNames->getValue();
     TColormapChoice color = p_colorNames->getValue(index);
@@ -934,11 +1023,23 @@ int Colors::compute(const char *)
         if (min == max
             || ((p_autoScale && p_autoScale->getValue()) && (minmaxIn == NULL)))
         {
+            int spikeAlgo = p_spikeAlgo ? p_spikeAlgo->getValue() : (int)SPIKE_NONE;
+            float spikeBot = p_spikeAlgo ? p_spikeBot->getValue() : 0.f;
+            float spikeTop = p_spikeAlgo ? p_spikeTop->getValue() : 0.f;
+
             min = FLT_MAX;
             max = -FLT_MAX;
 
+            // same data as before: only the colormap changed
+            if (data && d_range.objName == data->getName() && d_range.spikeAlgo == spikeAlgo
+                && d_range.spikeBot == spikeBot && d_range.spikeTop == spikeTop)
+            {
+                min = d_range.min;
+                max = d_range.max;
+                rangeCached = true;
+            }
             // search data for min and max
-            if (data)
+            else if (data)
                 getMinMax(base, min, max);
 
             // Oops, there wasn't even one element...
@@ -948,7 +1049,7 @@ int Colors::compute(const char *)
                 max = 1.0;
             }
             // Otherwise we might want to eliminate spikes - but only if we configured it
-            else if (p_spikeAlgo)
+            else if (p_spikeAlgo && !rangeCached)
             {
                 switch (p_spikeAlgo->getValue())
                 {
@@ -977,6 +1078,16 @@ int Colors::compute(const char *)
                 }
             }
 
+            if (data && !rangeCached)
+            {
+                d_range.objName = data->getName();
+                d_range.spikeAlgo = spikeAlgo;
+                d_range.spikeBot = spikeBot;
+                d_range.spikeTop = spikeTop;
+                d_range.min = min;
+                d_range.max = max;
+            }
+
             // min and max are same - would give random results: not pretty
             if (min == max)
                 max = min + 1;
@@ -1002,13 +1113,19 @@ int Colors::compute(const char *)
         // create the colormap: interpolate to selected number of steps
         actMap = interpolateColormap(numSteps, alphaMult);
     }
+    float rangeTime = ww.elapsed();
+    ww.reset();
 
     const char *outName;
     coDistributedObject *outObj;
 
+    // texture coordinates only: the colormap is applied as texture by the renderer
+    bool textureOnly = p_outputMode && p_outputMode->getValue() == OUTPUT_TEXTURE;
+    int numValues = data ? countValues(base) : 0;
+
     // ---- Create the colors
 
-    if (data && p_color)
+    if (data && p_color && !textureOnly)
     {
         outName = p_color->getObjName();
         outObj = createColors(base, alpha, actMap, min, max, numSteps, outName, RGBA);
@@ -1021,10 +1138,10 @@ int Colors::compute(const char *)
 
     // ---- Create the color Texture object
 
-    if (p_texture)
+    if (p_texture && (textureOnly || p_texture->isConnected()))
     {
         outName = p_texture->getObjName();
-        outObj = createColors(base, alpha, actMap, min, max, numSteps, outName, TEX);
+        outObj = createColors(base, alpha, actMap, min, max, numSteps, outName, textureOnly ? TEX_COORD : TEX);
         p_texture->setCurrentObject(outObj);
         if (colorMapIn)
             outObj->copyAllAttributes(colorMapIn);
@@ -1048,6 +1165,22 @@ int Colors::compute(const char *)
     if (!colorMapIn)
         delete[] actMap;
 
+    if (numValues > 0)
+    {
+        // RGBA: one packed color, texture coordinates: one float per value,
+        // texture: index and two coordinates per value
+        double rgbaMB = 4. * numValues / 1048576.;
+        double coordMB = 4. * numValues / 1048576.;
+        double textureMB = 12. * numValues / 1048576.;
+        if (textureOnly)
+            sendInfo("%d values: range %.3f s%s, texture coordinates %.3f s (%.1f MB instead of %.1f MB RGBA colors)",
+                     numValues, rangeTime, rangeCached ? " (cached)" : "", ww.elapsed(), coordMB, rgbaMB);
+        else
+            sendInfo("%d values: range %.3f s%s, colors %.3f s (%.1f MB)",
+                     numValues, rangeTime, rangeCached ? " (cached)" : "", ww.elapsed(),
+                     rgbaMB + (p_texture && p_texture->isConnected() ? textureMB : 0.));
+    }
+
     return SUCCESS;
 }
 
@@ -1277,13 +1410,34 @@ void Colors::getMinMax(const recObj &base, float &min, float &max,
     // run over own object
     else
     {
-        for (i = 0; i < base.numElem; i++)
+        const float *data = base.data;
+        const int numElem = base.numElem;
+        const float startMin = min, startMax = max;
+#ifdef _OPENMP
+#pragma omp parallel if (numElem >= MinParallelValues)
+#endif
         {
-            float actVal = base.data[i];
-            if (actVal >= minV && actVal < min)
-                min = actVal;
-            if (actVal <= maxV && actVal > max)
-                max = actVal;
+            float threadMin = startMin, threadMax = startMax;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int i = 0; i < numElem; i++)
+            {
+                float actVal = data[i];
+                if (actVal >= minV && actVal < threadMin)
+                    threadMin = actVal;
+                if (actVal <= maxV && actVal > threadMax)
+                    threadMax = actVal;
+            }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            {
+                if (threadMin < min)
+                    min = threadMin;
+                if (threadMax > max)
+                    max = threadMax;
+            }
         }
     }
 }
@@ -1315,19 +1469,36 @@ void Colors::countBins(const recObj &base, float min, float max,
     else
     {
         float delta = max - min;
+        const float *data = base.data;
+        const int numElem = base.numElem;
 
-        for (i = 0; i < base.numElem; i++)
+        // every thread counts into its own bins
+#ifdef _OPENMP
+#pragma omp parallel if (numElem >= MinParallelValues)
+#endif
         {
-            float actData = base.data[i];
-
-            // do not care about FLT_MAX elements in min/max calc.
-            if (actData < NoDataColorPercent * FLT_MAX)
+            std::vector<int> threadBins(numBins, 0);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int i = 0; i < numElem; i++)
             {
-                int binNo = (int)((actData - min) / delta * (numBins - 0.00000001));
+                float actData = data[i];
 
-                if (binNo >= 0 && binNo < numBins)
-                    ++bins[binNo];
+                // do not care about FLT_MAX elements in min/max calc.
+                if (actData < NoDataColorPercent * FLT_MAX)
+                {
+                    int binNo = (int)((actData - min) / delta * (numBins - 0.00000001));
+
+                    if (binNo >= 0 && binNo < numBins)
+                        ++threadBins[binNo];
+                }
             }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            for (int b = 0; b < numBins; b++)
+                bins[b] += threadBins[b];
         }
     }
 }
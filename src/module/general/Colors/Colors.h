@@ -78,6 +78,7 @@ private:
     coBooleanParam *p_autoScale;
     coBooleanParam *p_scaleNow;
     coFloatParam *p_alpha;
+    coChoiceParam *p_outputMode;
 
     // ports for Spike Removal
     coChoiceParam *p_spikeAlgo;
@@ -94,9 +95,28 @@ private:
     enum Outstyle
     {
         RGBA = 1,
-        TEX = 4
+        TEX = 4,
+        TEX_COORD = 8 // one float per value, colormap in the COLORMAP attribute
     };
 
+    // values for OutputMode: packed colors or only texture coordinates
+    enum
+    {
+        OUTPUT_RGBA = 0,
+        OUTPUT_TEXTURE = 1
+    };
+
+    // data range found for the last data object, re-used while the data
+    // object and the spike removal parameters are unchanged
+    struct DataRange
+    {
+        std::string objName;
+        int spikeAlgo;
+        float spikeBot, spikeTop;
+        float min, max;
+    };
+    DataRange d_range;
+
     // struct captures all info for one data input object
     struct recObj
     {
@@ -131,6 +151,9 @@ private:
 
     void getMinMax(const recObj &base, float &min, float &max);
 
+    // number of data values in all leaves
+    int countValues(const recObj &base);
+
     FlColor *interpolateColormap(int numSteps, float alphaMult);
 
     coDistributedObject *createColors(recObj &base, recObj &alpha, FlColor *map,
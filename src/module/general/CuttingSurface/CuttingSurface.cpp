@@ -101,6 +101,10 @@ CuttingSurfaceModule::CuttingSurfaceModule(int argc, char *argv[])
     // by setting his own title: done in param()
     autoTitle = autoTitleConfigured;
 
+    // build an index of the cells of a grid when it is cut again, e.g. while dragging the plane
+    useCellIndex = coCoviseConfig::isOn("Module.CuttingSurface.CellIndex", true);
+    numCells = numVisitedCells = 0;
+
     p_MeshIn = addInputPort("GridIn0", "UnstructuredGrid|UniformGrid|StructuredGrid|RectilinearGrid", "input mesh");
     p_DataIn = addInputPort("DataIn0", "Byte|Float|Vec3", "input data");
     p_DataIn->setRequired(1);
@@ -221,6 +225,22 @@ CuttingSurfaceModule::CuttingSurfaceModule(int argc, char *argv[])
 #endif
 }
 
+// the index type is complete here, the cache deletes its indices
+CuttingSurfaceModule::~CuttingSurfaceModule()
+{
+}
+
+CellBlockIndex *CuttingSurfaceModule::getCellIndex(const coDoUnstructuredGrid *grid, int numelem, int numconn,
+                                                   int *el, int *cl, float *x, float *y, float *z)
+{
+    CellBlockIndex **index = cellIndices.lookup(grid->getName());
+    if (!index)
+        return NULL;
+    if (!*index)
+        *index = new CellBlockIndex(numelem, numconn, el, cl, x, y, z);
+    return *index;
+}
+
 //================called by compute
 void CuttingSurfaceModule::ini_borders()
 {
@@ -462,6 +482,8 @@ void
 CuttingSurfaceModule::preHandleObjects(coInputPort **)
 {
     ww_.reset();
+    cellIndices.beginExecution();
+    numCells = numVisitedCells = 0;
     // Automatically adapt our Module's title to the species
     if (autoTitle)
     {
@@ -875,6 +897,8 @@ public:
 void
 CuttingSurfaceModule::postHandleObjects(coOutputPort **outPorts)
 {
+    cellIndices.endExecution();
+
     if (!DoPostHandle)
     {
         return;
@@ -882,6 +906,9 @@ CuttingSurfaceModule::postHandleObjects(coOutputPort **outPorts)
 
     Terminator terminator;
 
+    if (numVisitedCells < numCells)
+        Covise::sendInfo("visited %d of %d cells", numVisitedCells, numCells);
+
 #ifndef _COMPLEX_MODULE_ // in the complex case, only for scalar data
     addFeedbackParams(outPorts[shiftOut]->getCurrentObject());
 #endif
@@ -1536,12 +1563,15 @@ int CuttingSurfaceModule::compute(const char *)
         }
         else
         {
+            CellBlockIndex *index = NULL;
+            if (useCellIndex)
+                index = getCellIndex(grid_in, numelem, numconn, el, cl, x_in, y_in, z_in);
             plane = new Plane(numelem, numcoord, DataType, el, cl, tl,
                               x_in, y_in, z_in,
                               s_in, bs_in, i_in,
                               u_in, v_in, w_in,
                               sgrid_in, grid_in, vertexAllocRatio, maxPolyPerVertex, planei, planej, planek, startx, starty, startz, myDistance,
-                              radius, gennormals, param_option, genstrips, iblank);
+                              radius, gennormals, param_option, genstrips, iblank, index);
         }
 
         // plane->set_min_max(x_minb, y_minb, z_minb, x_maxb, y_maxb, z_maxb);
@@ -1560,6 +1590,9 @@ int CuttingSurfaceModule::compute(const char *)
             delete plane;
             return -1;
         }
+        // count only the run that is kept, the re-executed one reports its own cells
+        numCells += numelem;
+        numVisitedCells += plane->getNumVisitedCells();
     }
 
     if (ugrid_in) // handle as rect. grids
@@ -27,10 +27,17 @@
 
 #include <api/coSimpleModule.h>
 #include <do/coDoGeometry.h>
+#include <alg/coIndexCache.h>
 #ifdef _COMPLEX_MODULE_
 #include <alg/coColors.h>
 #endif
 
+namespace covise
+{
+class CellBlockIndex;
+class coDoUnstructuredGrid;
+}
+
 using namespace covise;
 
 class CuttingSurfaceModule : public covise::coSimpleModule
@@ -133,6 +140,14 @@ private:
     // config variable for autoTitle set?
     bool autoTitleConfigured;
 
+    // cell indices of unstructured grids by object name
+    coIndexCache<CellBlockIndex> cellIndices;
+    bool useCellIndex;
+    int numCells, numVisitedCells;
+
+    CellBlockIndex *getCellIndex(const coDoUnstructuredGrid *grid, int numelem, int numconn,
+                                 int *el, int *cl, float *x, float *y, float *z);
+
 public:
     // parameters for immediate mode
     float param_vertex[3];
@@ -143,8 +158,6 @@ public:
 
     float vertexAllocRatio; // allocate x% of numVert for output vertices
     CuttingSurfaceModule(int argc, char *argv[]);
-    virtual ~CuttingSurfaceModule()
-    {
-    }
+    virtual ~CuttingSurfaceModule();
 };
 #endif // _CuttingSurface_H
@@ -30,6 +30,55 @@
 #include <do/coDoStructuredGrid.h>
 #include <do/coDoUniformGrid.h>
 #include <do/coDoRectilinearGrid.h>
+#include <util/coWristWatch.h>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+
+// parallel exclusive prefix sum, returns the total
+int exclusiveScan(int *a, int n)
+{
+    int nchunks = 1;
+#ifdef _OPENMP
+    if (n >= 65536)
+        nchunks = omp_get_max_threads();
+#endif
+    const int chunk = (n + nchunks - 1) / nchunks;
+    std::vector<int> sums(nchunks + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int c = 0; c < nchunks; c++)
+    {
+        const int end = std::min(n, (c + 1) * chunk);
+        int sum = 0;
+        for (int i = c * chunk; i < end; i++)
+            sum += a[i];
+        sums[c + 1] = sum;
+    }
+    for (int c = 0; c < nchunks; c++)
+        sums[c + 1] += sums[c];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int c = 0; c < nchunks; c++)
+    {
+        const int end = std::min(n, (c + 1) * chunk);
+        int run = sums[c];
+        for (int i = c * chunk; i < end; i++)
+        {
+            const int v = a[i];
+            a[i] = run;
+            run += v;
+        }
+    }
+    return sums[nchunks];
+}
+}
 
 SDomainsurface::SDomainsurface(int argc, char *argv[])
     : coSimpleModule(argc, argv, "Domain surfaces of grids")
@@ -963,6 +1012,23 @@ int SDomainsurface::compute(const char *)
     return CONTINUE_PIPELINE;
 }
 
+void SDomainsurface::preHandleObjects(coInputPort **)
+{
+    usedNeighborLists.clear();
+}
+
+void SDomainsurface::postHandleObjects(coOutputPort **)
+{
+    // neighbor lists of grids which have not been used in this run are obsolete
+    for (NeighborListMap::iterator it = neighborLists.begin(); it != neighborLists.end(); ++it)
+    {
+        const_cast<coDoNeighborList *>(it->second)->destroy();
+        delete it->second;
+    }
+    neighborLists.swap(usedNeighborLists);
+    usedNeighborLists.clear();
+}
+
 double SDomainsurface::get_angle(int v1, int v2, int v3, int v21, int v22, int v23)
 {
     double n1x, n1y, n1z, n2x, n2y, n2z, l, ang;
@@ -1117,6 +1183,24 @@ void SDomainsurface::doModule(const coDistributedObject *meshIn,
     //      If computation is for the first time or the grid has changed
     //      create adjacency information
     //	get cells_use_coord list from shared memory
+    //      the neighbor list is kept in shared memory and reused as long as the grid is unchanged
+    coWristWatch ww;
+    NeighborListMap::iterator nbl = usedNeighborLists.find(tmp_grid->getName());
+    if (nbl != usedNeighborLists.end())
+    {
+        tmp_grid->GetNeighborList(nbl->second, NULL);
+    }
+    else if ((nbl = neighborLists.find(tmp_grid->getName())) != neighborLists.end())
+    {
+        tmp_grid->GetNeighborList(nbl->second, NULL);
+        usedNeighborLists[nbl->first] = nbl->second;
+        neighborLists.erase(nbl);
+    }
+    else if (numelem > 0)
+    {
+        usedNeighborLists[tmp_grid->getName()] = tmp_grid->GetNeighborList(NULL, meshOutName);
+        Covise::sendInfo("neighbor list for %d cells built in %6.3f s", numelem, ww.elapsed());
+    }
     int cuc_count;
     int *cuc, *cuc_pos;
     tmp_grid->getNeighborList(&cuc_count, &cuc, &cuc_pos);
@@ -1311,612 +1395,261 @@ void SDomainsurface::doModule(const coDistributedObject *meshIn,
     delete[] elemMap;
 }
 
-void SDomainsurface::lines()
+// mark the edges of surface polygon i, from vertex j to j+1, which are
+// lines: boundary edges and edges to a neighbor at an angle above tresh,
+// normal holds the normal of each polygon from its first three vertices
+void SDomainsurface::featureEdges(int i, const float *normal, char *feature)
 {
-    int i, j, np, n;
-    int v1, v2, v3, v4, v21, v22, v23;
+    int j, np, n;
+    int v1, v2, v3, v21, v22, v23;
     float n1x, n1y, n1z, n2x, n2y, n2z, ang, l;
-    lx_out = new float[num_vert + num_bar * 2];
-    ly_out = new float[num_vert + num_bar * 2];
-    lz_out = new float[num_vert + num_bar * 2];
-
     bool vertices_found_1;
     bool vertices_found_2;
     int edge;
 
-    vector<int> temp_lconn_list;
-    vector<int> temp_lelem_list;
-
-    Polygons->computeNeighborList();
-
-    memset(conn_tag, -1, numcoord * sizeof(int));
-    lnum_vert = 0;
-    lnum_conn = 0;
-    lnum_elem = 0;
-    // cerr <<"TEST: " <<  num_elem << "\t" << num_bar << endl;
-    for (i = 0; i < num_elem; i++)
+    if (i == num_elem - 1)
+        np = num_conn - elem_list[i];
+    else
+        np = elem_list[i + 1] - elem_list[i];
+    switch (np)
     {
-        if (i == num_elem - 1)
-            np = num_conn - elem_list[i];
-        else
-            np = elem_list[i + 1] - elem_list[i];
-        switch (np)
-        {
-        case 3:
+    case 3:
+    case 4:
+    {
+        for (j = 0; j < np; j++)
         {
-            v1 = conn_list[elem_list[i]];
-            v2 = conn_list[elem_list[i] + 1];
-            v3 = conn_list[elem_list[i] + 2];
-            n1x = ((y_out[v1] - y_out[v2]) * (z_out[v1] - z_out[v3])) - ((z_out[v1] - z_out[v2]) * (y_out[v1] - y_out[v3]));
-            n1y = ((z_out[v1] - z_out[v2]) * (x_out[v1] - x_out[v3])) - ((x_out[v1] - x_out[v2]) * (z_out[v1] - z_out[v3]));
-            n1z = ((x_out[v1] - x_out[v2]) * (y_out[v1] - y_out[v3])) - ((y_out[v1] - y_out[v2]) * (x_out[v1] - x_out[v3]));
-            l = sqrt(n1x * n1x + n1y * n1y + n1z * n1z);
-            n1x /= l;
-            n1y /= l;
-            n1z /= l;
-            if ((n = Polygons->getNeighbor(i, v1, v2)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                if (ang < 0)
-                    ang = -ang;
-                ang = 1 - ang;
-                if (ang > tresh)
-                {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v1));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v2));
-                    lnum_conn++;
-                }
-            }
-            else
-            {
-                if (DataType == DATA_S_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
-                }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v1));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v2));
-                lnum_conn++;
-            }
-            if ((n = Polygons->getNeighbor(i, v2, v3)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                if (ang < 0)
-                    ang = -ang;
-                ang = 1 - ang;
-                if (ang > tresh)
-                {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v2));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v3));
-                    lnum_conn++;
-                }
-            }
+            v1 = conn_list[elem_list[i] + j];
+            v2 = conn_list[elem_list[i] + (j + 1) % np];
+            // the closing edge of a triangle is searched from its first vertex
+            if (np == 3 && j == 2)
+                n = Polygons->getNeighbor(i, v2, v1);
             else
+                n = Polygons->getNeighbor(i, v1, v2);
+            if (n >= 0)
             {
-                if (DataType == DATA_S_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
-                }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v2));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v3));
-                lnum_conn++;
-            }
-            if ((n = Polygons->getNeighbor(i, v1, v3)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
+                ang = (normal[3 * i] * normal[3 * n] + normal[3 * i + 1] * normal[3 * n + 1] + normal[3 * i + 2] * normal[3 * n + 2]);
                 if (ang < 0)
                     ang = -ang;
                 ang = 1 - ang;
                 if (ang > tresh)
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v3));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v1));
-                    lnum_conn++;
+                    feature[j] = 1;
                 }
             }
             else
             {
-                if (DataType == DATA_S_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
-                }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v3));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v1));
-                lnum_conn++;
+                feature[j] = 1;
             }
         }
-        break;
-        case 4:
+    }
+    break;
+    default:
+    {
+        // Polyhedral cells
+        if (np > 4)
         {
-            v1 = conn_list[elem_list[i]];
-            v2 = conn_list[elem_list[i] + 1];
-            v3 = conn_list[elem_list[i] + 2];
-            v4 = conn_list[elem_list[i] + 3];
-            n1x = ((y_out[v1] - y_out[v2]) * (z_out[v1] - z_out[v3])) - ((z_out[v1] - z_out[v2]) * (y_out[v1] - y_out[v3]));
-            n1y = ((z_out[v1] - z_out[v2]) * (x_out[v1] - x_out[v3])) - ((x_out[v1] - x_out[v2]) * (z_out[v1] - z_out[v3]));
-            n1z = ((x_out[v1] - x_out[v2]) * (y_out[v1] - y_out[v3])) - ((y_out[v1] - y_out[v2]) * (x_out[v1] - x_out[v3]));
-            l = sqrt(n1x * n1x + n1y * n1y + n1z * n1z);
-            n1x /= l;
-            n1y /= l;
-            n1z /= l;
-            if ((n = Polygons->getNeighbor(i, v1, v2)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                if (ang < 0)
-                    ang = -ang;
-                ang = 1 - ang;
-                if (ang > tresh)
-                {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v1));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v2));
-                    lnum_conn++;
-                }
-            }
-            else
-            {
-                if (DataType == DATA_S_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
-                }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v1));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v2));
-                lnum_conn++;
-            }
-            if ((n = Polygons->getNeighbor(i, v2, v3)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                if (ang < 0)
-                    ang = -ang;
-                ang = 1 - ang;
-                if (ang > tresh)
-                {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v2));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v3));
-                    lnum_conn++;
-                }
-            }
-            else
-            {
-                if (DataType == DATA_S_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
-                }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v2));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v3));
-                lnum_conn++;
-            }
-            if ((n = Polygons->getNeighbor(i, v3, v4)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                if (ang < 0)
-                    ang = -ang;
-                ang = 1 - ang;
-                if (ang > tresh)
-                {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v3));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v4));
-                    lnum_conn++;
-                }
-            }
-            else
+            vertices_found_1 = false;
+            // Avoid degeneracies:  choose three consecutive vertices of the polygon which are different and not collinear
+            for (j = 0; j < np; j++)
             {
-                if (DataType == DATA_S_E)
-                {
-                    temp_lu_out.push_back(u_out[i]);
-                }
-                else if (DataType == DATA_V_E)
+                if (j < np - 2)
                 {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
+                    v1 = conn_list[elem_list[i] + j];
+                    v2 = conn_list[elem_list[i] + j + 1];
+                    v3 = conn_list[elem_list[i] + j + 2];
                 }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v3));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v4));
-                lnum_conn++;
-            }
-            if ((n = Polygons->getNeighbor(i, v4, v1)) >= 0)
-            {
-                v21 = conn_list[elem_list[n]];
-                v22 = conn_list[elem_list[n] + 1];
-                v23 = conn_list[elem_list[n] + 2];
-                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                n2x /= l;
-                n2y /= l;
-                n2z /= l;
-                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                if (ang < 0)
-                    ang = -ang;
-                ang = 1 - ang;
-                if (ang > tresh)
+
+                else if (j == np - 2)
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_lu_out.push_back(u_out[i]);
-                        temp_lv_out.push_back(v_out[i]);
-                        temp_lw_out.push_back(w_out[i]);
-                    }
-                    temp_lelem_list.push_back(lnum_conn);
-                    lnum_elem++;
-                    temp_lconn_list.push_back(ladd_vertex(v4));
-                    lnum_conn++;
-                    temp_lconn_list.push_back(ladd_vertex(v1));
-                    lnum_conn++;
+                    v1 = conn_list[elem_list[i] + j];
+                    v2 = conn_list[elem_list[i] + j + 1];
+                    v3 = conn_list[elem_list[i]];
                 }
-            }
-            else
-            {
-                if (DataType == DATA_S_E)
+
+                else if (j == np - 1)
                 {
-                    temp_lu_out.push_back(u_out[i]);
+                    v1 = conn_list[elem_list[i] + j];
+                    v2 = conn_list[elem_list[i]];
+                    v3 = conn_list[elem_list[i] + 1];
                 }
-                else if (DataType == DATA_V_E)
+
+                // Assuming the vertices of the polygon are contained within a plane, calculate its normal
+                n1x = ((y_out[v1] - y_out[v2]) * (z_out[v1] - z_out[v3])) - ((z_out[v1] - z_out[v2]) * (y_out[v1] - y_out[v3]));
+                n1y = ((z_out[v1] - z_out[v2]) * (x_out[v1] - x_out[v3])) - ((x_out[v1] - x_out[v2]) * (z_out[v1] - z_out[v3]));
+                n1z = ((x_out[v1] - x_out[v2]) * (y_out[v1] - y_out[v3])) - ((y_out[v1] - y_out[v2]) * (x_out[v1] - x_out[v3]));
+                l = sqrt(n1x * n1x + n1y * n1y + n1z * n1z);
+                n1x /= l;
+                n1y /= l;
+                n1z /= l;
+
+                if (n1x != 0 || n1y != 0 || n1z != 0)
                 {
-                    temp_lu_out.push_back(u_out[i]);
-                    temp_lv_out.push_back(v_out[i]);
-                    temp_lw_out.push_back(w_out[i]);
+                    vertices_found_1 = true;
+                    break;
                 }
-                temp_lelem_list.push_back(lnum_conn);
-                lnum_elem++;
-                temp_lconn_list.push_back(ladd_vertex(v4));
-                lnum_conn++;
-                temp_lconn_list.push_back(ladd_vertex(v1));
-                lnum_conn++;
             }
-        }
-        break;
-        default:
-        {
-            // Polyhedral cells
-            if (np > 4)
+
+            if (vertices_found_1)
             {
-                vertices_found_1 = false;
-                // Avoid degeneracies:  choose three consecutive vertices of the polygon which are different and not collinear
-                for (j = 0; j < np; j++)
+                // Test for each edge of the polygon!!!
+                for (edge = 0; edge < np; edge++)
                 {
-                    if (j < np - 2)
-                    {
-                        v1 = conn_list[elem_list[i] + j];
-                        v2 = conn_list[elem_list[i] + j + 1];
-                        v3 = conn_list[elem_list[i] + j + 2];
-                    }
+                    vertices_found_2 = false;
 
-                    else if (j == np - 2)
+                    // Select an edge
+                    if (edge < np - 1)
                     {
-                        v1 = conn_list[elem_list[i] + j];
-                        v2 = conn_list[elem_list[i] + j + 1];
-                        v3 = conn_list[elem_list[i]];
+                        v1 = conn_list[elem_list[i] + edge];
+                        v2 = conn_list[elem_list[i] + edge + 1];
                     }
 
-                    else if (j == np - 1)
+                    else if (edge == np - 1)
                     {
-                        v1 = conn_list[elem_list[i] + j];
+                        v1 = conn_list[elem_list[i] + edge];
                         v2 = conn_list[elem_list[i]];
-                        v3 = conn_list[elem_list[i] + 1];
-                    }
-
-                    // Assuming the vertices of the polygon are contained within a plane, calculate its normal
-                    n1x = ((y_out[v1] - y_out[v2]) * (z_out[v1] - z_out[v3])) - ((z_out[v1] - z_out[v2]) * (y_out[v1] - y_out[v3]));
-                    n1y = ((z_out[v1] - z_out[v2]) * (x_out[v1] - x_out[v3])) - ((x_out[v1] - x_out[v2]) * (z_out[v1] - z_out[v3]));
-                    n1z = ((x_out[v1] - x_out[v2]) * (y_out[v1] - y_out[v3])) - ((y_out[v1] - y_out[v2]) * (x_out[v1] - x_out[v3]));
-                    l = sqrt(n1x * n1x + n1y * n1y + n1z * n1z);
-                    n1x /= l;
-                    n1y /= l;
-                    n1z /= l;
-
-                    if (n1x != 0 || n1y != 0 || n1z != 0)
-                    {
-                        vertices_found_1 = true;
-                        break;
                     }
-                }
 
-                if (vertices_found_1)
-                {
-                    // Test for each edge of the polygon!!!
-                    for (edge = 0; edge < np; edge++)
+                    if ((n = Polygons->getNeighbor(i, v1, v2)) >= 0)
                     {
-                        vertices_found_2 = false;
-
-                        // Select an edge
-                        if (edge < np - 1)
+                        // Avoid degeneracies:  choose three consecutive vertices of the polygon which are different and not collinear
+                        for (j = 0; j < np; j++)
                         {
-                            v1 = conn_list[elem_list[i] + edge];
-                            v2 = conn_list[elem_list[i] + edge + 1];
-                        }
+                            if (j < np - 2)
+                            {
+                                v21 = conn_list[elem_list[n] + j];
+                                v22 = conn_list[elem_list[n] + j + 1];
+                                v23 = conn_list[elem_list[n] + j + 2];
+                            }
 
-                        else if (edge == np - 1)
-                        {
-                            v1 = conn_list[elem_list[i] + edge];
-                            v2 = conn_list[elem_list[i]];
-                        }
+                            else if (j == np - 2)
+                            {
+                                v21 = conn_list[elem_list[n] + j];
+                                v22 = conn_list[elem_list[n] + j + 1];
+                                v23 = conn_list[elem_list[n]];
+                            }
 
-                        if ((n = Polygons->getNeighbor(i, v1, v2)) >= 0)
-                        {
-                            // Avoid degeneracies:  choose three consecutive vertices of the polygon which are different and not collinear
-                            for (j = 0; j < np; j++)
+                            else if (j == np - 1)
                             {
-                                if (j < np - 2)
-                                {
-                                    v21 = conn_list[elem_list[n] + j];
-                                    v22 = conn_list[elem_list[n] + j + 1];
-                                    v23 = conn_list[elem_list[n] + j + 2];
-                                }
-
-                                else if (j == np - 2)
-                                {
-                                    v21 = conn_list[elem_list[n] + j];
-                                    v22 = conn_list[elem_list[n] + j + 1];
-                                    v23 = conn_list[elem_list[n]];
-                                }
-
-                                else if (j == np - 1)
-                                {
-                                    v21 = conn_list[elem_list[n] + j];
-                                    v22 = conn_list[elem_list[n]];
-                                    v23 = conn_list[elem_list[n] + 1];
-                                }
-
-                                // Assuming the vertices of the polygon are contained within a plane, calculate its normal
-                                n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
-                                n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
-                                n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
-
-                                l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
-                                n2x /= l;
-                                n2y /= l;
-                                n2z /= l;
-
-                                if (n2x != 0 || n2y != 0 || n2z != 0)
-                                {
-                                    vertices_found_2 = true;
-                                    break;
-                                }
+                                v21 = conn_list[elem_list[n] + j];
+                                v22 = conn_list[elem_list[n]];
+                                v23 = conn_list[elem_list[n] + 1];
                             }
 
-                            if (vertices_found_2)
+                            // Assuming the vertices of the polygon are contained within a plane, calculate its normal
+                            n2x = ((y_out[v21] - y_out[v22]) * (z_out[v21] - z_out[v23])) - ((z_out[v21] - z_out[v22]) * (y_out[v21] - y_out[v23]));
+                            n2y = ((z_out[v21] - z_out[v22]) * (x_out[v21] - x_out[v23])) - ((x_out[v21] - x_out[v22]) * (z_out[v21] - z_out[v23]));
+                            n2z = ((x_out[v21] - x_out[v22]) * (y_out[v21] - y_out[v23])) - ((y_out[v21] - y_out[v22]) * (x_out[v21] - x_out[v23]));
+
+                            l = sqrt(n2x * n2x + n2y * n2y + n2z * n2z);
+                            n2x /= l;
+                            n2y /= l;
+                            n2z /= l;
+
+                            if (n2x != 0 || n2y != 0 || n2z != 0)
                             {
-                                ang = (n1x * n2x + n1y * n2y + n1z * n2z);
-                                if (ang < 0)
-                                    ang = -ang;
-                                ang = 1 - ang;
-                                if (ang > tresh)
-                                {
-                                    if (DataType == DATA_S_E)
-                                    {
-                                        temp_lu_out.push_back(u_out[i]);
-                                    }
-                                    else if (DataType == DATA_V_E)
-                                    {
-                                        temp_lu_out.push_back(u_out[i]);
-                                        temp_lv_out.push_back(v_out[i]);
-                                        temp_lw_out.push_back(w_out[i]);
-                                    }
-                                    temp_lelem_list.push_back(lnum_conn);
-                                    lnum_elem++;
-                                    temp_lconn_list.push_back(ladd_vertex(v1));
-                                    lnum_conn++;
-                                    temp_lconn_list.push_back(ladd_vertex(v2));
-                                    lnum_conn++;
-                                }
+                                vertices_found_2 = true;
+                                break;
                             }
                         }
-                        else
+
+                        if (vertices_found_2)
                         {
-                            if (DataType == DATA_S_E)
-                            {
-                                temp_lu_out.push_back(u_out[i]);
-                            }
-                            else if (DataType == DATA_V_E)
+                            ang = (n1x * n2x + n1y * n2y + n1z * n2z);
+                            if (ang < 0)
+                                ang = -ang;
+                            ang = 1 - ang;
+                            if (ang > tresh)
                             {
-                                temp_lu_out.push_back(u_out[i]);
-                                temp_lv_out.push_back(v_out[i]);
-                                temp_lw_out.push_back(w_out[i]);
+                                feature[edge] = 1;
                             }
-                            temp_lelem_list.push_back(lnum_conn);
-                            lnum_elem++;
-                            temp_lconn_list.push_back(ladd_vertex(v1));
-                            lnum_conn++;
-                            temp_lconn_list.push_back(ladd_vertex(v2));
-                            lnum_conn++;
                         }
                     }
+                    else
+                    {
+                        feature[edge] = 1;
+                    }
                 }
             }
         }
-        break;
-        };
+    }
+    break;
+    };
+}
+
+void SDomainsurface::lines()
+{
+    int i, j, np;
+    lx_out = new float[num_vert + num_bar * 2];
+    ly_out = new float[num_vert + num_bar * 2];
+    lz_out = new float[num_vert + num_bar * 2];
+
+    vector<int> temp_lconn_list;
+    vector<int> temp_lelem_list;
+
+    Polygons->computeNeighborList();
+
+    // The neighbor search and the normals are the expensive part: the normals
+    // are computed once per polygon and the edges of all polygons are tested
+    // in parallel, then the lines are added in the order of the polygons, so
+    // the vertices are numbered as before.
+    vector<float> normal(3 * num_elem);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (i = 0; i < num_elem; i++)
+    {
+        int np = (i == num_elem - 1 ? num_conn : elem_list[i + 1]) - elem_list[i];
+        if (np < 3)
+            continue;
+        int v1 = conn_list[elem_list[i]];
+        int v2 = conn_list[elem_list[i] + 1];
+        int v3 = conn_list[elem_list[i] + 2];
+        float nx = ((y_out[v1] - y_out[v2]) * (z_out[v1] - z_out[v3])) - ((z_out[v1] - z_out[v2]) * (y_out[v1] - y_out[v3]));
+        float ny = ((z_out[v1] - z_out[v2]) * (x_out[v1] - x_out[v3])) - ((x_out[v1] - x_out[v2]) * (z_out[v1] - z_out[v3]));
+        float nz = ((x_out[v1] - x_out[v2]) * (y_out[v1] - y_out[v3])) - ((y_out[v1] - y_out[v2]) * (x_out[v1] - x_out[v3]));
+        float l = sqrt(nx * nx + ny * ny + nz * nz);
+        normal[3 * i] = nx / l;
+        normal[3 * i + 1] = ny / l;
+        normal[3 * i + 2] = nz / l;
+    }
+    vector<char> feature(num_conn, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+    for (i = 0; i < num_elem; i++)
+        featureEdges(i, &normal[0], &feature[elem_list[i]]);
+
+    memset(conn_tag, -1, numcoord * sizeof(int));
+    lnum_vert = 0;
+    lnum_conn = 0;
+    lnum_elem = 0;
+    for (i = 0; i < num_elem; i++)
+    {
+        if (i == num_elem - 1)
+            np = num_conn - elem_list[i];
+        else
+            np = elem_list[i + 1] - elem_list[i];
+        for (j = 0; j < np; j++)
+        {
+            if (!feature[elem_list[i] + j])
+                continue;
+            if (DataType == DATA_S_E)
+            {
+                temp_lu_out.push_back(u_out[i]);
+            }
+            else if (DataType == DATA_V_E)
+            {
+                temp_lu_out.push_back(u_out[i]);
+                temp_lv_out.push_back(v_out[i]);
+                temp_lw_out.push_back(w_out[i]);
+            }
+            temp_lelem_list.push_back(lnum_conn);
+            lnum_elem++;
+            temp_lconn_list.push_back(ladd_vertex(conn_list[elem_list[i] + j]));
+            lnum_conn++;
+            temp_lconn_list.push_back(ladd_vertex(conn_list[elem_list[i] + (j + 1) % np]));
+            lnum_conn++;
+        }
     }
     for (i = 0; i < num_bar; i++)
     {
@@ -2046,11 +1779,10 @@ int SDomainsurface::ladd_vertex(int v)
 //=====================================================================
 // create the surface of a domain
 //=====================================================================
-void SDomainsurface::surface()
+// boundary polygons of cell i with the vertices of the grid
+void SDomainsurface::cellSurface(int i, SurfacePart &part)
 {
-    // int i, a, c;
-    int i, j, a, c;
-    int nb; // ne deleted
+    int j, a, c;
 
     bool start_vertex_set;
     bool vertices_found;
@@ -2076,6 +1808,7 @@ void SDomainsurface::surface()
     float normx;
     float normy;
     float normz;
+    float center[3];
 
     vector<int> temp_elem_in;
     vector<int> temp_conn_in;
@@ -2085,1227 +1818,911 @@ void SDomainsurface::surface()
     vector<int>::iterator it;
     vector<int>::reverse_iterator rit;
 
-    int ct_alloc;
-
-    ct_alloc = numcoord;
-    conn_tag = new int[ct_alloc];
-
-    memset(conn_tag, -1, numcoord * sizeof(int));
-    num_vert = 0;
-    num_conn = 0;
-    num_elem = 0;
-    num_bar = 0;
-    int first = 1;
-
     // Compute volume-center of current element
-    for (i = 0; i < numelem; i++)
+    switch (tl[i])
     {
-        switch (tl[i])
-        {
-        case TYPE_HEXAGON:
-            c = 8;
-            break;
+    case TYPE_HEXAGON:
+        c = 8;
+        break;
 
-        case TYPE_TETRAHEDER:
-            c = 4;
-            break;
+    case TYPE_TETRAHEDER:
+        c = 4;
+        break;
 
-        case TYPE_PRISM:
-            c = 6;
-            break;
+    case TYPE_PRISM:
+        c = 6;
+        break;
 
-        case TYPE_PYRAMID:
-            c = 5;
-            break;
+    case TYPE_PYRAMID:
+        c = 5;
+        break;
 
-        case TYPE_POLYHEDRON:
-        {
-            /* Calculate number of vertices of the cell */
-            temp_elem_in.clear();
-            temp_conn_in.clear();
-            temp_vertex_list.clear();
+    case TYPE_POLYHEDRON:
+    {
+        /* Calculate number of vertices of the cell */
+        temp_elem_in.clear();
+        temp_conn_in.clear();
+        temp_vertex_list.clear();
 
-            start_vertex_set = false;
+        start_vertex_set = false;
 
-            next_elem_index = (i < numelem - 1) ? el[i + 1] : numconn;
+        next_elem_index = (i < numelem - 1) ? el[i + 1] : numconn;
 
-            /* Construct DO_Polygons Element and Connectivity Lists */
-            for (j = el[i]; j < next_elem_index; j++)
+        /* Construct DO_Polygons Element and Connectivity Lists */
+        for (j = el[i]; j < next_elem_index; j++)
+        {
+            if (j == el[i] && start_vertex_set == false)
             {
-                if (j == el[i] && start_vertex_set == false)
-                {
-                    start_vertex = cl[el[i]];
-                    temp_elem_in.push_back(temp_conn_in.size());
-                    temp_conn_in.push_back(start_vertex);
-                    start_vertex_set = true;
-                }
+                start_vertex = cl[el[i]];
+                temp_elem_in.push_back(temp_conn_in.size());
+                temp_conn_in.push_back(start_vertex);
+                start_vertex_set = true;
+            }
 
-                if (j > el[i] && start_vertex_set == true)
+            if (j > el[i] && start_vertex_set == true)
+            {
+                if (cl[j] != start_vertex)
                 {
-                    if (cl[j] != start_vertex)
-                    {
-                        temp_conn_in.push_back(cl[j]);
-                    }
-
-                    else
-                    {
-                        start_vertex_set = false;
-                        continue;
-                    }
+                    temp_conn_in.push_back(cl[j]);
                 }
 
-                if (j > el[i] && start_vertex_set == false)
+                else
                 {
-                    start_vertex = cl[j];
-                    temp_elem_in.push_back(temp_conn_in.size());
-                    temp_conn_in.push_back(start_vertex);
-                    start_vertex_set = true;
+                    start_vertex_set = false;
+                    continue;
                 }
             }
 
-            /* Construct Vertex List */
-            for (j = 0; j < temp_conn_in.size(); j++)
+            if (j > el[i] && start_vertex_set == false)
             {
-                if (temp_vertex_list.size() == 0)
-                {
-                    temp_vertex_list.push_back(temp_conn_in[j]);
-                }
+                start_vertex = cl[j];
+                temp_elem_in.push_back(temp_conn_in.size());
+                temp_conn_in.push_back(start_vertex);
+                start_vertex_set = true;
+            }
+        }
 
-                else
+        /* Construct Vertex List */
+        for (j = 0; j < temp_conn_in.size(); j++)
+        {
+            if (temp_vertex_list.size() == 0)
+            {
+                temp_vertex_list.push_back(temp_conn_in[j]);
+            }
+
+            else
+            {
+                if (find(temp_vertex_list.begin(), temp_vertex_list.end(), temp_conn_in[j]) == temp_vertex_list.end())
                 {
-                    if (find(temp_vertex_list.begin(), temp_vertex_list.end(), temp_conn_in[j]) == temp_vertex_list.end())
-                    {
-                        temp_vertex_list.push_back(temp_conn_in[j]);
-                    }
+                    temp_vertex_list.push_back(temp_conn_in[j]);
                 }
             }
+        }
 
-            sort(temp_vertex_list.begin(), temp_vertex_list.end());
+        sort(temp_vertex_list.begin(), temp_vertex_list.end());
 
-            c = temp_vertex_list.size();
-        }
-        break;
+        c = temp_vertex_list.size();
+    }
+    break;
 
-        default:
-            // other possible elements are 2D and so we can't compute a
-            // volume-center nor can we decide where the normal
-            // has to point to
-            c = 0;
-            break;
-        }
+    default:
+        // other possible elements are 2D and so we can't compute a
+        // volume-center nor can we decide where the normal
+        // has to point to
+        c = 0;
+        break;
+    }
 
-        x_center = 0;
-        y_center = 0;
-        z_center = 0;
+    center[0] = 0;
+    center[1] = 0;
+    center[2] = 0;
 
-        if (tl[i] == TYPE_POLYHEDRON)
+    if (tl[i] == TYPE_POLYHEDRON)
+    {
+        for (a = 0; a < c; a++)
         {
-            for (a = 0; a < c; a++)
-            {
-                x_center += x_in[temp_vertex_list[a]];
-                y_center += y_in[temp_vertex_list[a]];
-                z_center += z_in[temp_vertex_list[a]];
-            }
+            center[0] += x_in[temp_vertex_list[a]];
+            center[1] += y_in[temp_vertex_list[a]];
+            center[2] += z_in[temp_vertex_list[a]];
         }
+    }
 
-        else
+    else
+    {
+        for (a = 0; a < c; a++)
         {
-            for (a = 0; a < c; a++)
-            {
-                x_center += x_in[cl[el[i] + a]];
-                y_center += y_in[cl[el[i] + a]];
-                z_center += z_in[cl[el[i] + a]];
-            }
+            center[0] += x_in[cl[el[i] + a]];
+            center[1] += y_in[cl[el[i] + a]];
+            center[2] += z_in[cl[el[i] + a]];
         }
+    }
 
-        x_center /= (float)c;
-        y_center /= (float)c;
-        z_center /= (float)c;
+    center[0] /= (float)c;
+    center[1] /= (float)c;
+    center[2] /= (float)c;
 
-        //converting into polygons
-        switch (tl[i])
-        {
-        case TYPE_HEXAGON:
-        {
+    //converting into polygons
+    switch (tl[i])
+    {
+    case TYPE_HEXAGON:
+    {
 
-            //Computation for hexahedra
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 5], cl[el[i] + 4]) < 0)
+        //Computation for hexahedra
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 5], cl[el[i] + 4]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 5]) || test(cl[el[i]], cl[el[i] + 4], cl[el[i] + 5]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 5]) || test(cl[el[i]], cl[el[i] + 4], cl[el[i] + 5]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 1], cl[el[i] + 5], cl[el[i] + 2]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 1], cl[el[i] + 5], cl[el[i] + 2]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i]]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 7], cl[el[i] + 6]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 7], cl[el[i] + 6]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 7]) || test(cl[el[i] + 2], cl[el[i] + 6], cl[el[i] + 7]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 7]) || test(cl[el[i] + 2], cl[el[i] + 6], cl[el[i] + 7]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 7], cl[el[i]]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 7], cl[el[i]]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 7]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 6]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 6]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 7]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 7]);
+                    part.conn.push_back(cl[el[i] + 6]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 6]);
+                    part.conn.push_back(cl[el[i] + 7]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 2]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 4], cl[el[i] + 5], cl[el[i] + 6], cl[el[i] + 7]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 4], cl[el[i] + 5], cl[el[i] + 6], cl[el[i] + 7]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i] + 4], cl[el[i] + 5], cl[el[i] + 6]) || test(cl[el[i] + 4], cl[el[i] + 7], cl[el[i] + 6]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i] + 4], cl[el[i] + 5], cl[el[i] + 6]) || test(cl[el[i] + 4], cl[el[i] + 7], cl[el[i] + 6]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 4], cl[el[i] + 5], cl[el[i] + 6], cl[el[i] + 1]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 4], cl[el[i] + 5], cl[el[i] + 6], cl[el[i] + 1]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 6]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 7]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 7]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 6]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 6]);
+                    part.conn.push_back(cl[el[i] + 7]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 7]);
+                    part.conn.push_back(cl[el[i] + 6]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 4]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 4], cl[el[i] + 7], cl[el[i] + 3]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 4], cl[el[i] + 7], cl[el[i] + 3]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i]], cl[el[i] + 4], cl[el[i] + 7]) || test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 7]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i]], cl[el[i] + 4], cl[el[i] + 7]) || test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 7]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 4], cl[el[i] + 7], cl[el[i] + 5]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 4], cl[el[i] + 7], cl[el[i] + 5]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 7]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 7]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 7]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 7]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
+        }
 
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 6], cl[el[i] + 5]) < 0)
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 6], cl[el[i] + 5]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 6]) || test(cl[el[i] + 1], cl[el[i] + 5], cl[el[i] + 6]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 6]) || test(cl[el[i] + 1], cl[el[i] + 5], cl[el[i] + 6]))
-                {
 
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 6], cl[el[i] + 3]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 6]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 6]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 6], cl[el[i] + 3]))
+                {
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 6]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 6]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
                 }
             }
+        }
 
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 1]) < 0)
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 1]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]) || test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]) || test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 7]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 7]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
         }
-        break;
-        case TYPE_TETRAHEDER:
+    }
+    break;
+    case TYPE_TETRAHEDER:
+    {
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 2], cl[el[i] + 1]) < 0)
         {
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 2], cl[el[i] + 1]) < 0)
+            if (test(cl[el[i]], cl[el[i] + 2], cl[el[i] + 1]))
             {
-                if (test(cl[el[i]], cl[el[i] + 2], cl[el[i] + 1]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 2], cl[el[i] + 1], cl[el[i] + 3]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 2], cl[el[i] + 1], cl[el[i] + 3]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
                 }
-            }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 3]) < 0)
-            {
-                if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 3]))
+                else
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 1], cl[el[i] + 3], cl[el[i] + 2]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 3], cl[el[i] + 1], cl[el[i] + 2]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 3]) < 0)
+        {
+            if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 3]))
             {
-                if (test(cl[el[i] + 3], cl[el[i] + 1], cl[el[i] + 2]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 1], cl[el[i] + 3], cl[el[i] + 2]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 3], cl[el[i] + 1], cl[el[i] + 2], cl[el[i]]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 3], cl[el[i] + 1], cl[el[i] + 2]) < 0)
+        {
+            if (test(cl[el[i] + 3], cl[el[i] + 1], cl[el[i] + 2]))
             {
-                if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 3], cl[el[i] + 1], cl[el[i] + 2], cl[el[i]]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 1]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 3]);
                 }
             }
         }
-        break;
-        case TYPE_PRISM:
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]) < 0)
         {
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 3]) < 0)
+            if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i]], cl[el[i] + 2], cl[el[i] + 5]) || test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 5]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 1]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 1]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3]) < 0)
+        }
+    }
+    break;
+    case TYPE_PRISM:
+    {
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 3]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i]], cl[el[i] + 2], cl[el[i] + 5]) || test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 5]))
             {
-                if (test(cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 1]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3], cl[el[i] + 1]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 4], cl[el[i] + 1]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3]) < 0)
+        {
+            if (test(cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 4]) || test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 4]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3], cl[el[i] + 1]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 3], cl[el[i] + 4], cl[el[i] + 5]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 5]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 4], cl[el[i] + 1]) < 0)
+        {
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 4]) || test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 4]))
             {
-                if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 3], cl[el[i] + 4], cl[el[i] + 5]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 1]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]) < 0)
+        {
+            if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 4]) || test(cl[el[i] + 2], cl[el[i] + 1], cl[el[i] + 4]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 5]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
         }
-        break;
-        case TYPE_PYRAMID:
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 1]) < 0)
         {
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 4]) < 0)
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 4]) || test(cl[el[i] + 2], cl[el[i] + 1], cl[el[i] + 4]))
             {
-                if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 4]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 2], cl[el[i] + 5], cl[el[i] + 4], cl[el[i] + 3]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 1], cl[el[i] + 4], cl[el[i] + 2]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 5]);
+                    part.conn.push_back(cl[el[i] + 2]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 4], cl[el[i] + 3]) < 0)
+        }
+    }
+    break;
+    case TYPE_PYRAMID:
+    {
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 1], cl[el[i] + 4]) < 0)
+        {
+            if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 4]))
             {
-                if (test(cl[el[i]], cl[el[i] + 4], cl[el[i] + 3]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 1], cl[el[i] + 4], cl[el[i] + 2]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 4], cl[el[i] + 3], cl[el[i] + 2]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 4]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 4], cl[el[i] + 3]) < 0)
+        {
+            if (test(cl[el[i]], cl[el[i] + 4], cl[el[i] + 3]))
             {
-                if (test(cl[el[i] + 4], cl[el[i] + 2], cl[el[i] + 3]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 4], cl[el[i] + 3], cl[el[i] + 2]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 4], cl[el[i] + 0]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i]]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 4]) < 0)
+        {
+            if (test(cl[el[i] + 4], cl[el[i] + 2], cl[el[i] + 3]))
             {
-                if (test(cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 2], cl[el[i] + 3], cl[el[i] + 4], cl[el[i] + 0]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4], cl[el[i] + 3]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 4]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i] + 2]);
                 }
             }
-            if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 1]) < 0)
+        }
+        if (tmp_grid->getNeighbor(i, cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4]) < 0)
+        {
+            if (test(cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4]))
             {
-                //sc: when two points of a quad are identical
-                if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]) || test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i] + 1], cl[el[i] + 2], cl[el[i] + 4], cl[el[i] + 3]))
                 {
-                    if (DataType == DATA_S_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                    }
-                    else if (DataType == DATA_V_E)
-                    {
-                        temp_u_out.push_back(u_in[i]);
-                        temp_v_out.push_back(v_in[i]);
-                        temp_w_out.push_back(w_in[i]);
-                    }
-                    temp_elem_list.push_back(num_conn);
-                    num_elem++;
-                    if (norm_check(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 4]))
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                    }
-                    else
-                    {
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                        num_conn++;
-                        temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                        num_conn++;
-                    }
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 4]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 1]);
                 }
             }
         }
-        break;
-        case TYPE_POLYHEDRON:
+        if (tmp_grid->getNeighbor(i, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 1]) < 0)
         {
-            // Test for each face
-            for (face = 0; face < temp_elem_in.size(); face++)
+            //sc: when two points of a quad are identical
+            if (test(cl[el[i]], cl[el[i] + 3], cl[el[i] + 2]) || test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
             {
-                next_face_index = (face < temp_elem_in.size() - 1) ? temp_elem_in[face + 1] : temp_conn_in.size();
-
-                for (node_count = temp_elem_in[face]; node_count < next_face_index; node_count++)
+                part.elem.push_back((int)part.conn.size());
+                part.cell.push_back(i);
+                if (norm_check(center, cl[el[i]], cl[el[i] + 3], cl[el[i] + 2], cl[el[i] + 4]))
                 {
-                    face_nodes.push_back(temp_conn_in[node_count]);
+                    part.conn.push_back(cl[el[i]]);
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 3]);
                 }
+                else
+                {
+                    part.conn.push_back(cl[el[i] + 1]);
+                    part.conn.push_back(cl[el[i] + 2]);
+                    part.conn.push_back(cl[el[i] + 3]);
+                    part.conn.push_back(cl[el[i]]);
+                }
+            }
+        }
+    }
+    break;
+    case TYPE_POLYHEDRON:
+    {
+        // Test for each face
+        for (face = 0; face < temp_elem_in.size(); face++)
+        {
+            next_face_index = (face < temp_elem_in.size() - 1) ? temp_elem_in[face + 1] : temp_conn_in.size();
+
+            for (node_count = temp_elem_in[face]; node_count < next_face_index; node_count++)
+            {
+                face_nodes.push_back(temp_conn_in[node_count]);
+            }
 
-                face_polygon = face_nodes;
-                sort(face_nodes.begin(), face_nodes.end());
-                vertices_found = false;
+            face_polygon = face_nodes;
+            sort(face_nodes.begin(), face_nodes.end());
+            vertices_found = false;
 
-                if (tmp_grid->getNeighbor(i, face_nodes) < 0)
+            if (tmp_grid->getNeighbor(i, face_nodes) < 0)
+            {
+                // Avoid degeneracies:  choose three consecutive vertices of the polygon which are different and not collinear
+                for (j = 0; j < face_polygon.size(); j++)
                 {
-                    // Avoid degeneracies:  choose three consecutive vertices of the polygon which are different and not collinear
-                    for (j = 0; j < face_polygon.size(); j++)
+                    if (j < face_polygon.size() - 2)
                     {
-                        if (j < face_polygon.size() - 2)
-                        {
-                            v1 = face_polygon[j];
-                            v2 = face_polygon[j + 1];
-                            v3 = face_polygon[j + 2];
-                        }
+                        v1 = face_polygon[j];
+                        v2 = face_polygon[j + 1];
+                        v3 = face_polygon[j + 2];
+                    }
 
-                        else if (j == face_polygon.size() - 2)
-                        {
-                            v1 = face_polygon[j];
-                            v2 = face_polygon[j + 1];
-                            v3 = face_polygon[0];
-                        }
+                    else if (j == face_polygon.size() - 2)
+                    {
+                        v1 = face_polygon[j];
+                        v2 = face_polygon[j + 1];
+                        v3 = face_polygon[0];
+                    }
 
-                        else if (j == face_polygon.size() - 1)
-                        {
-                            v1 = face_polygon[j];
-                            v2 = face_polygon[0];
-                            v3 = face_polygon[1];
-                        }
+                    else if (j == face_polygon.size() - 1)
+                    {
+                        v1 = face_polygon[j];
+                        v2 = face_polygon[0];
+                        v3 = face_polygon[1];
+                    }
 
-                        v1_x = x_in[v1];
-                        v2_x = x_in[v2];
-                        v3_x = x_in[v3];
+                    v1_x = x_in[v1];
+                    v2_x = x_in[v2];
+                    v3_x = x_in[v3];
 
-                        v1_y = y_in[v1];
-                        v2_y = y_in[v2];
-                        v3_y = y_in[v3];
+                    v1_y = y_in[v1];
+                    v2_y = y_in[v2];
+                    v3_y = y_in[v3];
 
-                        v1_z = z_in[v1];
-                        v2_z = z_in[v2];
-                        v3_z = z_in[v3];
+                    v1_z = z_in[v1];
+                    v2_z = z_in[v2];
+                    v3_z = z_in[v3];
 
-                        normx = (v1_y - v2_y) * (v3_z - v2_z) - (v1_z - v2_z) * (v3_y - v2_y);
-                        normy = (v1_z - v2_z) * (v3_x - v2_x) - (v1_x - v2_x) * (v3_z - v2_z);
-                        normz = (v1_x - v2_x) * (v3_y - v2_y) - (v1_y - v2_y) * (v3_x - v2_x);
+                    normx = (v1_y - v2_y) * (v3_z - v2_z) - (v1_z - v2_z) * (v3_y - v2_y);
+                    normy = (v1_z - v2_z) * (v3_x - v2_x) - (v1_x - v2_x) * (v3_z - v2_z);
+                    normz = (v1_x - v2_x) * (v3_y - v2_y) - (v1_y - v2_y) * (v3_x - v2_x);
 
-                        if (normx != 0 || normy != 0 || normz != 0)
-                        {
-                            vertices_found = true;
-                            break;
-                        }
+                    if (normx != 0 || normy != 0 || normz != 0)
+                    {
+                        vertices_found = true;
+                        break;
                     }
+                }
 
-                    if (vertices_found)
+                if (vertices_found)
+                {
+                    if (test(v1, v2, v3))
                     {
-                        if (test(v1, v2, v3))
-                        {
-                            if (DataType == DATA_S_E)
-                            {
-                                temp_u_out.push_back(u_in[i]);
-                            }
-                            else if (DataType == DATA_V_E)
-                            {
-                                temp_u_out.push_back(u_in[i]);
-                                temp_v_out.push_back(v_in[i]);
-                                temp_w_out.push_back(w_in[i]);
-                            }
-                            temp_elem_list.push_back(num_conn);
-                            num_elem++;
+                        part.elem.push_back((int)part.conn.size());
+                        part.cell.push_back(i);
 
-                            if (norm_check(v1, v2, v3))
+                        if (norm_check(center, v1, v2, v3))
+                        {
+                            for (it = face_polygon.begin(); it < face_polygon.end(); it++)
                             {
-                                for (it = face_polygon.begin(); it < face_polygon.end(); it++)
-                                {
-                                    temp_conn_list.push_back(add_vertex(*it));
-                                    num_conn++;
-                                }
+                                part.conn.push_back(*it);
                             }
-                            else
+                        }
+                        else
+                        {
+                            for (rit = face_polygon.rbegin(); rit < face_polygon.rend(); rit++)
                             {
-                                for (rit = face_polygon.rbegin(); rit < face_polygon.rend(); rit++)
-                                {
-                                    temp_conn_list.push_back(add_vertex(*rit));
-                                    num_conn++;
-                                }
+                                part.conn.push_back(*rit);
                             }
                         }
                     }
                 }
-                face_nodes.clear();
-                face_polygon.clear();
-            }
-        }
-        break;
-        case TYPE_QUAD:
-        {
-            if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
-            {
-                if (DataType == DATA_S_E)
-                {
-                    temp_u_out.push_back(u_in[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_u_out.push_back(u_in[i]);
-                    temp_v_out.push_back(v_in[i]);
-                    temp_w_out.push_back(w_in[i]);
-                }
-                temp_elem_list.push_back(num_conn);
-                num_elem++;
-                temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                num_conn++;
-                temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                num_conn++;
-                temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                num_conn++;
-                temp_conn_list.push_back(add_vertex(cl[el[i] + 3]));
-                num_conn++;
             }
+            face_nodes.clear();
+            face_polygon.clear();
         }
-        break;
-        case TYPE_TRIANGLE:
+    }
+    break;
+    case TYPE_QUAD:
+    {
+        if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
         {
-            if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
-            {
-                if (DataType == DATA_S_E)
-                {
-                    temp_u_out.push_back(u_in[i]);
-                }
-                else if (DataType == DATA_V_E)
-                {
-                    temp_u_out.push_back(u_in[i]);
-                    temp_v_out.push_back(v_in[i]);
-                    temp_w_out.push_back(w_in[i]);
-                }
-                temp_elem_list.push_back(num_conn);
-                num_elem++;
-                temp_conn_list.push_back(add_vertex(cl[el[i]]));
-                num_conn++;
-                temp_conn_list.push_back(add_vertex(cl[el[i] + 1]));
-                num_conn++;
-                temp_conn_list.push_back(add_vertex(cl[el[i] + 2]));
-                num_conn++;
-            }
+            part.elem.push_back((int)part.conn.size());
+            part.cell.push_back(i);
+            part.conn.push_back(cl[el[i]]);
+            part.conn.push_back(cl[el[i] + 1]);
+            part.conn.push_back(cl[el[i] + 2]);
+            part.conn.push_back(cl[el[i] + 3]);
         }
-        break;
-        case TYPE_BAR: // no surface representation possible
-            num_bar++;
-            break;
-        case TYPE_POINT: // no surface/line representation possible
-            break; // but do not send an error!!!!
-        default:
+    }
+    break;
+    case TYPE_TRIANGLE:
+    {
+        if (test(cl[el[i]], cl[el[i] + 1], cl[el[i] + 2]))
         {
-            if (first)
-                Covise::sendError("ERROR: unsupported grid type detected");
-            first = 0;
-            //return;
-        }
-            //  break; Everything is either specific or default...
+            part.elem.push_back((int)part.conn.size());
+            part.cell.push_back(i);
+            part.conn.push_back(cl[el[i]]);
+            part.conn.push_back(cl[el[i] + 1]);
+            part.conn.push_back(cl[el[i] + 2]);
         }
     }
-    elemMap = new int[num_bar];
-    nb = 0;
-    for (i = 0; i < numelem; i++)
+    break;
+    case TYPE_BAR: // no surface representation possible
+        break;
+    case TYPE_POINT: // no surface/line representation possible
+        break; // but do not send an error!!!!
+    default:
     {
-        switch (tl[i])
-        {
-        case TYPE_BAR:
-            elemMap[nb] = i;
-            nb++;
-            break;
-        };
+        part.unsupported = true;
+        //return;
     }
+        //  break; Everything is either specific or default...
+    }
+}
 
-    conn_list = new int[temp_conn_list.size()];
-    elem_list = new int[temp_elem_list.size()];
-
-    x_out = new float[temp_x_out.size()];
-    y_out = new float[temp_y_out.size()];
-    z_out = new float[temp_z_out.size()];
-
-    u_out = new float[temp_u_out.size()];
-    v_out = new float[temp_v_out.size()];
-    w_out = new float[temp_w_out.size()];
-
-    for (i = 0; i < temp_conn_list.size(); i++)
+// The boundary polygons of ranges of cells are collected in parallel and
+// concatenated in the order of the cells. Interior and boundary faces are
+// told apart by the shared neighbor list: its face table for grids with
+// vertices of very many cells, otherwise by searching the cells of a face
+// vertex. The vertices are numbered in the order of their first use, as
+// before.
+void SDomainsurface::surface()
+{
+    int i;
+    coWristWatch ww;
+
+    const int num_parts = (numelem + CellsPerPart - 1) / CellsPerPart;
+    vector<SurfacePart> parts(num_parts);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int p = 0; p < num_parts; p++)
     {
-        conn_list[i] = temp_conn_list[i];
+        SurfacePart &part = parts[p];
+        part.unsupported = false;
+        int end = std::min(numelem, (p + 1) * CellsPerPart);
+        for (int cell = p * CellsPerPart; cell < end; cell++)
+            cellSurface(cell, part);
     }
 
-    for (i = 0; i < temp_elem_list.size(); i++)
+    // start of the parts in the output
+    vector<int> elem_start(num_parts + 1, 0), conn_start(num_parts + 1, 0);
+    bool unsupported = false;
+    for (int p = 0; p < num_parts; p++)
     {
-        elem_list[i] = temp_elem_list[i];
+        elem_start[p + 1] = elem_start[p] + (int)parts[p].elem.size();
+        conn_start[p + 1] = conn_start[p] + (int)parts[p].conn.size();
+        unsupported = unsupported || parts[p].unsupported;
     }
-
-    for (i = 0; i < temp_x_out.size(); i++)
+    if (unsupported)
+        Covise::sendError("ERROR: unsupported grid type detected");
+    num_elem = elem_start[num_parts];
+    num_conn = conn_start[num_parts];
+
+    elem_list = new int[num_elem];
+    conn_list = new int[num_conn];
+    u_out = v_out = w_out = NULL;
+    if (DataType == DATA_S_E || DataType == DATA_V_E)
+        u_out = new float[num_elem];
+    if (DataType == DATA_V_E)
     {
-        x_out[i] = temp_x_out[i];
-        y_out[i] = temp_y_out[i];
-        z_out[i] = temp_z_out[i];
+        v_out = new float[num_elem];
+        w_out = new float[num_elem];
     }
 
-    if (DataType == DATA_S_E)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int p = 0; p < num_parts; p++)
     {
-        for (i = 0; i < temp_elem_list.size(); i++)
+        const SurfacePart &part = parts[p];
+        for (size_t e = 0; e < part.elem.size(); e++)
         {
-            u_out[i] = temp_u_out[i];
+            int elem = elem_start[p] + (int)e;
+            elem_list[elem] = conn_start[p] + part.elem[e];
+            if (DataType == DATA_S_E || DataType == DATA_V_E)
+                u_out[elem] = u_in[part.cell[e]];
+            if (DataType == DATA_V_E)
+            {
+                v_out[elem] = v_in[part.cell[e]];
+                w_out[elem] = w_in[part.cell[e]];
+            }
         }
+        if (!part.conn.empty())
+            memcpy(conn_list + conn_start[p], &part.conn[0], part.conn.size() * sizeof(int));
     }
-
-    if (DataType == DATA_V_E)
+    parts.clear();
+
+    // Every thread owns a range of vertices and finds the first use of its
+    // vertices in the connectivity list. The positions are sorted by vertex
+    // range first (stable counting sort over chunks of the list), so that
+    // each thread only walks the positions of its own vertices. A prefix
+    // sum over the first uses yields the numbers of the output vertices.
+    conn_tag = new int[numcoord];
+    memset(conn_tag, -1, numcoord * sizeof(int));
+    int num_ranges = 1;
+#ifdef _OPENMP
+    if (num_conn >= CellsPerPart)
+        num_ranges = omp_get_max_threads();
+#endif
+    const int range_size = std::max(1, (numcoord + num_ranges - 1) / num_ranges);
+    const int chunk = (num_conn + num_ranges - 1) / num_ranges;
+    vector<int> range_pos(num_ranges * num_ranges + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int c = 0; c < num_ranges; c++)
     {
-        for (i = 0; i < temp_elem_list.size(); i++)
-        {
-            u_out[i] = temp_u_out[i];
-            v_out[i] = temp_v_out[i];
-            w_out[i] = temp_w_out[i];
-        }
+        int *count = &range_pos[c];
+        const int end = std::min(num_conn, (c + 1) * chunk);
+        for (int pos = c * chunk; pos < end; pos++)
+            count[(conn_list[pos] / range_size) * num_ranges]++;
     }
-
-    if (DataType == DATA_S)
+    // range-major, chunk-minor: the positions of a range stay ascending
+    exclusiveScan(&range_pos[0], num_ranges * num_ranges + 1);
+    vector<int> range_start(num_ranges + 1);
+    for (int r = 0; r <= num_ranges; r++)
+        range_start[r] = range_pos[r * num_ranges];
+    vector<int> sorted_pos(num_conn + 1);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int c = 0; c < num_ranges; c++)
     {
-        for (i = 0; i < temp_u_out.size(); i++)
+        int *next = &range_pos[c];
+        const int end = std::min(num_conn, (c + 1) * chunk);
+        for (int pos = c * chunk; pos < end; pos++)
+            sorted_pos[next[(conn_list[pos] / range_size) * num_ranges]++] = pos;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int r = 0; r < num_ranges; r++)
+    {
+        for (int o = range_start[r]; o < range_start[r + 1]; o++)
         {
-            u_out[i] = temp_u_out[i];
+            int pos = sorted_pos[o];
+            int v = conn_list[pos];
+            if (conn_tag[v] < 0)
+                conn_tag[v] = pos;
         }
     }
-
+    vector<int>().swap(sorted_pos);
+
+    vector<int> vertex_number(num_conn + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int pos = 0; pos < num_conn; pos++)
+        vertex_number[pos] = (conn_tag[conn_list[pos]] == pos) ? 1 : 0;
+    num_vert = exclusiveScan(&vertex_number[0], num_conn + 1);
+
+    x_out = new float[num_vert];
+    y_out = new float[num_vert];
+    z_out = new float[num_vert];
+    if (DataType == DATA_S || DataType == DATA_V)
+        u_out = new float[num_vert];
     if (DataType == DATA_V)
     {
-        for (i = 0; i < temp_u_out.size(); i++)
+        v_out = new float[num_vert];
+        w_out = new float[num_vert];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int pos = 0; pos < num_conn; pos++)
+    {
+        int v = conn_list[pos];
+        int first = conn_tag[v];
+        int n = vertex_number[first];
+        if (first == pos)
         {
-            u_out[i] = temp_u_out[i];
-            v_out[i] = temp_v_out[i];
-            w_out[i] = temp_w_out[i];
+            x_out[n] = x_in[v];
+            y_out[n] = y_in[v];
+            z_out[n] = z_in[v];
+            if (DataType == DATA_S || DataType == DATA_V)
+                u_out[n] = u_in[v];
+            if (DataType == DATA_V)
+            {
+                v_out[n] = v_in[v];
+                w_out[n] = w_in[v];
+            }
         }
+        conn_list[pos] = n;
     }
 
-    temp_elem_in.clear();
-    temp_conn_in.clear();
-    temp_vertex_list.clear();
-    temp_conn_list.clear();
-    temp_elem_list.clear();
-    temp_x_out.clear();
-    temp_y_out.clear();
-    temp_z_out.clear();
-    temp_u_out.clear();
-    temp_v_out.clear();
-    temp_w_out.clear();
-
-    return;
-}
-
-int SDomainsurface::add_vertex(int v)
-{
-    if (conn_tag[v] >= 0)
-        return (conn_tag[v]);
-    conn_tag[v] = num_vert;
-    temp_x_out.push_back(x_in[v]);
-    temp_y_out.push_back(y_in[v]);
-    temp_z_out.push_back(z_in[v]);
-
-    if (DataType == DATA_S)
+    num_bar = 0;
+    for (i = 0; i < numelem; i++)
     {
-        temp_u_out.push_back(u_in[v]);
+        if (tl[i] == TYPE_BAR)
+            num_bar++;
     }
-    if (DataType == DATA_V)
+    elemMap = new int[num_bar];
+    int nb = 0;
+    for (i = 0; i < numelem; i++)
     {
-        temp_u_out.push_back(u_in[v]);
-        temp_v_out.push_back(v_in[v]);
-        temp_w_out.push_back(w_in[v]);
+        switch (tl[i])
+        {
+        case TYPE_BAR:
+            elemMap[nb] = i;
+            nb++;
+            break;
+        };
     }
-    num_vert++;
-    return (num_vert - 1);
+
+    Covise::sendInfo("surface of %d cells: %d polygons in %6.3f s", numelem, num_elem, ww.elapsed());
 }
 
 ////// normals
-int SDomainsurface::norm_check(int v1, int v2, int v3, int /* v4 */)
+int SDomainsurface::norm_check(const float *center, int v1, int v2, int v3, int /* v4 */) const
 {
     int r;
     float a[3], b[3], c[3], n[3];
@@ -3322,9 +2739,9 @@ int SDomainsurface::norm_check(int v1, int v2, int v3, int /* v4 */)
     n[2] = a[0] * b[1] - b[0] * a[1];
 
     // compute vector from base-point to volume-center
-    c[0] = x_center - x_in[v2];
-    c[1] = y_center - y_in[v2];
-    c[2] = z_center - z_in[v2];
+    c[0] = center[0] - x_in[v2];
+    c[1] = center[1] - y_in[v2];
+    c[2] = center[2] - z_in[v2];
     // look if normal is correct or not
     if ((c[0] * n[0] + c[1] * n[1] + c[2] * n[2]) > 0)
         r = 0;
@@ -3338,7 +2755,7 @@ int SDomainsurface::norm_check(int v1, int v2, int v3, int /* v4 */)
 //=====================================================================
 // test if surface should be displayed
 //=====================================================================
-inline int SDomainsurface::test(int v1, int v2, int v3)
+inline int SDomainsurface::test(int v1, int v2, int v3) const
 {
     float l, n1x, n1y, n1z;
     n1x = ((y_in[v1] - y_in[v2]) * (z_in[v1] - z_in[v3])) - ((z_in[v1] - z_in[v2]) * (y_in[v1] - y_in[v3]));
@@ -14,6 +14,9 @@ using namespace covise;
 #include <do/coDoData.h>
 #include <do/coDoLines.h>
 #include <do/coDoPolygons.h>
+#include <do/coDoNeighborList.h>
+#include <map>
+#include <string>
 
 class SDomainsurface : public coSimpleModule
 {
@@ -23,6 +26,8 @@ private:
 
     // compute callback
     virtual int compute(const char *port);
+    virtual void preHandleObjects(coInputPort **);
+    virtual void postHandleObjects(coOutputPort **);
     void copyAttributesToOutObj(coInputPort **input_ports,
                                 coOutputPort **output_ports, int n);
     double get_angle(int v1, int v2, int v3, int v21, int v22, int v23);
@@ -57,7 +62,6 @@ private:
     };
 
     //       int MEMORY_OPTIMIZED;
-    float x_center, y_center, z_center;
 
     //  adjacency vars
     float angle, n2x, n2y, n2z, scalar;
@@ -81,21 +85,17 @@ private:
     float *lu_out, *lv_out, *lw_out;
 
     /////////////////////////////////////////////////////////
-    vector<int> temp_conn_list;
-    vector<int> temp_elem_list;
-
-    vector<float> temp_x_out;
-    vector<float> temp_y_out;
-    vector<float> temp_z_out;
-    vector<float> temp_u_out;
-    vector<float> temp_v_out;
-    vector<float> temp_w_out;
     vector<float> temp_lu_out;
     vector<float> temp_lv_out;
     vector<float> temp_lw_out;
     //////////////////////////////////////////////////////////
 
     coDoUnstructuredGrid *tmp_grid;
+
+    // shared neighbor lists of the grids of the last execution, by grid name
+    typedef std::map<std::string, const coDoNeighborList *> NeighborListMap;
+    NeighborListMap neighborLists;
+    NeighborListMap usedNeighborLists;
     coDoLines *Lines;
     coDoPolygons *Polygons;
     coDoFloat *SOut;
@@ -118,12 +118,26 @@ private:
                   coDistributedObject **linesOut,
                   coDistributedObject **ldataOut);
 
+    // boundary polygons of a range of cells, extracted by one thread
+    struct SurfacePart
+    {
+        vector<int> elem; // start of the polygons in conn
+        vector<int> conn; // grid vertices
+        vector<int> cell; // cell of each polygon
+        bool unsupported; // contains cells of unsupported type
+    };
+    enum
+    {
+        CellsPerPart = 16384
+    };
+
     void surface();
+    void cellSurface(int i, SurfacePart &part);
     void lines();
-    int test(int, int, int);
-    int add_vertex(int v);
+    void featureEdges(int i, const float *normal, char *feature);
+    int test(int, int, int) const;
     int ladd_vertex(int v);
-    int norm_check(int v1, int v2, int v3, int v4 = -1);
+    int norm_check(const float *center, int v1, int v2, int v3, int v4 = -1) const;
 
 public:
     SDomainsurface(int argc, char *argv[]);
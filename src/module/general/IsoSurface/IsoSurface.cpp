@@ -138,9 +138,31 @@ IsoSurface::UpdateIsoValue()
     }
 }
 
+// the index type is complete here, the cache deletes its indices
+IsoSurface::~IsoSurface()
+{
+}
+
+SpanSpaceIndex *IsoSurface::getSpanSpaceIndex(const coDistributedObject *grid, const coDistributedObject *isoData,
+                                              int numelem, int numconn, int *el, int *cl, int *tl, float *iso)
+{
+    SpanSpaceIndex **index = spanSpaceIndices.lookup(std::string(grid->getName()) + "\n" + isoData->getName());
+    if (!index)
+        return NULL;
+    if (!*index)
+    {
+        if (spanSpaceIndices.getMemorySize() + SpanSpaceIndex::getMemorySize(numelem) > maxSpanSpaceMemory)
+            return NULL;
+        *index = new SpanSpaceIndex(numelem, numconn, el, cl, tl, iso);
+    }
+    return *index;
+}
+
 void IsoSurface::preHandleObjects(coInputPort **InPorts)
 {
     ww_.reset();
+    spanSpaceIndices.beginExecution();
+    numCells = numVisitedCells = 0;
     // Automatically adapt our Module's title to the species
     if (autoTitle)
     {
@@ -257,11 +279,16 @@ public:
 
 void IsoSurface::postHandleObjects(coOutputPort **OutPorts)
 {
+    spanSpaceIndices.endExecution();
 
     lookUp = 0;
 
     Terminator terminator;
 
+    if (numVisitedCells < numCells)
+        Covise::sendInfo("visited %d of %d cells, span space index: %.1f MB", numVisitedCells, numCells,
+                         spanSpaceIndices.getMemorySize() / 1048576.);
+
     //sl:  FEEDBACK for the object of the first port
     if (OutPorts == NULL || OutPorts[shiftOut]->getCurrentObject() == NULL)
     {
@@ -1803,13 +1830,19 @@ int IsoSurface::compute(const char *)
         else if (strcmp(gtype, "UNSGRD") == 0)
         {
             // Support for polyhedral cells
+            SpanSpaceIndex *index = NULL;
+            if (useSpanSpaceIndex && iblank == NULL)
+                index = getSpanSpaceIndex(grid_in, i_data_in, numelem, numconn, el, cl, tl, i_in);
             if (Polyhedra)
             {
                 pplane = new POLYHEDRON_IsoPlane(numelem, numconn, numcoord, DataType, /*vertexRatio,*/
                                                  el, cl, tl,
                                                  x_in, y_in, z_in, s_in, i_in, u_in, v_in, w_in, isovalue,
-                                                 (p_DataIn->isConnected() != 0), iblank);
-                if (!pplane->createIsoPlane())
+                                                 (p_DataIn->isConnected() != 0), iblank, index);
+                bool created = pplane->createIsoPlane();
+                numCells += numelem;
+                numVisitedCells += pplane->getNumVisitedCells();
+                if (!created)
                 {
                     delete pplane;
                     sendError("The isosurface could not be created");
@@ -1823,8 +1856,11 @@ int IsoSurface::compute(const char *)
                 plane = new IsoPlane(numelem, numcoord, DataType, vertexRatio,
                                      el, cl, tl,
                                      x_in, y_in, z_in, s_in, i_in, u_in, v_in, w_in, isovalue,
-                                     (p_DataIn->isConnected() != 0), iblank);
-                if (!plane->createIsoPlane())
+                                     (p_DataIn->isConnected() != 0), iblank, index);
+                bool created = plane->createIsoPlane();
+                numCells += numelem;
+                numVisitedCells += plane->getNumVisitedCells();
+                if (!created)
                 {
                     delete plane;
 
@@ -2834,6 +2870,12 @@ IsoSurface::IsoSurface(int argc, char *argv[])
 
     Polyhedra = coCoviseConfig::isOn("Module.IsoSurface.SupportPolyhedra", true);
 
+    // index the cells of unstructured grids by their iso data range when the
+    // isovalue is changed on the same data, e.g. while sweeping it from COVER
+    useSpanSpaceIndex = coCoviseConfig::isOn("Module.IsoSurface.SpanSpaceIndex", true);
+    maxSpanSpaceMemory = (size_t)coCoviseConfig::getInt("Module.IsoSurface.SpanSpaceMemory", 256) << 20;
+    numCells = numVisitedCells = 0;
+
     /// Send old-style or new-style feedback: Default values different HLRS/Vrc
     fbStyle_ = FEED_NEW;
     std::string fbStyleStr = coCoviseConfig::getEntry("System.FeedbackStyle.IsoSurface");
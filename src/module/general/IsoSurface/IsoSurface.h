@@ -29,6 +29,7 @@
 using namespace covise;
 #include <util/coviseCompat.h>
 #include <float.h>
+#include <alg/coIndexCache.h>
 
 #include <do/coDoData.h>
 #include <do/coDoRectilinearGrid.h>
@@ -41,6 +42,11 @@ using namespace covise;
 #include <alg/coColors.h>
 #endif
 
+namespace covise
+{
+class SpanSpaceIndex;
+}
+
 class IsoSurface : public coSimpleModule
 {
 
@@ -115,6 +121,16 @@ private:
     // use polyhedra support or not
     bool Polyhedra;
 
+    // span space indices of unstructured grids by grid and iso data object name,
+    // kept between executions, their memory is limited to maxSpanSpaceMemory
+    coIndexCache<SpanSpaceIndex> spanSpaceIndices;
+    bool useSpanSpaceIndex;
+    size_t maxSpanSpaceMemory;
+    int numCells, numVisitedCells;
+
+    SpanSpaceIndex *getSpanSpaceIndex(const coDistributedObject *grid, const coDistributedObject *isoData,
+                                      int numelem, int numconn, int *el, int *cl, int *tl, float *iso);
+
 protected:
     myPair find_isovalueU(const coDoUniformGrid *, const coDoFloat *);
     myPair find_isovalueR(const coDoRectilinearGrid *, const coDoFloat *);
@@ -174,8 +190,6 @@ public:
 
     // void postInst(){setCopyNonSetAttributes(0);}
 
-    virtual ~IsoSurface()
-    {
-    }
+    virtual ~IsoSurface();
 };
 #endif // _ISOS_H
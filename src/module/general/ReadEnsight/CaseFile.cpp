@@ -52,6 +52,7 @@ string trim(const string &s)
 CaseFile::CaseFile()
     : empty_(true)
     , geoTsIdx_(-1)
+    , changeCoordsOnly_(false)
 {
 }
 
@@ -65,9 +66,16 @@ CaseFile::CaseFile(const CaseFile &cf)
     , dir_(cf.dir_)
     , timeSets_(cf.timeSets_)
     , geoTsIdx_(cf.geoTsIdx_)
+    , changeCoordsOnly_(cf.changeCoordsOnly_)
 {
 }
 
+void
+CaseFile::setChangeCoordsOnly(const bool &b)
+{
+    changeCoordsOnly_ = b;
+}
+
 void
 CaseFile::setGeoFileNm(const string &fn)
 {
@@ -60,6 +60,13 @@ public:
     int getGeoTsIdx();
     void setVersion(const int &v);
 
+    // model line with change_coords_only: the connectivity is the same in all geometry files
+    void setChangeCoordsOnly(const bool &b);
+    bool changeCoordsOnly() const
+    {
+        return changeCoordsOnly_;
+    };
+
     // set the full name of the case file
     void setFullFilename(const string &fn);
 
@@ -104,6 +111,7 @@ private:
     string projectNm_;
     TimeSets timeSets_;
     int geoTsIdx_; // time set index of geometry
+    bool changeCoordsOnly_;
 };
 
 // simple data class to store time step information
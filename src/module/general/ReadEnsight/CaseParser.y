@@ -327,6 +327,16 @@ model_spec: MODEL any_identifier
 	      caseFile_.setGeoTsIdx(1);
 	      //	      fprintf(stderr,"  ENSIGHT MODEL <%s> TIMESET <%d> found\n", ensight_geofile.c_str(), ts);
           }
+          // only the coordinates change over time, the connectivity of the first
+          // geometry file may be reused
+          | model_spec CH_CO_ONLY
+          {
+	      caseFile_.setChangeCoordsOnly(true);
+          }
+          | model_spec CH_CO_ONLY INTEGER
+          {
+	      caseFile_.setChangeCoordsOnly(true);
+          }
 
 
           | MEASURED any_identifier 
@@ -20,8 +20,13 @@
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 #include "DataFileGoldBin.h"
+#include <config/CoviseConfig.h>
 #include <util/byteswap.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //
 // Constructor
 //
@@ -41,6 +46,10 @@ DataFileGoldBin::DataFileGoldBin(const coModule *mod,
     byteSwap_ = false;
     //byteSwap_ =  machineIsLittleEndian();
 
+    // the arrays of all parts are decoded concurrently in read()
+    if (isOpen_ && coCoviseConfig::isOn("Module.ReadEnsight.MemoryMap", true))
+        mapFile(name);
+
     // dc_ is only a marker here
     switch (dim_)
     {
@@ -57,6 +66,63 @@ DataFileGoldBin::DataFileGoldBin(const coModule *mod,
     }
 }
 
+DataFileGoldBin::DataFileGoldBin(const DataFileGoldBin &master, SharedMapping)
+    : EnFile(master.module_, master.binType_)
+    , lineCnt_(0)
+    , numVals_(0)
+    , indexMap_(NULL)
+    , actPartIndex_(0)
+{
+    className_ = string("DataFileGoldBin");
+    shareMap(master, 0);
+    isOpen_ = true;
+}
+
+void
+DataFileGoldBin::readFloats(const int &n, float *arr, vector<FloatBlock> *blocks)
+{
+    if (blocks == NULL)
+    {
+        getFloatArr(n, arr);
+        return;
+    }
+    FloatBlock b;
+    b.arr = arr;
+    b.n = n;
+    b.offset = tell();
+    b.byteSwap = byteSwap_;
+    blocks->push_back(b);
+    skipFloat(n);
+}
+
+void
+DataFileGoldBin::decodeBlocks(const vector<FloatBlock> &blocks)
+{
+    if (blocks.empty())
+        return;
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = coCoviseConfig::getInt("Module.ReadEnsight.Threads", omp_get_num_procs());
+    if (numThreads < 1)
+        numThreads = 1;
+#endif
+
+    int numBlocks = (int)blocks.size();
+#pragma omp parallel num_threads(numThreads)
+    {
+        // one decoder with a private file position per thread
+        DataFileGoldBin decoder(*this, SHARE_MAPPING);
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            decoder.seek(blocks[i].offset);
+            decoder.byteSwap_ = blocks[i].byteSwap;
+            decoder.getFloatArr(blocks[i].n, blocks[i].arr);
+        }
+    }
+}
+
 void
 DataFileGoldBin::readCells()
 {
@@ -69,7 +135,7 @@ DataFileGoldBin::readCells()
         EnPart *actPart(NULL);
         int eleCnt2d = 0, eleCnt3d = 0;
 
-        while (!feof(in_))
+        while (!eof())
         {
             string tmp(getStr());
 
@@ -249,7 +315,7 @@ DataFileGoldBin::readCells()
 
                 int numParts = currPart.getNumEle();
                 // skip data
-                while ((!feof(in_)) && (numParts > 0))
+                while ((!eof()) && (numParts > 0))
                 {
                     tmp = getStr();
                     string elementType(strip(tmp));
@@ -291,7 +357,12 @@ DataFileGoldBin::read()
         size_t id(0);
         int actPartNr;
 
-        while (!feof(in_))
+        // with a mapped file the arrays are allocated while scanning
+        // the file and filled concurrently afterwards
+        vector<FloatBlock> blocks;
+        vector<FloatBlock> *mapBlocks = isMapped() ? &blocks : NULL;
+
+        while (!eof())
         {
             float *arr1 = NULL, *arr2 = NULL, *arr3 = NULL;
             int numVal;
@@ -369,12 +440,12 @@ DataFileGoldBin::read()
                         {
                         case 1:
                             //cerr << "DataFileGoldBin::read()  reading scalar data" << endl;
-                            getFloatArr(numVal, arr1);
+                            readFloats(numVal, arr1, mapBlocks);
                             break;
                         case 3:
-                            getFloatArr(numVal, arr1);
-                            getFloatArr(numVal, arr2);
-                            getFloatArr(numVal, arr3);
+                            readFloats(numVal, arr1, mapBlocks);
+                            readFloats(numVal, arr2, mapBlocks);
+                            readFloats(numVal, arr3, mapBlocks);
                             break;
                         }
                     }
@@ -395,6 +466,7 @@ DataFileGoldBin::read()
                 }
             }
         }
+        decodeBlocks(blocks);
     }
     //buildParts(true);
 }
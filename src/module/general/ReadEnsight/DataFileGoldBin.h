@@ -43,6 +43,31 @@ public:
     ~DataFileGoldBin();
 
 private:
+    // float array of an active part in a memory mapped file
+    struct FloatBlock
+    {
+        float *arr;
+        int n;
+        size_t offset;
+        bool byteSwap;
+    };
+
+    // selects the constructor of a decoder, copies are plain member copies
+    enum SharedMapping
+    {
+        SHARE_MAPPING
+    };
+
+    // decoder for float arrays sharing the mapping of master
+    DataFileGoldBin(const DataFileGoldBin &master, SharedMapping);
+
+    // read n floats to arr or, if blocks is not NULL, remember the position
+    // for decoding later and skip them
+    void readFloats(const int &n, float *arr, vector<FloatBlock> *blocks);
+
+    // decode all remembered blocks concurrently
+    void decodeBlocks(const vector<FloatBlock> &blocks);
+
     int lineCnt_; // actual linecount
     int numVals_; // number of values
     int *indexMap_; // may contain indexMap
@@ -31,6 +31,19 @@
 #include <util/coviseCompat.h>
 #include <api/coModule.h>
 
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace covise;
 InvalidWordException::InvalidWordException(const string &type)
     : type_(type)
@@ -142,6 +155,7 @@ EnFile::EnFile(const coModule *mod, const BinType &binType)
     : fileMayBeCorrupt_(false)
     , className_(string("EnFile"))
     , isOpen_(false)
+    , in_(NULL)
     , binType_(binType)
     , byteSwap_(false)
     , partList_(NULL)
@@ -149,6 +163,17 @@ EnFile::EnFile(const coModule *mod, const BinType &binType)
     , activeAlloc_(true)
     , dataByteSwap_(false)
     , module_(mod)
+    , mapData_(NULL)
+    , mapSize_(0)
+    , pos_(0)
+    , connPL_(NULL)
+    , ownsMap_(false)
+#ifdef _WIN32
+    , mapFile_(NULL)
+    , mapping_(NULL)
+#else
+    , mapFd_(-1)
+#endif
 {
 }
 
@@ -163,7 +188,18 @@ EnFile::EnFile(const coModule *mod, const string &name, const int &dim, const Bi
     , activeAlloc_(true)
     , dataByteSwap_(false)
     , module_(mod)
+    , mapData_(NULL)
+    , mapSize_(0)
+    , pos_(0)
+    , connPL_(NULL)
     , name_(name)
+    , ownsMap_(false)
+#ifdef _WIN32
+    , mapFile_(NULL)
+    , mapping_(NULL)
+#else
+    , mapFd_(-1)
+#endif
 {
     if (binType != FBIN && binType != CBIN)
     { // reopen as ASCII else leave it in binary mode
@@ -198,7 +234,18 @@ EnFile::EnFile(const coModule *mod, const string &name, const BinType &binType)
     , dim_(1)
     , activeAlloc_(true)
     , module_(mod)
+    , mapData_(NULL)
+    , mapSize_(0)
+    , pos_(0)
+    , connPL_(NULL)
     , name_(name)
+    , ownsMap_(false)
+#ifdef _WIN32
+    , mapFile_(NULL)
+    , mapping_(NULL)
+#else
+    , mapFd_(-1)
+#endif
 {
 
     if (binType != FBIN && binType != CBIN)
@@ -309,10 +356,166 @@ EnFile::getDataCont() const
 
 EnFile::~EnFile()
 {
-    if (isOpen_)
+    unmapFile();
+    if (isOpen_ && in_)
         fclose(in_);
 }
 
+// map the whole file read-only, the binary helpers then copy directly from
+// the mapping instead of calling fread for every item
+bool
+EnFile::mapFile(const string &name)
+{
+    unmapFile();
+#ifdef _WIN32
+    mapFile_ = CreateFileA(name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mapFile_ == INVALID_HANDLE_VALUE)
+    {
+        mapFile_ = NULL;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(mapFile_, &size);
+    mapSize_ = size.QuadPart;
+    if (mapSize_ > 0)
+        mapping_ = CreateFileMapping(mapFile_, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_)
+        mapData_ = (const char *)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+    mapFd_ = open(name.c_str(), O_RDONLY);
+    if (mapFd_ < 0)
+        return false;
+    struct stat info;
+    if (fstat(mapFd_, &info) == 0 && info.st_size > 0)
+    {
+        mapSize_ = info.st_size;
+        void *addr = mmap(NULL, mapSize_, PROT_READ, MAP_SHARED, mapFd_, 0);
+        if (addr != MAP_FAILED)
+        {
+            mapData_ = (const char *)addr;
+            madvise(addr, mapSize_, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+    if (!mapData_)
+    {
+        unmapFile();
+        return false;
+    }
+    ownsMap_ = true;
+    pos_ = 0;
+    return true;
+}
+
+void
+EnFile::unmapFile()
+{
+    if (ownsMap_)
+    {
+#ifdef _WIN32
+        if (mapData_)
+            UnmapViewOfFile(mapData_);
+#else
+        if (mapData_)
+            munmap((void *)mapData_, mapSize_);
+#endif
+    }
+#ifdef _WIN32
+    if (mapping_)
+        CloseHandle(mapping_);
+    if (mapFile_)
+        CloseHandle(mapFile_);
+    mapping_ = NULL;
+    mapFile_ = NULL;
+#else
+    if (mapFd_ >= 0)
+        close(mapFd_);
+    mapFd_ = -1;
+#endif
+    mapData_ = NULL;
+    mapSize_ = 0;
+    pos_ = 0;
+    ownsMap_ = false;
+}
+
+void
+EnFile::shareMap(const EnFile &other, const size_t &pos)
+{
+    unmapFile();
+    mapData_ = other.mapData_;
+    mapSize_ = other.mapSize_;
+    pos_ = pos;
+}
+
+bool
+EnFile::eof()
+{
+    if (mapData_)
+        return pos_ >= mapSize_;
+    return feof(in_) != 0;
+}
+
+void
+EnFile::seekCur(const long &off)
+{
+    if (mapData_)
+    {
+        if (off < 0 && size_t(-off) > pos_)
+            pos_ = 0;
+        else
+            pos_ = std::min(pos_ + off, mapSize_);
+        return;
+    }
+#ifdef WIN32
+    _fseeki64(in_, off, SEEK_CUR);
+#else
+    fseek(in_, off, SEEK_CUR);
+#endif
+}
+
+size_t
+EnFile::tell()
+{
+    if (mapData_)
+        return pos_;
+    return ftell(in_);
+}
+
+void
+EnFile::seek(const size_t &pos)
+{
+    if (mapData_)
+    {
+        pos_ = std::min(pos, mapSize_);
+        return;
+    }
+#ifdef WIN32
+    _fseeki64(in_, pos, SEEK_SET);
+#else
+    fseek(in_, pos, SEEK_SET);
+#endif
+}
+
+// read len bytes to dst, returns the number of bytes read
+size_t
+EnFile::readRaw(void *dst, const size_t &len)
+{
+    if (mapData_)
+    {
+        size_t n = std::min(len, mapSize_ - std::min(pos_, mapSize_));
+        memcpy(dst, mapData_ + pos_, n);
+        pos_ += n;
+        if (n < len)
+        {
+            memset((char *)dst + n, 0, len - n);
+            pos_ = mapSize_;
+        }
+        return n;
+    }
+    return fread(dst, 1, len, in_);
+}
+
 // helper skip n floats or doubles
 void
 EnFile::skipFloat(const int &n)
@@ -321,11 +524,7 @@ EnFile::skipFloat(const int &n)
     { // check for block markers
         int ilen(getIntRaw());
 
-#ifdef WIN32
-        _fseeki64(in_, ilen, SEEK_CUR);
-#else
-        fseek(in_, ilen, SEEK_CUR);
-#endif
+        seekCur(ilen);
 
         int olen(getIntRaw());
         if ((ilen != olen))
@@ -340,11 +539,7 @@ EnFile::skipFloat(const int &n)
     // Read floats up to 4GB
     else
     {
-#ifdef WIN32
-        _fseeki64(in_, n * sizeof(float), SEEK_CUR);
-#else
-        fseek(in_, n * sizeof(float), SEEK_CUR);
-#endif
+        seekCur(long(n) * sizeof(float));
     }
 }
 
@@ -355,11 +550,7 @@ EnFile::skipInt(const int &n)
     if (binType_ == EnFile::FBIN)
     { // check for block markers
         int ilen(getIntRaw());
-#ifdef WIN32
-        _fseeki64(in_, n * 4, SEEK_CUR);
-#else
-        fseek(in_, n * 4, SEEK_CUR);
-#endif
+        seekCur(long(n) * 4);
 
         int olen(getIntRaw());
         if ((ilen != olen) || (ilen != n * 4))
@@ -372,11 +563,7 @@ EnFile::skipInt(const int &n)
     }
     else
     {
-#ifdef WIN32
-        _fseeki64(in_, n * sizeof(int), SEEK_CUR);
-#else
-        fseek(in_, n * sizeof(int), SEEK_CUR);
-#endif
+        seekCur(long(n) * sizeof(int));
     }
 }
 
@@ -393,7 +580,7 @@ EnFile::getStr()
     if (binType_ == EnFile::FBIN)
     {
         int ilen(getIntRaw());
-        if (feof(in_))
+        if (eof())
         {
             //end of file reached
             return ret;
@@ -425,8 +612,8 @@ EnFile::getStr()
             cerr << "ERROR: EnFile::getStr(): not a fortran string of length 80" << endl;
             return ret;
         }
-        fread(buf, strLen, 1, in_);
-        if (feof(in_))
+        readRaw(buf, strLen);
+        if (eof())
         {
 #ifdef WIN32
             DebugBreak();
@@ -444,6 +631,10 @@ EnFile::getStr()
             return ret;
         }
     }
+    else if (mapData_)
+    {
+        readRaw(buf, strLen);
+    }
     else
     {
         for (int i = 0; i < strLen; ++i)
@@ -478,7 +669,7 @@ int
 EnFile::getIntRaw()
 {
     int ret = 0;
-    fread(&ret, 4, 1, in_); // read a 4 byte integer
+    readRaw(&ret, 4); // read a 4 byte integer
     if (byteSwap_)
     {
         byteSwap(ret);
@@ -494,12 +685,12 @@ EnFile::getIntArr(const int &n, int *iarr)
 
     if (binType_ == EnFile::FBIN)
     {
-        if (in_)
+        if (in_ || mapData_)
         {
             int ilen(getIntRaw());
             getIntArrHelper(n, iarr);
             int olen(getIntRaw());
-            if ((ilen != olen) && (!feof(in_)))
+            if ((ilen != olen) && (!eof()))
             {
 #ifdef WIN32
                 DebugBreak();
@@ -523,36 +714,24 @@ EnFile::getIntArr(const int &n, int *iarr)
 void
 EnFile::getIntArrHelper(const int &n, int *iarr)
 {
-    //////////////////////////// quick workaround (the original code doesn't work if n*sizeof(int) exceeds maxint)
-    // TODO: we now use fread() -> is this still nescessary?
-    if (n > 100000000)
+    // callers pass NULL to skip the values
+    if (iarr == NULL)
     {
-        int offset(0);
-        while (offset < n)
-        {
-            int current = n - offset;
-            if (current > 100000000)
-                current = 100000000;
-            getIntArrHelper(current, (iarr + offset));
-            offset += current;
-        }
+        seekCur(long(n) * long(sizeof(int)));
         return;
     }
-    ////////////////////////////
 
-    const int len(sizeof(int));
-    char *buf = new char[n * len];
-
-    fread(buf, len, n, in_);
+    // read directly to the destination, no intermediate buffer
+    readRaw(iarr, size_t(n) * sizeof(int));
 
     if (byteSwap_)
-        byteSwap((uint32_t *)buf, n);
-
-    if (iarr != NULL)
-        memcpy(iarr, buf, n * len);
+        byteSwap((uint32_t *)iarr, n);
+}
 
-    delete[] buf;
-    return;
+void
+EnFile::setConnectivityPL(const PartList *p)
+{
+    connPL_ = p;
 }
 
 void
@@ -580,7 +759,6 @@ EnFile::getFloatArr(const int &n, float *farr)
         return NULL;
 
     const int len(sizeof(float));
-    char *buf = new char[n * len];
     bool eightBytePerFloat = false;
 
     if (binType_ == EnFile::FBIN)
@@ -589,33 +767,24 @@ EnFile::getFloatArr(const int &n, float *farr)
         int olen;
 
         // we may have obtained double arrays
-        // unfortionately ifstream.read will read only basic types
-        // otherwise we would have saved one memcpy
-        // There may be more elegant soutions for that.
         if (ilen / n == 8)
         {
             eightBytePerFloat = true;
-            double *dummyArr = new double[n];
-            delete[] buf;
-            buf = new char[ilen];
-            fread(buf, 8, n, in_);
+            std::vector<double> dummyArr(n);
+            readRaw(&dummyArr[0], size_t(n) * 8);
             olen = getIntRaw();
             if (byteSwap_)
-                byteSwap((uint64_t *)buf, n);
-            memcpy(dummyArr, buf, ilen);
+                byteSwap((uint64_t *)&dummyArr[0], n);
             cerr << "got 64-bit floats" << endl;
-            int i;
-            if (farr != NULL)
-                for (i = 0; i < n; ++i)
-                    farr[i] = (float)dummyArr[i];
-            delete[] dummyArr;
+            for (int i = 0; i < n; ++i)
+                farr[i] = (float)dummyArr[i];
         }
         else
         {
-            fread(buf, len, n, in_);
+            readRaw(farr, size_t(n) * len);
             olen = getIntRaw();
         }
-        if ((ilen != olen) && (!feof(in_)))
+        if ((ilen != olen) && (!eof()))
         {
 #ifdef WIN32
             DebugBreak();
@@ -625,17 +794,14 @@ EnFile::getFloatArr(const int &n, float *farr)
     }
     else
     {
-        fread(buf, len, n, in_);
+        readRaw(farr, size_t(n) * len);
     }
 
     if (!eightBytePerFloat)
     {
         if (byteSwap_)
-            byteSwap((uint32_t *)buf, n);
-        if (farr != NULL)
-            memcpy(farr, buf, n * len);
+            byteSwap((uint32_t *)farr, n);
     }
-    delete[] buf;
     return NULL;
 }
 
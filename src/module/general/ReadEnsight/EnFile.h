@@ -165,6 +165,10 @@ public:
 
     void setDataByteSwap(const bool &v);
     void setIncludePolyeder(const bool &b);
+
+    // geometry with "change_coords_only": take the connectivity of the parts
+    // from p and read only the coordinates from the file
+    void setConnectivityPL(const PartList *p);
     virtual coDistributedObject *getDataObject(std::string)
     {
         return NULL;
@@ -192,6 +196,25 @@ protected:
     // get float array
     virtual float *getFloatArr(const int &n, float *farr = NULL);
 
+    // memory mapped input, if a file is mapped the helpers above read from
+    // the mapping and no longer from in_
+    bool mapFile(const string &name);
+    void unmapFile();
+    bool isMapped() const
+    {
+        return mapData_ != NULL;
+    };
+
+    // share the mapping of another file, the position is private to *this
+    // this allows to decode several parts of one file concurrently
+    void shareMap(const EnFile &other, const size_t &pos);
+
+    // position in the file - use these instead of feof/fseek on in_
+    bool eof();
+    void seekCur(const long &off);
+    size_t tell();
+    void seek(const size_t &pos);
+
     // find a part by its part number
     virtual EnPart *findPart(const int &partNum) const;
 
@@ -233,9 +256,25 @@ protected:
     // pointer to module for sending ui messages
     const coModule *module_;
 
+    const char *mapData_;
+    size_t mapSize_;
+    size_t pos_;
+
+    const PartList *connPL_;
+
 private:
     string name_;
 
+    bool ownsMap_;
+#ifdef _WIN32
+    void *mapFile_;
+    void *mapping_;
+#else
+    int mapFd_;
+#endif
+
     void getIntArrHelper(const int &n, int *iarr = NULL);
+
+    size_t readRaw(void *dst, const size_t &len);
 };
 #endif
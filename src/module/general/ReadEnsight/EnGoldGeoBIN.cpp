@@ -23,10 +23,15 @@
 #include "EnGoldGeoBIN.h"
 #include "GeoFileAsc.h"
 #include <api/coModule.h>
+#include <config/CoviseConfig.h>
 #include <util/byteswap.h>
 
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define DEBUG
 
 //
@@ -70,6 +75,10 @@ EnGoldGeoBIN::EnGoldGeoBIN(const coModule *mod, const string &name, EnFile::BinT
     else
         cerr << className_ << "::EnGoldGeoBIN(..) open NOT successful" << endl;
 
+    // parts of a mapped file are decoded concurrently in read()
+    if (isOpen_ && coCoviseConfig::isOn("Module.ReadEnsight.MemoryMap", true))
+        mapFile(name);
+
     //byteSwap_ =  machineIsLittleEndian();
     byteSwap_ = false;
 
@@ -80,6 +89,31 @@ EnGoldGeoBIN::EnGoldGeoBIN(const coModule *mod, const string &name, EnFile::BinT
 #endif
 }
 
+EnGoldGeoBIN::EnGoldGeoBIN(const EnGoldGeoBIN &master, const PartOffset &part, PartList *pl)
+    : EnFile(master.module_, master.binType_)
+    , lineCnt_(0)
+    , numCoords_(0)
+    , indexMap_(NULL)
+    , maxIndex_(0)
+    , lastNc_(0)
+    , globalCoordIndexOffset_(0)
+    , actPartNumber_(part.partNum)
+    , currElementIdx_(0)
+    , currCornerIdx_(0)
+    , partFound(false)
+{
+    className_ = string("EnGoldGeoBIN");
+    shareMap(master, part.offset);
+    isOpen_ = true;
+    byteSwap_ = part.byteSwap;
+    nodeId_ = master.nodeId_;
+    elementId_ = master.elementId_;
+    includePolyeder_ = master.includePolyeder_;
+    dataByteSwap_ = master.dataByteSwap_;
+    connPL_ = master.connPL_;
+    partList_ = pl;
+}
+
 //
 // thats the gereral read method
 //
@@ -97,6 +131,12 @@ EnGoldGeoBIN::read()
     // allocate memory for coords, connectivities...
     //allocateMemory();
 
+    if (isMapped())
+    {
+        readParallel();
+        return;
+    }
+
     int allPartsToRead(0);
     if (!masterPL_.empty())
     {
@@ -117,19 +157,13 @@ EnGoldGeoBIN::read()
     PartList::iterator it(masterPL_.begin());
     for (; it != masterPL_.end(); it++)
     {
+        decodePart(it->isActive());
         if (it->isActive())
         {
-            EnPart part;
-            readPart(part);
-            readPartConn(part);
             sprintf(buf, "read part#%d :  %d of %d", it->getPartNum(), cnt, allPartsToRead);
             module_->sendInfo("%s", buf);
             cnt++;
         }
-        else
-        {
-            skipPart();
-        }
         globalCoordIndexOffset_ = numCoords_;
     }
 
@@ -139,6 +173,142 @@ EnGoldGeoBIN::read()
     return;
 }
 
+void
+EnGoldGeoBIN::decodePart(const bool &active)
+{
+    if (!active)
+    {
+        skipPart();
+        return;
+    }
+
+    EnPart part;
+    readPart(part);
+    if (connPL_ != NULL)
+    {
+        // change_coords_only: reuse the connectivity of the first timestep
+        for (size_t i = 0; i < connPL_->size(); ++i)
+        {
+            const EnPart &conn = (*connPL_)[i];
+            if (conn.getPartNum() == part.getPartNum() && const_cast<EnPart &>(conn).numCoords() == part.numCoords())
+            {
+                skipElements(part);
+                part.copyConnectivity(conn);
+                if (partList_ != NULL)
+                    partList_->push_back(part);
+                return;
+            }
+        }
+    }
+    readPartConn(part);
+}
+
+void
+EnGoldGeoBIN::indexParts(vector<PartOffset> &index)
+{
+    while (!eof())
+    {
+        PartOffset part;
+        part.offset = tell();
+        part.byteSwap = byteSwap_;
+        string tmp(getStr());
+        if (tmp.find("part") != string::npos)
+        {
+            part.partNum = getInt();
+            if (part.partNum > 10000 || part.partNum < 0)
+            {
+                byteSwap_ = !byteSwap_;
+                byteSwap(part.partNum);
+            }
+            index.push_back(part);
+
+            // description line
+            getStr();
+            string coordTok(getStr());
+            if (coordTok.find("coordinates") != string::npos)
+            {
+                int numCoords = getInt();
+                if (nodeId_ == GIVEN)
+                    skipInt(numCoords);
+                skipFloat(numCoords);
+                skipFloat(numCoords);
+                skipFloat(numCoords);
+            }
+            continue;
+        }
+
+        EnElement elem(strip(tmp));
+        if (elem.valid())
+        {
+            int numElements = getInt();
+            if (elementId_ == GIVEN)
+                skipInt(numElements);
+            if (elem.getEnTypeStr() == "nfaced")
+            {
+                int numFaces = 0;
+                int numNodes = 0;
+                for (int i = 0; i < numElements; i++)
+                    numFaces += getInt();
+                for (int i = 0; i < numFaces; i++)
+                    numNodes += getInt();
+                skipInt(numNodes);
+            }
+            else if (elem.getEnTypeStr() == "nsided")
+            {
+                int numPoints = 0;
+                for (int i = 0; i < numElements; i++)
+                    numPoints += getInt();
+                skipInt(numPoints);
+            }
+            else
+            {
+                skipInt(elem.getNumberOfCorners() * numElements);
+            }
+        }
+    }
+}
+
+void
+EnGoldGeoBIN::readParallel()
+{
+    // scanning the file for the part offsets is cheap compared to decoding,
+    // only headers and element counts are touched
+    vector<PartOffset> index;
+    indexParts(index);
+
+    int numParts = (int)std::min(index.size(), masterPL_.size());
+    if (numParts < (int)masterPL_.size())
+        cerr << className_ << "::readParallel() found only " << numParts << " of " << masterPL_.size() << " parts" << endl;
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = coCoviseConfig::getInt("Module.ReadEnsight.Threads", omp_get_num_procs());
+    if (numThreads < 1)
+        numThreads = 1;
+#endif
+
+    // every part is decoded into its own list by a decoder with a private
+    // file position, the results are appended in file order
+    vector<PartList> results(numParts);
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads)
+    for (int i = 0; i < numParts; ++i)
+    {
+        EnGoldGeoBIN decoder(*this, index[i], &results[i]);
+        decoder.decodePart(masterPL_[i].isActive());
+    }
+
+    int cnt = 0;
+    for (int i = 0; i < numParts; ++i)
+    {
+        if (masterPL_[i].isActive())
+            cnt++;
+        if (partList_ != NULL)
+            partList_->insert(partList_->end(), results[i].begin(), results[i].end());
+    }
+
+    module_->sendInfo("done reading parts  %d parts read with %d threads", cnt, numThreads);
+}
+
 // get Bounding Box section in ENSIGHT GOLD (only)
 int
 EnGoldGeoBIN::readBB()
@@ -157,19 +327,11 @@ EnGoldGeoBIN::readBB()
         {
             if (binType_ == EnFile::FBIN)
             {
-#ifdef WIN32
-                _fseeki64(in_, -88, SEEK_CUR); // 4 + 80 + 4
-#else
-                fseek(in_, -88, SEEK_CUR); // 4 + 80 + 4
-#endif
+                seekCur(-88); // 4 + 80 + 4
             }
             else
             {
-#ifdef WIN32
-                _fseeki64(in_, -80, SEEK_CUR);
-#else
-                fseek(in_, -80, SEEK_CUR);
-#endif
+                seekCur(-80);
             }
         }
     }
@@ -288,6 +450,7 @@ EnGoldGeoBIN::readPart(EnPart &actPart)
             {
                 if (line.find("block") != string::npos)
                 {
+#pragma omp critical(ensight_info)
                     module_->sendInfo("%s", "found structured part - not implemented yet -");
                     return -1;
                 }
@@ -395,7 +558,7 @@ EnGoldGeoBIN::readPartConn(EnPart &actPart)
     // we don't know a priori how many Ensight elements we can expect here therefore we have to read
     // until we find a new 'part'
     lastNc_ = 0;
-    while ((!feof(in_)) && (!partFound))
+    while ((!eof()) && (!partFound))
     {
         string tmp(getStr());
         if (tmp.find("part") != string::npos)
@@ -642,6 +805,7 @@ EnGoldGeoBIN::readPartConn(EnPart &actPart)
     }
 
     if (degCells > 0)
+#pragma omp critical(ensight_info)
     {
         cerr << " WRONG ELEMENT STATISTICS" << endl;
         cerr << "-------------------------------------------" << endl;
@@ -665,6 +829,7 @@ EnGoldGeoBIN::readPartConn(EnPart &actPart)
 //
 EnGoldGeoBIN::~EnGoldGeoBIN()
 {
+    delete[] indexMap_;
 }
 
 //
@@ -684,7 +849,7 @@ EnGoldGeoBIN::parseForParts()
 
     int cnt = 0;
     bool validElementFound = false;
-    while (!feof(in_))
+    while (!eof())
     {
         string tmp(getStr());
         int actPartNr;
@@ -942,38 +1107,35 @@ EnGoldGeoBIN::skipPart()
             }
         }
     }
-    // scan for element type
+    skipElements(actPart);
+    if (partList_ != NULL)
+        partList_->push_back(actPart);
 
-    while (!feof(in_))
+    return 0;
+}
+
+void
+EnGoldGeoBIN::skipElements(EnPart &part)
+{
+    while (!eof())
     {
         string tmp(getStr());
 
         // scan for part token
-        // int id = tmp.find("part");
-        id = tmp.find("part");
+        size_t id = tmp.find("part");
         // part found - rewind one line and exit
         if (id != string::npos)
         {
-            if (partList_ != NULL)
-                partList_->push_back(actPart);
             if (binType_ == EnFile::FBIN)
             {
-#ifdef WIN32
-                _fseeki64(in_, -88L, SEEK_CUR);
-#else
-                fseek(in_, -88L, SEEK_CUR);
-#endif
+                seekCur(-88);
             }
             else
             {
-#ifdef WIN32
-                _fseeki64(in_, -80L, SEEK_CUR);
-#else
-                fseek(in_, -80L, SEEK_CUR);
-#endif
+                seekCur(-80);
             }
             partFound = false; // read part string again next time;
-            return 0;
+            return;
         }
 
         string elementType(strip(tmp));
@@ -1009,14 +1171,9 @@ EnGoldGeoBIN::skipPart()
             {
                 skipInt(elem.getNumberOfCorners() * numElements);
             }
-            actPart.addElement(elem, numElements);
+            part.addElement(elem, numElements);
         } // if( elem.valid() )
     }
-
-    if (partList_ != NULL)
-        partList_->push_back(actPart);
-
-    return 0;
 }
 
 void
@@ -44,6 +44,26 @@ public:
     ~EnGoldGeoBIN();
 
 private:
+    // position of a part in a memory mapped file
+    struct PartOffset
+    {
+        size_t offset;
+        bool byteSwap;
+        int partNum;
+    };
+
+    // decoder for a single part sharing the mapping of master
+    EnGoldGeoBIN(const EnGoldGeoBIN &master, const PartOffset &part, PartList *pl);
+
+    // find the start of all parts from the current position
+    void indexParts(vector<PartOffset> &index);
+
+    // decode all parts of a memory mapped file concurrently
+    void readParallel();
+
+    // read (active) or skip the next part
+    void decodePart(const bool &active);
+
     int allocateMemory();
 
     // read header
@@ -61,6 +81,9 @@ private:
     // skip part
     int skipPart();
 
+    // skip the element sections of the current part, element types are added to part
+    void skipElements(EnPart &part);
+
     // redundant find a slution must go into base-class
     void fillIndexMap(const int &i, const int &natIdx);
 
@@ -21,6 +21,7 @@
 
 #include "EnPart.h"
 #include <numeric>
+#include <algorithm>
 
 EnPart::EnPart()
     : arr1_(NULL)
@@ -507,6 +508,48 @@ EnPart::setNumConnRead3d(const int &n)
     numConnRead3d_ = n;
 }
 
+static int *
+copyArr(const int *src, const uint64_t &n)
+{
+    if (src == NULL)
+        return NULL;
+    int *dst = new int[n];
+    std::copy(src, src + n, dst);
+    return dst;
+}
+
+void
+EnPart::copyConnectivity(const EnPart &p)
+{
+    if (this == &p)
+        return;
+
+    delete[] el2d_;
+    delete[] cl2d_;
+    delete[] tl2d_;
+    delete[] el3d_;
+    delete[] cl3d_;
+    delete[] tl3d_;
+
+    numEleRead2d_ = p.numEleRead2d_;
+    numConnRead2d_ = p.numConnRead2d_;
+    numEleRead3d_ = p.numEleRead3d_;
+    numConnRead3d_ = p.numConnRead3d_;
+
+    el2d_ = copyArr(p.el2d_, numEleRead2d_);
+    tl2d_ = copyArr(p.tl2d_, numEleRead2d_);
+    cl2d_ = copyArr(p.cl2d_, numConnRead2d_);
+    el3d_ = copyArr(p.el3d_, numEleRead3d_);
+    tl3d_ = copyArr(p.tl3d_, numEleRead3d_);
+    cl3d_ = copyArr(p.cl3d_, numConnRead3d_);
+
+    elementList_ = p.elementList_;
+    numList_ = p.numList_;
+    numList2d_ = p.numList2d_;
+    numList3d_ = p.numList3d_;
+    empty_ = p.empty_;
+}
+
 void
 EnPart::clearFields()
 {
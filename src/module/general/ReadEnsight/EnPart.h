@@ -113,6 +113,10 @@ public:
     // delete all fields (see below) and reset pointers to NULL
     void clearFields();
 
+    // replace the connectivity of *this by a deep copy of the element,
+    // type and connectivity arrays and the element lists of p
+    void copyConnectivity(const EnPart &p);
+
     // these pointers have to be used with care
     float *arr1_, *arr2_, *arr3_;
     float *d2dx_, *d2dy_, *d2dz_;
@@ -26,6 +26,7 @@
 #include <do/coDoUnstructuredGrid.h>
 #include <util/coRestraint.h>
 #include <util/covise_regexp.h>
+#include <util/coWristWatch.h>
 #include <alg/coCellToVert.h>
 
 #include "ReadEnsight.h"
@@ -381,6 +382,13 @@ ReadEnsight::readGeometry(const int &portTok2d, const int &portTok3d)
     if (numTs == 0)
         allGeoFiles.push_back(case_.getGeoFileNm());
 
+    // gold binary geometry with change_coords_only: read the connectivity only once
+    bool reuseConn = case_.changeCoordsOnly() && (case_.getVersion() == CaseFile::gold);
+    coWristWatch watch;
+    for (size_t i = 0; i < connPL_.size(); ++i)
+        connPL_[i].clearFields();
+    connPL_.clear();
+
     // read all files
     int cnt(0);
     for (ii = allGeoFiles.begin(); ii != allGeoFiles.end(); ii++)
@@ -411,6 +419,8 @@ ReadEnsight::readGeometry(const int &portTok2d, const int &portTok3d)
         enf->setPartList(pl);
         enf->setMasterPL(masterPL_);
         enf->setActiveAlloc((cnt != 0));
+        if (reuseConn && (cnt > 0) && !connPL_.empty())
+            enf->setConnectivityPL(&connPL_);
 
         if (!enf->isOpen())
         {
@@ -427,6 +437,17 @@ ReadEnsight::readGeometry(const int &portTok2d, const int &portTok3d)
 
         globalParts_.push_back(*pl);
 
+        if (reuseConn && (cnt == 0) && (binType_ != EnFile::NOBIN))
+        {
+            for (size_t i = 0; i < pl->size(); ++i)
+            {
+                EnPart conn((*pl)[i].getPartNum());
+                conn.setNumCoords((*pl)[i].numCoords());
+                conn.copyConnectivity((*pl)[i]);
+                connPL_.push_back(conn);
+            }
+        }
+
         delete enf;
 
         // create DO's
@@ -442,6 +463,12 @@ ReadEnsight::readGeometry(const int &portTok2d, const int &portTok3d)
         ++cnt;
     }
 
+    for (size_t i = 0; i < connPL_.size(); ++i)
+        connPL_[i].clearFields();
+    connPL_.clear();
+
+    coModule::sendInfo(" read %d geometry files in %.2f s", cnt, watch.elapsed());
+
     // we have no timesteps - feed objectsXY[0] to outports
     if (realNumTs <= 1)
     {
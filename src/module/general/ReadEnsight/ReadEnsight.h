@@ -149,6 +149,10 @@ private:
 
     PartList masterPL_;
 
+    // connectivity of the first geometry file if the case file has
+    // change_coords_only, Reducer works on the arrays in place
+    PartList connPL_;
+
     coDistributedObject *geoObj_;
     coDistributedObject *geoObjs_[3];
 };
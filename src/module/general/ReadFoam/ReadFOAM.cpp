@@ -25,6 +25,8 @@
 #include <do/coDoSet.h>
 #include <util/coFileUtil.h>
 #include <util/coRestraint.h>
+#include <util/coWristWatch.h>
+#include <config/CoviseConfig.h>
 
 #include <sstream>
 #include <fstream>
@@ -41,11 +43,20 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <algorithm>
 
 #include <boost/shared_ptr.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ReadFOAM::ReadFOAM(int argc, char *argv[]) //Constructor
     : coModule(argc, argv, "Read FOAM Data") // description in the module setup window
+    , m_numThreads(1)
+    , m_filesRead(0)
+    , m_bytesRead(0.)
+    , m_readTime(0.)
 {
     //Set Number of Data Ports here. Default=3
     num_ports = 3;
@@ -205,7 +216,7 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
         }
         coModule::sendInfo("Listing Boundary Patches!");
         Boundaries bounds = loadBoundary(meshdir.str());
-        for (int i = 0; i < bounds.boundaries.size(); ++i)
+        for (int i = 0; i < (int)bounds.boundaries.size(); ++i)
         {
             std::stringstream info;
             info << bounds.boundaries[i].index << " ## " << bounds.boundaries[i].name;
@@ -221,7 +232,7 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
         {
             std::string lastSelection = lastDataPortSelection[i];
             int last = 0;
-            for (int j = 0; j < choiceVal.size(); ++j)
+            for (int j = 0; j < (int)choiceVal.size(); ++j)
             {
                 if (strcmp(lastSelection.c_str(), choiceVal[j]) == 0)
                 {
@@ -235,7 +246,7 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
         {
             std::string lastSelection = lastBoundaryPortSelection[i];
             int last = 0;
-            for (int j = 0; j < choiceVal.size(); ++j)
+            for (int j = 0; j < (int)choiceVal.size(); ++j)
             {
                 if (strcmp(lastSelection.c_str(), choiceVal[j]) == 0)
                 {
@@ -285,7 +296,7 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
             {
                 std::string lastSelection = lastDataPortSelection[i];
                 int last = 0;
-                for (int j = 0; j < choiceVal.size(); ++j)
+                for (int j = 0; j < (int)choiceVal.size(); ++j)
                 {
                     if (strcmp(lastSelection.c_str(), choiceVal[j]) == 0)
                     {
@@ -300,7 +311,7 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
             {
                 std::string lastSelection = lastBoundaryPortSelection[i];
                 int last = 0;
-                for (int j = 0; j < choiceVal.size(); ++j)
+                for (int j = 0; j < (int)choiceVal.size(); ++j)
                 {
                     if (strcmp(lastSelection.c_str(), choiceVal[j]) == 0)
                     {
@@ -314,287 +325,321 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
     }
 }
 
-coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
-                                         const std::string &pointsdir,
-                                         const std::string &meshObjName,
-                                         const index_t Processor)
+void ReadFOAM::countFile(const std::string &dir, const std::string &basename)
 {
-    DimensionInfo dim = readDimensions(meshdir);
-    coDoUnstructuredGrid *meshObj;
-    index_t *el, *cl, *tl; // element list, connectivity list, type list
-    float *x_coord, *y_coord, *z_coord; // coordinate lists
+    double bytes = getFileSize(dir, basename);
+#pragma omp atomic
+    m_filesRead += 1;
+#pragma omp atomic
+    m_bytesRead += bytes;
+}
 
-    if (Processor == -1)
+// only reads files and builds the lists, safe to be called from several threads
+bool ReadFOAM::readMesh(const MeshTask &task, MeshData &mesh)
+{
+    const std::string &meshdir = task.meshdir;
+    const std::string &pointsdir = task.pointsdir;
+    mesh.valid = false;
+
+    if (task.copyFrom == -1)
     {
+#ifdef VERBOSE
+        std::cerr << std::time(0) << " Reading mesh from: " << meshdir.c_str() << std::endl;
+#endif
+        DimensionInfo dim = readDimensions(meshdir);
+
+        //std::cerr << std::time(0) << " reading Faces" << std::endl;
+        boost::shared_ptr<std::istream> facesIn = getStreamForFile(meshdir, "faces");
+        if (!facesIn)
+            return false;
+        countFile(meshdir, "faces");
+        HeaderInfo facesH = readFoamHeader(*facesIn);
+        std::vector<std::vector<index_t> > faces(facesH.lines);
+        readIndexListArray(facesH, *facesIn, faces.data(), faces.size());
+
+        //std::cerr << std::time(0) << " reading Owners" << std::endl;
+        boost::shared_ptr<std::istream> ownersIn = getStreamForFile(meshdir, "owner");
+        if (!ownersIn)
+            return false;
+        countFile(meshdir, "owner");
+        HeaderInfo ownerH = readFoamHeader(*ownersIn);
+        std::vector<index_t> owners(ownerH.lines);
+        readIndexArray(ownerH, *ownersIn, owners.data(), owners.size());
+
+        //std::cerr << std::time(0) << " reading neighbours" << std::endl;
+        boost::shared_ptr<std::istream> neighborsIn = getStreamForFile(meshdir, "neighbour");
+        if (!neighborsIn)
+            return false;
+        countFile(meshdir, "neighbour");
+        HeaderInfo neighbourH = readFoamHeader(*neighborsIn);
+        if (neighbourH.lines != dim.internalFaces)
+        {
+            std::cerr << "inconsistency: #internalFaces != #neighbours" << std::endl;
+        }
+        std::vector<index_t> neighbours(neighbourH.lines);
+        readIndexArray(neighbourH, *neighborsIn, neighbours.data(), neighbours.size());
+
+        //mesh
+        //std::cerr << std::time(0) << " creating cellToFace Mapping" << std::endl;
+        std::vector<std::vector<index_t> > cellfacemap(dim.cells);
+        for (index_t face = 0; face < (index_t)owners.size(); ++face)
+        {
+            cellfacemap[owners[face]].push_back(face);
+        }
+
+        for (index_t face = 0; face < (index_t)neighbours.size(); ++face)
         {
-            std::cerr << std::time(0) << " Reading mesh from: " << meshdir.c_str() << std::endl;
-
-            boost::shared_ptr<std::istream> pointsSizeIn = getStreamForFile(pointsdir, "points");
-            if (!pointsSizeIn)
-                return NULL;
-            HeaderInfo pointsSizeH = readFoamHeader(*pointsSizeIn);
-            int num_points = pointsSizeH.lines;
-
-            //std::cerr << std::time(0) << " reading Faces" << std::endl;
-            boost::shared_ptr<std::istream> facesIn = getStreamForFile(meshdir, "faces");
-            if (!facesIn)
-                return NULL;
-            HeaderInfo facesH = readFoamHeader(*facesIn);
-            std::vector<std::vector<index_t> > faces(facesH.lines);
-            readIndexListArray(facesH, *facesIn, faces.data(), faces.size());
-
-            //std::cerr << std::time(0) << " reading Owners" << std::endl;
-            boost::shared_ptr<std::istream> ownersIn = getStreamForFile(meshdir, "owner");
-            if (!ownersIn)
-                return NULL;
-            HeaderInfo ownerH = readFoamHeader(*ownersIn);
-            std::vector<index_t> owners(ownerH.lines);
-            readIndexArray(ownerH, *ownersIn, owners.data(), owners.size());
-
-            //std::cerr << std::time(0) << " reading neighbours" << std::endl;
-            boost::shared_ptr<std::istream> neighborsIn = getStreamForFile(meshdir, "neighbour");
-            if (!neighborsIn)
-                return NULL;
-            HeaderInfo neighbourH = readFoamHeader(*neighborsIn);
-            if (neighbourH.lines != dim.internalFaces)
+            cellfacemap[neighbours[face]].push_back(face);
+        }
+
+        //std::cerr << std::time(0) << " Adding up connectivities" << std::endl;
+        index_t num_elem = dim.cells;
+        std::vector<index_t> &types = mesh.tl;
+        types.assign(num_elem, 0);
+        index_t num_conn = 0;
+        index_t num_hex = 0, num_tet = 0, num_prism = 0, num_pyr = 0, num_poly = 0;
+        //Check Shape of Cells and add fill Type_List
+        for (index_t i = 0; i < num_elem; i++)
+        {
+            const std::vector<index_t> &cellfaces = cellfacemap[i];
+            const std::vector<index_t> cellvertices = getVerticesForCell(cellfaces, faces);
+            bool onlySimpleFaces = true; //Simple Face = Triangle or Square
+            for (index_t j = 0; j < (index_t)cellfaces.size(); ++j)
+            { //check if Cell has only Triangular and/or Square Faces
+                if (faces[cellfaces[j]].size() < 3 || faces[cellfaces[j]].size() > 4)
+                {
+                    onlySimpleFaces = false;
+                    break;
+                }
+            }
+            const index_t num_faces = cellfaces.size();
+            index_t num_verts = cellvertices.size();
+            if (num_faces == 6 && num_verts == 8 && onlySimpleFaces)
             {
-                std::cerr << "inconsistency: #internalFaces != #neighbours" << std::endl;
+                types[i] = TYPE_HEXAEDER;
+                ++num_hex;
             }
-            std::vector<index_t> neighbours(neighbourH.lines);
-            readIndexArray(neighbourH, *neighborsIn, neighbours.data(), neighbours.size());
-
-            //mesh
-            //std::cerr << std::time(0) << " creating cellToFace Mapping" << std::endl;
-            std::vector<std::vector<index_t> > cellfacemap(dim.cells);
-            for (index_t face = 0; face < owners.size(); ++face)
+            else if (num_faces == 5 && num_verts == 6 && onlySimpleFaces)
             {
-                cellfacemap[owners[face]].push_back(face);
+                types[i] = TYPE_PRISM;
+                ++num_prism;
             }
-
-            for (index_t face = 0; face < neighbours.size(); ++face)
+            else if (num_faces == 5 && num_verts == 5 && onlySimpleFaces)
             {
-                cellfacemap[neighbours[face]].push_back(face);
+                types[i] = TYPE_PYRAMID;
+                ++num_pyr;
             }
-
-            //std::cerr << std::time(0) << " Adding up connectivities" << std::endl;
-            index_t num_elem = dim.cells;
-            std::vector<index_t> types(num_elem, 0);
-            index_t num_conn = 0;
-            index_t num_hex = 0, num_tet = 0, num_prism = 0, num_pyr = 0, num_poly = 0;
-            //Check Shape of Cells and add fill Type_List
-            for (index_t i = 0; i < num_elem; i++)
+            else if (num_faces == 4 && num_verts == 4 && onlySimpleFaces)
             {
-                const std::vector<index_t> &cellfaces = cellfacemap[i];
-                const std::vector<index_t> cellvertices = getVerticesForCell(cellfaces, faces);
-                bool onlySimpleFaces = true; //Simple Face = Triangle or Square
-                for (index_t j = 0; j < cellfaces.size(); ++j)
-                { //check if Cell has only Triangular and/or Square Faces
-                    if (faces[cellfaces[j]].size() < 3 || faces[cellfaces[j]].size() > 4)
-                    {
-                        onlySimpleFaces = false;
-                        break;
-                    }
-                }
-                const index_t num_faces = cellfaces.size();
-                index_t num_verts = cellvertices.size();
-                if (num_faces == 6 && num_verts == 8 && onlySimpleFaces)
-                {
-                    types[i] = TYPE_HEXAEDER;
-                    ++num_hex;
-                }
-                else if (num_faces == 5 && num_verts == 6 && onlySimpleFaces)
-                {
-                    types[i] = TYPE_PRISM;
-                    ++num_prism;
-                }
-                else if (num_faces == 5 && num_verts == 5 && onlySimpleFaces)
-                {
-                    types[i] = TYPE_PYRAMID;
-                    ++num_pyr;
-                }
-                else if (num_faces == 4 && num_verts == 4 && onlySimpleFaces)
+                types[i] = TYPE_TETRAHEDER;
+                ++num_tet;
+            }
+            else
+            {
+                ++num_poly;
+                types[i] = TYPE_POLYHEDRON;
+                num_verts = 0;
+                for (index_t j = 0; j < (index_t)cellfaces.size(); ++j)
                 {
-                    types[i] = TYPE_TETRAHEDER;
-                    ++num_tet;
+                    num_verts += faces[cellfaces[j]].size() + 1;
                 }
-                else
-                {
-                    ++num_poly;
-                    types[i] = TYPE_POLYHEDRON;
-                    num_verts = 0;
-                    for (index_t j = 0; j < cellfaces.size(); ++j)
-                    {
-                        num_verts += faces[cellfaces[j]].size() + 1;
-                    }
-                }
-                num_conn += num_verts;
             }
+            num_conn += num_verts;
+        }
 
-            //Create the unstructured grid
-            meshObj = new coDoUnstructuredGrid(meshObjName.c_str(), num_elem, num_conn, num_points, 1);
-
-            // get pointers to the first element of the element, vertex and coordinate lists
-            meshObj->getAddresses(&el, &cl, &x_coord, &y_coord, &z_coord);
-            // get a pointer to the type list
-            meshObj->getTypeList(&tl);
+        mesh.el.resize(num_elem);
+        mesh.cl.reserve(num_conn);
 
-            //std::cerr << std::time(0) << " Setting element list and connectivity list" << std::endl;
-            // save data cell by cell to element, connectivity and type list
-            index_t conncount = 0;
-            std::vector<index_t> connectivities;
-            //go cell by cell (element by element)
-            for (index_t i = 0; i < dim.cells; i++)
+        //std::cerr << std::time(0) << " Setting element list and connectivity list" << std::endl;
+        // save data cell by cell to element, connectivity and type list
+        index_t conncount = 0;
+        std::vector<index_t> connectivities;
+        //go cell by cell (element by element)
+        for (index_t i = 0; i < dim.cells; i++)
+        {
+            //element list
+            mesh.el[i] = conncount;
+            //connectivity list
+            const std::vector<index_t> &cellfaces = cellfacemap[i]; //get all faces of current cell
+            //IF cell is Hexahedron
+            if (types[i] == TYPE_HEXAEDER)
             {
-                //element list
-                *el = conncount;
-                ++el;
-                //connectivity list
-                const std::vector<index_t> &cellfaces = cellfacemap[i]; //get all faces of current cell
-                //IF cell is Hexahedron
-                if (types[i] == TYPE_HEXAEDER)
-                {
-                    index_t ia = cellfaces[0]; //Pick the first face in the Vector as Starting Face (all faces are squares)
-                    std::vector<index_t> a = faces[ia]; //find face that corresponds to index ia
+                index_t ia = cellfaces[0]; //Pick the first face in the Vector as Starting Face (all faces are squares)
+                std::vector<index_t> a = faces[ia]; //find face that corresponds to index ia
 
-                    bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-                    if (na == false)
-                    { //if normal vector is not pointing inwards
-                        std::reverse(a.begin(), a.end()); //reverse the ordering of the Vertices
-                    }
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
+                { //if normal vector is not pointing inwards
+                    std::reverse(a.begin(), a.end()); //reverse the ordering of the Vertices
+                }
 
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[3], ia, cellfaces, faces));
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[3], ia, cellfaces, faces));
 
-                    conncount += 8;
+                conncount += 8;
+            }
+
+            if (types[i] == TYPE_PRISM)
+            {
+                index_t it = 1;
+                index_t ia = cellfaces[0];
+                while (faces[ia].size() > 3)
+                { //find triangular face and use it as starting face
+                    ia = cellfaces[it++];
                 }
 
-                if (types[i] == TYPE_PRISM)
+                std::vector<index_t> a = faces[ia];
+
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
                 {
-                    index_t it = 1;
-                    index_t ia = cellfaces[0];
-                    while (faces[ia].size() > 3)
-                    { //find triangular face and use it as starting face
-                        ia = cellfaces[it++];
-                    }
+                    std::reverse(a.begin(), a.end());
+                }
 
-                    std::vector<index_t> a = faces[ia];
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
 
-                    bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-                    if (na == false)
-                    {
-                        std::reverse(a.begin(), a.end());
-                    }
-
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
+                conncount += 6;
+            }
 
-                    conncount += 6;
+            if (types[i] == TYPE_PYRAMID)
+            {
+                index_t it = 1;
+                index_t ia = cellfaces[0];
+                while (faces[ia].size() < 4)
+                { //find the square and use it as starting face
+                    ia = cellfaces[it++];
                 }
 
-                if (types[i] == TYPE_PYRAMID)
+                std::vector<index_t> a = faces[ia];
+
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
                 {
-                    index_t it = 1;
-                    index_t ia = cellfaces[0];
-                    while (faces[ia].size() < 4)
-                    { //find the square and use it as starting face
-                        ia = cellfaces[it++];
-                    }
+                    std::reverse(a.begin(), a.end());
+                }
 
-                    std::vector<index_t> a = faces[ia];
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
 
-                    bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-                    if (na == false)
-                    {
-                        std::reverse(a.begin(), a.end());
-                    }
+                conncount += 5;
+            }
 
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+            if (types[i] == TYPE_TETRAHEDER)
+            {
+                index_t ia = cellfaces[0]; //use first face in vector as starting face (all faces are triangles)
+                std::vector<index_t> a = faces[ia];
 
-                    conncount += 5;
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
+                {
+                    std::reverse(a.begin(), a.end());
                 }
 
-                if (types[i] == TYPE_TETRAHEDER)
-                {
-                    index_t ia = cellfaces[0]; //use first face in vector as starting face (all faces are triangles)
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+
+                conncount += 4;
+            }
+
+            if (types[i] == TYPE_POLYHEDRON)
+            {
+                index_t kk;
+                for (index_t j = 0; j < (index_t)cellfaces.size(); j++)
+                { //go through all faces in order
+                    index_t ia = cellfaces[j];
                     std::vector<index_t> a = faces[ia];
 
                     bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+
                     if (na == false)
                     {
                         std::reverse(a.begin(), a.end());
                     }
-
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
-
-                    conncount += 4;
-                }
-
-                if (types[i] == TYPE_POLYHEDRON)
-                {
-                    index_t kk;
-                    for (index_t j = 0; j < cellfaces.size(); j++)
-                    { //go through all faces in order
-                        index_t ia = cellfaces[j];
-                        std::vector<index_t> a = faces[ia];
-
-                        bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-
-                        if (na == false)
+                    for (index_t k = 0; k < (index_t)a.size() + 1; k++)
+                    { //go through the vertices of the current face in order
+                        if (k == (index_t)a.size())
                         {
-                            std::reverse(a.begin(), a.end());
-                        }
-                        for (index_t k = 0; k < a.size() + 1; k++)
-                        { //go through the vertices of the current face in order
-                            if (k == a.size())
-                            {
-                                kk = 0;
-                            }
-                            else
-                            {
-                                kk = k;
-                            } //the first point has to appear again at the end
-                            connectivities.push_back(a[kk]);
-                            conncount++;
+                            kk = 0;
                         }
+                        else
+                        {
+                            kk = k;
+                        } //the first point has to appear again at the end
+                        connectivities.push_back(a[kk]);
+                        conncount++;
                     }
                 }
+            }
 
-                for (index_t j = 0; j < connectivities.size(); j++)
-                { //add connectivities of the current element to the connectivity List
-                    *cl = connectivities[j];
-                    ++cl;
-                }
-                // add the type of the current element the type lists
-                *tl++ = types[i];
+            //add connectivities of the current element to the connectivity List
+            mesh.cl.insert(mesh.cl.end(), connectivities.begin(), connectivities.end());
 
-                connectivities.clear();
-            }
+            connectivities.clear();
         }
+        // the grid is allocated with the number of connectivities counted above
+        mesh.cl.resize(num_conn, 0);
+    }
 
-        // save coordinates to coordinate lists
-        std::cerr << std::time(0) << " Reading points from: " << pointsdir.c_str() << std::endl;
-        boost::shared_ptr<std::istream> pointsIn = getStreamForFile(pointsdir, "points");
-        if (!pointsIn)
-            return NULL;
-        HeaderInfo pointsH = readFoamHeader(*pointsIn);
-        //      if (pointsH.lines != dim.points) {
-        //         std::cerr << std::time(0) << " inconsistency: #Number of points in points-file != #points declared in owner header" << std::endl;
-        //      }
+    // save coordinates to coordinate lists
+#ifdef VERBOSE
+    std::cerr << std::time(0) << " Reading points from: " << pointsdir.c_str() << std::endl;
+#endif
+    boost::shared_ptr<std::istream> pointsIn = getStreamForFile(pointsdir, "points");
+    if (!pointsIn)
+        return false;
+    countFile(pointsdir, "points");
+    HeaderInfo pointsH = readFoamHeader(*pointsIn);
+    //      if (pointsH.lines != dim.points) {
+    //         std::cerr << std::time(0) << " inconsistency: #Number of points in points-file != #points declared in owner header" << std::endl;
+    //      }
+    mesh.x.resize(pointsH.lines);
+    mesh.y.resize(pointsH.lines);
+    mesh.z.resize(pointsH.lines);
+
+    //std::cerr << std::time(0) << " reading Points" << std::endl;
+    readFloatVectorArray(pointsH, *pointsIn, mesh.x.data(), mesh.y.data(), mesh.z.data(), pointsH.lines);
+
+    mesh.valid = true;
+    return true;
+}
+
+// creates the shared memory object, must be called from the main thread
+coDoUnstructuredGrid *ReadFOAM::createMesh(const MeshTask &task, const MeshData &mesh)
+{
+    if (!mesh.valid)
+        return NULL;
 
-        //std::cerr << std::time(0) << " reading Points" << std::endl;
-        readFloatVectorArray(pointsH, *pointsIn, x_coord, y_coord, z_coord, pointsH.lines);
+    coDoUnstructuredGrid *meshObj;
+    index_t *el, *cl, *tl; // element list, connectivity list, type list
+    float *x_coord, *y_coord, *z_coord; // coordinate lists
+    index_t num_points = mesh.x.size();
+
+    if (task.copyFrom == -1)
+    {
+        index_t num_elem = mesh.el.size(), num_conn = mesh.cl.size();
+
+        //Create the unstructured grid
+        meshObj = new coDoUnstructuredGrid(task.objName.c_str(), num_elem, num_conn, num_points, 1);
+
+        // get pointers to the first element of the element, vertex and coordinate lists
+        meshObj->getAddresses(&el, &cl, &x_coord, &y_coord, &z_coord);
+        // get a pointer to the type list
+        meshObj->getTypeList(&tl);
+
+        std::copy(mesh.el.begin(), mesh.el.end(), el);
+        std::copy(mesh.tl.begin(), mesh.tl.end(), tl);
+        std::copy(mesh.cl.begin(), mesh.cl.end(), cl);
     }
     else
     { //if Processor >= 0  ->  Copy everything but the Coordinates from basemeshs[processor]
-        std::cerr << std::time(0) << " copying mesh from first timestep in Processor" << Processor << std::endl;
-        coDoUnstructuredGrid *oldMesh = basemeshs[Processor];
+        std::cerr << std::time(0) << " copying mesh from first timestep in Processor" << task.copyFrom << std::endl;
+        coDoUnstructuredGrid *oldMesh = basemeshs[task.copyFrom];
         index_t num_elem, num_conn, void_points;
         oldMesh->getGridSize(&num_elem, &num_conn, &void_points);
         index_t *oldel, *oldcl, *oldtl;
@@ -602,13 +647,7 @@ coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
         oldMesh->getAddresses(&oldel, &oldcl, &oldx_coord, &oldy_coord, &oldz_coord);
         oldMesh->getTypeList(&oldtl);
 
-        boost::shared_ptr<std::istream> pointsSizeIn = getStreamForFile(pointsdir, "points");
-        if (!pointsSizeIn)
-            return NULL;
-        HeaderInfo pointsSizeH = readFoamHeader(*pointsSizeIn);
-        int num_points = pointsSizeH.lines;
-
-        meshObj = new coDoUnstructuredGrid(meshObjName.c_str(), num_elem, num_conn, num_points, 1);
+        meshObj = new coDoUnstructuredGrid(task.objName.c_str(), num_elem, num_conn, num_points, 1);
         // get pointers to the first element of the element, vertex and coordinate lists
         meshObj->getAddresses(&el, &cl, &x_coord, &y_coord, &z_coord);
         // get a pointer to the type list
@@ -623,18 +662,68 @@ coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
         {
             cl[i] = oldcl[i];
         }
+    }
 
-        // save coordinates to coordinate lists
-        std::cerr << std::time(0) << " Reading points from: " << pointsdir.c_str() << std::endl;
-        boost::shared_ptr<std::istream> pointsIn = getStreamForFile(pointsdir, "points");
-        if (!pointsIn)
-            return NULL;
-        HeaderInfo pointsH = readFoamHeader(*pointsIn);
-        //if (pointsH.lines != dim.points) {
-        //   std::cerr << std::time(0) << " inconsistency: #Number of points in points-file != #points declared in owner header" << std::endl;
-        //}
-        readFloatVectorArray(pointsH, *pointsIn, x_coord, y_coord, z_coord, pointsH.lines);
+    std::copy(mesh.x.begin(), mesh.x.end(), x_coord);
+    std::copy(mesh.y.begin(), mesh.y.end(), y_coord);
+    std::copy(mesh.z.begin(), mesh.z.end(), z_coord);
+
+    if (task.saveAs >= 0)
+    {
+        basemeshs[task.saveAs] = meshObj;
+    }
+
+    return meshObj;
+}
+
+// reads up to 2*m_numThreads meshes concurrently, the objects are created in the order of tasks
+std::vector<coDoUnstructuredGrid *> ReadFOAM::loadMeshes(const std::vector<MeshTask> &tasks)
+{
+    std::vector<coDoUnstructuredGrid *> grids;
+    const size_t batch = 2 * m_numThreads;
+    for (size_t begin = 0; begin < tasks.size(); begin += batch)
+    {
+        const int num = int(std::min(batch, tasks.size() - begin));
+        std::vector<MeshData> data(num);
+
+        coWristWatch watch;
+#pragma omp parallel for schedule(dynamic) num_threads(m_numThreads)
+        for (int i = 0; i < num; ++i)
+        {
+            try
+            {
+                readMesh(tasks[begin + i], data[i]);
+            }
+            catch (std::exception &e)
+            {
+#pragma omp critical
+                std::cerr << "ReadFOAM: reading " << tasks[begin + i].meshdir << " failed: " << e.what() << std::endl;
+                data[i].valid = false;
+            }
+        }
+        m_readTime += watch.elapsed();
+
+        for (int i = 0; i < num; ++i)
+        {
+            grids.push_back(createMesh(tasks[begin + i], data[i]));
+            data[i] = MeshData();
+        }
     }
+    std::cerr << std::time(0) << " done!" << std::endl;
+    return grids;
+}
+
+coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
+                                         const std::string &pointsdir,
+                                         const std::string &meshObjName,
+                                         const index_t Processor)
+{
+    MeshTask task(meshdir, pointsdir, meshObjName, Processor);
+    MeshData mesh;
+    coWristWatch watch;
+    readMesh(task, mesh);
+    m_readTime += watch.elapsed();
+    coDoUnstructuredGrid *meshObj = createMesh(task, mesh);
 
     std::cerr << std::time(0) << " done!" << std::endl;
 
@@ -679,7 +768,7 @@ coDoPolygons *ReadFOAM::loadPatches(const std::string &meshdir,
                 {
                     ++num_polygons;
                     std::vector<index_t> &face = faces[i];
-                    for (index_t j = 0; j < face.size(); ++j)
+                    for (index_t j = 0; j < (index_t)face.size(); ++j)
                     {
                         pointmap[face[j]] += 1; //it does not matter what value is assigned just that the key is created if it was not already
                         num_corners++;
@@ -714,7 +803,7 @@ coDoPolygons *ReadFOAM::loadPatches(const std::string &meshdir,
                     *polygonList = cornercount;
                     ++polygonList;
                     std::vector<index_t> &face = faces[i];
-                    for (index_t j = 0; j < face.size(); j++)
+                    for (index_t j = 0; j < (index_t)face.size(); j++)
                     {
                         *cornerList = pointmap[face[j]];
                         ++cornerList;
@@ -797,21 +886,115 @@ coDoPolygons *ReadFOAM::loadPatches(const std::string &meshdir,
     return polyObj;
 }
 
-coDoVec3 *ReadFOAM::loadVectorField(const std::string &timedir,
-                                    const std::string &file,
-                                    const std::string &vecObjName)
+// only reads the file, safe to be called from several threads
+bool ReadFOAM::readField(const FieldTask &task, FieldData &field)
 {
-    std::cerr << std::time(0) << " Reading VectorField from: " << timedir.c_str() << "//" << file.c_str() << std::endl;
-    boost::shared_ptr<std::istream> vecIn = getStreamForFile(timedir, file);
+    field.valid = false;
+    boost::shared_ptr<std::istream> vecIn = getStreamForFile(task.dir, task.file);
     if (!vecIn)
-        return NULL;
+        return false;
+    countFile(task.dir, task.file);
     HeaderInfo header = readFoamHeader(*vecIn);
+    field.fieldclass = header.fieldclass;
+    if (header.fieldclass == "volVectorField")
+    {
+#ifdef VERBOSE
+        std::cerr << std::time(0) << " Reading VectorField from: " << task.dir.c_str() << "//" << task.file.c_str() << std::endl;
+#endif
+        field.x.resize(header.lines);
+        field.y.resize(header.lines);
+        field.z.resize(header.lines);
+        readFloatVectorArray(header, *vecIn, field.x.data(), field.y.data(), field.z.data(), header.lines);
+    }
+    else if (header.fieldclass == "volScalarField")
+    {
+#ifdef VERBOSE
+        std::cerr << std::time(0) << " Reading ScalarField from: " << task.dir.c_str() << "//" << task.file.c_str() << std::endl;
+#endif
+        field.x.resize(header.lines);
+        readFloatArray(header, *vecIn, field.x.data(), header.lines);
+    }
+    else
+    {
+        return false;
+    }
+    field.valid = true;
+    return true;
+}
 
-    coDoVec3 *vecObj = new coDoVec3(vecObjName.c_str(), header.lines);
-    float *x, *y, *z;
-    vecObj->getAddresses(&x, &y, &z);
+// creates the shared memory object, must be called from the main thread
+coDistributedObject *ReadFOAM::createField(const FieldTask &task, const FieldData &field)
+{
+    if (!field.valid)
+    {
+        std::cerr << "Unknown field type in file: " << task.file << std::endl;
+        return NULL;
+    }
 
-    readFloatVectorArray(header, *vecIn, x, y, z, header.lines);
+    if (field.fieldclass == "volVectorField")
+    {
+        coDoVec3 *vecObj = new coDoVec3(task.objName.c_str(), field.x.size());
+        float *x, *y, *z;
+        vecObj->getAddresses(&x, &y, &z);
+        std::copy(field.x.begin(), field.x.end(), x);
+        std::copy(field.y.begin(), field.y.end(), y);
+        std::copy(field.z.begin(), field.z.end(), z);
+        return vecObj;
+    }
+
+    coDoFloat *vecObj = new coDoFloat(task.objName.c_str(), field.x.size());
+    float *x;
+    vecObj->getAddress(&x);
+    std::copy(field.x.begin(), field.x.end(), x);
+    return vecObj;
+}
+
+// reads up to 2*m_numThreads files concurrently, the objects are created in the order of tasks
+std::vector<coDistributedObject *> ReadFOAM::loadFields(const std::vector<FieldTask> &tasks)
+{
+    std::vector<coDistributedObject *> objects;
+    const size_t batch = 2 * m_numThreads;
+    for (size_t begin = 0; begin < tasks.size(); begin += batch)
+    {
+        const int num = int(std::min(batch, tasks.size() - begin));
+        std::vector<FieldData> data(num);
+
+        coWristWatch watch;
+#pragma omp parallel for schedule(dynamic) num_threads(m_numThreads)
+        for (int i = 0; i < num; ++i)
+        {
+            try
+            {
+                readField(tasks[begin + i], data[i]);
+            }
+            catch (std::exception &e)
+            {
+#pragma omp critical
+                std::cerr << "ReadFOAM: reading " << tasks[begin + i].file << " failed: " << e.what() << std::endl;
+                data[i].valid = false;
+            }
+        }
+        m_readTime += watch.elapsed();
+
+        for (int i = 0; i < num; ++i)
+        {
+            objects.push_back(createField(tasks[begin + i], data[i]));
+            data[i] = FieldData();
+        }
+    }
+    std::cerr << std::time(0) << " done!" << std::endl;
+    return objects;
+}
+
+coDoVec3 *ReadFOAM::loadVectorField(const std::string &timedir,
+                                    const std::string &file,
+                                    const std::string &vecObjName)
+{
+    FieldTask task(timedir, file, vecObjName);
+    FieldData field;
+    if (!readField(task, field) || field.fieldclass != "volVectorField")
+        return NULL;
+    coDoVec3 *vecObj = static_cast<coDoVec3 *>(createField(task, field));
 
     std::cerr << std::time(0) << " done!" << std::endl;
     return vecObj;
@@ -821,17 +1004,11 @@ coDoFloat *ReadFOAM::loadScalarField(const std::string &timedir,
                                      const std::string &file,
                                      const std::string &vecObjName)
 {
-    std::cerr << std::time(0) << " Reading ScalarField from: " << timedir.c_str() << "//" << file.c_str() << std::endl;
-    boost::shared_ptr<std::istream> vecIn = getStreamForFile(timedir, file);
-    if (!vecIn)
+    FieldTask task(timedir, file, vecObjName);
+    FieldData field;
+    if (!readField(task, field) || field.fieldclass != "volScalarField")
         return NULL;
-    HeaderInfo header = readFoamHeader(*vecIn);
-
-    coDoFloat *vecObj = new coDoFloat(vecObjName.c_str(), header.lines);
-    float *x;
-    vecObj->getAddress(&x);
-
-    readFloatArray(header, *vecIn, x, header.lines);
+    coDoFloat *vecObj = static_cast<coDoFloat *>(createField(task, field));
 
     std::cerr << std::time(0) << " done!" << std::endl;
     return vecObj;
@@ -882,7 +1059,7 @@ coDoVec3 *ReadFOAM::loadBoundaryVectorField(const std::string &timedir,
     float *x, *y, *z;
     vecObj->getAddresses(&x, &y, &z);
 
-    for (index_t i = 0; i < dataMapping.size(); ++i)
+    for (index_t i = 0; i < (index_t)dataMapping.size(); ++i)
     {
         *x = fullX[dataMapping[i]];
         ++x;
@@ -940,7 +1117,7 @@ coDoFloat *ReadFOAM::loadBoundaryScalarField(const std::string &timedir,
     float *x;
     vecObj->getAddress(&x);
 
-    for (index_t i = 0; i < dataMapping.size(); ++i)
+    for (index_t i = 0; i < (index_t)dataMapping.size(); ++i)
     {
         *x = fullX[dataMapping[i]];
         ++x;
@@ -954,6 +1131,18 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
 {
     (void)port;
     m_case = getCaseInfo(casedir, starttimeParam->getValue(), stoptimeParam->getValue(), skipfactorParam->getValue());
+
+    // processor directories and timesteps are read by up to m_numThreads threads
+    m_numThreads = 1;
+#ifdef _OPENMP
+    m_numThreads = coCoviseConfig::getInt("Module.ReadFOAM.Threads", 0);
+    if (m_numThreads <= 0)
+        m_numThreads = omp_get_max_threads();
+#endif
+    m_filesRead = 0;
+    m_bytesRead = 0.;
+    m_readTime = 0.;
+
     //Mesh
     basemeshs.clear();
     basebounds.clear();
@@ -966,7 +1155,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
         {
             if (m_case.numblocks > 0)
             { //Mesh does NOT change over time BUT is distributed over multiple Processor Directories
-                std::vector<coDistributedObject *> tempSet;
+                std::vector<MeshTask> tasks;
                 coDoSet *meshSet, *meshSubSet;
                 for (index_t i = 0; i < m_case.numblocks; i++)
                 { //fill vector:tempSet with all the mesh parts of all processors
@@ -979,9 +1168,10 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     std::string meshObjName = meshOutPort->getObjName();
                     meshObjName += sn.str();
 
-                    coDoUnstructuredGrid *m = loadMesh(dir, dir, meshObjName);
-                    tempSet.push_back(m);
+                    tasks.push_back(MeshTask(dir, dir, meshObjName));
                 }
+                std::vector<coDoUnstructuredGrid *> grids = loadMeshes(tasks);
+                std::vector<coDistributedObject *> tempSet(grids.begin(), grids.end());
 
                 if (m_case.timedirs.size() > 1)
                 { //more than 1 timestep -> mesh needs to be referenced multiple times in a set with TIMESTEP attribute
@@ -991,7 +1181,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     meshSubSetName += s.str();
                     meshSubSet = new coDoSet(meshSubSetName, tempSet.size(), &tempSet.front());
                     std::vector<coDistributedObject *> meshSubSets;
-                    for (index_t i = 0; i < m_case.timedirs.size(); i++)
+                    for (index_t i = 0; i < (index_t)m_case.timedirs.size(); i++)
                     {
                         meshSubSets.push_back(meshSubSet);
                         if (i > 0)
@@ -1036,7 +1226,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     meshSubObjName += ss.str();
                     coDoUnstructuredGrid *meshSub = loadMesh(dir, dir, meshSubObjName);
                     std::vector<coDistributedObject *> meshSubSets;
-                    for (index_t i = 0; i < m_case.timedirs.size(); i++)
+                    for (index_t i = 0; i < (index_t)m_case.timedirs.size(); i++)
                     {
                         meshSubSets.push_back(meshSub);
                         if (i > 0)
@@ -1079,19 +1269,17 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
             if (m_case.numblocks > 0)
             { //Mesh DOES change over time AND is distributed over multiple Processor Directories
                 index_t i = 0;
-                std::vector<coDistributedObject *> meshSubSets;
+                std::vector<MeshTask> tasks;
                 for (std::map<double, std::string>::const_iterator it = m_case.timedirs.begin();
                      it != m_case.timedirs.end();
                      ++it)
                 {
-                    std::vector<coDistributedObject *> meshObjects;
                     for (index_t j = 0; j < m_case.numblocks; ++j)
                     {
                         std::stringstream sn;
                         sn << "_timestep_" << i << "_processor_" << j;
                         std::string meshObjName = meshOutPort->getObjName();
                         meshObjName += sn.str();
-                        coDoUnstructuredGrid *m;
                         std::string timedir = it->second;
                         std::string pointsdir = casedir;
                         std::stringstream s;
@@ -1106,29 +1294,34 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                             meshdir += sConstant.str();
                             if (i == 0)
                             { //If first timestep
-                                m = loadMesh(meshdir, pointsdir, meshObjName); //Read the first timestep from every processor directory.
-                                basemeshs[j] = m;
+                                tasks.push_back(MeshTask(meshdir, pointsdir, meshObjName, -1, j)); //Read the first timestep from every processor directory.
                             }
                             else
                             { //If not first timestep
-                                m = loadMesh(meshdir, pointsdir, meshObjName, j); //copy everything but the coordinates from the first timestep in Processor J
+                                tasks.push_back(MeshTask(meshdir, pointsdir, meshObjName, j)); //copy everything but the coordinates from the first timestep in Processor J
                             }
                         }
                         else
                         { //If grid also changes
                             meshdir = pointsdir;
-                            m = loadMesh(meshdir, pointsdir, meshObjName); //reload everything
+                            tasks.push_back(MeshTask(meshdir, pointsdir, meshObjName)); //reload everything
                         }
-                        meshObjects.push_back(m);
                     }
+                    ++i;
+                }
+                std::vector<coDoUnstructuredGrid *> grids = loadMeshes(tasks);
+
+                std::vector<coDistributedObject *> meshSubSets;
+                for (i = 0; i < (index_t)m_case.timedirs.size(); ++i)
+                {
+                    std::vector<coDistributedObject *> meshObjects(grids.begin() + i * m_case.numblocks,
+                                                                   grids.begin() + (i + 1) * m_case.numblocks);
                     std::string meshSubSetName = meshOutPort->getObjName();
                     std::stringstream s;
                     s << "_set_timestep_" << i;
                     meshSubSetName += s.str();
                     coDoSet *meshSubSet = new coDoSet(meshSubSetName, meshObjects.size(), &meshObjects.front());
                     meshSubSets.push_back(meshSubSet);
-
-                    ++i;
                 }
 
                 std::string meshSetName = meshOutPort->getObjName();
@@ -1142,7 +1335,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
             else
             { //Mesh DOES change over time BUT is NOT distributed over multiple Processor Directories
                 index_t i = 0;
-                std::vector<coDistributedObject *> meshObjects;
+                std::vector<MeshTask> tasks;
                 coDoSet *meshSet;
                 for (std::map<double, std::string>::const_iterator it = m_case.timedirs.begin();
                      it != m_case.timedirs.end();
@@ -1153,8 +1346,6 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     std::string meshObjName = meshOutPort->getObjName();
                     meshObjName += sn.str();
 
-                    coDoUnstructuredGrid *m;
-                    coDoPolygons *p;
                     std::string timedir = it->second;
                     std::string pointsdir = casedir;
                     std::stringstream s;
@@ -1169,23 +1360,22 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                         meshdir += sConstant.str();
                         if (i == 0)
                         {
-                            m = loadMesh(meshdir, pointsdir, meshObjName);
-                            basemeshs[0] = m;
+                            tasks.push_back(MeshTask(meshdir, pointsdir, meshObjName, -1, 0));
                         }
                         else
                         {
-                            m = loadMesh(meshdir, pointsdir, meshObjName, 0);
+                            tasks.push_back(MeshTask(meshdir, pointsdir, meshObjName, 0));
                         }
                     }
                     else
                     {
                         meshdir = pointsdir;
-                        m = loadMesh(meshdir, pointsdir, meshObjName);
+                        tasks.push_back(MeshTask(meshdir, pointsdir, meshObjName));
                     }
-
-                    meshObjects.push_back(m);
                     ++i;
                 }
+                std::vector<coDoUnstructuredGrid *> grids = loadMeshes(tasks);
+                std::vector<coDistributedObject *> meshObjects(grids.begin(), grids.end());
                 std::string meshSetName = meshOutPort->getObjName();
                 meshSet = new coDoSet(meshSetName, meshObjects.size(), &meshObjects.front());
                 std::stringstream sMesh;
@@ -1230,7 +1420,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     boundSubSetName += s.str();
                     boundarySubSet = new coDoSet(boundSubSetName, tempSet.size(), &tempSet.front());
                     std::vector<coDistributedObject *> boundarySubSets;
-                    for (index_t i = 0; i < m_case.timedirs.size(); i++)
+                    for (index_t i = 0; i < (index_t)m_case.timedirs.size(); i++)
                     {
                         boundarySubSets.push_back(boundarySubSet);
                         if (i > 0)
@@ -1275,7 +1465,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     boundSubObjName += ss.str();
                     coDoPolygons *boundarySub = loadPatches(dir, dir, boundSubObjName, selection);
                     std::vector<coDistributedObject *> boundarySubSets;
-                    for (index_t i = 0; i < m_case.timedirs.size(); i++)
+                    for (index_t i = 0; i < (index_t)m_case.timedirs.size(); i++)
                     {
                         boundarySubSets.push_back(boundarySub);
                         if (i > 0)
@@ -1436,7 +1626,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
     for (int nPort = 0; nPort < num_ports; ++nPort)
     {
         index_t portchoice = portChoice[nPort]->getValue();
-        if (portchoice > 0 && portchoice <= m_case.varyingFields.size())
+        if (portchoice > 0 && portchoice <= (index_t)m_case.varyingFields.size())
         {
             coModule::sendInfo("Reading Port Data. Please wait ...");
             std::vector<coDistributedObject *> tempSet;
@@ -1448,6 +1638,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                 if (m_case.timedirs.size() > 0)
                 {
                     std::vector<coDistributedObject *> portSubSets;
+                    std::vector<FieldTask> tasks;
                     index_t i = 0;
                     for (std::map<double, std::string>::const_iterator it = m_case.timedirs.begin();
                          it != m_case.timedirs.end();
@@ -1466,22 +1657,18 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                             std::string portObjName = outPorts[nPort]->getObjName();
                             portObjName += sn.str();
 
-                            boost::shared_ptr<std::istream> portIn = getStreamForFile(dir, dataFilename);
-                            HeaderInfo header = readFoamHeader(*portIn);
-                            if (header.fieldclass == "volVectorField")
-                            {
-                                coDoVec3 *v = loadVectorField(dir, dataFilename, portObjName);
-                                tempSet.push_back(v);
-                            }
-                            else if (header.fieldclass == "volScalarField")
-                            {
-                                coDoFloat *v = loadScalarField(dir, dataFilename, portObjName);
-                                tempSet.push_back(v);
-                            }
-                            else
-                            {
-                                std::cerr << "Unknown field type in file: " << dataFilename << std::endl;
-                            }
+                            tasks.push_back(FieldTask(dir, dataFilename, portObjName));
+                        }
+                        ++i;
+                    }
+                    std::vector<coDistributedObject *> fields = loadFields(tasks);
+
+                    for (i = 0; i < (index_t)m_case.timedirs.size(); ++i)
+                    {
+                        for (index_t j = 0; j < m_case.numblocks; ++j)
+                        {
+                            if (fields[i * m_case.numblocks + j])
+                                tempSet.push_back(fields[i * m_case.numblocks + j]);
                         }
                         std::string portSubSetName = outPorts[nPort]->getObjName();
                         std::stringstream s;
@@ -1491,7 +1678,6 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                         portSubSet = new coDoSet(portSubSetName, tempSet.size(), &tempSet.front());
                         tempSet.clear();
                         portSubSets.push_back(portSubSet);
-                        ++i;
                     }
                     std::string portSetName = outPorts[nPort]->getObjName();
                     portSet = new coDoSet(portSetName, portSubSets.size(), &portSubSets.front());
@@ -1508,6 +1694,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
             { //If no Processor directories exist
                 if (m_case.timedirs.size() > 0)
                 {
+                    std::vector<FieldTask> tasks;
                     index_t i = 0;
                     for (std::map<double, std::string>::const_iterator it = m_case.timedirs.begin();
                          it != m_case.timedirs.end();
@@ -1524,24 +1711,15 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                         std::string portObjName = outPorts[nPort]->getObjName();
                         portObjName += sn.str();
 
-                        boost::shared_ptr<std::istream> portIn = getStreamForFile(dir, dataFilename);
-                        HeaderInfo header = readFoamHeader(*portIn);
-                        if (header.fieldclass == "volVectorField")
-                        {
-                            coDoVec3 *v = loadVectorField(dir, dataFilename, portObjName);
-                            tempSet.push_back(v);
-                        }
-                        else if (header.fieldclass == "volScalarField")
-                        {
-                            coDoFloat *v = loadScalarField(dir, dataFilename, portObjName);
-                            tempSet.push_back(v);
-                        }
-                        else
-                        {
-                            std::cerr << "Unknown field type in file: " << dataFilename << std::endl;
-                        }
+                        tasks.push_back(FieldTask(dir, dataFilename, portObjName));
                         ++i;
                     }
+                    std::vector<coDistributedObject *> fields = loadFields(tasks);
+                    for (size_t k = 0; k < fields.size(); ++k)
+                    {
+                        if (fields[k])
+                            tempSet.push_back(fields[k]);
+                    }
                     std::string portSetName = outPorts[nPort]->getObjName();
                     portSet = new coDoSet(portSetName, tempSet.size(), &tempSet.front());
                     if (m_case.timedirs.size() > 1)
@@ -1566,7 +1744,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
     {
         std::string selection = patchesStringParam->getValString();
         index_t portchoice = boundaryDataChoice[nPort]->getValue();
-        if (portchoice > 0 && portchoice <= m_case.varyingFields.size())
+        if (portchoice > 0 && portchoice <= (index_t)m_case.varyingFields.size())
         {
             coModule::sendInfo("Reading Boundary Port Data. Please wait ...");
             std::vector<coDistributedObject *> tempSet;
@@ -1707,6 +1885,12 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
         }
     }
 
+    if (m_filesRead > 0 && m_readTime > 0.)
+    {
+        double mb = m_bytesRead / (1024. * 1024.);
+        coModule::sendInfo("Read %d files (%.1f MB) in %.2f s with %d threads: %.1f files/s, %.1f MB/s",
+                           m_filesRead, mb, m_readTime, m_numThreads, m_filesRead / m_readTime, mb / m_readTime);
+    }
     coModule::sendInfo("ReadFOAM complete.");
     std::cerr << "ReadFOAM finished." << std::endl;
 
@@ -1716,14 +1900,14 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
 bool ReadFOAM::vectorsAreFilled()
 {
     bool filled = true;
-    for (int i = 0; i < lastDataPortSelection.size(); ++i)
+    for (int i = 0; i < (int)lastDataPortSelection.size(); ++i)
     {
         if (lastDataPortSelection[i].empty())
         {
             filled = false;
         }
     }
-    for (int i = 0; i < lastBoundaryPortSelection.size(); ++i)
+    for (int i = 0; i < (int)lastBoundaryPortSelection.size(); ++i)
     {
         if (lastBoundaryPortSelection[i].empty())
         {
@@ -37,6 +37,62 @@
 using namespace covise;
 typedef int index_t;
 
+// a mesh to be read: with copyFrom >= 0 only the points are read and the
+// topology is taken from basemeshs[copyFrom], with saveAs >= 0 the grid is
+// stored as basemeshs[saveAs]
+struct MeshTask
+{
+    MeshTask(const std::string &meshdir, const std::string &pointsdir, const std::string &objName,
+             index_t copyFrom = -1, index_t saveAs = -1)
+        : meshdir(meshdir)
+        , pointsdir(pointsdir)
+        , objName(objName)
+        , copyFrom(copyFrom)
+        , saveAs(saveAs)
+    {
+    }
+    std::string meshdir;
+    std::string pointsdir;
+    std::string objName;
+    index_t copyFrom;
+    index_t saveAs;
+};
+
+struct MeshData
+{
+    MeshData()
+        : valid(false)
+    {
+    }
+    std::vector<index_t> el, cl, tl;
+    std::vector<float> x, y, z;
+    bool valid;
+};
+
+struct FieldTask
+{
+    FieldTask(const std::string &dir, const std::string &file, const std::string &objName)
+        : dir(dir)
+        , file(file)
+        , objName(objName)
+    {
+    }
+    std::string dir;
+    std::string file;
+    std::string objName;
+};
+
+struct FieldData
+{
+    FieldData()
+        : valid(false)
+    {
+    }
+    std::string fieldclass;
+    std::vector<float> x, y, z;
+    bool valid;
+};
+
 class ReadFOAM : public coModule
 {
 
@@ -68,6 +124,21 @@ private:
     virtual int compute(const char *port);
     bool vectorsAreFilled();
 
+    // reading is done concurrently, shared memory objects are created sequentially
+    bool readMesh(const MeshTask &task, MeshData &mesh);
+    coDoUnstructuredGrid *createMesh(const MeshTask &task, const MeshData &mesh);
+    std::vector<coDoUnstructuredGrid *> loadMeshes(const std::vector<MeshTask> &tasks);
+    bool readField(const FieldTask &task, FieldData &field);
+    coDistributedObject *createField(const FieldTask &task, const FieldData &field);
+    std::vector<coDistributedObject *> loadFields(const std::vector<FieldTask> &tasks);
+    void countFile(const std::string &dir, const std::string &basename);
+
+    // read statistics
+    int m_numThreads;
+    int m_filesRead;
+    double m_bytesRead;
+    double m_readTime;
+
 public:
     ReadFOAM(int argc, char *argv[]); //Constructor
     virtual ~ReadFOAM(); //Destructor
@@ -28,6 +28,8 @@
 #include <set>
 #include <map>
 #include <cctype>
+#include <climits>
+#include <cfloat>
 
 #include <cstdlib>
 
@@ -140,6 +142,22 @@ boost::shared_ptr<std::istream> getStreamForFile(const std::string &dir, const s
         return getStreamForFile(dir + "/" + basename);
 }
 
+// size on disk of the file returned by getStreamForFile
+double getFileSize(const std::string &dir, const std::string &basename)
+{
+    try
+    {
+        bf::path zipped(dir + "/" + basename + ".gz");
+        if (bf::exists(zipped) && !::is_directory(zipped))
+            return bf::file_size(zipped);
+        return bf::file_size(dir + "/" + basename);
+    }
+    catch (bf::filesystem_error &)
+    {
+        return 0.;
+    }
+}
+
 bool isTimeDir(const std::string &dir)
 {
 
@@ -445,7 +463,7 @@ bool checkCaseDirectory(CaseInfo &info, const std::string &casedir, bool compare
         }
     }
 
-    if (compare && num_timesteps != info.timedirs.size())
+    if (compare && num_timesteps != (index_t)info.timedirs.size())
     {
         std::cerr << "not all timesteps available on all processors" << std::endl;
         return false;
@@ -866,6 +884,259 @@ struct on_disk<unsigned long>
     while(false)
 
 
+// Reads numbers directly from the stream buffer: operator>> constructs a sentry
+// and goes through the locale for every single number, which dominates the
+// time for reading ASCII meshes. The results are the same as with operator>>.
+class AsciiScanner
+{
+public:
+    AsciiScanner(std::istream &stream)
+        : stream(stream)
+        , buf(stream.rdbuf())
+    {
+    }
+
+    bool read(int &val)
+    {
+        long long v = 0;
+        if (!readInteger(v) || v > INT_MAX || v < INT_MIN)
+        {
+            stream.setstate(std::ios_base::failbit);
+            return false;
+        }
+        val = (int)v;
+        return true;
+    }
+
+    bool read(size_t &val)
+    {
+        long long v = 0;
+        if (!readInteger(v) || v < 0)
+        {
+            stream.setstate(std::ios_base::failbit);
+            return false;
+        }
+        val = (size_t)v;
+        return true;
+    }
+
+    bool read(float &val)
+    {
+        bool neg = false, exact = true;
+        unsigned long long mantissa = 0;
+        int digits = 0, exponent = 0;
+        if (!readFloatToken(neg, mantissa, digits, exponent, exact))
+        {
+            val = 0.f;
+            stream.setstate(std::ios_base::failbit);
+            return false;
+        }
+
+        // exact operands give a correctly rounded result, as strtof does
+        static const float pow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+        while (digits > 7 && mantissa % 10 == 0)
+        {
+            mantissa /= 10;
+            --digits;
+            ++exponent;
+        }
+        if (exact && mantissa == 0)
+        {
+            val = neg ? -0.f : 0.f;
+            return true;
+        }
+        if (exact && digits <= 7 && exponent >= -10 && exponent <= 10)
+        {
+            float m = (float)mantissa;
+            val = exponent >= 0 ? m * pow10[exponent] : m / pow10[-exponent];
+            if (neg)
+                val = -val;
+            return true;
+        }
+
+        char *end = NULL;
+        val = strtof(token.c_str(), &end);
+        if (end == token.c_str() || *end != '\0')
+        {
+            val = 0.f;
+            stream.setstate(std::ios_base::failbit);
+            return false;
+        }
+        if (val == std::numeric_limits<float>::infinity() || val == -std::numeric_limits<float>::infinity())
+        {
+            val = val > 0 ? FLT_MAX : -FLT_MAX;
+            stream.setstate(std::ios_base::failbit);
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool read(std::vector<T> &vec)
+    {
+        size_t n = 0;
+        read(n);
+        ignore('(');
+        vec.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            T val;
+            read(val);
+            vec.push_back(val);
+        }
+        ignore(')');
+        return stream.good();
+    }
+
+    // same as stream.ignore(std::numeric_limits<std::streamsize>::max(), delim)
+    void ignore(char delim)
+    {
+        int c = buf->sbumpc();
+        while (c != EOF && c != (unsigned char)delim)
+            c = buf->sbumpc();
+        if (c == EOF)
+            stream.setstate(std::ios_base::eofbit);
+    }
+
+private:
+    static bool isSpace(int c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    static bool isDigit(int c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    int skipSpace()
+    {
+        int c = buf->sgetc();
+        while (c != EOF && isSpace(c))
+            c = buf->snextc();
+        return c;
+    }
+
+    bool readInteger(long long &val)
+    {
+        if (!stream.good())
+            return false;
+        int c = skipSpace();
+        bool neg = false;
+        if (c == '-' || c == '+')
+        {
+            neg = (c == '-');
+            c = buf->snextc();
+        }
+        if (!isDigit(c))
+        {
+            if (c == EOF)
+                stream.setstate(std::ios_base::eofbit);
+            return false;
+        }
+        long long v = 0;
+        while (isDigit(c))
+        {
+            v = v * 10 + (c - '0');
+            if (v > (long long)UINT_MAX + 1)
+                return false;
+            c = buf->snextc();
+        }
+        if (c == EOF)
+            stream.setstate(std::ios_base::eofbit);
+        val = neg ? -v : v;
+        return true;
+    }
+
+    // collects the characters accepted by operator>> for floating point numbers
+    // and decomposes the number into significant digits and decimal exponent,
+    // exact is cleared if the decomposition does not represent the number
+    bool readFloatToken(bool &neg, unsigned long long &mantissa, int &digits, int &exponent, bool &exact)
+    {
+        if (!stream.good())
+            return false;
+        token.clear();
+        int c = skipSpace();
+        if (c == '-' || c == '+')
+        {
+            neg = (c == '-');
+            token += (char)c;
+            c = buf->snextc();
+        }
+        bool any = false, point = false;
+        while (isDigit(c) || (c == '.' && !point))
+        {
+            if (c == '.')
+            {
+                point = true;
+            }
+            else
+            {
+                any = true;
+                if (mantissa == 0 && c == '0')
+                {
+                    if (point)
+                        --exponent;
+                }
+                else if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + (c - '0');
+                    ++digits;
+                    if (point)
+                        --exponent;
+                }
+                else
+                {
+                    if (c != '0')
+                        exact = false;
+                    if (!point)
+                        ++exponent;
+                }
+            }
+            token += (char)c;
+            c = buf->snextc();
+        }
+        if (!any)
+        {
+            if (c == EOF)
+                stream.setstate(std::ios_base::eofbit);
+            return false;
+        }
+        if (c == 'e' || c == 'E')
+        {
+            token += (char)c;
+            c = buf->snextc();
+            bool eneg = false;
+            if (c == '-' || c == '+')
+            {
+                eneg = (c == '-');
+                token += (char)c;
+                c = buf->snextc();
+            }
+            int e = 0;
+            bool edigits = false;
+            while (isDigit(c))
+            {
+                edigits = true;
+                if (e < 100000)
+                    e = e * 10 + (c - '0');
+                token += (char)c;
+                c = buf->snextc();
+            }
+            if (!edigits)
+                exact = false; // incomplete exponent: strtof decides
+            exponent += eneg ? -e : e;
+        }
+        if (c == EOF)
+            stream.setstate(std::ios_base::eofbit);
+        return true;
+    }
+
+    std::istream &stream;
+    std::streambuf *buf;
+    std::string token;
+};
+
 template <typename T>
 std::istream &operator>>(std::istream &stream, std::vector<T> &vec)
 {
@@ -934,11 +1205,12 @@ bool readVectorArray(const HeaderInfo &info, std::istream &stream, T *x, T *y, T
     {
         expect('(');
         expect('\n');
+        AsciiScanner scanner(stream);
         for (size_t i = 0; i < lines; ++i)
         {
-            stream.ignore(std::numeric_limits<std::streamsize>::max(), '(');
-            stream >> x[i] >> y[i] >> z[i];
-            stream.ignore(std::numeric_limits<std::streamsize>::max(), ')');
+            scanner.ignore('(');
+            scanner.read(x[i]) && scanner.read(y[i]) && scanner.read(z[i]);
+            scanner.ignore(')');
         }
         expect('\n');
         expect(')');
@@ -975,9 +1247,10 @@ bool readArrayBinary(std::istream &stream, T *p, const size_t lines)
 template <typename T>
 bool readArrayAscii(std::istream &stream, T *p, const size_t lines)
 {
+    AsciiScanner scanner(stream);
     for (size_t i = 0; i < lines; ++i)
     {
-        stream >> p[i];
+        scanner.read(p[i]);
         if (!stream.good())
         {
            std::cerr << "readArrayAscii: failure at element " << i << " of " << lines << std::endl;
@@ -1130,12 +1403,12 @@ index_t findVertexAlongEdge(const index_t point,
 {
 
     std::vector<index_t> pointfaces;
-    for (index_t i = 0; i < cellfaces.size(); i++)
+    for (index_t i = 0; i < (index_t)cellfaces.size(); i++)
     {
         if (cellfaces[i] != homeface)
         {
             const std::vector<index_t> &face = faces[cellfaces[i]];
-            for (index_t j = 0; j < face.size(); j++)
+            for (index_t j = 0; j < (index_t)face.size(); j++)
             {
                 if (face[j] == point)
                 {
@@ -1147,9 +1420,9 @@ index_t findVertexAlongEdge(const index_t point,
     }
     const std::vector<index_t> &a = faces[pointfaces[0]];
     const std::vector<index_t> &b = faces[pointfaces[1]];
-    for (index_t i = 0; i < a.size(); i++)
+    for (index_t i = 0; i < (index_t)a.size(); i++)
     {
-        for (index_t j = 0; j < b.size(); j++)
+        for (index_t j = 0; j < (index_t)b.size(); j++)
         {
             if (a[i] == b[j] && a[i] != point)
             {
@@ -1204,9 +1477,9 @@ std::vector<index_t> getVerticesForCell(
 {
 
     std::vector<index_t> cellvertices;
-    for (index_t i = 0; i < cellfaces.size(); i++)
+    for (index_t i = 0; i < (index_t)cellfaces.size(); i++)
     {
-        for (index_t j = 0; j < faces[cellfaces[i]].size(); j++)
+        for (index_t j = 0; j < (index_t)faces[cellfaces[i]].size(); j++)
         {
             cellvertices.push_back(faces[cellfaces[i]][j]);
         }
@@ -155,6 +155,7 @@ public:
 CaseInfo getCaseInfo(const std::string &casedir, double mintime, double maxtime, int skipfactor = 1, bool exact = false);
 boost::shared_ptr<std::istream> getStreamForFile(const std::string &filename);
 boost::shared_ptr<std::istream> getStreamForFile(const std::string &dir, const std::string &basename);
+double getFileSize(const std::string &dir, const std::string &basename);
 HeaderInfo readFoamHeader(std::istream &stream);
 DimensionInfo readDimensions(const std::string &meshdir);
 
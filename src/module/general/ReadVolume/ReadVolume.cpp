@@ -252,6 +252,7 @@ int coReadVolume::compute(const char *)
                 char buf[1024];
                 sprintf(buf, "%s_%d", poGrid->getObjName(), t);
                 gridData[t] = new coDoUniformGrid(buf, vox[0], vox[1], vox[2], minX, maxX, minY, maxY, minZ, maxZ);
+                streamTimestep(poGrid, gridData[t], t, vd->frames);
             }
             else
             {
@@ -381,6 +382,9 @@ int coReadVolume::compute(const char *)
                             fdata[i] = 0.0f;
                     }
                 }
+
+                if (vd->frames > 1)
+                    streamTimestep(poVolume[c], timesteps.back(), t, vd->frames);
             }
 
             if (vd->frames > 1)
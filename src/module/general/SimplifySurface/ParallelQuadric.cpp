@@ -0,0 +1,819 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "ParallelQuadric.h"
+#include "Point.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <math.h>
+#include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+
+// no partitioning below this number of triangles per partition
+const int PARTITION_MIN_TRIANGLES = 50000;
+// reject collapses turning a triangle normal by more than ~78 degrees
+const double FLIP_COS = 0.2;
+
+// symmetric 4x4 matrix: xx xy xz xd yy yz yd zz zd dd
+enum
+{
+    QSIZE = 10
+};
+
+void addPlane(double *q, double nx, double ny, double nz, double d, double w)
+{
+    q[0] += w * nx * nx;
+    q[1] += w * nx * ny;
+    q[2] += w * nx * nz;
+    q[3] += w * nx * d;
+    q[4] += w * ny * ny;
+    q[5] += w * ny * nz;
+    q[6] += w * ny * d;
+    q[7] += w * nz * nz;
+    q[8] += w * nz * d;
+    q[9] += w * d * d;
+}
+
+double quadricError(const double *q, const double *p)
+{
+    return q[0] * p[0] * p[0] + 2.0 * q[1] * p[0] * p[1] + 2.0 * q[2] * p[0] * p[2] + 2.0 * q[3] * p[0]
+           + q[4] * p[1] * p[1] + 2.0 * q[5] * p[1] * p[2] + 2.0 * q[6] * p[1]
+           + q[7] * p[2] * p[2] + 2.0 * q[8] * p[2]
+           + q[9];
+}
+
+void triNormal(const double *p0, const double *p1, const double *p2, double *n)
+{
+    double e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    double e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+    n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+    n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+    n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+struct Collapse
+{
+    double cost;
+    int v0, v1;
+    unsigned int version0, version1;
+    bool operator>(const Collapse &other) const
+    {
+        return cost > other.cost;
+    }
+};
+
+// a triangle mesh reduced by quadric error edge collapses,
+// all entities are addressed by index
+class MeshDecimator
+{
+public:
+    MeshDecimator(int nattr)
+        : nattr_(nattr)
+        , nnormal_(0)
+    {
+    }
+
+    vector<float> coord; // 3 per vertex
+    vector<float> attr; // nattr per vertex
+    vector<int> tri; // 3 per triangle
+    vector<char> locked; // vertex must not be moved (empty: none)
+    vector<char> seed; // only edges touching these vertices are queued initially (empty: all)
+
+    // the last three attribute components are normals and renormalised
+    void setNormalOffset(int offset)
+    {
+        nnormal_ = offset;
+    }
+
+    // returns the number of remaining triangles
+    int Run(int target, int max_valence, double boundary_weight);
+
+    bool isDead(int t) const
+    {
+        return dead_[t] != 0;
+    }
+
+private:
+    int nattr_;
+    int nnormal_;
+    int live_;
+    vector<char> dead_;
+    vector<char> removed_;
+    vector<char> boundary_;
+    vector<unsigned int> version_;
+    vector<double> quadric_;
+    vector<int> refs_;
+    vector<int> refStart_;
+    vector<int> refCount_;
+    vector<int> markA_;
+    vector<int> markB_;
+    int stamp_;
+    size_t refsLimit_;
+    std::priority_queue<Collapse, vector<Collapse>, std::greater<Collapse> > queue_;
+
+    bool isLocked(int v) const
+    {
+        return !locked.empty() && locked[v];
+    }
+    void position(int v, double *p) const
+    {
+        p[0] = coord[3 * v];
+        p[1] = coord[3 * v + 1];
+        p[2] = coord[3 * v + 2];
+    }
+    bool contains(int t, int v) const
+    {
+        return tri[3 * t] == v || tri[3 * t + 1] == v || tri[3 * t + 2] == v;
+    }
+    void buildRefs();
+    void computeQuadrics(double boundary_weight);
+    double cost(int v0, int v1, double *pos, double *t) const;
+    void pushEdge(int v0, int v1);
+    bool flips(int v, int other, const double *pos) const;
+    bool collapse(int v0, int v1, int max_valence);
+};
+
+void MeshDecimator::buildRefs()
+{
+    int nv = coord.size() / 3;
+    int nt = tri.size() / 3;
+    refCount_.assign(nv, 0);
+    refStart_.assign(nv, 0);
+    int t, k;
+    for (t = 0; t < nt; ++t)
+    {
+        if (dead_[t])
+            continue;
+        for (k = 0; k < 3; ++k)
+            ++refCount_[tri[3 * t + k]];
+    }
+    int sum = 0;
+    int v;
+    for (v = 0; v < nv; ++v)
+    {
+        refStart_[v] = sum;
+        sum += refCount_[v];
+        refCount_[v] = 0;
+    }
+    refs_.resize(sum);
+    for (t = 0; t < nt; ++t)
+    {
+        if (dead_[t])
+            continue;
+        for (k = 0; k < 3; ++k)
+        {
+            v = tri[3 * t + k];
+            refs_[refStart_[v] + refCount_[v]++] = t;
+        }
+    }
+    // collapses append the new triangle lists of the surviving vertex,
+    // compact again when the list has grown considerably
+    refsLimit_ = 3 * refs_.size() + 1024;
+}
+
+void MeshDecimator::computeQuadrics(double boundary_weight)
+{
+    int nv = coord.size() / 3;
+    int nt = tri.size() / 3;
+    quadric_.assign(QSIZE * nv, 0.0);
+    boundary_.assign(nv, 0);
+    int t, k;
+    for (t = 0; t < nt; ++t)
+    {
+        if (dead_[t])
+            continue;
+        double p0[3], p1[3], p2[3], n[3];
+        position(tri[3 * t], p0);
+        position(tri[3 * t + 1], p1);
+        position(tri[3 * t + 2], p2);
+        triNormal(p0, p1, p2, n);
+        double len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len == 0.0)
+            continue;
+        n[0] /= len;
+        n[1] /= len;
+        n[2] /= len;
+        double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+        for (k = 0; k < 3; ++k)
+            addPlane(&quadric_[QSIZE * tri[3 * t + k]], n[0], n[1], n[2], d, 0.5 * len);
+    }
+
+    // an edge v->w used by a single triangle is a boundary edge,
+    // it is kept in place by a plane perpendicular to the triangle
+    int v;
+    for (v = 0; v < nv; ++v)
+    {
+        int r;
+        for (r = 0; r < refCount_[v]; ++r)
+        {
+            t = refs_[refStart_[v] + r];
+            int corner = (tri[3 * t] == v) ? 0 : ((tri[3 * t + 1] == v) ? 1 : 2);
+            int w = tri[3 * t + (corner + 1) % 3];
+            int users = 0;
+            int s;
+            for (s = 0; s < refCount_[v]; ++s)
+            {
+                if (contains(refs_[refStart_[v] + s], w))
+                    ++users;
+            }
+            if (users != 1)
+                continue;
+            boundary_[v] = 1;
+            boundary_[w] = 1;
+            double p0[3], p1[3], p2[3], n[3];
+            position(tri[3 * t], p0);
+            position(tri[3 * t + 1], p1);
+            position(tri[3 * t + 2], p2);
+            triNormal(p0, p1, p2, n);
+            double pv[3], pw[3];
+            position(v, pv);
+            position(w, pw);
+            double e[3] = { pw[0] - pv[0], pw[1] - pv[1], pw[2] - pv[2] };
+            double m[3] = { e[1] * n[2] - e[2] * n[1],
+                            e[2] * n[0] - e[0] * n[2],
+                            e[0] * n[1] - e[1] * n[0] };
+            double len = sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+            if (len == 0.0)
+                continue;
+            m[0] /= len;
+            m[1] /= len;
+            m[2] /= len;
+            double d = -(m[0] * pv[0] + m[1] * pv[1] + m[2] * pv[2]);
+            double w2 = boundary_weight * (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+            addPlane(&quadric_[QSIZE * v], m[0], m[1], m[2], d, w2);
+            addPlane(&quadric_[QSIZE * w], m[0], m[1], m[2], d, w2);
+        }
+    }
+}
+
+// optimal position for the collapse of v1 into v0,
+// t is the parameter along the edge used for the attributes
+double MeshDecimator::cost(int v0, int v1, double *pos, double *t) const
+{
+    double q[QSIZE];
+    int i;
+    for (i = 0; i < QSIZE; ++i)
+        q[i] = quadric_[QSIZE * v0 + i] + quadric_[QSIZE * v1 + i];
+
+    double p0[3], p1[3];
+    position(v0, p0);
+    position(v1, p1);
+    if (isLocked(v0))
+    {
+        std::copy(p0, p0 + 3, pos);
+        *t = 0.0;
+        return quadricError(q, pos);
+    }
+    if (isLocked(v1))
+    {
+        std::copy(p1, p1 + 3, pos);
+        *t = 1.0;
+        return quadricError(q, pos);
+    }
+
+    double e[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    double elen2 = e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+
+    // solve A x = -b by Cramer's rule
+    double det = q[0] * (q[4] * q[7] - q[5] * q[5])
+                 - q[1] * (q[1] * q[7] - q[5] * q[2])
+                 + q[2] * (q[1] * q[5] - q[4] * q[2]);
+    double trace = q[0] + q[4] + q[7];
+    if (fabs(det) > 1.0e-10 * trace * trace * trace)
+    {
+        double x[3];
+        x[0] = (-q[3] * (q[4] * q[7] - q[5] * q[5])
+                + q[6] * (q[1] * q[7] - q[5] * q[2])
+                - q[8] * (q[1] * q[5] - q[4] * q[2])) / det;
+        x[1] = (q[0] * (-q[6] * q[7] + q[5] * q[8])
+                - q[1] * (-q[3] * q[7] + q[2] * q[8])
+                + q[2] * (-q[3] * q[5] + q[2] * q[6])) / det;
+        x[2] = (q[0] * (-q[4] * q[8] + q[6] * q[5])
+                - q[1] * (-q[1] * q[8] + q[6] * q[2])
+                + q[2] * (-q[1] * q[5] + q[4] * q[3])) / det;
+        double mid[3] = { x[0] - 0.5 * (p0[0] + p1[0]),
+                          x[1] - 0.5 * (p0[1] + p1[1]),
+                          x[2] - 0.5 * (p0[2] + p1[2]) };
+        // ill-conditioned systems may place the vertex far away
+        if (mid[0] * mid[0] + mid[1] * mid[1] + mid[2] * mid[2] <= 4.0 * elen2)
+        {
+            std::copy(x, x + 3, pos);
+            double s = 0.0;
+            if (elen2 > 0.0)
+                s = ((x[0] - p0[0]) * e[0] + (x[1] - p0[1]) * e[1] + (x[2] - p0[2]) * e[2]) / elen2;
+            *t = std::min(1.0, std::max(0.0, s));
+            return quadricError(q, pos);
+        }
+    }
+
+    // fall back to the end points and the mid point
+    double best = DBL_MAX;
+    int k;
+    for (k = 0; k < 3; ++k)
+    {
+        double s = 0.5 * k;
+        double x[3] = { p0[0] + s * e[0], p0[1] + s * e[1], p0[2] + s * e[2] };
+        double err = quadricError(q, x);
+        if (err < best)
+        {
+            best = err;
+            std::copy(x, x + 3, pos);
+            *t = s;
+        }
+    }
+    return best;
+}
+
+void MeshDecimator::pushEdge(int v0, int v1)
+{
+    if (isLocked(v0) && isLocked(v1))
+        return;
+    // the locked vertex is the one that survives
+    if (isLocked(v1))
+        std::swap(v0, v1);
+    Collapse c;
+    double pos[3], t;
+    c.cost = cost(v0, v1, pos, &t);
+    c.v0 = v0;
+    c.v1 = v1;
+    c.version0 = version_[v0];
+    c.version1 = version_[v1];
+    queue_.push(c);
+}
+
+// would moving v to pos turn one of its triangles not shared with other?
+bool MeshDecimator::flips(int v, int other, const double *pos) const
+{
+    int r;
+    for (r = 0; r < refCount_[v]; ++r)
+    {
+        int t = refs_[refStart_[v] + r];
+        if (dead_[t] || contains(t, other))
+            continue;
+        double p[3][3], n_old[3], n_new[3];
+        int k;
+        for (k = 0; k < 3; ++k)
+            position(tri[3 * t + k], p[k]);
+        triNormal(p[0], p[1], p[2], n_old);
+        for (k = 0; k < 3; ++k)
+        {
+            if (tri[3 * t + k] == v)
+                std::copy(pos, pos + 3, p[k]);
+        }
+        triNormal(p[0], p[1], p[2], n_new);
+        double len_old = sqrt(n_old[0] * n_old[0] + n_old[1] * n_old[1] + n_old[2] * n_old[2]);
+        double len_new = sqrt(n_new[0] * n_new[0] + n_new[1] * n_new[1] + n_new[2] * n_new[2]);
+        if (len_new == 0.0)
+            return true;
+        double dot = n_old[0] * n_new[0] + n_old[1] * n_new[1] + n_old[2] * n_new[2];
+        if (dot < FLIP_COS * len_old * len_new)
+            return true;
+    }
+    return false;
+}
+
+bool MeshDecimator::collapse(int v0, int v1, int max_valence)
+{
+    int r, k;
+
+    // link condition: the common neighbours of v0 and v1 have to be
+    // the opposite vertices of the triangles sharing the edge
+    int stampA = ++stamp_;
+    int deg0 = 0;
+    for (r = 0; r < refCount_[v0]; ++r)
+    {
+        int t = refs_[refStart_[v0] + r];
+        if (dead_[t])
+            continue;
+        for (k = 0; k < 3; ++k)
+        {
+            int w = tri[3 * t + k];
+            if (w != v0 && markA_[w] != stampA)
+            {
+                markA_[w] = stampA;
+                ++deg0;
+            }
+        }
+    }
+    int deg1 = 0, common = 0, shared = 0;
+    for (r = 0; r < refCount_[v1]; ++r)
+    {
+        int t = refs_[refStart_[v1] + r];
+        if (dead_[t])
+            continue;
+        if (contains(t, v0))
+            ++shared;
+        for (k = 0; k < 3; ++k)
+        {
+            int w = tri[3 * t + k];
+            if (w != v1 && markB_[w] != stampA)
+            {
+                markB_[w] = stampA;
+                ++deg1;
+                if (w != v0 && markA_[w] == stampA)
+                    ++common;
+            }
+        }
+    }
+    if (shared == 0 || shared > 2 || common != shared)
+        return false;
+    // do not pinch the mesh between two boundaries
+    if (shared == 2 && boundary_[v0] && boundary_[v1])
+        return false;
+    if ((deg0 - 1) + (deg1 - 1) - common > max_valence)
+        return false;
+
+    double pos[3], t;
+    cost(v0, v1, pos, &t);
+    if (flips(v0, v1, pos) || flips(v1, v0, pos))
+        return false;
+
+    // move v0 and merge the attributes and quadrics of v1
+    for (k = 0; k < 3; ++k)
+        coord[3 * v0 + k] = (float)pos[k];
+    for (k = 0; k < nattr_; ++k)
+        attr[nattr_ * v0 + k] = (float)((1.0 - t) * attr[nattr_ * v0 + k] + t * attr[nattr_ * v1 + k]);
+    for (k = 0; k < QSIZE; ++k)
+        quadric_[QSIZE * v0 + k] += quadric_[QSIZE * v1 + k];
+    if (boundary_[v1])
+        boundary_[v0] = 1;
+    removed_[v1] = 1;
+    ++version_[v0];
+
+    int start = refs_.size();
+    for (r = 0; r < refCount_[v1]; ++r)
+    {
+        int tr = refs_[refStart_[v1] + r];
+        if (dead_[tr])
+            continue;
+        if (contains(tr, v0))
+        {
+            dead_[tr] = 1;
+            --live_;
+            continue;
+        }
+        for (k = 0; k < 3; ++k)
+        {
+            if (tri[3 * tr + k] == v1)
+                tri[3 * tr + k] = v0;
+        }
+        refs_.push_back(tr);
+    }
+    for (r = 0; r < refCount_[v0]; ++r)
+    {
+        int tr = refs_[refStart_[v0] + r];
+        if (!dead_[tr])
+            refs_.push_back(tr);
+    }
+    refStart_[v0] = start;
+    refCount_[v0] = refs_.size() - start;
+    refCount_[v1] = 0;
+    if (refs_.size() > refsLimit_)
+        buildRefs();
+
+    int stampC = ++stamp_;
+    for (r = 0; r < refCount_[v0]; ++r)
+    {
+        int tr = refs_[refStart_[v0] + r];
+        for (k = 0; k < 3; ++k)
+        {
+            int w = tri[3 * tr + k];
+            if (w != v0 && markA_[w] != stampC)
+            {
+                markA_[w] = stampC;
+                pushEdge(v0, w);
+            }
+        }
+    }
+    return true;
+}
+
+int MeshDecimator::Run(int target, int max_valence, double boundary_weight)
+{
+    int nv = coord.size() / 3;
+    int nt = tri.size() / 3;
+    dead_.assign(nt, 0);
+    live_ = 0;
+    int t;
+    for (t = 0; t < nt; ++t)
+    {
+        const int *c = &tri[3 * t];
+        if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2])
+            dead_[t] = 1;
+        else
+            ++live_;
+    }
+    removed_.assign(nv, 0);
+    version_.assign(nv, 0);
+    markA_.assign(nv, 0);
+    markB_.assign(nv, 0);
+    stamp_ = 0;
+    queue_ = std::priority_queue<Collapse, vector<Collapse>, std::greater<Collapse> >();
+
+    buildRefs();
+    computeQuadrics(boundary_weight);
+
+    // every edge is queued once from its lower vertex
+    int v, r, k;
+    for (v = 0; v < nv; ++v)
+    {
+        int stamp = ++stamp_;
+        for (r = 0; r < refCount_[v]; ++r)
+        {
+            t = refs_[refStart_[v] + r];
+            if (dead_[t])
+                continue;
+            for (k = 0; k < 3; ++k)
+            {
+                int w = tri[3 * t + k];
+                if (w <= v || markA_[w] == stamp)
+                    continue;
+                markA_[w] = stamp;
+                if (seed.empty() || seed[v] || seed[w])
+                    pushEdge(v, w);
+            }
+        }
+    }
+
+    while (live_ > target && !queue_.empty())
+    {
+        Collapse c = queue_.top();
+        queue_.pop();
+        if (removed_[c.v0] || removed_[c.v1]
+            || version_[c.v0] != c.version0 || version_[c.v1] != c.version1)
+        {
+            continue;
+        }
+        collapse(c.v0, c.v1, max_valence);
+    }
+
+    if (nnormal_ > 0)
+    {
+        for (v = 0; v < nv; ++v)
+        {
+            if (!removed_[v])
+                Normalise(&attr[nattr_ * v + nnormal_]);
+        }
+    }
+    return live_;
+}
+}
+
+ParallelQuadric::ParallelQuadric(vector<float> &x_c,
+                                 vector<float> &y_c,
+                                 vector<float> &z_c,
+                                 vector<int> &conn_list,
+                                 vector<float> &data_c,
+                                 vector<float> &normals_c)
+    : _x_c(x_c)
+    , _y_c(y_c)
+    , _z_c(z_c)
+    , _conn_list(conn_list)
+    , _data_c(data_c)
+    , _normals_c(normals_c)
+{
+}
+
+int
+ParallelQuadric::Simplify(float ratio, int max_valence, float boundary_factor)
+{
+    int nv = _x_c.size();
+    int nt = _conn_list.size() / 3;
+    if (nv == 0 || nt == 0)
+        return 0;
+    int ndata = _data_c.size() / nv;
+    int nnormal = _normals_c.size() / nv;
+    int nattr = ndata + nnormal;
+    int target = int(nt * ratio);
+
+    MeshDecimator mesh(nattr);
+    if (nnormal == 3)
+        mesh.setNormalOffset(ndata);
+    mesh.coord.resize(3 * nv);
+    mesh.attr.resize(nattr * nv);
+    int v, k;
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (v = 0; v < nv; ++v)
+    {
+        float p[3] = { _x_c[v], _y_c[v], _z_c[v] };
+        for (k = 0; k < 3; ++k)
+        {
+            mesh.coord[3 * v + k] = p[k];
+            if (p[k] < lo[k])
+                lo[k] = p[k];
+            if (p[k] > hi[k])
+                hi[k] = p[k];
+        }
+        for (k = 0; k < ndata; ++k)
+            mesh.attr[nattr * v + k] = _data_c[ndata * v + k];
+        for (k = 0; k < nnormal; ++k)
+            mesh.attr[nattr * v + ndata + k] = _normals_c[nnormal * v + k];
+    }
+
+    int nparts = 1;
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1)
+        nparts = 2 * omp_get_max_threads();
+#endif
+    nparts = std::min(nparts, nt / PARTITION_MIN_TRIANGLES);
+    if (nparts < 1)
+        nparts = 1;
+
+    if (nparts > 1)
+    {
+        // slabs with equal numbers of vertices along the longest axis
+        int axis = 0;
+        for (k = 1; k < 3; ++k)
+        {
+            if (hi[k] - lo[k] > hi[axis] - lo[axis])
+                axis = k;
+        }
+        const int nbins = 256 * nparts;
+        float extent = hi[axis] - lo[axis];
+        float scale = extent > 0.0f ? nbins / extent : 0.0f;
+        vector<int> bin(nv);
+        vector<int> binCount(nbins, 0);
+        for (v = 0; v < nv; ++v)
+        {
+            int b = int((mesh.coord[3 * v + axis] - lo[axis]) * scale);
+            bin[v] = std::min(b, nbins - 1);
+            ++binCount[bin[v]];
+        }
+        vector<int> binPart(nbins);
+        int sum = 0;
+        int b;
+        for (b = 0; b < nbins; ++b)
+        {
+            binPart[b] = std::min(int((long long)sum * nparts / nv), nparts - 1);
+            sum += binCount[b];
+        }
+
+        vector<int> part(nv);
+#pragma omp parallel for
+        for (v = 0; v < nv; ++v)
+            part[v] = binPart[bin[v]];
+
+        // triangles with vertices in different slabs (-1) stay for the border pass
+        vector<int> triPart(nt);
+        int t;
+#pragma omp parallel for
+        for (t = 0; t < nt; ++t)
+        {
+            int p = part[_conn_list[3 * t]];
+            if (part[_conn_list[3 * t + 1]] != p || part[_conn_list[3 * t + 2]] != p)
+                p = -1;
+            triPart[t] = p;
+        }
+
+        vector<int> partStart(nparts + 2, 0);
+        for (t = 0; t < nt; ++t)
+            ++partStart[triPart[t] + 2];
+        int p;
+        for (p = 1; p < nparts + 2; ++p)
+            partStart[p] += partStart[p - 1];
+        vector<int> sortedTris(nt);
+        for (t = 0; t < nt; ++t)
+            sortedTris[partStart[triPart[t] + 1]++] = t;
+        // partStart[p+1] is now the start of partition p, partStart[0] of the border
+
+        vector<char> locked(nv, 0);
+        for (t = 0; t < partStart[1]; ++t)
+        {
+            const int *c = &_conn_list[3 * sortedTris[t]];
+            locked[c[0]] = locked[c[1]] = locked[c[2]] = 1;
+        }
+
+        vector<vector<int> > partTris(nparts);
+        vector<int> localIndex(nv, -1);
+#pragma omp parallel for schedule(dynamic)
+        for (p = 0; p < nparts; ++p)
+        {
+            int begin = partStart[p + 1];
+            int end = partStart[p + 2];
+            MeshDecimator local(nattr);
+            if (nnormal == 3)
+                local.setNormalOffset(ndata);
+            vector<int> globalIndex;
+            local.tri.reserve(3 * (end - begin));
+            int i, j;
+            // the vertices of a partition's triangles belong to that partition only
+            for (i = begin; i < end; ++i)
+            {
+                const int *c = &_conn_list[3 * sortedTris[i]];
+                for (j = 0; j < 3; ++j)
+                {
+                    int g = c[j];
+                    if (localIndex[g] < 0)
+                    {
+                        localIndex[g] = globalIndex.size();
+                        globalIndex.push_back(g);
+                    }
+                    local.tri.push_back(localIndex[g]);
+                }
+            }
+            int nlocal = globalIndex.size();
+            local.coord.resize(3 * nlocal);
+            local.attr.resize(nattr * nlocal);
+            local.locked.resize(nlocal);
+            for (i = 0; i < nlocal; ++i)
+            {
+                int g = globalIndex[i];
+                std::copy(&mesh.coord[3 * g], &mesh.coord[3 * g] + 3, &local.coord[3 * i]);
+                std::copy(mesh.attr.begin() + nattr * g, mesh.attr.begin() + nattr * (g + 1),
+                          local.attr.begin() + nattr * i);
+                local.locked[i] = locked[g];
+            }
+
+            local.Run(int((end - begin) * ratio), max_valence, boundary_factor);
+
+            // removed vertices are not referenced any more, writing them back does no harm
+            for (i = 0; i < nlocal; ++i)
+            {
+                int g = globalIndex[i];
+                std::copy(&local.coord[3 * i], &local.coord[3 * i] + 3, &mesh.coord[3 * g]);
+                std::copy(local.attr.begin() + nattr * i, local.attr.begin() + nattr * (i + 1),
+                          mesh.attr.begin() + nattr * g);
+            }
+            int ntl = local.tri.size() / 3;
+            for (i = 0; i < ntl; ++i)
+            {
+                if (local.isDead(i))
+                    continue;
+                for (j = 0; j < 3; ++j)
+                    partTris[p].push_back(globalIndex[local.tri[3 * i + j]]);
+            }
+        }
+
+        size_t nconn = 3 * partStart[1];
+        for (p = 0; p < nparts; ++p)
+            nconn += partTris[p].size();
+        mesh.tri.reserve(nconn);
+        for (t = 0; t < partStart[1]; ++t)
+        {
+            const int *c = &_conn_list[3 * sortedTris[t]];
+            mesh.tri.insert(mesh.tri.end(), c, c + 3);
+        }
+        for (p = 0; p < nparts; ++p)
+        {
+            mesh.tri.insert(mesh.tri.end(), partTris[p].begin(), partTris[p].end());
+            vector<int>().swap(partTris[p]);
+        }
+        mesh.seed.swap(locked);
+    }
+    else
+    {
+        mesh.tri = _conn_list;
+    }
+
+    // border pass, or the whole mesh if it was not partitioned
+    mesh.Run(target, max_valence, boundary_factor);
+
+    // compact the result
+    vector<int> newIndex(nv, -1);
+    int nleft = 0;
+    _conn_list.clear();
+    int ntm = mesh.tri.size() / 3;
+    int t;
+    for (t = 0; t < ntm; ++t)
+    {
+        if (mesh.isDead(t))
+            continue;
+        for (k = 0; k < 3; ++k)
+        {
+            int g = mesh.tri[3 * t + k];
+            if (newIndex[g] < 0)
+                newIndex[g] = nleft++;
+            _conn_list.push_back(newIndex[g]);
+        }
+    }
+    _x_c.resize(nleft);
+    _y_c.resize(nleft);
+    _z_c.resize(nleft);
+    _data_c.resize(ndata * nleft);
+    _normals_c.resize(nnormal * nleft);
+    for (v = 0; v < nv; ++v)
+    {
+        int n = newIndex[v];
+        if (n < 0)
+            continue;
+        _x_c[n] = mesh.coord[3 * v];
+        _y_c[n] = mesh.coord[3 * v + 1];
+        _z_c[n] = mesh.coord[3 * v + 2];
+        for (k = 0; k < ndata; ++k)
+            _data_c[ndata * n + k] = mesh.attr[nattr * v + k];
+        for (k = 0; k < nnormal; ++k)
+            _normals_c[nnormal * n + k] = mesh.attr[nattr * v + ndata + k];
+    }
+    return nparts;
+}
@@ -0,0 +1,51 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  CLASS ParallelQuadric
+//
+//  Quadric error edge collapse on compact index based arrays.
+//  The vertices are split into slabs along the longest axis of the
+//  bounding box, the slabs are simplified independently in parallel
+//  with the vertices of triangles crossing a slab border locked.
+//  A final serial pass only starts from edges at the former borders.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _PARALLEL_QUADRIC_H_
+#define _PARALLEL_QUADRIC_H_
+
+#include "util/coviseCompat.h"
+
+class ParallelQuadric
+{
+public:
+    /// the arguments are overwritten with the reduced geometry by Simplify,
+    /// data_c and normals_c may be empty or hold 1 or 3 values per vertex
+    ParallelQuadric(vector<float> &x_c,
+                    vector<float> &y_c,
+                    vector<float> &z_c,
+                    vector<int> &conn_list,
+                    vector<float> &data_c,
+                    vector<float> &normals_c);
+
+    /** reduce the number of triangles
+       * @param ratio           fraction of triangles to be kept
+       * @param max_valence     highest valence of a vertex after a collapse
+       * @param boundary_factor weight of the planes keeping boundary edges in place
+       * @return number of partitions which were simplified in parallel
+       */
+    int Simplify(float ratio, int max_valence, float boundary_factor);
+
+private:
+    vector<float> &_x_c;
+    vector<float> &_y_c;
+    vector<float> &_z_c;
+    vector<int> &_conn_list;
+    vector<float> &_data_c;
+    vector<float> &_normals_c;
+};
+#endif
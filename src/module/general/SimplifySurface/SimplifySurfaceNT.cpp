@@ -9,10 +9,12 @@
 #include "Point.h"
 #include "EdgeCollapse.h"
 #include "EdgeCollapseSimple.h"
+#include "ParallelQuadric.h"
 #include <do/coDoTriangleStrips.h>
 #include <do/coDoData.h>
 #include <alg/coFeatureLines.h>
 #include <config/CoviseConfig.h>
+#include <util/coWristWatch.h>
 
 #ifdef HAVE_VTK
 #include <vtkVersion.h>
@@ -71,10 +73,13 @@ SimplifySurface::SimplifySurface(int argc, char *argv[])
     p_normalsOut = addOutputPort("normalsOut", "Vec3", "The interpolated normals");
     p_normalsOut->setDependencyPort(p_normalsIn);
 
-#ifdef HAVE_VTK
-    const char *method_labels[] = { "EdgeCollapse", "QuadricClustering", "DecimatePro", "QuadricDecimation" };
     p_method = addChoiceParam("method", "simplification algorithm");
-    p_method->setValue(4, method_labels, 0);
+#ifdef HAVE_VTK
+    const char *method_labels[] = { "EdgeCollapse", "QuadricClustering", "DecimatePro", "QuadricDecimation", "ParallelQuadric" };
+    p_method->setValue(5, method_labels, 0);
+#else
+    const char *method_labels[] = { "EdgeCollapse", "ParallelQuadric" };
+    p_method->setValue(2, method_labels, 0);
 #endif
 
     param_percent = addFloatParam("percent", "Percentage of triangles to be left after simplification");
@@ -140,6 +145,16 @@ SimplifySurface::SimplifySurface(int argc, char *argv[])
     cf_Algorithm = coCoviseConfig::getInt("Module.SimplifySurface.Algorithm", 2);
 }
 
+int SimplifySurface::getMethod() const
+{
+#ifdef HAVE_VTK
+    return p_method->getValue();
+#else
+    // without VTK only EdgeCollapse and ParallelQuadric are offered
+    return p_method->getValue() == 0 ? EDGECOLLAPSE : PARALLELQUADRIC;
+#endif
+}
+
 float max_cos_2;
 float normaldeviation_cos;
 float domaindeviation_cos;
@@ -223,6 +238,7 @@ void SimplifySurface::param(const char *paramname, bool /*inMapLoading*/)
             break;
 
         case QUADRICDECIMATION:
+        case PARALLELQUADRIC:
             param_percent->enable();
             param_normaldeviation->disable();
             param_domaindeviation->disable();
@@ -551,63 +567,81 @@ SimplifySurface::compute(const char *)
 
     float total_ratio = percent * 0.01f;
 
+    int method = getMethod();
 #ifdef HAVE_VTK
-    if (p_method->getValue() == EDGECOLLAPSE)
+    if (method == EDGECOLLAPSE || method == PARALLELQUADRIC)
     {
 #endif
-        int stage;
         int num_ini_triangles = tri_conn_list.size() / 3;
         int ziel_triangles = int(tri_conn_list.size() * total_ratio / 3);
-        for (stage = 0; stage < 1; ++stage) // @@@ relict from original version
+        if (method == PARALLELQUADRIC)
         {
-            float stage_num_ini_triangles = tri_conn_list.size() / 3.0f;
-            if (stage_num_ini_triangles <= ziel_triangles)
+            coWristWatch ww;
+            ParallelQuadric parallelQuadric(x_c, y_c, z_c, tri_conn_list, data_c, normals_c);
+            int num_partitions = parallelQuadric.Simplify(total_ratio, max_valence, boundary_factor);
+            float elapsed = ww.elapsed();
+            sendInfo("ParallelQuadric: %d partitions, %6.3f s, %.0f triangles/s",
+                     num_partitions, elapsed,
+                     elapsed > 0.0f ? num_ini_triangles / elapsed : 0.0f);
+            if (tri_conn_list.size() / 3 > (size_t)ziel_triangles)
             {
-                break;
+                sendWarning("...could not attain goal.");
             }
-            // @@@ relict from original version
-            float remaining_reduction = ziel_triangles / stage_num_ini_triangles;
-            float stage_ratio = remaining_reduction;
-            EdgeCollapseBasis *edgeCollapse = NULL;
-            if (cf_Algorithm == 1)
-            {
-                edgeCollapse = new EdgeCollapse(x_c, y_c, z_c,
-                                                tri_conn_list, data_c, normals_c,
-                                                VertexContainer::VECTOR,
-                                                TriangleContainer::VECTOR,
-                                                EdgeContainer::HASHED_SET);
-            }
-            else
-            {
-                edgeCollapse = new EdgeCollapseSimple(x_c, y_c, z_c,
-                                                      tri_conn_list, data_c, normals_c,
-                                                      VertexContainer::VECTOR,
-                                                      TriangleContainer::VECTOR,
-                                                      EdgeContainer::HASHED_SET);
-            }
-            // reduction is expected here...
-            float num_tri_red = 0;
-            string message("Initial number of triangles for ");
-            char buf[512];
-            sprintf(buf, "is %lu, trying reduction up to %.2f%%...",
-                    (unsigned long)tri_conn_list.size() / 3,
-                    stage_ratio * 100.0);
-            message += buf;
-            sendInfo("%s", message.c_str());
-            while ((1.0 - (num_tri_red / stage_num_ini_triangles)) > stage_ratio)
+        }
+        else
+        {
+            int stage;
+            for (stage = 0; stage < 1; ++stage) // @@@ relict from original version
             {
-                int reduced = edgeCollapse->EdgeContraction(max_valence);
-                if (reduced < 0)
+                float stage_num_ini_triangles = tri_conn_list.size() / 3.0f;
+                if (stage_num_ini_triangles <= ziel_triangles)
                 {
-                    sendWarning("...could not attain goal at this stage.");
                     break;
                 }
-                num_tri_red += reduced;
-            }
-            // get reduced results
-            edgeCollapse->LeftEntities(tri_conn_list, x_c, y_c, z_c, data_c, normals_c);
+                // @@@ relict from original version
+                float remaining_reduction = ziel_triangles / stage_num_ini_triangles;
+                float stage_ratio = remaining_reduction;
+                EdgeCollapseBasis *edgeCollapse = NULL;
+                if (cf_Algorithm == 1)
+                {
+                    edgeCollapse = new EdgeCollapse(x_c, y_c, z_c,
+                                                    tri_conn_list, data_c, normals_c,
+                                                    VertexContainer::VECTOR,
+                                                    TriangleContainer::VECTOR,
+                                                    EdgeContainer::HASHED_SET);
+                }
+                else
+                {
+                    edgeCollapse = new EdgeCollapseSimple(x_c, y_c, z_c,
+                                                          tri_conn_list, data_c, normals_c,
+                                                          VertexContainer::VECTOR,
+                                                          TriangleContainer::VECTOR,
+                                                          EdgeContainer::HASHED_SET);
+                }
+                // reduction is expected here...
+                float num_tri_red = 0;
+                string message("Initial number of triangles for ");
+                char buf[512];
+                sprintf(buf, "is %lu, trying reduction up to %.2f%%...",
+                        (unsigned long)tri_conn_list.size() / 3,
+                        stage_ratio * 100.0);
+                message += buf;
+                sendInfo("%s", message.c_str());
+                while ((1.0 - (num_tri_red / stage_num_ini_triangles)) > stage_ratio)
+                {
+                    int reduced = edgeCollapse->EdgeContraction(max_valence);
+                    if (reduced < 0)
+                    {
+                        sendWarning("...could not attain goal at this stage.");
+                        break;
+                    }
+                    num_tri_red += reduced;
+                }
+                // get reduced results
+                edgeCollapse->LeftEntities(tri_conn_list, x_c, y_c, z_c, data_c, normals_c);
 
-            delete edgeCollapse;
+                delete edgeCollapse;
+            }
         }
         if (num_ini_triangles > 0)
         {
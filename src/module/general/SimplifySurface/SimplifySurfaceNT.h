@@ -26,6 +26,7 @@ using namespace covise;
 #define QUADRICCLUSTERING 1
 #define DECIMATEPRO 2
 #define QUADRICDECIMATION 3
+#define PARALLELQUADRIC 4
 
 class SimplifySurface : public coSimpleModule
 {
@@ -37,6 +38,8 @@ protected:
     virtual int compute(const char *port);
 
 private:
+    // selected algorithm, one of the defines above
+    int getMethod() const;
     // MaxAngleVertex is used by Triangulate,
     // it returns the local node of a triangle (a number
     // >= 0 and < num_conn), where num_conn is the number of polygon vertices
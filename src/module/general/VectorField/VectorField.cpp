@@ -34,6 +34,7 @@ VectField::VectField(int argc, char *argv[])
 {
     const char *ChoiseVal1[] = { "1*scale", "length*scale", "according_to_data" };
     const char *ChoiseVal2[] = { "on_the_bottom", "on_the_middle" };
+    const char *ChoiseVal3[] = { "lines", "glyphs" };
 
     //parameters
     p_scale = addFloatSliderParam("scale", "Scale factor");
@@ -48,14 +49,17 @@ VectField::VectField(int argc, char *argv[])
     p_arrow_head_factor->setValue(0.2f);
     p_arrow_head_angle = addFloatParam("arrow_head_angle", "Opening angle of arrow head");
     p_arrow_head_angle->setValue(9.5f);
+    p_output = addChoiceParam("output", "lines or points and vectors for instanced arrows");
+    p_output->setValue(2, ChoiseVal3, 0);
 
     //ports
     p_inPort1 = addInputPort("meshIn", "StructuredGrid|RectilinearGrid|UniformGrid|Polygons|Lines|UnstructuredGrid|TriangleStrips|Points", "input mesh");
     p_inPort2 = addInputPort("vdataIn", "Vec3|Mat3", "input vector data");
     p_inPort3 = addInputPort("sdataIn", "Float", "input scalar data");
     p_inPort3->setRequired(0);
-    p_outPort1 = addOutputPort("linesOut", "Lines", "Vectors (Lines)");
+    p_outPort1 = addOutputPort("linesOut", "Lines|Points", "Vectors (Lines) or arrow positions (Points)");
     p_outPort2 = addOutputPort("dataOut", "Float", "Data on arrows");
+    p_outPort3 = addOutputPort("vectorsOut", "Vec3", "Scaled vectors at the arrow positions (glyphs) or line vertices (lines)");
 }
 
 void VectField::fillRefLines(coDoMat3 *ur_data_in,
@@ -204,6 +208,7 @@ int VectField::compute(const char *)
     num_sectors_ = p_num_sectors->getValue();
     arrow_head_factor_ = p_arrow_head_factor->getValue();
     arrow_head_angle_ = p_arrow_head_angle->getValue();
+    bool glyphs = (p_output->getValue() == 1);
 
     if (num_sectors_ < 0)
     {
@@ -335,8 +340,21 @@ int VectField::compute(const char *)
          && snumc == 0)
         || vnumc == 0)
     {
-        coDistributedObject *dummyObj = new coDoLines(p_outPort1->getObjName(), 0, 0, 0);
-        p_outPort1->setCurrentObject(dummyObj);
+        coDistributedObject *dummyObj;
+        if (glyphs)
+        {
+            dummyObj = new coDoPoints(p_outPort1->getObjName(), 0);
+            p_outPort1->setCurrentObject(dummyObj);
+            dummyObj = new coDoVec3(p_outPort3->getObjName(), 0);
+            p_outPort3->setCurrentObject(dummyObj);
+        }
+        else
+        {
+            dummyObj = new coDoLines(p_outPort1->getObjName(), 0, 0, 0);
+            p_outPort1->setCurrentObject(dummyObj);
+            dummyObj = new coDoVec3(p_outPort3->getObjName(), 0);
+            p_outPort3->setCurrentObject(dummyObj);
+        }
         dummyObj = new coDoFloat(p_outPort2->getObjName(), 0);
         p_outPort2->setCurrentObject(dummyObj);
         return SUCCESS;
@@ -382,9 +400,37 @@ int VectField::compute(const char *)
         sendInfo("Mapping references: assuming length=1*scale");
     }
 
+    if (glyphs && ur_data_in)
+    {
+        glyphs = false;
+        sendInfo("Mapping references: creating lines");
+    }
+
     // create output objects
 
-    if (!ur_data_in)
+    if (glyphs)
+    {
+        // one point and one vector per arrow, the arrows are instanced by the renderer
+        coObjInfo out1(p_outPort1->getObjName());
+        coObjInfo out2(p_outPort2->getObjName());
+        coObjInfo out3(p_outPort3->getObjName());
+        vectfield->compute_vectorglyphs(scale, length_param, fasten_param,
+                                        p_outPort1->getObjName() ? &out1 : NULL,
+                                        p_outPort3->getObjName() ? &out3 : NULL,
+                                        p_outPort2->getObjName() ? &out2 : NULL);
+
+        coDoPoints *points = vectfield->get_obj_points();
+        if (points)
+        {
+            char buf[128];
+            sprintf(buf, "%d %g %g", num_sectors_, arrow_head_factor_, arrow_head_angle_);
+            points->addAttribute("VECTOR_GLYPHS", buf);
+        }
+        p_outPort1->setCurrentObject(points);
+        p_outPort2->setCurrentObject(vectfield->get_obj_scalar());
+        p_outPort3->setCurrentObject(vectfield->get_obj_vectors());
+    }
+    else if (!ur_data_in)
     {
         coObjInfo out1(p_outPort1->getObjName());
         coObjInfo out2(p_outPort2->getObjName());
@@ -397,9 +443,16 @@ int VectField::compute(const char *)
         {
             coDistributedObject *dummyObj = new coDoFloat(p_outPort2->getObjName(), 0); // work around only, TODO: Create Vector data if previous data has been vertex based or don't create a grid nor data but this is dangerous für timestep animations
             p_outPort2->setCurrentObject(dummyObj);
+            dummyObj = new coDoVec3(p_outPort3->getObjName(), 0);
+            p_outPort3->setCurrentObject(dummyObj);
         }
         else
+        {
             p_outPort2->setCurrentObject(vectfield->get_obj_scalar());
+            coObjInfo out3(p_outPort3->getObjName());
+            vectfield->compute_vectors(p_outPort3->getObjName() ? &out3 : NULL);
+            p_outPort3->setCurrentObject(vectfield->get_obj_vectors());
+        }
     }
     else
     {
@@ -52,6 +52,7 @@ private:
     coFloatSliderParam *p_scale;
     coChoiceParam *p_length;
     coChoiceParam *p_fasten;
+    coChoiceParam *p_output;
     coIntScalarParam *p_num_sectors;
     coFloatParam *p_arrow_head_factor, *p_arrow_head_angle;
 
@@ -61,6 +62,7 @@ private:
     coInputPort *p_inPort3;
     coOutputPort *p_outPort1;
     coOutputPort *p_outPort2;
+    coOutputPort *p_outPort3;
 
     // private data
 
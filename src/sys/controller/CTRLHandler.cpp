@@ -136,12 +136,18 @@ CTRLHandler::CTRLHandler(int argc, char *argv[])
     , m_xuif(0)
     , m_startScript(0)
     , m_accessGridDaemonPort(0)
+    , m_streamTimesteps(false)
+    , m_reportTimes(false)
+    , m_firstFrameTime(-1.f)
     , m_writeUndoBuffer(true)
 // == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == == ==
 {
 
     singleton = this;
 
+    m_streamTimesteps = coCoviseConfig::isOn("System.Controller.StreamTimesteps", false);
+    m_reportTimes = coCoviseConfig::isOn("System.Controller.ReportExecutionTime", m_streamTimesteps);
+
     //  create global CTRLGlobal object
     new CTRLGlobal();
 
@@ -327,6 +333,11 @@ void CTRLHandler::handleAndDeleteMsg(Message *msg)
         handleFinall(msg, copyMessageData);
         break;
 
+    //  FINPART: Module has finished a timestep and continues
+    case COVISE_MESSAGE_FINPART:
+        handleFinpart(msg, copyMessageData);
+        break;
+
     //  FINISHED : Finish from a Rendermodule
     case COVISE_MESSAGE_FINISHED:
     {
@@ -350,6 +361,8 @@ void CTRLHandler::handleAndDeleteMsg(Message *msg)
                 global.userinterfaceList->send_all(mapmsg);
                 global.netList->send_all_renderer(mapmsg);
                 delete mapmsg;
+
+                finishExecution();
             }
         }
         break;
@@ -1380,6 +1393,7 @@ void CTRLHandler::handleFinall(Message *msg, string copyMessageData)
                 module->set_start();
                 module->start_modules(global.userinterfaceList);
                 module->set_status(MODULE_IDLE);
+                module->reset_streaming();
             }
 
             else
@@ -1404,9 +1418,82 @@ void CTRLHandler::handleFinall(Message *msg, string copyMessageData)
         global.userinterfaceList->send_all(mapmsg);
         global.netList->send_all_renderer(mapmsg);
         delete mapmsg;
+
+        finishExecution();
+    }
+}
+
+//!
+//! handle a timestep which a module has finished while it is still running
+//!
+void CTRLHandler::handleFinpart(Message *, string copyMessageData)
+{
+    vector<string> list = splitString(copyMessageData, "\n");
+    if (list.size() < 6)
+        return;
+
+    net_module *module = global.netList->get(list[0], list[1], list[2]);
+    if (!module)
+        return;
+
+    int step = atoi(list[3].c_str());
+    int numSteps = atoi(list[4].c_str());
+    int count = atoi(list[5].c_str());
+
+    // timestep -1: sent once after startup by modules which can execute single timesteps
+    if (step < 0)
+    {
+        module->set_accepts_stream_steps(true);
+        return;
+    }
+
+    if (!m_streamTimesteps || (module->get_status() != MODULE_RUNNING && !module->is_streaming()))
+        return;
+
+    module->set_streaming();
+    size_t iel = 6;
+    for (int i = 0; i < count && iel + 1 < list.size(); i++)
+    {
+        string port = list[iel];
+        iel++;
+        string objName = list[iel];
+        iel++;
+        module->stream_output(global.userinterfaceList, port, objName, step, numSteps);
     }
 }
 
+void CTRLHandler::startExecution()
+{
+    m_execWatch.reset();
+    m_firstFrameTime = -1.f;
+}
+
+void CTRLHandler::firstFrame()
+{
+    if (m_numRunning > 0 && m_firstFrameTime < 0.f)
+        m_firstFrameTime = m_execWatch.elapsed();
+}
+
+void CTRLHandler::finishExecution()
+{
+    net_module *netmod;
+    global.netList->reset();
+    while ((netmod = global.netList->next()) != NULL)
+        netmod->reset_streaming();
+
+    if (!m_reportTimes)
+        return;
+
+    ostringstream os;
+    os << "Controller\n \n \n";
+    if (m_firstFrameTime >= 0.f)
+        os << "first object sent to renderer after " << m_firstFrameTime << " s, ";
+    os << "execution finished after " << m_execWatch.elapsed() << " s";
+    Message *msg = new Message(COVISE_MESSAGE_INFO, os.str());
+    global.userinterfaceList->send_all(msg);
+    delete msg;
+}
+
 //!
 //!
 //!
@@ -3565,6 +3652,9 @@ vector<string> CTRLHandler::splitString(string text, const string &sep)
 
 bool CTRLHandler::recreate(string content, readMode mode)
 {
+    coWristWatch loadWatch;
+    int numStarted = 0;
+
     // send message to UI that loading of a map has been started
     Message *tmpmsg;
     if (mode == NETWORKMAP)
@@ -3696,7 +3786,10 @@ bool CTRLHandler::recreate(string content, readMode mode)
             }
             int id = initModuleNode(name, current, host, posx, posy, title, 2, Start::Normal);
             if (id != -1)
+            {
                 nrnew = (global.netList->get(id))->get_nr();
+                ++numStarted;
+            }
         }
 
         else
@@ -3842,7 +3935,16 @@ bool CTRLHandler::recreate(string content, readMode mode)
     }
 
     if (mode == NETWORKMAP)
+    {
+        ostringstream os;
+        os << "Controller\n \n \n";
+        os << "network " << m_globalFilename << " loaded: " << numStarted << " modules started in " << loadWatch.elapsed() << " s";
+        tmpmsg = new Message(COVISE_MESSAGE_INFO, os.str());
+        global.userinterfaceList->send_all(tmpmsg);
+        delete tmpmsg;
+
         tmpmsg = new Message(COVISE_MESSAGE_UI, "END_READING\ntrue");
+    }
     else
         tmpmsg = new Message(COVISE_MESSAGE_UI, "END_READING\nfalse");
     global.userinterfaceList->send_all(tmpmsg);
@@ -11,6 +11,8 @@
 #include <QMap>
 #include <QStringList>
 
+#include <util/coWristWatch.h>
+
 #include "CTRLGlobal.h"
 
 class QString;
@@ -57,6 +59,13 @@ public:
     bool recreate(string buffer, readMode mode);
     void sendMessage();
 
+    /// called when the first module of an execution is started
+    void startExecution();
+    /// called when an object is handed to a renderer
+    void firstFrame();
+    /// called when no module is running anymore
+    void finishExecution();
+
 private:
     static CTRLHandler *singleton;
     FILE *fp;
@@ -73,6 +82,13 @@ private:
     int m_SSLDaemonPort;
     SSLClient *m_SSLClient;
 
+    // forward timesteps from streaming modules before their execution has finished
+    bool m_streamTimesteps;
+    // report time to the first rendered object and to the end of an execution
+    bool m_reportTimes;
+    coWristWatch m_execWatch;
+    float m_firstFrameTime;
+
     int parseCommandLine(int argc, char **argv);
     void startCrbUiDm();
     void loadNetworkFile();
@@ -81,6 +97,7 @@ private:
     void handleQuit(Message *msg);
     void handleUI(Message *msg, string data);
     void handleFinall(Message *msg, string data);
+    void handleFinpart(Message *msg, string data);
     void delModuleNode(vector<net_module *> liste);
     int initModuleNode(const string &name, const string &nr, const string &host, int, int, const string &, int, Start::Flags flags);
     void makeConnection(const string &from_mod, const string &from_nr, const string &from_host, const string &from_port,
@@ -226,6 +226,8 @@ net_module::net_module()
     m_alive = 1;
     m_mirror = 0;
     m_mirror_nodes = new Liste<Mirrored_Modules>(1);
+    m_streaming = false;
+    m_acceptsStreamSteps = false;
 }
 
 net_module::~net_module()
@@ -372,6 +374,80 @@ void net_module::set_start()
     }
 }
 
+void net_module::reset_streaming()
+{
+    m_streaming = false;
+    m_streamInputs.clear();
+}
+
+void net_module::stream_output(ui_list *ul, const string &intf_name, const string &DO_name, int step, int num_steps)
+{
+    net_interface *intf;
+    interfaces->reset();
+    while ((intf = (net_interface *)interfaces->next()) != NULL)
+    {
+        if (intf->get_direction() == "output" && intf->get_name() == intf_name)
+            break;
+    }
+    if (intf == NULL || intf->get_conn_state() != true)
+        return;
+
+    object *obj = intf->get_object();
+    obj_conn_list *to = obj->get_to();
+    to->reset();
+    obj_conn *tmp_conn;
+    while ((tmp_conn = to->next()) != NULL)
+    {
+        net_module *mod = tmp_conn->get_mod();
+        if (mod)
+            mod->send_stream_step(ul, obj, tmp_conn->get_mod_intf(), DO_name, step, num_steps);
+    }
+}
+
+void net_module::send_stream_step(ui_list *ul, object *, const string &intf_name,
+                                  const string &DO_name, int step, int num_steps)
+{
+    // a module still busy with a complete execution is started normally later
+    if (!m_acceptsStreamSteps || !is_alive() || get_status() == MODULE_RUNNING || m_mirror == CPY_MIRR)
+        return;
+
+    m_streamInputs[step][intf_name] = DO_name;
+
+    // wait until the ports fed by other streaming modules have this timestep,
+    // objects from modules which do not stream are used as they are
+    net_interface *intf;
+    interfaces->reset();
+    while ((intf = (net_interface *)interfaces->next()) != NULL)
+    {
+        if (intf->get_direction() == "input" && intf->get_conn_state() == true)
+        {
+            net_module *from = intf->get_object()->get_from()->get_mod();
+            if (from && from->is_streaming() && m_streamInputs[step].count(intf->get_name()) == 0)
+                return;
+        }
+    }
+
+    if (!m_streaming)
+    {
+        // name the output objects for this execution, the timesteps become
+        // the elements of these objects when the module is started normally
+        m_streaming = true;
+        delete_old_objs();
+        new_obj_names();
+    }
+
+    string content = get_startmessage(ul, step);
+    m_streamInputs.erase(step);
+    if (content.empty())
+        return;
+
+    ostringstream os;
+    os << step << "\n" << num_steps << "\n" << content;
+    Message *msg = new Message(COVISE_MESSAGE_FINPART, os.str());
+    applmod->send_msg(msg);
+    delete msg;
+}
+
 void net_module::start_modules(ui_list *ul)
 {
     net_interface *intf;
@@ -413,6 +489,7 @@ void net_module::exec_module(ui_list *uilist)
             CTRLHandler::instance()->m_numRunning++;
             if (CTRLHandler::instance()->m_numRunning == 1) // switch to execution mode
             {
+                CTRLHandler::instance()->startExecution();
                 Message *ex_msg = new Message(COVISE_MESSAGE_UI, "INEXEC");
                 uilist->send_all(ex_msg);
                 CTRLGlobal &global = CTRLGlobal::get_handle();
@@ -551,6 +628,18 @@ bool net_module::is_one_running_above(int first)
 
 bool net_module::delete_old_objs()
 {
+    // timesteps of an execution which did not finish normally
+    if (!m_streamObjects.empty())
+    {
+        for (size_t i = 0; i < m_streamObjects.size(); i++)
+        {
+            data stale;
+            stale.set_name(m_streamObjects[i]);
+            stale.del_data(datam);
+        }
+        m_streamObjects.clear();
+    }
+
     net_interface *intf;
     interfaces->reset();
     while ((intf = (net_interface *)interfaces->next()) != NULL)
@@ -997,7 +1086,7 @@ void net_module::add_param(const string &param_name, const string &add_param)
     para->set_addvalue(add_param);
 }
 
-string net_module::get_startmessage(ui_list *ul)
+string net_module::get_startmessage(ui_list *ul, int step)
 {
 
     ostringstream buffS;
@@ -1046,6 +1135,24 @@ string net_module::get_startmessage(ui_list *ul)
             if (obj_name.empty())
                 return "";
 
+            if (step >= 0)
+            {
+                if (tmp_intf->get_direction() == "output")
+                {
+                    // named like the set elements created by coSimpleModule
+                    ostringstream os;
+                    os << obj_name << "_" << step;
+                    obj_name = os.str();
+                    m_streamObjects.push_back(obj_name);
+                }
+                else
+                {
+                    std::map<string, string> &inputs = m_streamInputs[step];
+                    if (inputs.find(intf_name) != inputs.end())
+                        obj_name = inputs[intf_name];
+                }
+            }
+
             buffS << intf_name << "\n" << obj_name << "\n" << obj->get_type() << "\n";
             if (obj->get_to() && obj->get_to()->isEmpty())
                 buffS << "UNCONNECTED"
@@ -1126,10 +1233,20 @@ void net_module::start_module(ui_list *ul)
 
     set_status(MODULE_RUNNING);
 
-    //delete_all Objects if not saved
-    bool ret = delete_old_objs();
-    //give new Names to Output_objects
-    new_obj_names();
+    bool ret = false;
+    // output objects of a streamed execution are already named
+    if (!m_streaming)
+    {
+        //delete_all Objects if not saved
+        ret = delete_old_objs();
+        //give new Names to Output_objects
+        new_obj_names();
+    }
+    else
+    {
+        // the timesteps become elements of the complete output sets
+        m_streamObjects.clear();
+    }
 
     // reset error list of the module
     if (m_errors)
@@ -2335,6 +2452,19 @@ void display::send_add()
     }
 }
 
+// the renderer appends the timestep to the sequence set_name, no FINISHED is expected
+void display::send_stream_step(const string &set_name, const string &DO_name, int step, int num_steps)
+{
+    ostringstream os;
+    os << "STREAM_STEP\n" << set_name << "\n" << DO_name << "\n" << step << "\n" << num_steps << "\n";
+    Message *msg = new Message(COVISE_MESSAGE_RENDER, os.str());
+
+    if (!is_helper())
+        applmod->send_msg(msg);
+
+    delete msg;
+}
+
 void display::send_del(const string &DO_old_name, const string &DO_new_name)
 {
     CTRLHandler::instance()->m_numRunning++;
@@ -2644,6 +2774,17 @@ void displaylist::send_add(const string &DO_name)
     }
 }
 
+void displaylist::send_stream_step(const string &set_name, const string &DO_name, int step, int num_steps)
+{
+    display *tmp_dis;
+
+    this->reset();
+    while ((tmp_dis = this->next()) != NULL)
+    {
+        tmp_dis->send_stream_step(set_name, DO_name, step, num_steps);
+    }
+}
+
 void displaylist::send_del(const string &DO_name, const string &DO_new_name)
 {
     display *tmp_dis;
@@ -3106,6 +3247,8 @@ void render_module::send_add(ui_list *ul, object *obj, void *connection)
     // Namen des neuen DO lesen
     string DO_name = obj->get_current_name();
 
+    CTRLHandler::instance()->firstFrame();
+
     // existent and not empty
     if (!old_name.empty())
         displays->send_del(old_name, DO_name);
@@ -3125,6 +3268,13 @@ void render_module::send_add(ui_list *ul, object *obj, void *connection)
     }
 }
 
+void render_module::send_stream_step(ui_list *, object *obj, const string &,
+                                     const string &DO_name, int step, int num_steps)
+{
+    CTRLHandler::instance()->firstFrame();
+    displays->send_stream_step(obj->get_current_name(), DO_name, step, num_steps);
+}
+
 void render_module::start_module(ui_list *ul)
 {
 
@@ -20,6 +20,8 @@
 #include "control_object.h"
 #include "control_module.h"
 #include <string>
+#include <map>
+#include <vector>
 
 //#ifndef __sgi
 //#include <sys/times.h>
@@ -322,6 +324,21 @@ class net_module
     /// list to the mirrored versions of this module
     Liste<Mirrored_Modules> *m_mirror_nodes;
 
+    /// the module takes part in a streamed execution, its output
+    /// objects have been named for the current execution
+    bool m_streaming;
+
+    /// streamed timesteps waiting for objects on other input ports:
+    /// step -> (input port -> object name)
+    std::map<int, std::map<string, string> > m_streamInputs;
+
+    /// the module has announced that it can execute single timesteps
+    bool m_acceptsStreamSteps;
+
+    /// output objects of streamed timesteps, owned by the module's complete
+    /// output sets once it has been started normally
+    std::vector<string> m_streamObjects;
+
 public:
     /// member functions which are different in render_module
 
@@ -682,6 +699,61 @@ public:
        */
     void exec_module(ui_list *uilist);
 
+    /**
+       *  check if the module has received or produced single timesteps
+       *  during the current execution
+       */
+    bool is_streaming()
+    {
+        return m_streaming;
+    };
+
+    /**
+       *  mark the module as source of a streamed execution
+       */
+    void set_streaming()
+    {
+        m_streaming = true;
+    };
+
+    /**
+       *  mark the module as able to execute single timesteps,
+       *  only such modules are sent streamed timesteps
+       */
+    void set_accepts_stream_steps(bool accepts)
+    {
+        m_acceptsStreamSteps = accepts;
+    };
+
+    /**
+       *  end the streamed execution of the module
+       */
+    void reset_streaming();
+
+    /**
+       *  forward a single timestep finished on an output port
+       *  to the connected modules and renderers
+       *  @param  ul         list of user interfaces
+       *  @param  intf_name  name of the output port
+       *  @param  DO_name    name of the timestep object
+       *  @param  step       number of the timestep
+       *  @param  num_steps  number of timesteps of the complete object
+       */
+    void stream_output(ui_list *ul, const string &intf_name, const string &DO_name, int step, int num_steps);
+
+    /**
+       *  execute the module for a single timestep arriving on an input port
+       *  as soon as all streamed input ports have received it
+       *  @param  ul         list of user interfaces
+       *  @param  obj        the connection object of the sending port
+       *  @param  intf_name  name of the input port
+       *  @param  DO_name    name of the timestep object
+       *  @param  step       number of the timestep
+       *  @param  num_steps  number of timesteps of the complete object
+       */
+    virtual void send_stream_step(ui_list *ul, object *obj, const string &intf_name,
+                                  const string &DO_name, int step, int num_steps);
+
     /**
        *  send a message with an object to be displayed by the renderer
        *       - NOT IMPLEMMENTED IN THIS CLASS
@@ -887,7 +959,7 @@ public:
     virtual string get_intf_type(const string &output_name);
     virtual void set_intf_demand(const string &intf_name, const string &new_type);
 
-    virtual string get_startmessage(ui_list *ul);
+    virtual string get_startmessage(ui_list *ul, int step = -1);
     virtual void new_obj_names();
     virtual bool delete_old_objs();
     virtual void delete_rez_objs();
@@ -976,6 +1048,7 @@ public:
     void send_add(const string &DO_name);
     void send_add();
     void send_del(const string &DO_name, const string &DO_new_name);
+    void send_stream_step(const string &set_name, const string &DO_name, int step, int num_steps);
 
     void send_status(const string &info_str);
     void send_message(Message *msg);
@@ -1004,6 +1077,7 @@ public:
 
     void send_add(const string &DO_name);
     void send_del(const string &DO_name, const string &DO_new_name);
+    void send_stream_step(const string &set_name, const string &DO_name, int step, int num_steps);
 
     void decr_ready()
     {
@@ -1076,6 +1150,8 @@ public:
 
     void start_module(ui_list *ul);
     void send_add(ui_list *ul, object *obj, void *connection);
+    void send_stream_step(ui_list *ul, object *obj, const string &intf_name,
+                          const string &DO_name, int step, int num_steps);
     int get_mod_id();
 
     int update(int sender, ui_list *uilist);
@@ -0,0 +1,231 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include <covise/covise.h>
+#include <config/CoviseConfig.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <dlfcn.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#endif
+
+#include "CRB_Launcher.h"
+
+using namespace covise;
+
+#ifndef _WIN32
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// signature of the entry point defined by MODULE_MAIN
+typedef int (*ModuleMain)(int argc, char *argv[]);
+
+static bool readAll(int fd, void *buf, size_t len)
+{
+    char *p = (char *)buf;
+    while (len > 0)
+    {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const void *buf, size_t len)
+{
+    const char *p = (const char *)buf;
+    while (len > 0)
+    {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+#endif
+
+moduleLauncher::moduleLauncher()
+    : fd(-1)
+    , pid(-1)
+{
+}
+
+moduleLauncher::~moduleLauncher()
+{
+#ifndef _WIN32
+    // the launcher terminates when the socket is closed
+    if (fd >= 0)
+        close(fd);
+#endif
+}
+
+bool moduleLauncher::init()
+{
+#ifdef _WIN32
+    return false;
+#else
+    if (!coCoviseConfig::isOn("System.CRB.Launcher", true))
+        return false;
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+    {
+        fprintf(stderr, "module launcher: socketpair failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    // don't duplicate buffered output in the children
+    fflush(stdout);
+    fflush(stderr);
+    pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        serve(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid == -1)
+    {
+        fprintf(stderr, "module launcher: fork failed: %s\n", strerror(errno));
+        close(fds[0]);
+        return false;
+    }
+    fd = fds[0];
+    return true;
+#endif
+}
+
+bool moduleLauncher::start(const char *execpath, char *argv[])
+{
+#ifdef _WIN32
+    (void)execpath;
+    (void)argv;
+    return false;
+#else
+    if (fd < 0)
+        return false;
+
+    // request: length, then execpath and the arguments, each terminated by '\0'
+    std::string request(execpath);
+    request += '\0';
+    for (int i = 0; argv[i]; ++i)
+    {
+        request += argv[i];
+        request += '\0';
+    }
+    int len = (int)request.length();
+    int child = -1;
+    if (!writeAll(fd, &len, sizeof(len))
+        || !writeAll(fd, request.data(), len)
+        || !readAll(fd, &child, sizeof(child)))
+    {
+        fprintf(stderr, "module launcher terminated, starting modules with execv\n");
+        close(fd);
+        fd = -1;
+        return false;
+    }
+    return child > 0;
+#endif
+}
+
+void moduleLauncher::serve(int sock)
+{
+#ifndef _WIN32
+    // children are not waited for, as in module::start
+    signal(SIGCHLD, SIG_IGN);
+
+    // entry points of the modules opened so far, NULL if there is no shared object
+    std::map<std::string, ModuleMain> entries;
+    std::vector<char> buf;
+    for (;;)
+    {
+        int len = 0;
+        if (!readAll(sock, &len, sizeof(len)) || len <= 0)
+            break;
+        buf.resize(len);
+        if (!readAll(sock, &buf[0], len))
+            break;
+
+        std::vector<char *> argv;
+        for (int i = 0; i < len; i += (int)strlen(&buf[i]) + 1)
+            argv.push_back(&buf[i]);
+        std::string execpath = argv[0];
+        argv.erase(argv.begin());
+        int argc = (int)argv.size();
+        argv.push_back(NULL);
+
+        ModuleMain entry = NULL;
+        std::map<std::string, ModuleMain>::iterator it = entries.find(execpath);
+        if (it != entries.end())
+        {
+            entry = it->second;
+        }
+        else
+        {
+            // keep the library open, later instances are relocated already
+            std::string lib = execpath + ".so";
+            if (access(lib.c_str(), R_OK) == 0)
+            {
+                void *handle = dlopen(lib.c_str(), RTLD_NOW | RTLD_LOCAL);
+                if (handle)
+                {
+                    entry = (ModuleMain)dlsym(handle, "coModuleMain");
+                    if (!entry)
+                        dlclose(handle);
+                }
+                else
+                {
+                    fprintf(stderr, "module launcher: %s\n", dlerror());
+                }
+            }
+            entries[execpath] = entry;
+        }
+
+        int child = -1;
+        if (entry)
+        {
+            fflush(stdout);
+            fflush(stderr);
+            child = fork();
+            if (child == 0)
+            {
+                close(sock);
+                signal(SIGCHLD, SIG_DFL);
+#ifdef __linux__
+                if (argc > 0)
+                    prctl(PR_SET_NAME, argv[0], 0, 0, 0);
+#endif
+                exit(entry(argc, &argv[0]));
+            }
+            if (child == -1)
+                fprintf(stderr, "module launcher: fork for %s failed: %s\n", execpath.c_str(), strerror(errno));
+        }
+        if (!writeAll(sock, &child, sizeof(child)))
+            break;
+    }
+    close(sock);
+#else
+    (void)sock;
+#endif
+}
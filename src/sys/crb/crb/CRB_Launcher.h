@@ -0,0 +1,49 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef CRB_LAUNCHER_H
+#define CRB_LAUNCHER_H
+
+/************************************************************************/
+/* 									*/
+/* 			moduleLauncher 					*/
+/* 									*/
+/************************************************************************/
+
+// Pre-forked launcher for modules
+//
+// The launcher is forked from the CRB before it connects to the controller,
+// so it already has the COVISE libraries loaded and relocated and the
+// configuration parsed. Modules that are also available as shared object
+// (<execpath>.so, built with COVISE_BUILD_MODULE_LIBRARIES) are opened once
+// by the launcher, every instance is a fork of the launcher that calls the
+// coModuleMain entry point defined by MODULE_MAIN.
+// Modules without shared object have to be started with execv as before.
+//
+// Config: System.CRB.Launcher, default on
+class moduleLauncher
+{
+public:
+    moduleLauncher();
+    ~moduleLauncher();
+
+    // fork the launcher process, returns false if it is disabled or failed
+    bool init();
+
+    // start a module instance in a child of the launcher,
+    // returns false if the module has to be started with execv
+    bool start(const char *execpath, char *argv[]);
+
+private:
+    int fd; // socket to the launcher process
+    int pid;
+
+    // main loop of the launcher process
+    static void serve(int sock);
+};
+
+#endif
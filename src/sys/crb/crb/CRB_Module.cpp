@@ -25,6 +25,7 @@
 #endif
 
 #include "CRB_Module.h"
+#include "CRB_Launcher.h"
 #include <covise/Covise_Util.h>
 
 #ifndef NO_VRB
@@ -40,6 +41,7 @@ using namespace covise;
 extern bool rendererIsPossible;
 extern bool rendererIsActive;
 extern DataManagerProcess *datamgr;
+extern moduleLauncher *launcher;
 
 // this is our own C++ conformant strcpy routine
 inline char *STRDUP(const char *old)
@@ -293,6 +295,10 @@ void module::start(char *parameter, Start::Flags flags)
 #endif
 
 #else
+    // modules available as shared object are forked from the warm launcher
+    if (flags == Start::Normal && launcher && launcher->start(execpath, argv))
+        return;
+
     int pid = fork();
     if (0 == pid)
     {
@@ -620,7 +626,9 @@ void moduleList::search_dir(char *path, char *subdir)
             }
 #endif
 #ifndef _WIN32
-            if (dir->is_exe(i))
+            // skip shared objects of modules for the launcher
+            int namelen = (int)strlen(dir->name(i));
+            if (dir->is_exe(i) && !(namelen >= 3 && !strcmp(dir->name(i) + namelen - 3, ".so")))
             {
                 if (!find((char *)dir->name(i), subdir))
                     appendModule((char *)dir->name(i), tmp, subdir);
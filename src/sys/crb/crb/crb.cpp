@@ -29,6 +29,7 @@
 
 #include <covise/covise_version.h>
 #include "CRB_Module.h"
+#include "CRB_Launcher.h"
 #include <dmgr/dmgr.h>
 #include <covise/Covise_Util.h>
 
@@ -46,6 +47,7 @@ char err_name[20];
 bool rendererIsPossible = false;
 bool rendererIsActive = false;
 DataManagerProcess *datamgr;
+moduleLauncher *launcher = NULL;
 Host *host;
 
 int main(int argc, char *argv[])
@@ -98,6 +100,15 @@ int main(int argc, char *argv[])
     sprintf(err_name, "err%d", id);
     int send_back = 0;
 
+    // fork the module launcher before shared memory and connections are set up,
+    // it must not own any of them
+    launcher = new moduleLauncher();
+    if (!launcher->init())
+    {
+        delete launcher;
+        launcher = NULL;
+    }
+
     key = 2000 + (id << 24);
     datamgr = new DataManagerProcess((char *)"CRB", id, &key);
 
@@ -151,6 +162,7 @@ int main(int argc, char *argv[])
         /////  UI
 
         case COVISE_MESSAGE_QUIT:
+            delete launcher;
             delete datamgr;
             exit(0);
             break;
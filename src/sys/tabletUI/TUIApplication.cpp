@@ -618,147 +618,163 @@ QWidget *TUIMainWindow::getWidget(int ID)
 }
 
 //------------------------------------------------------------------------
-bool TUIMainWindow::handleClient(covise::Message *msg)
+void TUIMainWindow::handleTabletMessage(covise::TokenBuffer &tb)
 //------------------------------------------------------------------------
 {
-    if((msg->type == covise::COVISE_MESSAGE_SOCKET_CLOSED) || (msg->type == covise::COVISE_MESSAGE_CLOSE_SOCKET))
+    int type;
+    tb >> type;
+    int ID;
+    switch (type)
     {
-        delete clientSN;
-        clientSN = NULL;
-        connections->remove(msg->conn); //remove connection;
-        delete msg->conn;
-        msg->conn = NULL;
-        clientConn = NULL;
-        lastElement = NULL;
-        lastID = -10;
 
-        //remove all UI Elements
-        while (elements.size())
-        {
-            TUIElement *ele = *(elements.begin()); // destructor removes the element from the list
-            delete ele;
-        }
-
-#ifdef TABLET_PLUGIN
-        MEUserInterface::instance()->removeTabletUI();
-#endif
-        return true; // we have been deleted, exit immediately
-    }
-    covise::TokenBuffer tb(msg);
-    switch (msg->type)
-    {
-    case covise::COVISE_MESSAGE_TABLET_UI:
+    case TABLET_CREATE:
     {
-        int type;
-        tb >> type;
-        int ID;
-        //if(ID >= 0)
-        // {
-        switch (type)
-        {
+        tb >> ID;
+        int elementType, parent;
+        char *name;
+        tb >> elementType;
+        tb >> parent;
+        tb >> name;
+        //cerr << "TUIApplication::handleClient info: Create: ID: " << ID << " Type: " << elementType << " name: "<< name << " parent: " << parent << std::endl;
+        TUIContainer *parentElem = (TUIContainer *)getElement(parent);
+
+        QWidget *parentWidget;
+        if (parentElem)
+            parentWidget = parentElem->getWidget();
+        else
+            parentWidget = mainFrame;
 
-        case TABLET_CREATE:
+        TUIElement *newElement = createElement(ID, elementType, parentWidget, parent, name);
+        if (newElement)
         {
-            tb >> ID;
-            int elementType, parent;
-            char *name;
-            tb >> elementType;
-            tb >> parent;
-            tb >> name;
-            //cerr << "TUIApplication::handleClient info: Create: ID: " << ID << " Type: " << elementType << " name: "<< name << " parent: " << parent << std::endl;
-            TUIContainer *parentElem = (TUIContainer *)getElement(parent);
-
-            QWidget *parentWidget;
+            lastElement = newElement;
             if (parentElem)
-                parentWidget = parentElem->getWidget();
-            else
-                parentWidget = mainFrame;
-
-            TUIElement *newElement = createElement(ID, elementType, parentWidget, parent, name);
-            if (newElement)
-            {
-                lastElement = newElement;
-                if (parentElem)
-                    parentElem->addElement(lastElement);
-                lastID = ID;
-                QString parentName;
-                if (parentElem)
-                    parentName = parentElem->getName();
-                std::string blacklist = "COVER.TabletPC.Blacklist:";
-                QString qname(name);
-                qname.replace(".", "").replace(":", "");
-                blacklist += qname.toStdString();
+                parentElem->addElement(lastElement);
+            lastID = ID;
+            QString parentName;
+            if (parentElem)
+                parentName = parentElem->getName();
+            std::string blacklist = "COVER.TabletPC.Blacklist:";
+            QString qname(name);
+            qname.replace(".", "").replace(":", "");
+            blacklist += qname.toStdString();
 // TODO: won't work for items with identical names but different parents - a random item will be found
 //std::string value = covise::coCoviseConfig::getEntry(blacklist);
 
 #if !defined _WIN32_WCE && !defined ANDROID_TUI
-                std::string parent = covise::coCoviseConfig::getEntry("parent", blacklist);
-                if (covise::coCoviseConfig::isOn(blacklist, false) && (parent.empty() || parent == parentName.toStdString()))
-                {
-                    newElement->setHidden(true);
-                }
-#endif
+            std::string parent = covise::coCoviseConfig::getEntry("parent", blacklist);
+            if (covise::coCoviseConfig::isOn(blacklist, false) && (parent.empty() || parent == parentName.toStdString()))
+            {
+                newElement->setHidden(true);
             }
+#endif
         }
-        break;
-        case TABLET_SET_VALUE:
+    }
+    break;
+    case TABLET_SET_VALUE:
+    {
+        int type;
+        tb >> type;
+        tb >> ID;
+        //cerr << "TUIApplication::handleClient info: Set Value ID: " << ID <<" Type: "<< type << endl;
+        if (ID == lastID && (lastElement))
         {
-            int type;
-            tb >> type;
-            tb >> ID;
-            //cerr << "TUIApplication::handleClient info: Set Value ID: " << ID <<" Type: "<< type << endl;
-            if (ID == lastID && (lastElement))
-            {
-                lastElement->setValue(type, tb);
-            }
-            else
-            {
-                TUIElement *ele = getElement(ID);
-                if (ele)
-                {
-                    lastElement = ele;
-                    lastID = ID;
-                    ele->setValue(type, tb);
-                }
-                else
-                {
-                    std::cerr << "TUIApplication::handleClient warn: element not available in setValue: " << ID << std::endl;
-                }
-            }
+            lastElement->setValue(type, tb);
         }
-        break;
-        case TABLET_REMOVE:
+        else
         {
-            tb >> ID;
-            if (ID == lastID)
-            {
-                lastElement = NULL;
-                lastID = -10;
-            }
-
             TUIElement *ele = getElement(ID);
             if (ele)
             {
-                delete ele;
+                lastElement = ele;
+                lastID = ID;
+                ele->setValue(type, tb);
             }
             else
             {
-#ifdef DEBUG
-                std::cerr << "TUIApplication::handleClient warn: element not available in remove: " << ID << std::endl;
-#endif
+                std::cerr << "TUIApplication::handleClient warn: element not available in setValue: " << ID << std::endl;
             }
         }
-        break;
+    }
+    break;
+    case TABLET_REMOVE:
+    {
+        tb >> ID;
+        if (ID == lastID)
+        {
+            lastElement = NULL;
+            lastID = -10;
+        }
 
-        default:
+        TUIElement *ele = getElement(ID);
+        if (ele)
         {
-            std::cerr << "TUIApplication::handleClient err: unhandled message type " << type << std::endl;
+            delete ele;
         }
-        break;
+        else
+        {
+#ifdef DEBUG
+            std::cerr << "TUIApplication::handleClient warn: element not available in remove: " << ID << std::endl;
+#endif
         }
-        //}
     }
     break;
+
+    case TABLET_BATCH:
+    {
+        int count;
+        tb >> count;
+        for (int i = 0; i < count; ++i)
+        {
+            int len;
+            tb >> len;
+            covise::TokenBuffer sub(tb.getBinary(len), len);
+            handleTabletMessage(sub);
+        }
+    }
+    break;
+
+    default:
+    {
+        std::cerr << "TUIApplication::handleClient err: unhandled message type " << type << std::endl;
+    }
+    break;
+    }
+}
+
+//------------------------------------------------------------------------
+bool TUIMainWindow::handleClient(covise::Message *msg)
+//------------------------------------------------------------------------
+{
+    if((msg->type == covise::COVISE_MESSAGE_SOCKET_CLOSED) || (msg->type == covise::COVISE_MESSAGE_CLOSE_SOCKET))
+    {
+        delete clientSN;
+        clientSN = NULL;
+        connections->remove(msg->conn); //remove connection;
+        delete msg->conn;
+        msg->conn = NULL;
+        clientConn = NULL;
+        lastElement = NULL;
+        lastID = -10;
+
+        //remove all UI Elements
+        while (elements.size())
+        {
+            TUIElement *ele = *(elements.begin()); // destructor removes the element from the list
+            delete ele;
+        }
+
+#ifdef TABLET_PLUGIN
+        MEUserInterface::instance()->removeTabletUI();
+#endif
+        return true; // we have been deleted, exit immediately
+    }
+    covise::TokenBuffer tb(msg);
+    switch (msg->type)
+    {
+    case covise::COVISE_MESSAGE_TABLET_UI:
+        handleTabletMessage(tb);
+        break;
     default:
     {
         if (msg->type > 0)
@@ -88,6 +88,8 @@ private slots:
     bool handleClient(covise::Message *msg);
 
 private:
+    // message for the UI elements, a TABLET_BATCH contains several of them
+    void handleTabletMessage(covise::TokenBuffer &tb);
 #ifndef TABLET_PLUGIN
     void createMenubar();
     void createToolbar();
@@ -202,6 +202,8 @@ void VRBServer::processMessages()
 #endif
         }
     }
+    // one delta message per observer for all registry changes of this round
+    registry.flushUpdates();
 }
 
 void VRBServer::handleClient(Message *msg)
@@ -10,6 +10,8 @@
 #include "VRBClientList.h"
 #include <util/unixcompat.h>
 #include <net/tokenbuffer.h>
+#include <config/CoviseConfig.h>
+#include <algorithm>
 
 using namespace std;
 using namespace covise;
@@ -93,10 +95,14 @@ regVar::regVar(regClass *c, const char *n, const char *v, int s)
     strcpy(name, n);
     setValue(v);
     staticVar = s;
+    changed = false;
 }
 
 regVar::~regVar()
 {
+    // observers have to see the last change before the deletion
+    if (changed && coRegistry::instance)
+        coRegistry::instance->flushUpdates();
     observers.informDeleteObservers(this);
     getClass()->getOList()->informDeleteObservers(this);
     delete[] name;
@@ -190,7 +196,7 @@ void coRegistry::setVar(const char *className, int ID, const char *name, const c
     {
         regClass *grc;
         rc = new regClass(className, ID);
-        append(rc);
+        addClass(rc);
         grc = getClass(className, 0);
         if (grc)
         {
@@ -206,10 +212,9 @@ void coRegistry::setVar(const char *className, int ID, const char *name, const c
     else
     {
         rv = new regVar(rc, name, value);
-        rc->append(rv);
+        rc->addVar(rv);
     }
-    rc->getOList()->serveObservers(rv);
-    rv->getOList()->serveObservers(rv);
+    changed(rv);
     rv->updateUIs();
 }
 
@@ -221,7 +226,7 @@ void coRegistry::create(const char *className, int ID, const char *name, int s)
     {
         regClass *grc;
         rc = new regClass(className, ID);
-        append(rc);
+        addClass(rc);
         grc = getClass(className, 0);
         if (grc)
         {
@@ -233,9 +238,91 @@ void coRegistry::create(const char *className, int ID, const char *name, int s)
     if (!rv)
     {
         rv = new regVar(rc, name, "", s);
-        rc->append(rv);
+        rc->addVar(rv);
+    }
+    if (batchUpdates)
+        changed(rv);
+    else
+        rc->getOList()->serveObservers(rv);
+}
+
+void coRegistry::addClass(regClass *rc)
+{
+    append(rc);
+    classIndex[rc->getName()].push_back(rc);
+}
+
+void coRegistry::changed(regVar *rv)
+{
+    if (!batchUpdates)
+    {
+        rv->getClass()->getOList()->serveObservers(rv);
+        rv->getOList()->serveObservers(rv);
+        return;
+    }
+    if (!rv->isChanged())
+    {
+        rv->setChanged(true);
+        changedVars.push_back(rv);
+    }
+}
+
+void coRegistry::flushUpdates()
+{
+    if (changedVars.empty())
+        return;
+
+    // the last value of every changed variable, once for each observer of
+    // the variable or its class
+    std::vector<int> recv;
+    for (size_t i = 0; i < changedVars.size(); ++i)
+    {
+        regVar *rv = changedVars[i];
+        regClass *rc = rv->getClass();
+        rv->setChanged(false);
+
+        recv.clear();
+        observerList *ol = rc->getOList();
+        for (int j = 0; j < ol->getNumObservers(); ++j)
+            recv.push_back(ol->getObserver(j));
+        ol = rv->getOList();
+        for (int j = 0; j < ol->getNumObservers(); ++j)
+            recv.push_back(ol->getObserver(j));
+        std::sort(recv.begin(), recv.end());
+        recv.erase(std::unique(recv.begin(), recv.end()), recv.end());
+
+        for (size_t j = 0; j < recv.size(); ++j)
+        {
+            Delta &d = deltas[recv[j]];
+            if (!d.tb)
+                d.tb = new TokenBuffer();
+            *d.tb << rc->getName();
+            *d.tb << rc->getID();
+            *d.tb << rv->getName();
+            *d.tb << rv->getValue();
+            d.numEntries++;
+        }
+    }
+    changedVars.clear();
+
+    std::map<int, Delta>::iterator it;
+    for (it = deltas.begin(); it != deltas.end(); ++it)
+    {
+        Delta &d = it->second;
+        if (d.numEntries == 1)
+        {
+            clients.sendMessageToID(*d.tb, it->first, COVISE_MESSAGE_VRB_REGISTRY_ENTRY_CHANGED);
+        }
+        else if (d.numEntries > 1)
+        {
+            // an empty class name terminates the list
+            *d.tb << "";
+            clients.sendMessageToID(*d.tb, it->first, COVISE_MESSAGE_VRB_REGISTRY_ENTRIES_CHANGED);
+        }
+        if (d.tb)
+            d.tb->reset();
+        d.numEntries = 0;
     }
-    rc->getOList()->serveObservers(rv);
 }
 
 /// get a boolean Variable
@@ -272,17 +359,14 @@ void coRegistry::deleteEntry(const char *className, int ID, const char *name)
     {
         return;
     }
-    reset();
-    while (current())
+    unordered_map<std::string, std::vector<regClass *> >::iterator it = classIndex.find(className);
+    if (it == classIndex.end())
+        return;
+    std::vector<regClass *> &classes = it->second;
+    for (size_t i = 0; i < classes.size(); ++i)
     {
-        if ((ID == 0) || (current()->getID() == ID))
-        {
-            if (!strcmp(current()->getName(), className))
-            {
-                current()->deleteVar(name);
-            }
-        }
-        next();
+        if ((ID == 0) || (classes[i]->getID() == ID))
+            classes[i]->deleteVar(name);
     }
 }
 
@@ -309,17 +393,18 @@ regClass *coRegistry::getClass(const char *name, int ID)
     {
         return (NULL);
     }
-    reset();
-    while (current())
+    unordered_map<std::string, std::vector<regClass *> >::iterator it = classIndex.find(name);
+    if (it == classIndex.end())
     {
-        if ((ID == 0) || (current()->getID() == ID))
-        {
-            if (!strcmp(current()->getName(), name))
-                return (current());
-        }
-        next();
+        //cerr << "Class " << name << " not found!\n";
+        return (NULL);
+    }
+    std::vector<regClass *> &classes = it->second;
+    for (size_t i = 0; i < classes.size(); ++i)
+    {
+        if ((ID == 0) || (classes[i]->getID() == ID))
+            return (classes[i]);
     }
-    //cerr << "Class " << name << " not found!\n";
     return (NULL);
 }
 
@@ -331,6 +416,13 @@ void coRegistry::unObserve(int recvID)
         current()->unObserve(recvID);
         next();
     }
+
+    std::map<int, Delta>::iterator it = deltas.find(recvID);
+    if (it != deltas.end())
+    {
+        delete it->second.tb;
+        deltas.erase(it);
+    }
 }
 
 void coRegistry::observe(const char *className, int ID, int recvID, const char *variableName)
@@ -340,18 +432,18 @@ void coRegistry::observe(const char *className, int ID, int recvID, const char *
         return;
     }
     int foundOne = 0;
-    reset();
-    while (current())
+    unordered_map<std::string, std::vector<regClass *> >::iterator it = classIndex.find(className);
+    if (it != classIndex.end())
     {
-        if ((ID == 0) || (current()->getID() == ID))
+        std::vector<regClass *> &classes = it->second;
+        for (size_t i = 0; i < classes.size(); ++i)
         {
-            if (!strcmp(current()->getName(), className))
+            if ((ID == 0) || (classes[i]->getID() == ID))
             {
-                current()->observe(recvID, variableName);
+                classes[i]->observe(recvID, variableName);
                 foundOne = 1;
             }
         }
-        next();
     }
     if (!foundOne)
     {
@@ -359,7 +451,7 @@ void coRegistry::observe(const char *className, int ID, int recvID, const char *
         if (!rc)
         {
             rc = new regClass(className, ID);
-            append(rc);
+            addClass(rc);
         }
         rc->observe(recvID, variableName);
     }
@@ -372,18 +464,18 @@ void coRegistry::unObserve(const char *className, int ID, int recvID, const char
         return;
     }
     int foundOne = 0;
-    reset();
-    while (current())
+    unordered_map<std::string, std::vector<regClass *> >::iterator it = classIndex.find(className);
+    if (it != classIndex.end())
     {
-        if ((ID == 0) || (current()->getID() == ID))
+        std::vector<regClass *> &classes = it->second;
+        for (size_t i = 0; i < classes.size(); ++i)
         {
-            if (!strcmp(current()->getName(), className))
+            if ((ID == 0) || (classes[i]->getID() == ID))
             {
-                current()->unObserve(recvID, variableName);
+                classes[i]->unObserve(recvID, variableName);
                 foundOne = 1;
             }
         }
-        next();
     }
     if (!foundOne)
     {
@@ -402,7 +494,7 @@ void regClass::observe(int recvID, const char *variableName)
         if (!rv)
         {
             rv = new regVar(this, variableName, "coNULL");
-            append(rv);
+            addVar(rv);
         }
         rv->observe(recvID);
     }
@@ -448,32 +540,34 @@ regVar *regClass::getVar(const char *n)
     {
         return (NULL);
     }
-    reset();
-    while (current())
-    {
-        if (!strcmp(current()->getName(), n))
-            return (current());
-        next();
-    }
+    unordered_map<std::string, regVar *>::iterator it = varIndex.find(n);
+    if (it != varIndex.end())
+        return (it->second);
     //cerr << "Var " << n << " not found in Class "<< name <<"!\n";
     return (NULL);
 }
 
+void regClass::addVar(regVar *v)
+{
+    append(v);
+    varIndex[v->getName()] = v;
+}
+
 void regClass::deleteVar(const char *n)
 {
     if (!n)
     {
         return;
     }
-    reset();
-    while (current())
+    unordered_map<std::string, regVar *>::iterator it = varIndex.find(n);
+    if (it != varIndex.end())
     {
-        if (!strcmp(current()->getName(), n))
-        {
-            remove();
-            return;
-        }
-        next();
+        regVar *v = it->second;
+        varIndex.erase(it);
+        coDLListIter<regVar *> iter = findElem(v);
+        if (iter)
+            iter.remove();
+        return;
     }
     cerr << "Var " << n << " not found in Class " << name << "!\n";
 }
@@ -485,6 +579,7 @@ void regClass::deleteAllNonStaticVars()
     {
         if (!(current()->isStatic()))
         {
+            varIndex.erase(current()->getName());
             remove();
         }
         else
@@ -547,4 +642,14 @@ coRegistry::coRegistry()
     instance = this;
     setNoDelete();
     regMode = 0;
+    batchUpdates = coCoviseConfig::isOn("System.VRB.RegistryDeltas", true);
+}
+
+coRegistry::~coRegistry()
+{
+    std::map<int, Delta>::iterator it;
+    for (it = deltas.begin(); it != deltas.end(); ++it)
+        delete it->second.tb;
+    if (instance == this)
+        instance = NULL;
 }
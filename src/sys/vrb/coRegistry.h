@@ -9,6 +9,15 @@
 #define regVar_H
 
 #include <util/coDLList.h>
+#include <alg/unordered_set.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace covise
+{
+class TokenBuffer;
+}
 
 class netModule;
 class coCharBuffer;
@@ -32,6 +41,14 @@ public:
     void serveObservers(regVar *v);
     void informDeleteObservers(regVar *v);
     void copyObservers(regClass *v);
+    int getNumObservers() const
+    {
+        return numObservers;
+    };
+    int getObserver(int i) const
+    {
+        return observers[i];
+    };
 
     ~observerList()
     {
@@ -47,6 +64,7 @@ private:
     regClass *myClass;
     observerList observers;
     int staticVar;
+    bool changed;
 
 public:
     regVar(regClass *c, const char *n, const char *v, int s = 1);
@@ -92,6 +110,15 @@ public:
     {
         return (&observers);
     };
+    /// true if the value has changed since the last coRegistry::flushUpdates()
+    bool isChanged() const
+    {
+        return changed;
+    };
+    void setChanged(bool c)
+    {
+        changed = c;
+    };
     /**
        * add Variables to Script
        */
@@ -105,6 +132,7 @@ private:
     char *name;
     int classID;
     observerList observers;
+    unordered_map<std::string, regVar *> varIndex;
 
 public:
     regClass(const char *n, int ID);
@@ -124,6 +152,8 @@ public:
     };
     /// getVariableEntry, returns NULL if not found
     regVar *getVar(const char *name);
+    /// append a new Variable
+    void addVar(regVar *v);
     /// get list of Observers
     observerList *getOList()
     {
@@ -149,10 +179,30 @@ public:
  */
 class coRegistry : public covise::coDLPtrList<regClass *>
 {
+    // all classes with the same name, in the order they were created
+    unordered_map<std::string, std::vector<regClass *> > classIndex;
+
+    // send changes once per tick if true, otherwise immediately
+    bool batchUpdates;
+    std::vector<regVar *> changedVars;
+    // one reused send buffer per observer
+    struct Delta
+    {
+        covise::TokenBuffer *tb;
+        int numEntries;
+    };
+    std::map<int, Delta> deltas;
+
+    void addClass(regClass *rc);
+    void changed(regVar *rv);
+
 public:
     /// constructor initializes Variables with values from yac.config:regVariables
     int regMode;
     coRegistry();
+    ~coRegistry();
+    /// send all changes since the last call, one message per observer
+    void flushUpdates();
     /// getClassEntry, returns NULL if not found
     regClass *getClass(const char *name, int ID = 0);
     /// set a Value or create new Entry
@@ -0,0 +1,92 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef BENCH_GRID_H
+#define BENCH_GRID_H
+
+/**
+ * Unstructured grid of hexahedra or tetrahedra on the unit cube, shared by
+ * the benchmarks of the grid algorithms in tools/bench
+ */
+
+#include <do/coDoUnstructuredGrid.h>
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+struct BenchGrid
+{
+    int n; // cubes per side
+    std::vector<int> el, cl, tl;
+    std::vector<float> x, y, z;
+    std::vector<int> cube; // cube of each cell, i + n * (j + n * k)
+};
+
+//
+//  n^3 hexahedra, or 6 n^3 tetrahedra conforming between the cubes
+//  shuffle: cells in random order with a fixed seed, so that neighbouring
+//           cells are far apart in memory as in many solver outputs
+//
+inline void makeBenchGrid(int n, bool tets, bool shuffle, BenchGrid &grid)
+{
+    int nn = n + 1;
+    grid.n = n;
+    for (int k = 0; k < nn; k++)
+    {
+        for (int j = 0; j < nn; j++)
+        {
+            for (int i = 0; i < nn; i++)
+            {
+                grid.x.push_back((float)i / n);
+                grid.y.push_back((float)j / n);
+                grid.z.push_back((float)k / n);
+            }
+        }
+    }
+
+    std::vector<int> order(n * n * n);
+    for (size_t c = 0; c < order.size(); c++)
+        order[c] = (int)c;
+    if (shuffle)
+    {
+        srand(4711);
+        for (size_t c = order.size(); c > 1; c--)
+            std::swap(order[c - 1], order[((size_t)rand() * (RAND_MAX + 1ul) + rand()) % c]);
+    }
+
+    for (size_t c = 0; c < order.size(); c++)
+    {
+        int i = order[c] % n, j = (order[c] / n) % n, k = order[c] / (n * n);
+        int v = (k * nn + j) * nn + i;
+        int hex[8] = { v, v + 1, v + nn + 1, v + nn,
+                       v + nn * nn, v + nn * nn + 1, v + nn * nn + nn + 1, v + nn * nn + nn };
+        if (!tets)
+        {
+            grid.el.push_back((int)grid.cl.size());
+            grid.tl.push_back(TYPE_HEXAEDER);
+            grid.cl.insert(grid.cl.end(), hex, hex + 8);
+            grid.cube.push_back(order[c]);
+            continue;
+        }
+        // six tetrahedra around the diagonal 0-6
+        const int ring[7] = { 1, 2, 3, 7, 4, 5, 1 };
+        for (int t = 0; t < 6; t++)
+        {
+            grid.el.push_back((int)grid.cl.size());
+            grid.tl.push_back(TYPE_TETRAHEDER);
+            grid.cl.push_back(hex[0]);
+            grid.cl.push_back(hex[ring[t]]);
+            grid.cl.push_back(hex[ring[t + 1]]);
+            grid.cl.push_back(hex[6]);
+            grid.cube.push_back(order[c]);
+        }
+    }
+}
+
+#endif
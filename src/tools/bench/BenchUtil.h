@@ -0,0 +1,90 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+/**
+ * Helpers shared by the benchmarks in tools/bench and OpenCOVER/bench:
+ * a stop watch on coWristWatch and the thread counts to run with
+ */
+
+#include <util/coWristWatch.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <vector>
+
+// wall clock time of a run, keeps the fastest of all runs
+class BenchTimer
+{
+public:
+    BenchTimer()
+        : runs(0)
+        , fastest(0.)
+    {
+    }
+
+    void start()
+    {
+        watch.reset();
+    }
+
+    // seconds since start()
+    double elapsed()
+    {
+        return watch.elapsed();
+    }
+
+    // seconds since start(), counted as one run
+    double stop()
+    {
+        double t = watch.elapsed();
+        if (runs == 0 || t < fastest)
+            fastest = t;
+        ++runs;
+        return t;
+    }
+
+    // fastest of the runs so far
+    double best() const
+    {
+        return fastest;
+    }
+
+private:
+    covise::coWristWatch watch;
+    int runs;
+    double fastest;
+};
+
+// 1, 2, 4, ... threads up to the OpenMP maximum, which is always included
+inline std::vector<int> benchThreadCounts()
+{
+    int maxThreads = 1;
+#ifdef _OPENMP
+    maxThreads = omp_get_max_threads();
+#endif
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+inline void benchSetThreads(int threads)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+}
+
+#endif
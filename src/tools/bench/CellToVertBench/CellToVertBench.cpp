@@ -0,0 +1,193 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Cell to vertex interpolation: serial scatter against parallel gather
+ *
+ * An unstructured grid of n^3 hexahedra carries a scalar and a vector
+ * field per cell. Both are averaged to the vertices by the serial scatter
+ * loop coCellToVert used before, and by coCellToVert::interpolate
+ * (algorithm SIMPLE) with 1, 2, 4, ... threads up to the OpenMP maximum.
+ * "new" builds the vertex->cell index in every run, as for a grid the
+ * module sees for the first time (with one thread coCellToVert falls back
+ * to the scatter then), "cached" reuses the index the module keeps for a
+ * grid that is interpolated again.
+ *
+ * Reported are the times per run and the speedup against the scatter.
+ * The results have to be bit-identical. -s shuffles the cell order, so
+ * that neighbouring cells are far apart in memory as in many solver
+ * outputs, -r sets the number of runs of which the fastest is reported.
+ */
+
+#include "BenchGrid.h"
+#include "BenchUtil.h"
+
+#include <alg/coCellToVert.h>
+#include <do/coDoUnstructuredGrid.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+
+using namespace covise;
+
+struct Grid : BenchGrid
+{
+    std::vector<float> s, u, v, w;
+};
+
+static void makeGrid(int n, bool shuffle, Grid &grid)
+{
+    makeBenchGrid(n, false, shuffle, grid);
+    for (size_t c = 0; c < grid.cube.size(); c++)
+    {
+        int i = grid.cube[c] % n, j = (grid.cube[c] / n) % n, k = grid.cube[c] / (n * n);
+        float x = (i + 0.5f) / n - 0.5f, y = (j + 0.5f) / n - 0.5f, z = (k + 0.5f) / n - 0.5f;
+        grid.s.push_back(sqrtf(x * x + y * y + z * z) + 0.05f * sinf(20.f * x) * sinf(17.f * y));
+        grid.u.push_back(-y);
+        grid.v.push_back(x);
+        grid.w.push_back(0.2f * sinf(6.f * z));
+    }
+}
+
+// the serial loop of coCellToVert::simpleAlgo before the gather
+static void scatter(const Grid &grid, int numComp, std::vector<float> *out)
+{
+    int numElem = (int)grid.el.size(), numConn = (int)grid.cl.size(), numPoint = (int)grid.x.size();
+    std::vector<float> weight(numPoint, 1.0e-30f);
+    for (int c = 0; c < numComp; c++)
+        out[c].assign(numPoint, 0.0f);
+    const std::vector<float> *in[3] = { numComp == 1 ? &grid.s : &grid.u, &grid.v, &grid.w };
+
+    for (int i = 0; i < numElem; i++)
+    {
+        int end = i < numElem - 1 ? grid.el[i + 1] : numConn;
+        for (int j = grid.el[i]; j < end; j++)
+        {
+            int vertex = grid.cl[j];
+            weight[vertex] += 1.0f;
+            for (int c = 0; c < numComp; c++)
+                out[c][vertex] += (*in[c])[i];
+        }
+    }
+    for (int vertex = 0; vertex < numPoint; vertex++)
+    {
+        if (weight[vertex] >= 1.0f)
+        {
+            for (int c = 0; c < numComp; c++)
+                out[c][vertex] /= weight[vertex];
+        }
+    }
+}
+
+static bool gather(const Grid &grid, int numComp, const coCellToVertIndex *index, std::vector<float> *out)
+{
+    int numElem = (int)grid.el.size(), numConn = (int)grid.cl.size(), numPoint = (int)grid.x.size();
+    for (int c = 0; c < 3; c++)
+        out[c].resize(numPoint);
+    int dataSize = numElem;
+    coCellToVert fct;
+    fct.setIndex(index);
+    if (numComp == 1)
+        return fct.interpolate(true, numElem, numConn, numPoint, &grid.el[0], &grid.cl[0], &grid.tl[0], NULL, NULL,
+                               &grid.x[0], &grid.y[0], &grid.z[0], 1, dataSize, &grid.s[0], NULL, NULL,
+                               &out[0][0], NULL, NULL, coCellToVert::SIMPLE);
+    return fct.interpolate(true, numElem, numConn, numPoint, &grid.el[0], &grid.cl[0], &grid.tl[0], NULL, NULL,
+                           &grid.x[0], &grid.y[0], &grid.z[0], 3, dataSize, &grid.u[0], &grid.v[0], &grid.w[0],
+                           &out[0][0], &out[1][0], &out[2][0], coCellToVert::SIMPLE);
+}
+
+static bool identical(const std::vector<float> *a, const std::vector<float> *b, int numComp)
+{
+    for (int c = 0; c < numComp; c++)
+    {
+        if (a[c].size() != b[c].size() || memcmp(&a[c][0], &b[c][0], a[c].size() * sizeof(float)))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int n = 128;
+    int numRuns = 3;
+    bool shuffle = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            numRuns = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s"))
+            shuffle = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [-n cells per side] [-r runs] [-s (shuffle cells)]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1 || numRuns < 1)
+        return 1;
+
+    Grid grid;
+    makeGrid(n, shuffle, grid);
+    std::vector<int> threadCounts = benchThreadCounts();
+    printf("%d cells, %d vertices, %d connectivity entries, %s cell order, up to %d threads\n",
+           (int)grid.el.size(), (int)grid.x.size(), (int)grid.cl.size(), shuffle ? "shuffled" : "grid",
+           threadCounts.back());
+
+    coCellToVertIndex index((int)grid.el.size(), (int)grid.cl.size(), (int)grid.x.size(), &grid.el[0], &grid.cl[0]);
+
+    bool ok = true;
+    for (int numComp = 1; numComp <= 3; numComp += 2)
+    {
+        std::vector<float> ref[3], out[3];
+        BenchTimer scatterTimer;
+        for (int r = 0; r < numRuns; r++)
+        {
+            scatterTimer.start();
+            scatter(grid, numComp, ref);
+            scatterTimer.stop();
+        }
+        double scatterTime = scatterTimer.best();
+        printf("%s data\n", numComp == 1 ? "scalar" : "vector");
+        printf("  threads   new ms  speedup  cached ms  speedup\n");
+        printf("  scatter  %7.1f  %7.2f\n", scatterTime * 1e3, 1.);
+
+        for (size_t t = 0; t < threadCounts.size(); t++)
+        {
+            benchSetThreads(threadCounts[t]);
+            BenchTimer gatherTimer[2];
+            bool same = true;
+            for (int cached = 0; cached < 2; cached++)
+            {
+                for (int r = 0; r < numRuns; r++)
+                {
+                    gatherTimer[cached].start();
+                    if (!gather(grid, numComp, cached ? &index : NULL, out))
+                    {
+                        fprintf(stderr, "interpolation failed\n");
+                        return 1;
+                    }
+                    gatherTimer[cached].stop();
+                }
+                same = same && identical(ref, out, numComp);
+            }
+            ok = ok && same;
+            printf("  %7d  %7.1f  %7.2f    %7.1f  %7.2f%s\n", threadCounts[t],
+                   gatherTimer[0].best() * 1e3, scatterTime / gatherTimer[0].best(),
+                   gatherTimer[1].best() * 1e3, scatterTime / gatherTimer[1].best(),
+                   same ? "" : "  results DIFFER");
+        }
+    }
+
+    printf("%s\n", ok ? "results identical" : "results DIFFER");
+    return ok ? 0 : 1;
+}
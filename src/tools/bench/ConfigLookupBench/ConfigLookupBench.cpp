@@ -0,0 +1,103 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Startup time and lookup cost of coCoviseConfig
+ *
+ * The time of the first lookup includes loading the configuration, either
+ * parsing the XML files or mapping the config cache. Then the entries are
+ * looked up i times each, as done in the hot paths of OpenCOVER.
+ *
+ * The first run fills the cache in the local config directory, compare
+ * later runs with runs with COCONFIG_CACHE=0 in the environment.
+ */
+
+#include "BenchUtil.h"
+
+#include <config/CoviseConfig.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+using namespace covise;
+
+int main(int argc, char **argv)
+{
+    int iterations = 100000;
+    std::vector<std::string> entries;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc)
+            entries.push_back(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-i iterations] [-e Scope.Entry]...\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations < 1)
+        return 1;
+    if (entries.empty())
+    {
+        // a mix of existing and missing entries, as modules query them
+        entries.push_back("System.HostInfo.Hostname");
+        entries.push_back("System.VRB.Server");
+        entries.push_back("System.CRB.Launcher");
+        entries.push_back("COVER.Stereo");
+        entries.push_back("COVER.TabletPC.Server");
+        entries.push_back("COVER.Multisample");
+        entries.push_back("COVER.Plugin.Vrml97.ViewpointType");
+        entries.push_back("Module.ReadEnsight.MemoryMap");
+    }
+
+    const char *cache = getenv("COCONFIG_CACHE");
+    printf("config cache: %s\n", cache && !strcmp(cache, "0") ? "off" : "on");
+
+    BenchTimer timer;
+    timer.start();
+    bool exists = false;
+    coCoviseConfig::getEntry(entries[0], &exists);
+    printf("first lookup (startup): %.2f ms\n", timer.elapsed() * 1e3);
+
+    int found = 0;
+    for (size_t e = 0; e < entries.size(); ++e)
+    {
+        coCoviseConfig::getEntry(entries[e], &exists);
+        if (exists)
+            ++found;
+    }
+
+    timer.start();
+    long sum = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        const std::string &entry = entries[i % entries.size()];
+        switch (i % 3)
+        {
+        case 0:
+            sum += coCoviseConfig::getEntry(entry).length();
+            break;
+        case 1:
+            sum += coCoviseConfig::getInt(entry, 0);
+            break;
+        default:
+            sum += coCoviseConfig::isOn(entry, false);
+            break;
+        }
+    }
+    double elapsed = timer.elapsed();
+    printf("%d entries (%d existing), %d lookups: %.3f us per lookup (%ld)\n",
+           (int)entries.size(), found, iterations, elapsed / iterations * 1e6, sum);
+
+    return 0;
+}
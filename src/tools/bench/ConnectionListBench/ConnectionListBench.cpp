@@ -0,0 +1,161 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Message latency of ConnectionList::check_for_input with many connections
+ *
+ * A child process opens n loopback connections to the ConnectionList of
+ * the parent and sends messages on randomly chosen connections, the parent
+ * echoes every message. The child reports the round trip times. With -b,
+ * bursts of messages are sent on one connection before the replies are
+ * read, so that the parent finds several messages in one read buffer.
+ *
+ * Compare the backends by setting useEpoll="false" in the System.Network
+ * section of the configuration, select can't handle more than FD_SETSIZE
+ * sockets.
+ */
+
+#include "BenchUtil.h"
+
+#include <net/covise_connect.h>
+#include <net/covise_host.h>
+#include <net/message.h>
+#include <net/message_types.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <vector>
+#include <algorithm>
+
+using namespace covise;
+
+static int client(int port, int numConnections, int iterations, int burst)
+{
+    std::vector<ClientConnection *> conns;
+    for (int i = 0; i < numConnections; ++i)
+    {
+        ClientConnection *conn = new ClientConnection(NULL, port, 0, 0, 20, 5.0);
+        if (!conn->is_connected())
+        {
+            fprintf(stderr, "connection %d failed\n", i);
+            return 1;
+        }
+        conns.push_back(conn);
+    }
+
+    char payload[64];
+    memset(payload, 'x', sizeof(payload));
+    std::vector<double> times;
+    times.reserve(iterations);
+    unsigned int state = 12345;
+    for (int it = 0; it < iterations; ++it)
+    {
+        state = state * 1103515245 + 12345;
+        ClientConnection *conn = conns[(state >> 8) % conns.size()];
+        Message msg(COVISE_MESSAGE_UI, sizeof(payload), payload, MSG_NOCOPY);
+        Message reply;
+        BenchTimer timer;
+        timer.start();
+        for (int b = 0; b < burst; ++b)
+            conn->send_msg(&msg);
+        for (int b = 0; b < burst; ++b)
+        {
+            conn->recv_msg(&reply);
+            reply.delete_data();
+        }
+        times.push_back(timer.elapsed());
+    }
+
+    Message quit(COVISE_MESSAGE_QUIT, 0, NULL, MSG_NOCOPY);
+    conns[0]->send_msg(&quit);
+
+    std::sort(times.begin(), times.end());
+    double sum = 0.0;
+    for (size_t i = 0; i < times.size(); ++i)
+        sum += times[i];
+    printf("%d connections, %d bursts of %d messages: round trip mean %.1f us, median %.1f us, 99%% %.1f us, max %.1f us\n",
+           numConnections, iterations, burst,
+           sum / times.size() * 1e6,
+           times[times.size() / 2] * 1e6,
+           times[times.size() * 99 / 100] * 1e6,
+           times.back() * 1e6);
+    fflush(stdout);
+
+    for (size_t i = 0; i < conns.size(); ++i)
+        delete conns[i];
+    return 0;
+}
+
+static void server(ConnectionList *list, int numConnections)
+{
+    while (list->count() < numConnections)
+        list->check_for_input(1.0);
+    printf("backend: %s\n", list->uses_epoll() ? "epoll" : "select");
+    fflush(stdout);
+
+    for (;;)
+    {
+        Connection *conn = list->wait_for_input();
+        Message msg;
+        if (conn->recv_msg(&msg) <= 0 || msg.type == COVISE_MESSAGE_QUIT)
+            break;
+        conn->send_msg(&msg);
+        msg.delete_data();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int numConnections = 500;
+    int iterations = 100000;
+    int burst = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numConnections = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+            burst = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n connections] [-i bursts] [-b messages per burst]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numConnections < 1 || iterations < 1 || burst < 1)
+        return 1;
+
+    int port = 0;
+    ServerConnection *open_sock = new ServerConnection(&port, 0, 0);
+    if (!open_sock->is_connected())
+    {
+        fprintf(stderr, "could not open server socket\n");
+        return 1;
+    }
+    ConnectionList *list = new ConnectionList(open_sock);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0)
+        _exit(client(port, numConnections, iterations, burst));
+
+    server(list, numConnections);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    delete list;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
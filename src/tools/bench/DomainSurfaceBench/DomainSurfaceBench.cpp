@@ -0,0 +1,233 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Boundary faces of an unstructured grid: linear search against face table
+ *
+ * An unstructured grid of n^3 hexahedra, or of 6 n^3 tetrahedra with -t,
+ * is classified face by face into boundary and interior faces, as done by
+ * DomainSurface. The search looks for the cells of the face vertices in
+ * the vertex->cell list, as coDoUnstructuredGrid::getNeighbor does without
+ * a face table. The face table is built by coDoNeighborList::buildFaceTable
+ * and queried with findFaceNeighbor. Both run with 1, 2, 4, ... threads up
+ * to the OpenMP maximum, the vertex->cell list is built once and not timed.
+ *
+ * The search visits all cells at a vertex of the face, so it gets slow at
+ * vertices of many cells. -f m builds n layers of a fan of m sectors around
+ * an axis instead, with about 4 m cells at every vertex of the axis.
+ *
+ * Reported are the times of the search, of building the table and of the
+ * queries, the ratio of table and search, and whether DomainSurface builds
+ * the table for this grid. Both have to find the same boundary faces. -s
+ * shuffles the cell order, -r sets the number of runs of which the fastest
+ * is reported.
+ */
+
+#include "BenchGrid.h"
+#include "BenchUtil.h"
+
+#include <do/coDoNeighborList.h>
+#include <do/coDoUnstructuredGrid.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace covise;
+
+// faces as tested by DomainSurface
+static const int faceTet[4][4] = { { 0, 2, 1, -1 }, { 0, 1, 3, -1 }, { 3, 1, 2, -1 }, { 0, 3, 2, -1 } };
+static const int faceHexa[6][4] = { { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 4, 5, 6, 7 }, { 0, 4, 7, 3 }, { 1, 2, 6, 5 }, { 0, 3, 2, 1 } };
+
+// n layers of a cylinder of m sectors around its axis, three tetrahedra
+// per sector and layer: about 4 m cells at every vertex of the axis
+static void makeFanGrid(int n, int m, BenchGrid &grid)
+{
+    grid.n = n;
+    for (int k = 0; k <= n; k++)
+    {
+        grid.x.push_back(0.f);
+        grid.y.push_back(0.f);
+        grid.z.push_back((float)k / n);
+        for (int s = 0; s < m; s++)
+        {
+            grid.x.push_back(cosf(2.f * (float)M_PI * s / m));
+            grid.y.push_back(sinf(2.f * (float)M_PI * s / m));
+            grid.z.push_back((float)k / n);
+        }
+    }
+    for (int k = 0; k < n; k++)
+    {
+        for (int s = 0; s < m; s++)
+        {
+            // prism axis, ring s, ring s+1 of layer k and k+1, split conforming
+            // from the axis vertex of layer k
+            int p[6] = { k * (m + 1), k * (m + 1) + 1 + s, k * (m + 1) + 1 + (s + 1) % m,
+                         (k + 1) * (m + 1), (k + 1) * (m + 1) + 1 + s, (k + 1) * (m + 1) + 1 + (s + 1) % m };
+            const int tet[3][4] = { { 0, 1, 2, 5 }, { 0, 1, 5, 4 }, { 0, 3, 4, 5 } };
+            for (int t = 0; t < 3; t++)
+            {
+                grid.el.push_back((int)grid.cl.size());
+                grid.tl.push_back(TYPE_TETRAHEDER);
+                for (int v = 0; v < 4; v++)
+                    grid.cl.push_back(p[tet[t][v]]);
+                grid.cube.push_back(k * m + s);
+            }
+        }
+    }
+}
+
+static const int *faceOf(const BenchGrid &grid, int cell, int face, int *nodes)
+{
+    const int(*table)[4] = grid.tl[cell] == TYPE_TETRAHEDER ? faceTet : faceHexa;
+    const int *conn = &grid.cl[grid.el[cell]];
+    for (int n = 0; n < 4; n++)
+        nodes[n] = table[face][n] >= 0 ? conn[table[face][n]] : -1;
+    return nodes;
+}
+
+// the search of coDoUnstructuredGrid::getNeighbor without face table:
+// another cell at the first face vertex containing two of the others
+static int searchNeighbor(const BenchGrid &grid, const std::vector<int> &index, const std::vector<int> &cells,
+                          int element, const int *nodes)
+{
+    int numNodes = nodes[3] >= 0 ? 4 : 3;
+    for (int i = index[nodes[0]]; i < index[nodes[0] + 1]; i++)
+    {
+        int ce = cells[i];
+        if (ce == element)
+            continue;
+        int size = grid.tl[ce] == TYPE_TETRAHEDER ? 4 : 8;
+        int found = 0;
+        for (int n = 0; n < size; n++)
+        {
+            int v = grid.cl[grid.el[ce] + n];
+            for (int f = 1; f < numNodes; f++)
+            {
+                if (v == nodes[f])
+                    found++;
+            }
+        }
+        if (found >= 2)
+            return ce;
+    }
+    return -1;
+}
+
+int main(int argc, char **argv)
+{
+    int n = 64;
+    int numRuns = 3;
+    int sectors = 0;
+    bool tets = false, shuffle = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            numRuns = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            sectors = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-t"))
+            tets = true;
+        else if (!strcmp(argv[i], "-s"))
+            shuffle = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [-n cubes per side] [-r runs] [-t (tetrahedra)] [-s (shuffle cells)] [-f sectors (fan)]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1 || numRuns < 1 || sectors < 0 || (sectors > 0 && sectors < 3))
+        return 1;
+
+    BenchGrid grid;
+    if (sectors > 0)
+        makeFanGrid(n, sectors, grid);
+    else
+        makeBenchGrid(n, tets, shuffle, grid);
+    const int numElem = (int)grid.el.size(), numConn = (int)grid.cl.size(), numCoord = (int)grid.x.size();
+    const int facesPerCell = grid.tl[0] == TYPE_TETRAHEDER ? 4 : 6;
+    const int numFaces = numElem * facesPerCell;
+    std::vector<int> threadCounts = benchThreadCounts();
+
+    std::vector<int> index, cells;
+    coDoNeighborList::buildVertexCells(numElem, numConn, numCoord, &grid.el[0], &grid.cl[0], &grid.tl[0],
+                                       index, cells);
+    int maxValence = 0;
+    for (int v = 0; v < numCoord; v++)
+        maxValence = std::max(maxValence, index[v + 1] - index[v]);
+    printf("%d %s, %d faces, up to %d cells at a vertex, %s, up to %d threads\n", numElem,
+           facesPerCell == 4 ? "tetrahedra" : "hexahedra", numFaces, maxValence,
+           sectors > 0 ? "fan" : shuffle ? "shuffled cell order" : "grid cell order", threadCounts.back());
+
+    std::vector<char> ref(numFaces), boundary(numFaces);
+    bool ok = true;
+    printf("threads  search ms  build ms  query ms  table ms  table/search\n");
+    for (size_t t = 0; t < threadCounts.size(); t++)
+    {
+        benchSetThreads(threadCounts[t]);
+        BenchTimer searchTimer, buildTimer, queryTimer;
+        for (int r = 0; r < numRuns; r++)
+        {
+            // the search parallelizes over the cells as DomainSurface does
+            searchTimer.start();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4096)
+#endif
+            for (int i = 0; i < numElem; i++)
+            {
+                for (int f = 0; f < facesPerCell; f++)
+                {
+                    int nodes[4];
+                    ref[i * facesPerCell + f] = searchNeighbor(grid, index, cells, i, faceOf(grid, i, f, nodes)) < 0;
+                }
+            }
+            searchTimer.stop();
+
+            std::vector<int> buckets, keys, pairs;
+            buildTimer.start();
+            coDoNeighborList::buildFaceTable(numElem, numConn, &grid.el[0], &grid.cl[0], &grid.tl[0],
+                                             buckets, keys, pairs);
+            buildTimer.stop();
+
+            queryTimer.start();
+            const int numBuckets = (int)buckets.size() - 1;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4096)
+#endif
+            for (int i = 0; i < numElem; i++)
+            {
+                for (int f = 0; f < facesPerCell; f++)
+                {
+                    int nodes[4];
+                    faceOf(grid, i, f, nodes);
+                    int neighbor = coDoNeighborList::findFaceNeighbor(&buckets[0], numBuckets, &keys[0], &pairs[0],
+                                                                      i, nodes[3] >= 0 ? 4 : 3, nodes);
+                    boundary[i * facesPerCell + f] = neighbor == coDoNeighborList::NO_NEIGHBOR;
+                }
+            }
+            queryTimer.stop();
+        }
+        bool same = boundary == ref;
+        ok = ok && same;
+        double table = buildTimer.best() + queryTimer.best();
+        printf("%7d  %9.1f  %8.1f  %8.1f  %8.1f  %12.2f%s\n", threadCounts[t], searchTimer.best() * 1e3,
+               buildTimer.best() * 1e3, queryTimer.best() * 1e3, table * 1e3, table / searchTimer.best(),
+               same ? "" : "  faces DIFFER");
+    }
+
+    printf("%d boundary faces, %s\n", (int)std::count(ref.begin(), ref.end(), 1),
+           ok ? "identical" : "DIFFER");
+    printf("DomainSurface %s the face table for this grid\n",
+           maxValence > coDoNeighborList::FaceTableValence ? "builds" : "does not build");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Isovalue sweep on an unstructured grid with and without SpanSpaceIndex
+ *
+ * An unstructured grid of n^3 hexahedra carries a smooth scalar field.
+ * Isosurfaces for i isovalues across its range are extracted by IsoPlane,
+ * once searching all cells and once with a span space index, as done by
+ * the IsoSurface module while the isovalue is dragged in COVER. The
+ * surfaces have to be identical.
+ *
+ * Reported are the time to build the index and its memory, compared to
+ * the grid, and the time per isovalue and the visited cells for both.
+ * -p uses the polyhedra code path, which is the module default.
+ */
+
+#include "BenchGrid.h"
+#include "BenchUtil.h"
+
+#include <alg/coIsoSurface.h>
+#include <do/coDoUnstructuredGrid.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+
+using namespace covise;
+
+struct Grid : BenchGrid
+{
+    std::vector<float> data;
+};
+
+static void makeGrid(int n, Grid &grid)
+{
+    makeBenchGrid(n, false, false, grid);
+    for (size_t v = 0; v < grid.x.size(); v++)
+    {
+        float x = grid.x[v], y = grid.y[v], z = grid.z[v];
+        float r = sqrtf((x - 0.5f) * (x - 0.5f) + (y - 0.5f) * (y - 0.5f) + (z - 0.5f) * (z - 0.5f));
+        grid.data.push_back(r + 0.05f * sinf(20.f * x) * sinf(17.f * y) * sinf(13.f * z));
+    }
+}
+
+struct Result
+{
+    double time;
+    int visited;
+    std::vector<float> coords;
+    std::vector<int> vertices;
+};
+
+static bool extract(Grid &grid, bool polyhedra, float isovalue, const SpanSpaceIndex *index, Result &result)
+{
+    int numElem = (int)grid.el.size(), numConn = (int)grid.cl.size(), numCoord = (int)grid.x.size();
+    BenchTimer timer;
+    timer.start();
+    if (polyhedra)
+    {
+        POLYHEDRON_IsoPlane plane(numElem, numConn, numCoord, 1, &grid.el[0], &grid.cl[0], &grid.tl[0],
+                                  &grid.x[0], &grid.y[0], &grid.z[0], &grid.data[0], &grid.data[0],
+                                  NULL, NULL, NULL, isovalue, false, NULL, index);
+        bool ok = plane.createIsoPlane();
+        result.time = timer.stop();
+        result.visited = plane.getNumVisitedCells();
+        return ok;
+    }
+
+    IsoPlane plane(numElem, numCoord, 1, 100.f, &grid.el[0], &grid.cl[0], &grid.tl[0],
+                   &grid.x[0], &grid.y[0], &grid.z[0], &grid.data[0], &grid.data[0],
+                   NULL, NULL, NULL, isovalue, false, NULL, index);
+    bool ok = plane.createIsoPlane();
+    result.time = timer.stop();
+    result.visited = plane.getNumVisitedCells();
+    result.coords.assign(plane.getXout(), plane.getXout() + plane.getNumCoords());
+    result.coords.insert(result.coords.end(), plane.getYout(), plane.getYout() + plane.getNumCoords());
+    result.coords.insert(result.coords.end(), plane.getZout(), plane.getZout() + plane.getNumCoords());
+    result.vertices.assign(plane.getVerticeList(), plane.getVerticeList() + plane.getNumVertices());
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int n = 64;
+    int numIso = 100;
+    bool polyhedra = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            numIso = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-p"))
+            polyhedra = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [-n cells per side] [-i isovalues] [-p]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1 || numIso < 1)
+        return 1;
+
+    Grid grid;
+    makeGrid(n, grid);
+    int numElem = (int)grid.el.size();
+    float dataMin = grid.data[0], dataMax = grid.data[0];
+    for (size_t i = 0; i < grid.data.size(); i++)
+    {
+        if (grid.data[i] < dataMin)
+            dataMin = grid.data[i];
+        if (grid.data[i] > dataMax)
+            dataMax = grid.data[i];
+    }
+    size_t gridBytes = sizeof(int) * (grid.el.size() + grid.cl.size() + grid.tl.size())
+                       + sizeof(float) * (grid.x.size() + grid.y.size() + grid.z.size() + grid.data.size());
+
+    BenchTimer timer;
+    timer.start();
+    SpanSpaceIndex index(numElem, (int)grid.cl.size(), &grid.el[0], &grid.cl[0], &grid.tl[0], &grid.data[0]);
+    double build = timer.stop();
+
+    printf("%d cells, %d isovalues, %s\n", numElem, numIso, polyhedra ? "polyhedra" : "standard cells");
+    printf("index: %.2f ms to build, %.2f MB (%.0f%% of grid and data)\n", build * 1e3,
+           index.getMemorySize() / 1048576., 100. * index.getMemorySize() / gridBytes);
+
+    double fullTime = 0., indexTime = 0.;
+    double visited = 0.;
+    bool ok = true;
+    for (int i = 0; i < numIso; i++)
+    {
+        float isovalue = dataMin + (dataMax - dataMin) * (i + 0.5f) / numIso;
+        Result full, indexed;
+        if (!extract(grid, polyhedra, isovalue, NULL, full) || !extract(grid, polyhedra, isovalue, &index, indexed))
+        {
+            fprintf(stderr, "isovalue %g: extraction failed\n", isovalue);
+            ok = false;
+            continue;
+        }
+        fullTime += full.time;
+        indexTime += indexed.time;
+        visited += indexed.visited;
+        if (full.coords != indexed.coords || full.vertices != indexed.vertices)
+        {
+            fprintf(stderr, "isovalue %g: surfaces differ\n", isovalue);
+            ok = false;
+        }
+    }
+
+    printf("all cells: %8.3f ms per isovalue\n", fullTime / numIso * 1e3);
+    printf("index:     %8.3f ms per isovalue, %.1f%% of the cells visited\n", indexTime / numIso * 1e3,
+           100. * visited / numIso / numElem);
+    printf("sweep: %.2f s without, %.2f s with index (including the build)\n", fullTime, indexTime + build);
+    if (!polyhedra)
+        printf("%s\n", ok ? "surfaces identical" : "surfaces DIFFER");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Message rate of a single loopback connection
+ *
+ * A child process sends a stream of messages of a fixed size, the parent
+ * receives them and reports messages and megabytes per second. The received
+ * data is deleted after every message as most receivers do. With -k it is
+ * kept in the Message for the next receive, which then needs no allocation.
+ * With -f send_msg_fast/recv_msg_fast are used.
+ */
+
+#include "BenchUtil.h"
+
+#include <net/covise_connect.h>
+#include <net/covise_host.h>
+#include <net/message.h>
+#include <net/message_types.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <vector>
+
+using namespace covise;
+
+static int client(int port, int size, int count, bool fast)
+{
+    ClientConnection *conn = new ClientConnection(NULL, port, 0, 0, 20, 5.0);
+    if (!conn->is_connected())
+    {
+        fprintf(stderr, "connection failed\n");
+        return 1;
+    }
+
+    std::vector<char> payload(size > 0 ? size : 1, 'x');
+    Message msg(COVISE_MESSAGE_UI, size, size > 0 ? &payload[0] : NULL, MSG_NOCOPY);
+    for (int i = 0; i < count; ++i)
+    {
+        if ((fast ? conn->send_msg_fast(&msg) : conn->send_msg(&msg)) < 0)
+            return 1;
+    }
+    msg.data = NULL;
+
+    Message quit(COVISE_MESSAGE_QUIT, 0, NULL, MSG_NOCOPY);
+    if (fast)
+        conn->send_msg_fast(&quit);
+    else
+        conn->send_msg(&quit);
+
+    // wait until everything has been received
+    Message reply;
+    conn->recv_msg(&reply);
+    delete conn;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int size = 64;
+    int count = 1000000;
+    bool fast = false;
+    bool keep = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            size = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f"))
+            fast = true;
+        else if (!strcmp(argv[i], "-k"))
+            keep = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [-s message size] [-n messages] [-f] [-k]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (size < 0 || count < 1)
+        return 1;
+
+    int port = 0;
+    ServerConnection *open_sock = new ServerConnection(&port, 0, 0);
+    if (!open_sock->is_connected() || open_sock->listen() < 0)
+    {
+        fprintf(stderr, "could not open server socket\n");
+        return 1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0)
+        _exit(client(port, size, count, fast));
+
+    if (open_sock->acceptOne(10) < 0)
+    {
+        fprintf(stderr, "client did not connect\n");
+        return 1;
+    }
+
+    int received = 0;
+    BenchTimer timer;
+    Message msg;
+    for (;;)
+    {
+        int ret = fast ? open_sock->recv_msg_fast(&msg) : open_sock->recv_msg(&msg);
+        if (ret < 0 || msg.type == Message::SOCKET_CLOSED || msg.type == Message::EMPTY)
+        {
+            fprintf(stderr, "connection lost after %d messages\n", received);
+            break;
+        }
+        if (msg.type == COVISE_MESSAGE_QUIT)
+            break;
+        if (received == 0)
+            timer.start();
+        ++received;
+        if (!keep)
+            msg.delete_data();
+    }
+    double elapsed = timer.elapsed();
+
+    Message ack(COVISE_MESSAGE_QUIT, 0, NULL, MSG_NOCOPY);
+    open_sock->send_msg(&ack);
+
+    printf("%d messages of %d bytes%s%s: %.0f messages/s, %.1f MB/s\n",
+           received, size, fast ? " (fast)" : "", keep ? " (kept)" : "",
+           received / elapsed, (double)received * size / elapsed / (1024. * 1024.));
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    delete open_sock;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -0,0 +1,186 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * CPU test of the tile encodings of the ParallelRendering socket transport
+ *
+ * Synthetic frames are generated: a smooth background gradient, a flat
+ * floor and a shaded sphere moving across the image. Every encoding is run
+ * with and without skipping unchanged blocks, the packets are decoded into
+ * a receiver image, which has to match the frame exactly for the lossless
+ * encodings. For YUV, the PSNR is reported.
+ *
+ * Reported are the bytes per frame, the encode and decode times and the
+ * frame rate for several link bandwidths. Encoding, sending and decoding
+ * run in separate threads, so the slowest stage limits the frame rate.
+ */
+
+#include "BenchUtil.h"
+
+#include <ParallelRenderingCodec.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+// BGRA frame with a sphere at a position depending on the frame number
+static void renderFrame(std::vector<unsigned char> &image, int width, int height, int frame, int numFrames)
+{
+    float radius = height * 0.15f;
+    float cx = radius + (width - 2.f * radius) * frame / std::max(numFrames - 1, 1);
+    float cy = height * 0.5f;
+    int floor = height / 4;
+
+    for (int y = 0; y < height; ++y)
+    {
+        unsigned char *p = &image[(size_t)y * width * 4];
+        for (int x = 0; x < width; ++x, p += 4)
+        {
+            float dx = (x - cx) / radius, dy = (y - cy) / radius;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < 1.f)
+            {
+                float nz = sqrtf(1.f - d2);
+                float light = 0.2f + 0.8f * std::max(0.f, 0.3f * dx + 0.5f * dy + 0.8f * nz);
+                p[0] = (unsigned char)(40 * light);
+                p[1] = (unsigned char)(90 * light);
+                p[2] = (unsigned char)(230 * light);
+            }
+            else if (y < floor)
+            {
+                p[0] = 60;
+                p[1] = 70;
+                p[2] = 70;
+            }
+            else
+            {
+                p[0] = (unsigned char)(255 - 100 * y / height - 50 * x / width);
+                p[1] = (unsigned char)(160 - 60 * y / height + 40 * x / width);
+                p[2] = (unsigned char)(120 - 60 * y / height);
+            }
+            p[3] = 255;
+        }
+    }
+}
+
+static double psnr(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b)
+{
+    double sum = 0.;
+    size_t n = 0;
+    for (size_t i = 0; i < a.size(); i += 4)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            double d = (double)a[i + c] - (double)b[i + c];
+            sum += d * d;
+            ++n;
+        }
+    }
+    if (sum == 0.)
+        return INFINITY;
+    return 10. * log10(255. * 255. / (sum / n));
+}
+
+int main(int argc, char **argv)
+{
+    int width = 1920;
+    int height = 1080;
+    int numFrames = 60;
+    int blockSize = 64;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-w") && i + 1 < argc)
+            width = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-h") && i + 1 < argc)
+            height = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numFrames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+            blockSize = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-w width] [-h height] [-n frames] [-b block size]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width < 1 || height < 1 || numFrames < 1 || blockSize < 1)
+        return 1;
+
+    std::vector<std::vector<unsigned char> > frames(numFrames);
+    for (int f = 0; f < numFrames; ++f)
+    {
+        frames[f].resize((size_t)width * height * 4);
+        renderFrame(frames[f], width, height, f, numFrames);
+    }
+    double rawBytes = (double)width * height * 4;
+    printf("%d frames of %dx%d, %.2f MB raw, blocks of %d pixels\n", numFrames, width, height, rawBytes / 1e6, blockSize);
+
+    const double bandwidths[] = { 0.1e9, 1e9, 10e9 };
+    const int numBandwidths = sizeof(bandwidths) / sizeof(bandwidths[0]);
+
+    printf("encoding  skip  MB/frame  ratio  encode ms  decode ms  PSNR dB");
+    for (int b = 0; b < numBandwidths; ++b)
+        printf("  fps@%gG", bandwidths[b] / 1e9);
+    printf("\n");
+
+    bool ok = true;
+    const char *names[] = { "raw", "rle", "yuv" };
+    for (int e = 0; e < 3; ++e)
+    {
+        for (int skip = 0; skip < 2; ++skip)
+        {
+            ParallelRenderingCodec codec(ParallelRenderingCodec::encodingFromString(names[e]), skip != 0, blockSize);
+            std::vector<unsigned char> received((size_t)width * height * 4, 0);
+            std::vector<char> packet;
+            double bytes = 0., encodeTime = 0., decodeTime = 0., minPsnr = INFINITY;
+
+            for (int f = 0; f < numFrames; ++f)
+            {
+                BenchTimer timer;
+                timer.start();
+                codec.encode(&frames[f][0], width, height, packet);
+                encodeTime += timer.elapsed();
+                bytes += packet.size();
+
+                timer.start();
+                if (!ParallelRenderingCodec::decode(&packet[0], packet.size(), &received[0], width, height))
+                {
+                    fprintf(stderr, "%s: frame %d could not be decoded\n", names[e], f);
+                    ok = false;
+                }
+                decodeTime += timer.elapsed();
+
+                double p = psnr(frames[f], received);
+                minPsnr = std::min(minPsnr, p);
+                if (codec.getEncoding() != ParallelRenderingCodec::YUV && p != INFINITY)
+                {
+                    fprintf(stderr, "%s: frame %d differs\n", names[e], f);
+                    ok = false;
+                }
+            }
+
+            bytes /= numFrames;
+            encodeTime /= numFrames;
+            decodeTime /= numFrames;
+            printf("%8s  %4s  %8.3f  %5.1f  %9.2f  %9.2f  %7.1f", names[e], skip ? "on" : "off",
+                   bytes / 1e6, rawBytes / bytes, encodeTime * 1e3, decodeTime * 1e3, minPsnr);
+            for (int b = 0; b < numBandwidths; ++b)
+            {
+                double sendTime = bytes * 8. / bandwidths[b];
+                printf("  %7.1f", 1. / std::max(sendTime, std::max(encodeTime, decodeTime)));
+            }
+            printf("\n");
+        }
+    }
+
+    printf("%s\n", ok ? "all frames decoded" : "frames CORRUPTED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * CPU test of the compositing of the SortLast plugin
+ *
+ * Every simulated node renders a few rectangles with distinct depths into a
+ * synthetic color and depth buffer. The buffers are composited with the
+ * binary swap schedule of the plugin and gathered as the master does, the
+ * result is compared to a direct depth composite of all buffers.
+ *
+ * This is done for 1 to n nodes. Reported are the time on the critical
+ * path (the slowest node of every round), the decoding on the master and
+ * the bytes exchanged, compared to sending all buffers to the master.
+ * -f sets the fraction of the image covered per node, -u disables the
+ * compression of background pixels.
+ */
+
+#include "BenchUtil.h"
+
+#include <SortLastCompositor.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+static const int numRects = 8;
+
+static void makeImage(int node, int numNodes, int width, int height, float fill,
+                      std::vector<unsigned char> &color, std::vector<float> &depth)
+{
+    int numPixels = width * height;
+    color.assign(3 * numPixels, 40);
+    depth.assign(numPixels, 1.0f);
+
+    unsigned int seed = 12345 + 977 * node;
+    int side = (int)sqrt(fill * numPixels / numRects);
+    side = std::max(1, std::min(side, std::min(width, height)));
+    int total = numRects * numNodes;
+    for (int r = 0; r < numRects; ++r)
+    {
+        seed = seed * 1103515245 + 12345;
+        int x0 = (seed >> 8) % (width - side + 1);
+        seed = seed * 1103515245 + 12345;
+        int y0 = (seed >> 8) % (height - side + 1);
+
+        // distinct depths, so that the composite does not depend on the order
+        int id = r * numNodes + node;
+        float d = 0.05f + 0.9f * ((id * 7919 % total) + 0.5f) / total;
+        unsigned char c[3] = { (unsigned char)(50 + 25 * node), (unsigned char)(30 * r), (unsigned char)(id * 37) };
+        for (int y = y0; y < y0 + side; ++y)
+        {
+            for (int x = x0; x < x0 + side; ++x)
+            {
+                int p = y * width + x;
+                if (d < depth[p])
+                {
+                    depth[p] = d;
+                    memcpy(&color[3 * p], c, 3);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int maxNodes = 8;
+    int width = 1920, height = 1080;
+    float fill = 0.3f;
+    bool compress = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            maxNodes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-w") && i + 1 < argc)
+            width = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-h") && i + 1 < argc)
+            height = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            fill = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "-u"))
+            compress = false;
+        else
+        {
+            fprintf(stderr, "usage: %s [-n nodes] [-w width] [-h height] [-f fill] [-u]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxNodes < 1 || width < 1 || height < 1)
+        return 1;
+
+    int numPixels = width * height;
+    printf("%dx%d pixels, %.0f%% covered per node, %s\n", width, height, fill * 100.f,
+           compress ? "compressed" : "uncompressed");
+    printf("nodes  swap ms  master ms  swap MB  gather MB | direct ms  direct MB\n");
+
+    bool ok = true;
+    for (int numNodes = 1; numNodes <= maxNodes; ++numNodes)
+    {
+        std::vector<std::vector<unsigned char> > color(numNodes);
+        std::vector<std::vector<float> > depth(numNodes);
+        for (int n = 0; n < numNodes; ++n)
+            makeImage(n, numNodes, width, height, fill, color[n], depth[n]);
+
+        // reference and the master compositing everything itself
+        std::vector<unsigned char> refColor(3 * numPixels, 40);
+        std::vector<float> refDepth(numPixels, 1.0f);
+        double direct = 0.;
+        size_t directBytes = 0;
+        for (int n = 0; n < numNodes; ++n)
+        {
+            std::vector<char> tile;
+            SortLastCompositor::encode(&color[n][0], &depth[n][0], 0, numPixels, true, false, tile);
+            directBytes += tile.size();
+            BenchTimer timer;
+            timer.start();
+            SortLastCompositor::composite(&refColor[0], &refDepth[0], numPixels, &tile[0], tile.size());
+            direct += timer.elapsed();
+        }
+
+        std::vector<std::vector<SortLastCompositor::Step> > steps(numNodes);
+        std::vector<int> ownBegin(numNodes), ownEnd(numNodes);
+        size_t numSteps = 0;
+        for (int n = 0; n < numNodes; ++n)
+        {
+            SortLastCompositor::binarySwap(n, numNodes, numPixels, steps[n], ownBegin[n], ownEnd[n]);
+            numSteps = std::max(numSteps, steps[n].size());
+        }
+
+        // every round, all nodes send to their partner, then composite what they received
+        double swap = 0.;
+        size_t swapBytes = 0;
+        std::vector<std::vector<char> > mailbox(numNodes);
+        std::vector<double> nodeTime(numNodes);
+        for (size_t s = 0; s < numSteps; ++s)
+        {
+            std::fill(nodeTime.begin(), nodeTime.end(), 0.);
+            for (int n = 0; n < numNodes; ++n)
+            {
+                mailbox[n].clear();
+            }
+            for (int n = 0; n < numNodes; ++n)
+            {
+                if (s >= steps[n].size() || !steps[n][s].send)
+                    continue;
+                const SortLastCompositor::Step &step = steps[n][s];
+                BenchTimer timer;
+                timer.start();
+                SortLastCompositor::encode(&color[n][0], &depth[n][0], step.sendBegin, step.sendEnd,
+                                           true, compress, mailbox[step.partner]);
+                nodeTime[n] += timer.elapsed();
+                swapBytes += mailbox[step.partner].size();
+            }
+            for (int n = 0; n < numNodes; ++n)
+            {
+                if (s >= steps[n].size() || !steps[n][s].receive)
+                    continue;
+                BenchTimer timer;
+                timer.start();
+                if (!SortLastCompositor::composite(&color[n][0], &depth[n][0], numPixels,
+                                                   &mailbox[n][0], mailbox[n].size()))
+                {
+                    fprintf(stderr, "%d nodes: invalid tile in round %d\n", numNodes, (int)s);
+                    ok = false;
+                }
+                nodeTime[n] += timer.elapsed();
+            }
+            swap += *std::max_element(nodeTime.begin(), nodeTime.end());
+        }
+
+        // gather the final tiles on the master
+        std::vector<unsigned char> result(4 * numPixels, 1);
+        double master = 0.;
+        size_t gatherBytes = 0;
+        double gatherEncode = 0.;
+        for (int n = 0; n < numNodes; ++n)
+        {
+            if (ownBegin[n] == ownEnd[n])
+                continue;
+            std::vector<char> tile;
+            BenchTimer timer;
+            timer.start();
+            SortLastCompositor::encode(&color[n][0], &depth[n][0], ownBegin[n], ownEnd[n], false, compress, tile);
+            gatherEncode = std::max(gatherEncode, timer.elapsed());
+            gatherBytes += tile.size();
+            timer.start();
+            if (!SortLastCompositor::decode(&result[0], numPixels, &tile[0], tile.size()))
+            {
+                fprintf(stderr, "%d nodes: invalid final tile of node %d\n", numNodes, n);
+                ok = false;
+            }
+            master += timer.elapsed();
+        }
+        swap += gatherEncode;
+
+        int wrong = 0;
+        for (int p = 0; p < numPixels; ++p)
+        {
+            const unsigned char *r = &result[4 * p];
+            bool covered = refDepth[p] < 1.0f;
+            if (r[3] != (covered ? 255 : 0))
+                ++wrong;
+            else if (r[3] && memcmp(r, &refColor[3 * p], 3) != 0)
+                ++wrong;
+        }
+        if (wrong)
+        {
+            fprintf(stderr, "%d nodes: %d wrong pixels\n", numNodes, wrong);
+            ok = false;
+        }
+
+        printf("%5d %8.2f %10.2f %8.2f %10.2f | %9.2f %10.2f\n", numNodes, swap * 1e3, master * 1e3,
+               swapBytes / 1048576., gatherBytes / 1048576., direct * 1e3, directBytes / 1048576.);
+    }
+
+    printf("%s\n", ok ? "composite correct" : "composite WRONG");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/**
+ * Load test for the registry of a running VRB
+ *
+ * n clients connect to the VRB and subscribe to one registry class. The
+ * first client creates v variables and then changes u randomly chosen
+ * variables per round, the round is complete when every client has seen
+ * the end marker of the round. The time per round and the number of
+ * messages each client received are reported.
+ *
+ * Compare delta updates and single messages by setting
+ * RegistryDeltas="false" in the System.VRB section of the configuration
+ * used by the VRB.
+ */
+
+#include "BenchUtil.h"
+
+#include <net/covise_connect.h>
+#include <net/covise_host.h>
+#include <net/message.h>
+#include <net/message_types.h>
+#include <net/tokenbuffer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <algorithm>
+
+using namespace covise;
+
+static const char *className = "RegistryBench";
+
+struct BenchClient
+{
+    ClientConnection *conn;
+    int id;
+    int round; // last round completely received
+    long messages;
+    long entries;
+};
+
+static void setValue(BenchClient &c, const char *var, const char *value)
+{
+    TokenBuffer tb;
+    tb << className;
+    tb << 0;
+    tb << var;
+    tb << value;
+    Message m(tb);
+    m.type = COVISE_MESSAGE_VRB_REGISTRY_SET_VALUE;
+    c.conn->send_msg(&m);
+}
+
+// count a registry change, an end marker value "end <round>" completes a round
+static void entry(BenchClient &c, TokenBuffer &tb, char *cl)
+{
+    int clID;
+    char *var, *value;
+    tb >> clID;
+    tb >> var;
+    tb >> value;
+    if (strcmp(cl, className))
+        return;
+    ++c.entries;
+    int round;
+    if (!strcmp(var, "end") && sscanf(value, "end %d", &round) == 1)
+        c.round = std::max(c.round, round);
+}
+
+static void receive(BenchClient &c)
+{
+    Message msg;
+    c.conn->recv_msg(&msg);
+    TokenBuffer tb(&msg);
+    char *cl;
+    switch (msg.type)
+    {
+    case COVISE_MESSAGE_VRB_GET_ID:
+        tb >> c.id;
+        break;
+    case COVISE_MESSAGE_VRB_REGISTRY_ENTRY_CHANGED:
+        ++c.messages;
+        tb >> cl;
+        entry(c, tb, cl);
+        break;
+    case COVISE_MESSAGE_VRB_REGISTRY_ENTRIES_CHANGED:
+        ++c.messages;
+        for (;;)
+        {
+            tb >> cl;
+            if (!cl[0])
+                break;
+            entry(c, tb, cl);
+        }
+        break;
+    case COVISE_MESSAGE_SOCKET_CLOSED:
+    case COVISE_MESSAGE_CLOSE_SOCKET:
+        fprintf(stderr, "lost connection to VRB\n");
+        exit(1);
+    default:
+        break;
+    }
+    msg.delete_data();
+}
+
+// round < 0: all clients got their ID, otherwise all clients saw the end marker of round
+static bool allDone(std::vector<BenchClient> &clients, int round)
+{
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        if (round < 0 ? clients[i].id < 0 : clients[i].round < round)
+            return false;
+    }
+    return true;
+}
+
+static bool receiveAll(ConnectionList *list, std::vector<BenchClient> &clients, int round)
+{
+    BenchTimer timer;
+    timer.start();
+    while (!allDone(clients, round))
+    {
+        Connection *conn = list->check_for_input(1.0f);
+        if (!conn)
+        {
+            if (timer.elapsed() > 30.0)
+                return false;
+            continue;
+        }
+        for (size_t i = 0; i < clients.size(); ++i)
+        {
+            if (clients[i].conn == conn)
+            {
+                receive(clients[i]);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *hostname = "localhost";
+    int port = 31800;
+    int numClients = 30;
+    int numVars = 2000;
+    int updates = 500;
+    int rounds = 50;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-h") && i + 1 < argc)
+            hostname = argv[++i];
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numClients = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-v") && i + 1 < argc)
+            numVars = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-u") && i + 1 < argc)
+            updates = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            rounds = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-h vrb host] [-p port] [-n clients] [-v variables] [-u updates per round] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numClients < 1 || numVars < 1 || updates < 1 || rounds < 1)
+        return 1;
+
+    Host host(hostname);
+    ConnectionList *list = new ConnectionList();
+    std::vector<BenchClient> clients(numClients);
+    for (int i = 0; i < numClients; ++i)
+    {
+        BenchClient &c = clients[i];
+        c.conn = new ClientConnection(&host, port, 0, 0, 20, 5.0);
+        c.id = -1;
+        c.round = 0;
+        c.messages = c.entries = 0;
+        if (!c.conn->is_connected())
+        {
+            fprintf(stderr, "could not connect to VRB on %s:%d\n", hostname, port);
+            return 1;
+        }
+        list->add(c.conn);
+
+        TokenBuffer tb;
+        tb << "RegistryBench";
+        tb << "127.0.0.1";
+        Message m(tb);
+        m.type = COVISE_MESSAGE_VRB_CONTACT;
+        c.conn->send_msg(&m);
+    }
+    if (!receiveAll(list, clients, -1))
+    {
+        fprintf(stderr, "did not get client IDs from VRB\n");
+        return 1;
+    }
+
+    for (int i = 0; i < numClients; ++i)
+    {
+        TokenBuffer tb;
+        tb << className;
+        tb << 0;
+        tb << clients[i].id;
+        Message m(tb);
+        m.type = COVISE_MESSAGE_VRB_REGISTRY_SUBSCRIBE_CLASS;
+        clients[i].conn->send_msg(&m);
+    }
+
+    char var[64], value[64];
+    BenchClient &writer = clients[0];
+    for (int i = 0; i < numVars; ++i)
+    {
+        sprintf(var, "var%d", i);
+        setValue(writer, var, "0");
+    }
+    setValue(writer, "end", "end 0");
+    if (!receiveAll(list, clients, 0))
+    {
+        fprintf(stderr, "timeout while creating variables\n");
+        return 1;
+    }
+
+    for (int i = 0; i < numClients; ++i)
+        clients[i].messages = clients[i].entries = 0;
+
+    std::vector<double> times;
+    unsigned int state = 12345;
+    for (int r = 1; r <= rounds; ++r)
+    {
+        BenchTimer timer;
+        timer.start();
+        for (int i = 0; i < updates; ++i)
+        {
+            state = state * 1103515245 + 12345;
+            sprintf(var, "var%d", (state >> 8) % numVars);
+            sprintf(value, "%d %d", r, i);
+            setValue(writer, var, value);
+        }
+        sprintf(value, "end %d", r);
+        setValue(writer, "end", value);
+        if (!receiveAll(list, clients, r))
+        {
+            fprintf(stderr, "timeout in round %d\n", r);
+            return 1;
+        }
+        times.push_back(timer.elapsed());
+    }
+
+    long messages = 0, entries = 0;
+    for (int i = 0; i < numClients; ++i)
+    {
+        messages += clients[i].messages;
+        entries += clients[i].entries;
+    }
+    std::sort(times.begin(), times.end());
+    double sum = 0.0;
+    for (size_t i = 0; i < times.size(); ++i)
+        sum += times[i];
+    printf("%d clients, %d variables, %d updates per round, %d rounds\n", numClients, numVars, updates, rounds);
+    printf("round mean %.2f ms, median %.2f ms, max %.2f ms, %.0f updates/s\n",
+           sum / times.size() * 1e3, times[times.size() / 2] * 1e3, times.back() * 1e3,
+           updates * rounds / sum);
+    printf("per client and round: %.1f messages, %.1f entries\n",
+           double(messages) / numClients / rounds, double(entries) / numClients / rounds);
+
+    for (int i = 0; i < numClients; ++i)
+        delete clients[i].conn;
+    return 0;
+}
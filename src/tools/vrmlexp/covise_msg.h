@@ -197,7 +197,16 @@ enum covise_msg_type
     TABLET_UI, // 123
     QUERY_DATA_PATH, // 124
     SEND_DATA_PATH, // 125
-    LAST_DUMMY_MESSAGE
+    VRB_FB_RQ, // 126
+    VRB_FB_SET, // 127
+    VRB_FB_REMREQ, // 128
+    UPDATE_LOADED_MAPNAME, // 129
+    CRB_EXEC_DEBUG, // 130
+    CRB_EXEC_MEMCHECK, // 131
+    SSLDAEMON, // 132
+    VISENSO_UI, // 133
+    VRB_REGISTRY_ENTRIES_CHANGED, // 134
+    LAST_DUMMY_MESSAGE // 135
 };
 #ifdef DEFINE_MSG_TYPES
 const char *covise_msg_types_array[] = {
@@ -327,6 +336,15 @@ const char *covise_msg_types_array[] = {
     "TABLET_UI", // 123
     "QUERY_DATA_PATH", // 124
     "SEND_DATA_PATH", // 125
+    "VRB_FB_RQ", // 126
+    "VRB_FB_SET", // 127
+    "VRB_FB_REMREQ", // 128
+    "UPDATE_LOADED_MAPNAME", // 129
+    "CRB_EXEC_DEBUG", // 130
+    "CRB_EXEC_MEMCHECK", // 131
+    "SSLDAEMON", // 132
+    "VISENSO_UI", // 133
+    "VRB_REGISTRY_ENTRIES_CHANGED", // 134
     "GIVE_ME_A_NAME",
     "GIVE_ME_A_NAME",
     "GIVE_ME_A_NAME",